@@ -64,7 +64,6 @@ int32 APP_MAIN(int argc, char *argv[], char* /*envp*/[])
   if (VerboseLevel >= 1)
   {
     fmt::print(xMiscUtilsCORE::formatCompileTimeSetup());
-    fmt::print("USE_RUNTIME_CMPWEIGHTS = {}\n", xc_USE_RUNTIME_CMPWEIGHTS);
     fmt::print("\n");
   }
 
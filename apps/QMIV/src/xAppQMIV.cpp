@@ -59,7 +59,7 @@ usage::general --------------------------------------------------------------
  -r    ResultFile         Output file path for printing result(s) (optional)
  -ml   MetricList         List of quality metrics to be calculated, must be coma separated,
                           quotes are required. "All" enables all available metrics.
-                          [PSNR, WSPSNR, IVPSNR, SSIM, MSSSIM, IVSSIM]
+                          [PSNR, WSPSNR, IVPSNR, SSIM, MSSSIM, IVSSIM, FASTSSIM, IVFSSIM]
                           (optional, default="PSNR, WSPSNR, IVPSNR, IVSSIM")       
 
 PictureSize parameter can be used interchangeably with PictureWidth, PictureHeight pair. If PictureSize parameter is present the PictureWidth and PictureHeight arguments are ignored.
@@ -87,7 +87,7 @@ usage::IV_specific ----------------------------------------------------------
                           (optional, default=2 --> 5x5)
  -cws  CmpWeightsSearch   IV-metric component weights used during search
                           ("Lm:Cb:Cr:0" or "R:G:B:0" - per component integer weights,
-                          default="4:1:1:0", quotes are mandatory, requires USE_RUNTIME_CMPWEIGHTS=1)
+                          default="4:1:1:0", quotes are mandatory)
  -cwa  CmpWeightsAverage  IV-metric component weights used during averaging
                           ("Lm:Cb:Cr:0" or "R:G:B:0" - per component integer weights,
                           default="4:1:1:0", quotes are mandatory)
@@ -110,8 +110,36 @@ usage::software_operation ---------------------------------------------------
                           suggested ~8 for IVPSNR, all physical cores for SSIM)
                           [-1 = all available threads, -2 = reasonable auto]
  -ilp  InterleavedPic     Use additional image buffer with interleaved layout for IV-PSNR 
-                          (improves performance at a cost of increased memory usage
-                          optional, default=1)
+                          (increases memory usage, planar SIMD search is used otherwise,
+                          always used in mask mode, optional, default=0)
+ -scv  SharedCostVolume   Calculate both directions of IV-PSNR (R2T and T2R) from single
+                          shared displacement search (faster for SearchRange >= 4, slower
+                          for default SearchRange, does not change results, not used in
+                          mask mode, optional, default=0)
+                          If IV-SSIM is enabled too, the same search generates its shift
+                          compensated pictures.
+ -sts  StreamSCP          Generate shift compensated pictures for IV-SSIM in bands, just
+                          ahead of SSIM rows using them, instead of full pictures (single
+                          SCP row per thread, reduces memory footprint, does not change
+                          results, used when IV-SSIM is the only user of shift compensated
+                          pictures, optional, default=0)
+ -ssp  SSIMPrecision      Floating point precision of SSIM-based metrics calculation
+                          (optional, default=64) [32 = single (faster), 64 = double]
+ -ssc  SSIMPrecCheck      Calculate SSIM-based metrics in both precisions and report maximum
+                          per frame deviation of single against double precision
+                          (slows down computations, used with SSIMPrecision=32 only,
+                          optional, default=0)
+ -sss  SSIMSampleStep     Evaluate SSIM-based metrics only on regular grid of every N-th
+                          pixel in x and y (fast approximation for large sweeps, reported
+                          with -SN metric suffix, optional, default=1) [1 = all pixels]
+ -fsw  FastSSIMWindow     Size of box window used by FASTSSIM and IVFSSIM metrics
+                          (optional, default=8) [2-64]
+ -nch  NativeChroma       Keep chroma planes of 4:2:0 and 4:2:2 input in native resolution
+                          instead of upsampling them to luma resolution (reduces chroma
+                          memory and compute, does not change PSNR and WS-PSNR, changes
+                          chroma values of SSIM-based metrics - reported with -NC metric
+                          suffix, used only without IV metrics, mask and colorspace
+                          conversion, optional, default=0)
  -v    VerboseLevel       Verbose level (optional, default=1)
 
  -c    "config.cfg"       External config file - in INI format (optional)
@@ -122,7 +150,7 @@ VerboseLevel:
   1 = 0 + configuration + detected frame numbers
   2 = 1 + argc/argv + frame level metric values
   3 = 2 + computing time (could slightly slow down computations)
-  4 = 3 + IV specific debug data (GlobalColorShift, R2T+T2R, NumNonMasked)
+  4 = 3 + IV specific debug data (GlobalColorShift, R2T+T2R, NumNonMasked, SkippedPixels)
   9 = stdout flood 
 
 -----------------------------------------------------------------------------
@@ -188,6 +216,13 @@ void xAppQMIV::registerCmdParams()
   //operation
   m_CfgParser.addCmdParm("nth", "NumberOfThreads"  , "", "NumberOfThreads"     );
   m_CfgParser.addCmdParm("ilp", "InterleavedPic"   , "", "InterleavedPic"      );
+  m_CfgParser.addCmdParm("scv", "SharedCostVolume" , "", "SharedCostVolume"    );
+  m_CfgParser.addCmdParm("sts", "StreamSCP"        , "", "StreamSCP"           );
+  m_CfgParser.addCmdParm("ssp", "SSIMPrecision"    , "", "SSIMPrecision"       );
+  m_CfgParser.addCmdParm("ssc", "SSIMPrecCheck"    , "", "SSIMPrecCheck"       );
+  m_CfgParser.addCmdParm("sss", "SSIMSampleStep"   , "", "SSIMSampleStep"      );
+  m_CfgParser.addCmdParm("fsw", "FastSSIMWindow"   , "", "FastSSIMWindow"      );
+  m_CfgParser.addCmdParm("nch", "NativeChroma"     , "", "NativeChroma"        );
   m_CfgParser.addCmdParm("v"  , "VerboseLevel"     , "", "VerboseLevel"        );  
 }
 bool xAppQMIV::loadConfiguration(int argc, const char* argv[])
@@ -312,21 +347,37 @@ bool xAppQMIV::readConfiguration()
 
   //operation ---------------------------------------------------------------------------------------------------------
   m_NumberOfThreads = m_CfgParser.getParam1stArg("NumberOfThreads", -2  );
-  m_InterleavedPic  = m_CfgParser.getParam1stArg("InterleavedPic" , true);
+  m_InterleavedPic  = m_CfgParser.getParam1stArg("InterleavedPic" , false);
+  m_SharedCostVolume = m_CfgParser.getParam1stArg("SharedCostVolume", xCorrespPixelShiftPrms::c_DefaultUseCostVolume);
+  m_StreamSCP       = m_CfgParser.getParam1stArg("StreamSCP"      , false);
+  m_SSIMPrecision   = m_CfgParser.getParam1stArg("SSIMPrecision"  , xSSIM::c_DefaultPrecision);
+  m_SSIMPrecCheck   = m_CfgParser.getParam1stArg("SSIMPrecCheck"  , false);
+  if(m_SSIMPrecision != 32 && m_SSIMPrecision != 64) { m_ErrorLog += "!  SSIMPrecision value must be 32 or 64\n"; AnyError = true; }
+  m_SSIMSampleStep  = m_CfgParser.getParam1stArg("SSIMSampleStep" , xSSIM::c_DefaultSampleStep);
+  if(m_SSIMSampleStep < 1) { m_ErrorLog += "!  SSIMSampleStep value must be 1 or greater\n"; AnyError = true; }
+  m_FastSSIMWindow  = m_CfgParser.getParam1stArg("FastSSIMWindow" , xSSIM::c_DefaultBoxSize);
+  if(m_FastSSIMWindow < 2 || m_FastSSIMWindow > xSSIM::c_MaxBoxSize) { m_ErrorLog += fmt::format("!  FastSSIMWindow value must be in range 2-{}\n", xSSIM::c_MaxBoxSize); AnyError = true; }
+  m_NativeChroma    = m_CfgParser.getParam1stArg("NativeChroma"   , false);
   m_VerboseLevel    = m_CfgParser.getParam1stArg("VerboseLevel"   , 1   );
 
   //derrived ----------------------------------------------------------------------------------------------------------
   m_UseMask      = !m_InputFile[2].empty();
-  m_UsePicI      = m_InterleavedPic && getCalcMetric(eMetric::IVPSNR);
+  m_UsePicI      = (m_InterleavedPic || m_UseMask) && getCalcMetric(eMetric::IVPSNR); //mask mode uses interleaved layout only
   m_NumInputsCur = !m_UseMask ? 2 : 3;
   m_CvtYCbCr2RGB = isDefinedYCbCr(m_ColorSpaceInput) && isRGB(m_ColorSpaceMetric);
   m_CvtRGB2YCbCr = isRGB(m_ColorSpaceInput) && isDefinedYCbCr(m_ColorSpaceMetric);
   m_ReorderRGB   = isRGB(m_ColorSpaceInput) && m_ColorSpaceInput != eClrSpcApp::RGB && m_ColorSpaceMetric == eClrSpcApp::RGB;
   m_CalcPSNRs    = getCalcMetric(eMetric::PSNR) || getCalcMetric(eMetric::WSPSNR) || getCalcMetric(eMetric::IVPSNR);
-  m_CalcSSIMs    = getCalcMetric(eMetric::SSIM) || getCalcMetric(eMetric::MSSSIM) || getCalcMetric(eMetric::IVSSIM);
-  m_CalcIVs      = getCalcMetric(eMetric::IVPSNR) || getCalcMetric(eMetric::IVSSIM);
-  m_CalcSCP      = getCalcMetric(eMetric::IVSSIM);
+  m_CalcSSIMs    = getCalcMetric(eMetric::SSIM) || getCalcMetric(eMetric::MSSSIM) || getCalcMetric(eMetric::IVSSIM) || getCalcMetric(eMetric::FASTSSIM) || getCalcMetric(eMetric::IVFSSIM);
+  m_CalcIVs      = getCalcMetric(eMetric::IVPSNR) || getCalcMetric(eMetric::IVSSIM) || getCalcMetric(eMetric::IVFSSIM);
+  m_CalcSCP      = getCalcMetric(eMetric::IVSSIM) || getCalcMetric(eMetric::IVFSSIM);
+  m_ShareSCP     = m_CalcSCP && getCalcMetric(eMetric::IVPSNR);
+  m_UseStreamSCP = m_CalcSCP && m_StreamSCP && !m_ShareSCP && !getCalcMetric(eMetric::IVFSSIM);
   m_CalcGCD      = m_CalcIVs || m_CalcSCP;
+  m_CheckSSIMPrec = m_CalcSSIMs && m_SSIMPrecCheck && m_SSIMPrecision == 32;
+  m_UseNativeChroma = m_NativeChroma && (m_ChromaFormat == eCrF::CF420 || m_ChromaFormat == eCrF::CF422) && !m_CalcIVs && !m_UseMask && !m_CvtYCbCr2RGB && !m_CvtRGB2YCbCr && !m_ReorderRGB;
+  m_PicChromaFormat = m_UseNativeChroma ? m_ChromaFormat : eCrF::CF444;
+  m_UseDiffStats = !m_UseMask && !m_CvtYCbCr2RGB && !m_CvtRGB2YCbCr && !m_ReorderRGB && (getCalcMetric(eMetric::PSNR) || getCalcMetric(eMetric::WSPSNR) || m_CalcGCD);
   m_PicMargin    = xRoundUpToNearestMultiple(m_SearchRange, 2);
   m_WindowSize   = 2 * m_SearchRange + 1;
   m_PrintFrame   = m_VerboseLevel >= 2;
@@ -379,6 +430,13 @@ std::string xAppQMIV::formatConfiguration()
   //operation
   Config += fmt::format("NumberOfThreads   = {}{}\n", m_NumberOfThreads, m_NumberOfThreads == -1 ? "  (all)" : m_NumberOfThreads == -2 ? "  (auto)" : "");
   Config += fmt::format("InterleavedPic    = {:d}\n", m_InterleavedPic);
+  Config += fmt::format("SharedCostVolume  = {:d}\n", m_SharedCostVolume);
+  Config += fmt::format("StreamSCP         = {:d}\n", m_StreamSCP);
+  Config += fmt::format("SSIMPrecision     = {}{}\n"  , m_SSIMPrecision, m_CalcSSIMs ? "" : "  (irrelevant)");
+  Config += fmt::format("SSIMPrecCheck     = {:d}{}\n", m_SSIMPrecCheck, m_CheckSSIMPrec ? "" : "  (irrelevant)");
+  Config += fmt::format("SSIMSampleStep    = {}{}\n"  , m_SSIMSampleStep, m_CalcSSIMs ? "" : "  (irrelevant)");
+  Config += fmt::format("FastSSIMWindow    = {}{}\n"  , m_FastSSIMWindow, getCalcMetric(eMetric::FASTSSIM) || getCalcMetric(eMetric::IVFSSIM) ? "" : "  (irrelevant)");
+  Config += fmt::format("NativeChroma      = {:d}\n", m_NativeChroma  );
   Config += fmt::format("VerboseLevel      = {}\n"  , m_VerboseLevel  );
   Config += "\n";
   //derrived
@@ -386,6 +444,10 @@ std::string xAppQMIV::formatConfiguration()
   Config += fmt::format("WindowSize        = {}x{}\n", m_WindowSize, m_WindowSize);
   Config += fmt::format("PictureMargin     = {}\n", m_PicMargin);
   Config += fmt::format("UseMask           = {:d}\n", m_UseMask);
+  Config += fmt::format("ShareSCP          = {:d}\n", m_ShareSCP);
+  Config += fmt::format("UseStreamSCP      = {:d}\n", m_UseStreamSCP);
+  Config += fmt::format("UseNativeChroma   = {:d}\n", m_UseNativeChroma);
+  Config += fmt::format("UseDiffStats      = {:d}\n", m_UseDiffStats);
   Config += "\n";
   //metric description
   Config += fmt::format("Selected metrics:\n");
@@ -419,22 +481,16 @@ std::string xAppQMIV::formatWarnings()
 {
   std::string Warnings = "";
 
-  //check weights
-  if constexpr (!xc_USE_RUNTIME_CMPWEIGHTS)
-  {
-    Warnings += fmt::format("CONFIGURATION WARNING: Software was build with USE_RUNTIME_CMPWEIGHTS option disabled. Config parameter CmpWeightsSearch will be ignored. Default component weights will be used. The default weights are {}.\n\n", xFmtScn::formatIntWeights(xCorrespPixelShiftPrms::c_DefaultCmpWeights));
-  }
-
   //check conformance
   if(m_SearchRange != xCorrespPixelShiftPrms::c_DefaultSearchRange)
   {
     Warnings += fmt::format("CONFORMANCE WARNING: Software was executed with SearchRange different than default one. This leads to result different than expected for MPEG Common Test Conditions defined for immersive video. The default range is DefaultSearchRange={}.\n\n", xCorrespPixelShiftPrms::c_DefaultSearchRange);
   }
-  if(xc_USE_RUNTIME_CMPWEIGHTS && m_CmpWeightsSearch != xCorrespPixelShiftPrms::c_DefaultCmpWeights)
+  if(m_CmpWeightsSearch != xCorrespPixelShiftPrms::c_DefaultCmpWeights)
   {
     Warnings += fmt::format("CONFORMANCE WARNING: Software was executed with CmpWeightsSearch different than default one. This leads to result different than expected for MPEG Common Test Conditions defined for immersive video. The default weights are DefaultCmpWeights={}.\n\n", xFmtScn::formatIntWeights(xCorrespPixelShiftPrms::c_DefaultCmpWeights));
   }
-  if(xc_USE_RUNTIME_CMPWEIGHTS && m_CmpWeightsAverage != xCorrespPixelShiftPrms::c_DefaultCmpWeights)
+  if(m_CmpWeightsAverage != xCorrespPixelShiftPrms::c_DefaultCmpWeights)
   {
     Warnings += fmt::format("CONFORMANCE WARNING: Software was executed with CmpWeightsAverage different than default one. This leads to result different than expected for MPEG Common Test Conditions defined for immersive video. The default weights are DefaultCmpWeights={}.\n\n", xFmtScn::formatIntWeights(xCorrespPixelShiftPrms::c_DefaultCmpWeights));
   }
@@ -448,10 +504,6 @@ std::string xAppQMIV::formatWarnings()
   {
     Warnings += fmt::format("PERFORMANCE WARNING: Software was executed with SearchRange wider than default one. This leads to higher computational complexity and longer calculation time. The default range is DefaultSearchRange=%d.\n\n", xCorrespPixelShiftPrms::c_DefaultSearchRange);
   }
-  if(xc_USE_RUNTIME_CMPWEIGHTS && m_CmpWeightsSearch == xCorrespPixelShiftPrms::c_DefaultCmpWeights && !X_CORRESPPIXELSHIFT_CAN_USE_SSE)
-  {
-    Warnings += fmt::format("PERFORMANCE WARNING: Software was build with USE_RUNTIME_CMPWEIGHTS option enabled and default weights was selected. To speed up computation of IV-PSNR with default weights - dissable USE_RUNTIME_CMPWEIGHTS option.\n\n");
-  }
 
   return Warnings;
 }
@@ -570,11 +622,12 @@ eRes xAppQMIV::setupSeqAndBuffs()
   }
 
   //input buffers
-  for(int32 i = 0; i < m_NumInputsCur; i++) { m_PicInP[i].create(m_PictureSize, BDs[i], m_PicMargin); }
+  for(int32 i = 0; i < m_NumInputsCur; i++) { m_PicInP[i].create(m_PictureSize, BDs[i], m_PicMargin, m_PicChromaFormat); }
   if(m_UsePicI) { for(int32 i = 0; i < NumInputsSeq; i++) { m_PicInI[i].create(m_PictureSize, m_BitDepth, m_PicMargin); } }
+  if(m_UseMask) { m_PicMsk.create(&m_PicInP[2]); }
 
   //SCP buffers
-  if(m_CalcGCD) { for(int32 i = 0; i < NumInputsSeq; i++) { m_PicSCP[i].create(m_PictureSize, m_BitDepth, m_PicMargin); } }
+  if(m_CalcGCD && !m_UseStreamSCP) { for(int32 i = 0; i < NumInputsSeq; i++) { m_PicSCP[i].create(m_PictureSize, m_BitDepth, m_PicMargin); } }
 
   return eRes::Good;
 }
@@ -586,8 +639,9 @@ eRes xAppQMIV::ceaseSeqAndBuffs()
   //input buffers
   for(int32 i = 0; i < m_NumInputsCur; i++) { m_PicInP[i].destroy  (); }
   if(m_UsePicI) { for(int32 i = 0; i < NumInputsSeq; i++) { m_PicInI[i].destroy(); } }
+  if(m_UseMask) { m_PicMsk.destroy(); }
   //SCP buffers
-  if(m_CalcGCD) { for(int32 i = 0; i < NumInputsSeq; i++) { m_PicSCP[i].destroy(); } }
+  if(m_CalcGCD && !m_UseStreamSCP) { for(int32 i = 0; i < NumInputsSeq; i++) { m_PicSCP[i].destroy(); } }
   return eRes::Good;
 }
 void xAppQMIV::createProcessors()
@@ -595,6 +649,11 @@ void xAppQMIV::createProcessors()
   const int32 PictureWidth  = m_PictureSize.getX();
   const int32 PictureHeight = m_PictureSize.getY();
 
+  if(m_UseDiffStats)
+  {
+    if(m_NumberOfThreadsUsed > 0) { m_DiffStats.initThreadPool(m_ThreadPool, PictureHeight + 1); }
+  }
+
   if(m_CalcGCD)
   {
     m_ProcGCD.setUnntcbCoef(m_UnnoticeableCoef);
@@ -615,6 +674,7 @@ void xAppQMIV::createProcessors()
     m_ProcPSNR.setCmpWeightsSearch (m_CmpWeightsSearch );
     m_ProcPSNR.setCmpWeightsAverage(m_CmpWeightsAverage);
     m_ProcPSNR.setUnntcbCoef       (m_UnnoticeableCoef );
+    m_ProcPSNR.setUseCostVolume    (m_SharedCostVolume );
     if(m_NumberOfThreadsUsed > 0) { m_ProcPSNR.initThreadPool(m_ThreadPool, PictureHeight + 1); }
     m_ProcPSNR.initRowBuffers(PictureHeight);
     if(m_IsEquirectangular) { m_ProcPSNR.initWS(true, PictureWidth, PictureHeight, m_BitDepth, m_LonRangeDeg, m_LatRangeDeg); }
@@ -622,11 +682,15 @@ void xAppQMIV::createProcessors()
 
   if(m_CalcSSIMs)
   {
-    m_ProcSSIM.create(m_PictureSize, m_BitDepth, m_PicMargin, true);
+    m_ProcSSIM.create(m_PictureSize, m_BitDepth, m_PicMargin, true, m_PicChromaFormat);
     m_ProcSSIM.setSearchRange      (m_SearchRange      );
     m_ProcSSIM.setCmpWeightsSearch (m_CmpWeightsSearch );
     m_ProcSSIM.setCmpWeightsAverage(m_CmpWeightsAverage);
     m_ProcSSIM.setUnntcbCoef       (m_UnnoticeableCoef );
+    m_ProcSSIM.setPrecision        (m_SSIMPrecision    );
+    m_ProcSSIM.setSampleStep       (m_SSIMSampleStep   );
+    m_ProcSSIM.setBoxSize          (m_FastSSIMWindow   );
+    m_ProcSSIM.setUseMomentCache   ((int32)getCalcMetric(eMetric::SSIM) + (int32)getCalcMetric(eMetric::MSSSIM) + (int32)getCalcMetric(eMetric::IVSSIM) > 1); //Tst and Ref moments shared between metrics
     if(m_NumberOfThreadsUsed > 0) { m_ProcSSIM.initThreadPool(m_ThreadPool, PictureHeight + 1); }
     m_ProcSSIM.initRowBuffers(PictureHeight);
     if(m_IsEquirectangular) { m_ProcPSNR.initWS(true, PictureWidth, PictureHeight, m_BitDepth, m_LonRangeDeg, m_LatRangeDeg); }
@@ -637,7 +701,9 @@ void xAppQMIV::createProcessors()
     if(m_CalcMetric[m]) 
     {
       m_MetricData[m].initMetric  ((eMetric)m, m_NumFrames);
-      m_MetricData[m].initSuffixes(m_UseMask, isRGB(m_ColorSpaceMetric));
+      const bool IsSSIMBased = (eMetric)m == eMetric::SSIM || (eMetric)m == eMetric::MSSSIM || (eMetric)m == eMetric::IVSSIM;
+      const bool IsNativeChr = m_UseNativeChroma && ((eMetric)m == eMetric::SSIM || (eMetric)m == eMetric::MSSSIM || (eMetric)m == eMetric::FASTSSIM); //PSNR and WS-PSNR are not affected by chroma resolution
+      m_MetricData[m].initSuffixes(m_UseMask, isRGB(m_ColorSpaceMetric), IsSSIMBased ? m_SSIMSampleStep : 1, IsNativeChr);
       m_MetricData[m].initCmpWeightsAverage(m_CmpWeightsAverage);
     }
   }
@@ -645,6 +711,7 @@ void xAppQMIV::createProcessors()
   if(m_PrintDebug)
   {
     if(m_CalcPSNRs) { m_ProcPSNR.setDebugCallbackQAP([this](flt64 R2T, flt64 T2R) { m_LastR2T = R2T; m_LastT2R = T2R; }); }
+    if(m_CalcPSNRs) { m_ProcPSNR.setDebugCallbackSKP([this](int32 NumSkipped) { m_LastSKP = NumSkipped; }); }
     if(m_CalcSSIMs) { m_ProcSSIM.setDebugCallbackQAP([this](flt64 R2T, flt64 T2R) { m_LastR2T = R2T; m_LastT2R = T2R; }); }
   }
 }
@@ -687,20 +754,23 @@ eRes xAppQMIV::processAllFrames()
     uint64 T2 = m_GatherTime ? xTSC() : 0;
 
     preprocessFrames(f); //preprocessing
+    if(m_CalcSSIMs) { m_ProcSSIM.invalidateMomentCache(); } //new content of input pictures
 
     uint64 T3 = m_GatherTime ? xTSC() : 0;
     
     if(m_CalcGCD)
     {
-      if(m_UseMask) { m_GCD_R2T = m_ProcGCD.CalcGlobalColorDiffM(&m_PicInP[0], &m_PicInP[1], &m_PicInP[2], m_NumNonMasked); }
-      else          { m_GCD_R2T = m_ProcGCD.CalcGlobalColorDiff (&m_PicInP[0], &m_PicInP[1]                              ); }
+      if     (m_UsePicMsk   ) { m_GCD_R2T = m_ProcGCD.CalcGlobalColorDiffM(&m_PicInP[0], &m_PicInP[1], &m_PicMsk                    ); }
+      else if(m_UseMask     ) { m_GCD_R2T = m_ProcGCD.CalcGlobalColorDiffM(&m_PicInP[0], &m_PicInP[1], &m_PicInP[2], m_NumNonMasked); }
+      else if(m_UseDiffStats) { m_GCD_R2T = m_ProcGCD.CalcGlobalColorDiff (&m_DiffStats                                           ); }
+      else                    { m_GCD_R2T = m_ProcGCD.CalcGlobalColorDiff (&m_PicInP[0], &m_PicInP[1]                              ); }
       if(m_PrintDebug) { fmt::print("GCD-R2T {} {} {} {}    ", m_GCD_R2T[0], m_GCD_R2T[1], m_GCD_R2T[2], m_GCD_R2T[3]); }
     }
     if(m_PrintDebug) { fmt::print("\n"); }
 
     uint64 T4 = m_GatherTime ? xTSC() : 0;
 
-    if(m_CalcSCP) { m_ProcSCP.GenShftCompPics(&m_PicSCP[1], &m_PicSCP[0], &m_PicInP[1], &m_PicInP[0], m_GCD_R2T); }
+    if(m_CalcSCP && !m_ShareSCP && !m_UseStreamSCP) { m_ProcSCP.GenShftCompPics(&m_PicSCP[1], &m_PicSCP[0], &m_PicInP[1], &m_PicInP[0], m_GCD_R2T); }
 
     uint64 T5 = m_GatherTime ? xTSC() : 0;
 
@@ -728,6 +798,14 @@ eRes xAppQMIV::processAllFrames()
 
     uint64 T11 = m_GatherTime ? xTSC() : 0;
 
+    if(getCalcMetric(eMetric::FASTSSIM)) { calcFrameFASTSSIM(f); }
+
+    uint64 T12 = m_GatherTime ? xTSC() : 0;
+
+    if(getCalcMetric(eMetric:: IVFSSIM)) { calcFrame_IVFSSIM(f); }
+
+    uint64 T13 = m_GatherTime ? xTSC() : 0;
+
     if(m_GatherTime)
     {
       m_Ticks____Load += (T1 - T0);
@@ -741,6 +819,8 @@ eRes xAppQMIV::processAllFrames()
       m_MetricData[(int32)eMetric::    SSIM].addTicks(T9  - T8 );
       m_MetricData[(int32)eMetric::  MSSSIM].addTicks(T10 - T9 );
       m_MetricData[(int32)eMetric::  IVSSIM].addTicks(T11 - T10);
+      m_MetricData[(int32)eMetric::FASTSSIM].addTicks(T12 - T11);
+      m_MetricData[(int32)eMetric:: IVFSSIM].addTicks(T13 - T12);
     }
   } //end of loop over frames
 
@@ -770,9 +850,17 @@ eRes xAppQMIV::validateFrames(int32 /**/)
 }
 void xAppQMIV::preprocessFrames(int32 /**/)
 {
-  for(int32 CmpIdx = 0; CmpIdx < m_PicInP[0].getNumCmps(); CmpIdx++)
+  if(m_UseDiffStats) //single pass producing exactness flags together with SD and SSD
   {
-    m_ExactCmps[CmpIdx] = m_PicInP[0].equalCmp(&m_PicInP[1], (eCmp)CmpIdx);
+    m_DiffStats.calcPicDiffStats(&m_PicInP[0], &m_PicInP[1]);
+    for(int32 CmpIdx = 0; CmpIdx < m_PicInP[0].getNumCmps(); CmpIdx++) { m_ExactCmps[CmpIdx] = m_DiffStats.isExact((eCmp)CmpIdx); }
+  }
+  else
+  {
+    for(int32 CmpIdx = 0; CmpIdx < m_PicInP[0].getNumCmps(); CmpIdx++)
+    {
+      m_ExactCmps[CmpIdx] = m_PicInP[0].equalCmp(&m_PicInP[1], (eCmp)CmpIdx);
+    }
   }
 
   if(m_CvtYCbCr2RGB)
@@ -824,21 +912,25 @@ void xAppQMIV::preprocessFrames(int32 /**/)
 
   if(m_UseMask)
   {
-    m_NumNonMasked = xPixelOps::CountNonZero(m_PicInP[2].getAddr(eCmp::LM), m_PicInP[2].getStride(), m_PicInP[2].getWidth(), m_PicInP[2].getHeight());
+    //compact mask (1 bit or 8 bits per pel), falls back to planar mask for non-binary masks with BitDepthM > 8
+    m_UsePicMsk    = m_PicMsk.pack(&m_PicInP[2]);
+    m_NumNonMasked = m_UsePicMsk ? m_PicMsk.getNumNonZero() : xPixelOps::CountNonZero(m_PicInP[2].getAddr(eCmp::LM), m_PicInP[2].getStride(), m_PicInP[2].getWidth(), m_PicInP[2].getHeight());
     if(m_PrintDebug) { fmt::print("NNM {}    ", m_NumNonMasked); }
   }  
 }
 void xAppQMIV::calcFrame____PSNR(int32 FrameIdx)
 {
   flt64V4 PSNR  = xMakeVec4(0.0  );
-  if(m_UseMask) { PSNR = m_ProcPSNR.calcPicPSNRM(&m_PicInP[0], &m_PicInP[1], &m_PicInP[2], m_NumNonMasked); }
-  else          { PSNR = m_ProcPSNR.calcPicPSNR (&m_PicInP[0], &m_PicInP[1]                              ); }
+  if     (m_UsePicMsk   ) { PSNR = m_ProcPSNR.calcPicPSNRM(&m_PicInP[0], &m_PicInP[1], &m_PicMsk                    ); }
+  else if(m_UseMask     ) { PSNR = m_ProcPSNR.calcPicPSNRM(&m_PicInP[0], &m_PicInP[1], &m_PicInP[2], m_NumNonMasked); }
+  else if(m_UseDiffStats) { PSNR = m_ProcPSNR.calcPicPSNR (&m_DiffStats                                           ); }
+  else                    { PSNR = m_ProcPSNR.calcPicPSNR (&m_PicInP[0], &m_PicInP[1]                              ); }
 
   for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++)
   { 
     if(m_ExactCmps[CmpIdx])
     {
-      PSNR[CmpIdx] = m_ProcPSNR.getFakePSNR(m_PicInP[0].getArea(), m_PicInP[0].getBitDepth());
+      PSNR[CmpIdx] = m_ProcPSNR.getFakePSNR(m_PicInP[0].getArea((eCmp)CmpIdx), m_PicInP[0].getBitDepth());
       m_MetricData[(int32)eMetric::PSNR].setAnyFake(true);
     }
   }
@@ -858,14 +950,16 @@ void xAppQMIV::calcFrame__WSPSNR(int32 FrameIdx)
 {
   flt64V4 WSPSNR = xMakeVec4(0.0  );
 
-  if(m_UseMask) { WSPSNR = m_ProcPSNR.calcPicWSPSNRM(&m_PicInP[0], &m_PicInP[1], &m_PicInP[2], m_NumNonMasked); }
-  else          { WSPSNR = m_ProcPSNR.calcPicWSPSNR (&m_PicInP[0], &m_PicInP[1]                              ); }
+  if     (m_UsePicMsk   ) { WSPSNR = m_ProcPSNR.calcPicWSPSNRM(&m_PicInP[0], &m_PicInP[1], &m_PicMsk                    ); }
+  else if(m_UseMask     ) { WSPSNR = m_ProcPSNR.calcPicWSPSNRM(&m_PicInP[0], &m_PicInP[1], &m_PicInP[2], m_NumNonMasked); }
+  else if(m_UseDiffStats) { WSPSNR = m_ProcPSNR.calcPicWSPSNR (&m_DiffStats                                           ); }
+  else                    { WSPSNR = m_ProcPSNR.calcPicWSPSNR (&m_PicInP[0], &m_PicInP[1]                              ); }
 
   for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++)
   {
     if(m_ExactCmps[CmpIdx])
     {
-      WSPSNR[CmpIdx] = m_ProcPSNR.getFakePSNR(m_PicInP[0].getArea(), m_PicInP[0].getBitDepth());
+      WSPSNR[CmpIdx] = m_ProcPSNR.getFakePSNR(m_PicInP[0].getArea((eCmp)CmpIdx), m_PicInP[0].getBitDepth());
       m_MetricData[(int32)eMetric::WSPSNR].setAnyFake(true);
     }
   }
@@ -883,15 +977,18 @@ void xAppQMIV::calcFrame__WSPSNR(int32 FrameIdx)
 }
 void xAppQMIV::calcFrame__IVPSNR(int32 FrameIdx)
 {
-  flt64 IVPSNR = 0.0;
+  flt64  IVPSNR      = 0.0;
+  xPicP* ShftCompTst = m_ShareSCP ? &m_PicSCP[0] : nullptr;
+  xPicP* ShftCompRef = m_ShareSCP ? &m_PicSCP[1] : nullptr;
   if(m_UseMask)
   {
-    IVPSNR = m_ProcPSNR.calcPicIVPSNRM(&m_PicInI[0], &m_PicInI[1], &m_PicInP[2], m_NumNonMasked, m_GCD_R2T);
+    if(m_UsePicMsk) { IVPSNR = m_ProcPSNR.calcPicIVPSNRM(&m_PicInI[0], &m_PicInI[1], &m_PicMsk    ,                 m_GCD_R2T, ShftCompTst, ShftCompRef); }
+    else            { IVPSNR = m_ProcPSNR.calcPicIVPSNRM(&m_PicInI[0], &m_PicInI[1], &m_PicInP[2], m_NumNonMasked, m_GCD_R2T, ShftCompTst, ShftCompRef); }
   }
   else
   {
-    if  (m_InterleavedPic) { IVPSNR = m_ProcPSNR.calcPicIVPSNR(&m_PicInI[0], &m_PicInI[1], m_GCD_R2T); }
-    else                   { IVPSNR = m_ProcPSNR.calcPicIVPSNR(&m_PicInP[0], &m_PicInP[1], m_GCD_R2T); }
+    if  (m_InterleavedPic) { IVPSNR = m_ProcPSNR.calcPicIVPSNR(&m_PicInI[0], &m_PicInI[1], m_GCD_R2T, ShftCompTst, ShftCompRef); }
+    else                   { IVPSNR = m_ProcPSNR.calcPicIVPSNR(&m_PicInP[0], &m_PicInP[1], m_GCD_R2T, ShftCompTst, ShftCompRef); }
   }
   m_MetricData[(int32)eMetric::IVPSNR].setPerPicMeric(IVPSNR, FrameIdx);
 
@@ -899,6 +996,7 @@ void xAppQMIV::calcFrame__IVPSNR(int32 FrameIdx)
   {
     std::string Log = fmt::format("Frame {:08d} ", FrameIdx) + m_MetricData[(int32)eMetric::IVPSNR].formatPerPicMetric(FrameIdx);
     if(m_PrintDebug) { Log += fmt::format("    R2T {:7.4f}  T2R {:7.4f}", m_LastR2T, m_LastT2R); }
+    if(m_PrintDebug && !m_UseMask) { Log += fmt::format("  SKP {}", m_LastSKP); }
     fmt::print(Log + "\n");
   }
 }
@@ -907,6 +1005,14 @@ void xAppQMIV::calcFrame____SSIM(int32 FrameIdx)
   flt64V4 SSIM = m_ProcSSIM.calcPicSSIM(&m_PicInP[0], &m_PicInP[1]);
   m_MetricData[(int32)eMetric::SSIM].setPerCmpMeric(SSIM, FrameIdx);
 
+  if(m_CheckSSIMPrec)
+  {
+    m_ProcSSIM.setPrecision(64);
+    flt64V4 SSIM64 = m_ProcSSIM.calcPicSSIM(&m_PicInP[0], &m_PicInP[1]);
+    m_ProcSSIM.setPrecision(m_SSIMPrecision);
+    m_MaxPrecDeviation[(int32)eMetric::SSIM] = xMax(m_MaxPrecDeviation[(int32)eMetric::SSIM], (SSIM - SSIM64).getMaxAbs());
+  }
+
   if(m_PrintFrame)
   { 
     fmt::print("Frame {:08d} {}\n", FrameIdx, m_MetricData[(int32)eMetric::SSIM].formatPerCmpMetric(FrameIdx));
@@ -918,14 +1024,32 @@ void xAppQMIV::calcFrame__MSSSIM(int32 FrameIdx)
   flt64V4 MSSSIM = m_ProcSSIM.calcPicMSSSIM(&m_PicInP[0], &m_PicInP[1]);
   m_MetricData[(int32)eMetric::MSSSIM].setPerCmpMeric(MSSSIM, FrameIdx);
 
+  if(m_CheckSSIMPrec)
+  {
+    m_ProcSSIM.setPrecision(64);
+    flt64V4 MSSSIM64 = m_ProcSSIM.calcPicMSSSIM(&m_PicInP[0], &m_PicInP[1]);
+    m_ProcSSIM.setPrecision(m_SSIMPrecision);
+    m_MaxPrecDeviation[(int32)eMetric::MSSSIM] = xMax(m_MaxPrecDeviation[(int32)eMetric::MSSSIM], (MSSSIM - MSSSIM64).getMaxAbs());
+  }
+
   fmt::print("Frame {:08d} {}\n", FrameIdx, m_MetricData[(int32)eMetric::MSSSIM].formatPerCmpMetric(FrameIdx));
   fmt::print("Frame {:08d} {}\n", FrameIdx, m_MetricData[(int32)eMetric::MSSSIM].formatPerPicMetric(FrameIdx));
 }
 void xAppQMIV::calcFrame__IVSSIM(int32 FrameIdx)
 {
-  flt64 IVSSIM = m_ProcSSIM.calcPicIVSSIM(&m_PicInP[0], &m_PicInP[1], &m_PicSCP[0], &m_PicSCP[1]);
+  flt64 IVSSIM64 = 0;
+  if(m_CheckSSIMPrec) //calculated first, so R2T and T2R debug data comes from regular calculation
+  {
+    m_ProcSSIM.setPrecision(64);
+    IVSSIM64 = m_UseStreamSCP ? m_ProcSSIM.calcPicIVSSIMStreamed(&m_PicInP[0], &m_PicInP[1], m_GCD_R2T) : m_ProcSSIM.calcPicIVSSIM(&m_PicInP[0], &m_PicInP[1], &m_PicSCP[0], &m_PicSCP[1]);
+    m_ProcSSIM.setPrecision(m_SSIMPrecision);
+  }
+
+  flt64 IVSSIM = m_UseStreamSCP ? m_ProcSSIM.calcPicIVSSIMStreamed(&m_PicInP[0], &m_PicInP[1], m_GCD_R2T) : m_ProcSSIM.calcPicIVSSIM(&m_PicInP[0], &m_PicInP[1], &m_PicSCP[0], &m_PicSCP[1]);
   m_MetricData[(int32)eMetric::IVSSIM].setPerPicMeric(IVSSIM, FrameIdx);
 
+  if(m_CheckSSIMPrec) { m_MaxPrecDeviation[(int32)eMetric::IVSSIM] = xMax(m_MaxPrecDeviation[(int32)eMetric::IVSSIM], xAbs(IVSSIM - IVSSIM64)); }
+
   if(m_PrintFrame)
   {
     std::string Log = fmt::format("Frame {:08d} ", FrameIdx) + m_MetricData[(int32)eMetric::IVSSIM].formatPerPicMetric(FrameIdx);
@@ -934,6 +1058,30 @@ void xAppQMIV::calcFrame__IVSSIM(int32 FrameIdx)
   }
 }
 
+void xAppQMIV::calcFrameFASTSSIM(int32 FrameIdx)
+{
+  flt64V4 FASTSSIM = m_ProcSSIM.calcPicFastSSIM(&m_PicInP[0], &m_PicInP[1]);
+  m_MetricData[(int32)eMetric::FASTSSIM].setPerCmpMeric(FASTSSIM, FrameIdx);
+
+  if(m_PrintFrame)
+  { 
+    fmt::print("Frame {:08d} {}\n", FrameIdx, m_MetricData[(int32)eMetric::FASTSSIM].formatPerCmpMetric(FrameIdx));
+    fmt::print("Frame {:08d} {}\n", FrameIdx, m_MetricData[(int32)eMetric::FASTSSIM].formatPerPicMetric(FrameIdx));
+  }
+}
+void xAppQMIV::calcFrame_IVFSSIM(int32 FrameIdx)
+{
+  flt64 IVFSSIM = m_ProcSSIM.calcPicIVFastSSIM(&m_PicInP[0], &m_PicInP[1], &m_PicSCP[0], &m_PicSCP[1]);
+  m_MetricData[(int32)eMetric::IVFSSIM].setPerPicMeric(IVFSSIM, FrameIdx);
+
+  if(m_PrintFrame)
+  {
+    std::string Log = fmt::format("Frame {:08d} ", FrameIdx) + m_MetricData[(int32)eMetric::IVFSSIM].formatPerPicMetric(FrameIdx);
+    if(m_PrintDebug) { Log += fmt::format("    R2T {:7.4f}  T2R {:7.4f}", m_LastR2T, m_LastT2R); }
+    fmt::print(Log + "\n");
+  }
+}
+
 //---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
 std::string xAppQMIV::calibrateTimeStamp()
@@ -992,6 +1140,15 @@ std::string xAppQMIV::formatResultsStdOut()
     if(MD.getEnabled()) { Result += MD.formatAvgMetric("Average      ") + "\n"; }
   }
 
+  if(m_CheckSSIMPrec)
+  {
+    Result += "\n";
+    for(int32 m = (int32)eMetric::SSIM; m <= (int32)eMetric::IVSSIM; m++)
+    {
+      if(getCalcMetric((eMetric)m)) { Result += fmt::format("MaxDeviation {:>8} flt32 vs flt64 {:.3e}\n", xMetricToStr((eMetric)m), m_MaxPrecDeviation[m]); }
+    }
+  }
+
   if(m_GatherTime)
   {
     tDurationMS AvgDuration____Load = tDurationMS((flt64)m_Ticks____Load * m_InvDurationDenominator);
@@ -1005,7 +1162,7 @@ std::string xAppQMIV::formatResultsStdOut()
     Result += fmt::format("AvgTime      VALIDATE {:9.2f} ms\n", AvgDurationValidate.count());
     Result += fmt::format("AvgTime       PREPROC {:9.2f} ms\n", AvgDuration_Preproc.count());
     if(m_CalcGCD) { Result += fmt::format("AvgTime           GCD {:9.2f} ms\n", AvgDuration_____GCD.count()); }
-    if(m_CalcSCP) { Result += fmt::format("AvgTime           SCP {:9.2f} ms\n", AvgDuration_____SCP.count()); }
+    if(m_CalcSCP && !m_UseStreamSCP) { Result += fmt::format("AvgTime           SCP {:9.2f} ms\n", AvgDuration_____SCP.count()); }
 
     for(int32 m = 0; m < c_MetricsNum; m++)
     {
@@ -1021,6 +1178,8 @@ std::string xAppQMIV::formatResultsStdOut()
           case eMetric::    SSIM: break;
           case eMetric::  MSSSIM: break;
           case eMetric::  IVSSIM: PreMetricOps += AvgDuration_____GCD + AvgDuration_____SCP; break;
+          case eMetric::FASTSSIM: break;
+          case eMetric:: IVFSSIM: PreMetricOps += AvgDuration_____GCD + AvgDuration_____SCP; break;
           default: break;
         }
 
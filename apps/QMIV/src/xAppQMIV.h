@@ -127,6 +127,9 @@ enum class eMetric : int32 //values must start from 0 and be continous
       SSIM,
     MSSSIM,
     IVSSIM,
+  //SSIM - based with box window (fast approximation)
+  FASTSSIM,
+   IVFSSIM,
   //must be after last metric
   __NUM  
 };
@@ -140,6 +143,8 @@ static inline eMetric xStrToMetric(const std::string_view Metric)
          MetricU ==     "SSIM" ? eMetric::    SSIM :
          MetricU ==   "MSSSIM" ? eMetric::  MSSSIM :
          MetricU ==   "IVSSIM" ? eMetric::  IVSSIM :
+         MetricU == "FASTSSIM" ? eMetric::FASTSSIM :
+         MetricU ==  "IVFSSIM" ? eMetric:: IVFSSIM :
                                  eMetric::UNDEFINED;
 }
 static inline std::string xMetricToStr(eMetric Metric)
@@ -150,6 +155,8 @@ static inline std::string xMetricToStr(eMetric Metric)
          Metric == eMetric::    SSIM ?     "SSIM" :
          Metric == eMetric::  MSSSIM ?   "MSSSIM" :
          Metric == eMetric::  IVSSIM ?   "IVSSIM" :
+         Metric == eMetric::FASTSSIM ? "FASTSSIM" :
+         Metric == eMetric:: IVFSSIM ?  "IVFSSIM" :
                                        "UNDEFINED";
 }
 
@@ -158,11 +165,11 @@ struct xMetricInfo
   static constexpr int32 MetricsNum       = (int32)eMetric::__NUM;
   static constexpr int32 MaxMetricNameLen = 8;
 
-                                                          //     PSNR   WSPSNR IVPSNR SSIM   MSSSIM IVSSIM 
-  static constexpr bool             IsPerCmp    [MetricsNum] = { true , true , false, true , true , false  };
-  static constexpr bool             IsPerPic    [MetricsNum] = { false, false, true , false, false, true   };
-  static constexpr bool             IsNormalized[MetricsNum] = { false, false, false, true , true , true   };
-  static constexpr std::string_view Unit        [MetricsNum] = { "dB" , "dB" , "dB" , "  " , "  " , "  "   };
+                                                          //     PSNR   WSPSNR IVPSNR SSIM   MSSSIM IVSSIM FASTSSIM IVFSSIM
+  static constexpr bool             IsPerCmp    [MetricsNum] = { true , true , false, true , true , false, true , false  };
+  static constexpr bool             IsPerPic    [MetricsNum] = { false, false, true , false, false, true , false, true   };
+  static constexpr bool             IsNormalized[MetricsNum] = { false, false, false, true , true , true , true , true   };
+  static constexpr std::string_view Unit        [MetricsNum] = { "dB" , "dB" , "dB" , "  " , "  " , "  " , "  " , "  "   };
   static constexpr std::string_view Description [MetricsNum] =
   {
     "Peak Signal-to-Noise Ratio",
@@ -171,6 +178,8 @@ struct xMetricInfo
     "Structural Similarity Index Measure",
     "Multi Scale Structural Similarity Index Measure",
     "Immersive Video - Structural Similarity Index Measure",
+    "Fast Structural Similarity Index Measure (box window)",
+    "Immersive Video - Fast Structural Similarity Index Measure (box window)",
   };
 };
 
@@ -212,8 +221,17 @@ public:
     m_AnyFake  = false;
     m_Enabled  = true;
   }
-  void initSuffixes(bool UseMask, bool UseRGB)
+  void initSuffixes(bool UseMask, bool UseRGB, int32 SampleStep = 1, bool NativeChroma = false)
   {
+    if(SampleStep > 1 || NativeChroma) //strided SSIM-based metrics or chroma evaluated in native resolution (never combined with mask mode)
+    {
+      bool IsPerPic = xMetricInfo::IsPerPic[(int32)m_Metric];
+      std::string Tag = (SampleStep > 1 ? fmt::format("-S{}", SampleStep) : "") + (NativeChroma ? "-NC" : "");
+      m_SuffixCmp = fmt::format("{:<10}", fmt::format("{} {}", Tag, UseRGB ? "R:G:B" : "Y:Cb:Cr"));
+      m_SuffixPic = fmt::format("{:<10}", fmt::format("{}{}" , Tag, UseRGB ? "-RGB" : IsPerPic ? "" : "-YCbCr"));
+      return;
+    }
+
     if     (UseMask && UseRGB) { m_SuffixCmp = "-M R:G:B  "; }
     else if(UseMask          ) { m_SuffixCmp = "-M Y:Cb:Cr"; }
     else if(UseRGB           ) { m_SuffixCmp = " R:G:B    "; }
@@ -377,6 +395,13 @@ public:
   //operation
   int32       m_NumberOfThreads;
   bool        m_InterleavedPic;
+  bool        m_SharedCostVolume;
+  bool        m_StreamSCP;
+  int32       m_SSIMPrecision;
+  bool        m_SSIMPrecCheck;
+  int32       m_SSIMSampleStep;
+  int32       m_FastSSIMWindow;
+  bool        m_NativeChroma;
   int32       m_VerboseLevel;
   //derrived
   bool        m_UseMask;
@@ -391,6 +416,12 @@ public:
   bool        m_CalcIVs;
   bool        m_CalcGCD;
   bool        m_CalcSCP;
+  bool        m_ShareSCP; //SCP generated by IVPSNR search
+  bool        m_UseStreamSCP; //SCP rows generated by IVSSIM band tasks (no SCP pictures)
+  bool        m_CheckSSIMPrec; //SSIM-based metrics are calculated in flt32 and flt64 for comparison
+  bool        m_UseNativeChroma; //input pictures keep chroma planes in native (subsampled) resolution
+  bool        m_UseDiffStats; //exactness, GCD, PSNR and WS-PSNR share single pass over Tst and Ref
+  eCrF        m_PicChromaFormat; //chroma format of input picture buffers (CF444 = chroma upsampled to luma resolution)
   int32       m_PicMargin;
   int32       m_WindowSize;
   bool        m_PrintFrame;
@@ -413,8 +444,10 @@ protected:
   std::array<xPicP    , NumInputsMax> m_PicInP ; //0=Tst,1=Ref,2=Msk
   std::array<xPicI    , NumInputsSeq> m_PicInI ; //0=Tst,1=Ref
   std::array<xPicP    , NumInputsSeq> m_PicSCP ; //0=Tst,1=Ref
+  xPicMask                            m_PicMsk ; //compact representation of Msk
 
   //processors
+  xDiffStats       m_DiffStats;
   xGlobClrDiffProc m_ProcGCD;
   xShftCompPicProc m_ProcSCP;
   xIVPSNRM         m_ProcPSNR;
@@ -423,15 +456,18 @@ protected:
   //intermediates
   boolV4  m_ExactCmps    = xMakeVec4<bool>(false);
   int32   m_NumNonMasked = 0;
+  bool    m_UsePicMsk    = false; //current mask was packed into m_PicMsk
   int32V4 m_GCD_R2T;
 
   //debug data
   flt64   m_LastR2T = 0;
   flt64   m_LastT2R = 0;
+  int32   m_LastSKP = 0; //number of pixels skipped by IV search (within equal tiles)
   
 
   //merics data & stats
   std::array<xMetricStat, c_MetricsNum> m_MetricData;
+  std::array<flt64      , c_MetricsNum> m_MaxPrecDeviation = { 0 }; //max per frame deviation of flt32 against flt64 (SSIM-based metrics only)
 
   tTimePoint m_ProcBegTime  = tTimePoint::min();
   tTimePoint m_ProcEndTime  = tTimePoint::min();
@@ -475,6 +511,8 @@ public:
   void        calcFrame____SSIM(int32 FrameIdx);
   void        calcFrame__MSSSIM(int32 FrameIdx);
   void        calcFrame__IVSSIM(int32 FrameIdx);
+  void        calcFrameFASTSSIM(int32 FrameIdx);
+  void        calcFrame_IVFSSIM(int32 FrameIdx);
 
   std::string calibrateTimeStamp();
   void        combineFrameStats ();
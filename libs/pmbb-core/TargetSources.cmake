@@ -10,8 +10,8 @@ set(SRCLIST_PIXOPS_C                                     src/xPixelOpsSTD.cpp sr
 set(SRCLIST_CLR_H src/xColorSpaceCoeff.h   src/xColorSpace.h   src/xColorSpaceSTD.h   src/xColorSpaceSSE.h   src/xColorSpaceAVX.h   src/xColorSpaceAVX512.h  )
 set(SRCLIST_CLR_C src/xColorSpaceCoeff.cpp src/xColorSpace.cpp src/xColorSpaceSTD.cpp src/xColorSpaceSSE.cpp src/xColorSpaceAVX.cpp src/xColorSpaceAVX512.cpp)
 
-set(SRCLIST_PIC_H src/xPicCommon.h   src/xPic.h   src/xPlane.h  )
-set(SRCLIST_PIC_C src/xPicCommon.cpp src/xPic.cpp src/xPlane.cpp)
+set(SRCLIST_PIC_H src/xPicCommon.h   src/xPic.h   src/xPlane.h   src/xPicMask.h  )
+set(SRCLIST_PIC_C src/xPicCommon.cpp src/xPic.cpp src/xPlane.cpp src/xPicMask.cpp)
 
 set(SRCLIST_THREAD_H src/xEvent.h src/xQueue.h src/xThreadPool.h  )
 set(SRCLIST_THREAD_C                           src/xThreadPool.cpp)
@@ -51,6 +51,16 @@ public:
   static inline uint32 CalcSAD(const uint16* Tst, const uint16* Ref, int32 TstStride, int32 RefStride, int32 Width, int32 Height) { return xDistortionAVX512::CalcSAD(Tst, Ref, TstStride, RefStride, Width,  Height); }
   static inline uint64 CalcSSD(const uint16* Tst, const uint16* Ref,                                   int32 Area               ) { return xDistortionAVX512::CalcSSD(Tst, Ref,                       Area          ); }
   static inline uint64 CalcSSD(const uint16* Tst, const uint16* Ref, int32 TstStride, int32 RefStride, int32 Width, int32 Height) { return xDistortionAVX512::CalcSSD(Tst, Ref, TstStride, RefStride, Width,  Height); }
+  static inline std::tuple<int32, uint64> CalcSDSSD(const uint16* Tst, const uint16* Ref, int32 Area) { return xDistortionAVX512::CalcSDSSD(Tst, Ref, Area); }
+
+  static inline  int64 CalcWeightedSD (const uint16* Tst, const uint16* Ref, const uint16* Mask,                                                    int32 Area               ) { return xDistortionAVX512::CalcWeightedSD (Tst, Ref, Mask,                            Area          ); }
+  static inline  int64 CalcWeightedSD (const uint16* Tst, const uint16* Ref, const uint16* Mask, int32 TstStride, int32 RefStride, int32 MskStride, int32 Width, int32 Height) { return xDistortionAVX512::CalcWeightedSD (Tst, Ref, Mask, TstStride, RefStride, MskStride, Width,  Height); }
+  static inline uint64 CalcWeightedSSD(const uint16* Tst, const uint16* Ref, const uint16* Mask,                                                    int32 Area               ) { return xDistortionAVX512::CalcWeightedSSD(Tst, Ref, Mask,                            Area          ); }
+  static inline uint64 CalcWeightedSSD(const uint16* Tst, const uint16* Ref, const uint16* Mask, int32 TstStride, int32 RefStride, int32 MskStride, int32 Width, int32 Height) { return xDistortionAVX512::CalcWeightedSSD(Tst, Ref, Mask, TstStride, RefStride, MskStride, Width,  Height); }
+  static inline  int64 CalcWeightedSD (const uint16* Tst, const uint16* Ref, const uint8*  Mask    , int32 Area) { return xDistortionAVX512::CalcWeightedSD (Tst, Ref, Mask    , Area); }
+  static inline uint64 CalcWeightedSSD(const uint16* Tst, const uint16* Ref, const uint8*  Mask    , int32 Area) { return xDistortionAVX512::CalcWeightedSSD(Tst, Ref, Mask    , Area); }
+  static inline  int64 CalcMaskedSD   (const uint16* Tst, const uint16* Ref, const uint64* MaskBits, int32 Area) { return xDistortionAVX512::CalcMaskedSD   (Tst, Ref, MaskBits, Area); }
+  static inline uint64 CalcMaskedSSD  (const uint16* Tst, const uint16* Ref, const uint64* MaskBits, int32 Area) { return xDistortionAVX512::CalcMaskedSSD  (Tst, Ref, MaskBits, Area); }
 
 #elif X_CAN_USE_AVX
 
@@ -60,6 +70,16 @@ public:
   static inline uint32 CalcSAD(const uint16* Tst, const uint16* Ref, int32 TstStride, int32 RefStride, int32 Width, int32 Height) { return xDistortionAVX::CalcSAD(Tst, Ref, TstStride, RefStride, Width,  Height); }
   static inline uint64 CalcSSD(const uint16* Tst, const uint16* Ref,                                   int32 Area               ) { return xDistortionAVX::CalcSSD(Tst, Ref,                       Area          ); }
   static inline uint64 CalcSSD(const uint16* Tst, const uint16* Ref, int32 TstStride, int32 RefStride, int32 Width, int32 Height) { return xDistortionAVX::CalcSSD(Tst, Ref, TstStride, RefStride, Width,  Height); }
+  static inline std::tuple<int32, uint64> CalcSDSSD(const uint16* Tst, const uint16* Ref, int32 Area) { return xDistortionAVX::CalcSDSSD(Tst, Ref, Area); }
+
+  static inline  int64 CalcWeightedSD (const uint16* Tst, const uint16* Ref, const uint16* Mask,                                                    int32 Area               ) { return xDistortionAVX::CalcWeightedSD (Tst, Ref, Mask,                            Area          ); }
+  static inline  int64 CalcWeightedSD (const uint16* Tst, const uint16* Ref, const uint16* Mask, int32 TstStride, int32 RefStride, int32 MskStride, int32 Width, int32 Height) { return xDistortionAVX::CalcWeightedSD (Tst, Ref, Mask, TstStride, RefStride, MskStride, Width,  Height); }
+  static inline uint64 CalcWeightedSSD(const uint16* Tst, const uint16* Ref, const uint16* Mask,                                                    int32 Area               ) { return xDistortionAVX::CalcWeightedSSD(Tst, Ref, Mask,                            Area          ); }
+  static inline uint64 CalcWeightedSSD(const uint16* Tst, const uint16* Ref, const uint16* Mask, int32 TstStride, int32 RefStride, int32 MskStride, int32 Width, int32 Height) { return xDistortionAVX::CalcWeightedSSD(Tst, Ref, Mask, TstStride, RefStride, MskStride, Width,  Height); }
+  static inline  int64 CalcWeightedSD (const uint16* Tst, const uint16* Ref, const uint8*  Mask    , int32 Area) { return xDistortionAVX::CalcWeightedSD (Tst, Ref, Mask    , Area); }
+  static inline uint64 CalcWeightedSSD(const uint16* Tst, const uint16* Ref, const uint8*  Mask    , int32 Area) { return xDistortionAVX::CalcWeightedSSD(Tst, Ref, Mask    , Area); }
+  static inline  int64 CalcMaskedSD   (const uint16* Tst, const uint16* Ref, const uint64* MaskBits, int32 Area) { return xDistortionAVX::CalcMaskedSD   (Tst, Ref, MaskBits, Area); }
+  static inline uint64 CalcMaskedSSD  (const uint16* Tst, const uint16* Ref, const uint64* MaskBits, int32 Area) { return xDistortionAVX::CalcMaskedSSD  (Tst, Ref, MaskBits, Area); }
 
 #elif X_CAN_USE_SSE
 
@@ -69,6 +89,16 @@ public:
   static inline uint32 CalcSAD(const uint16* Tst, const uint16* Ref, int32 TstStride, int32 RefStride, int32 Width, int32 Height) { return xDistortionSSE::CalcSAD(Tst, Ref, TstStride, RefStride, Width,  Height); }
   static inline uint64 CalcSSD(const uint16* Tst, const uint16* Ref,                                   int32 Area               ) { return xDistortionSSE::CalcSSD(Tst, Ref,                       Area          ); }
   static inline uint64 CalcSSD(const uint16* Tst, const uint16* Ref, int32 TstStride, int32 RefStride, int32 Width, int32 Height) { return xDistortionSSE::CalcSSD(Tst, Ref, TstStride, RefStride, Width,  Height); }
+  static inline std::tuple<int32, uint64> CalcSDSSD(const uint16* Tst, const uint16* Ref, int32 Area) { return xDistortionSSE::CalcSDSSD(Tst, Ref, Area); }
+
+  static inline  int64 CalcWeightedSD (const uint16* Tst, const uint16* Ref, const uint16* Mask,                                                    int32 Area               ) { return xDistortionSSE::CalcWeightedSD (Tst, Ref, Mask,                            Area          ); }
+  static inline  int64 CalcWeightedSD (const uint16* Tst, const uint16* Ref, const uint16* Mask, int32 TstStride, int32 RefStride, int32 MskStride, int32 Width, int32 Height) { return xDistortionSSE::CalcWeightedSD (Tst, Ref, Mask, TstStride, RefStride, MskStride, Width,  Height); }
+  static inline uint64 CalcWeightedSSD(const uint16* Tst, const uint16* Ref, const uint16* Mask,                                                    int32 Area               ) { return xDistortionSSE::CalcWeightedSSD(Tst, Ref, Mask,                            Area          ); }
+  static inline uint64 CalcWeightedSSD(const uint16* Tst, const uint16* Ref, const uint16* Mask, int32 TstStride, int32 RefStride, int32 MskStride, int32 Width, int32 Height) { return xDistortionSSE::CalcWeightedSSD(Tst, Ref, Mask, TstStride, RefStride, MskStride, Width,  Height); }
+  static inline  int64 CalcWeightedSD (const uint16* Tst, const uint16* Ref, const uint8*  Mask    , int32 Area) { return xDistortionSSE::CalcWeightedSD (Tst, Ref, Mask    , Area); }
+  static inline uint64 CalcWeightedSSD(const uint16* Tst, const uint16* Ref, const uint8*  Mask    , int32 Area) { return xDistortionSSE::CalcWeightedSSD(Tst, Ref, Mask    , Area); }
+  static inline  int64 CalcMaskedSD   (const uint16* Tst, const uint16* Ref, const uint64* MaskBits, int32 Area) { return xDistortionSSE::CalcMaskedSD   (Tst, Ref, MaskBits, Area); }
+  static inline uint64 CalcMaskedSSD  (const uint16* Tst, const uint16* Ref, const uint64* MaskBits, int32 Area) { return xDistortionSSE::CalcMaskedSSD  (Tst, Ref, MaskBits, Area); }
 
 #else //X_CAN_USE_???
 
@@ -78,14 +108,18 @@ public:
   static inline uint32 CalcSAD(const uint16* Tst, const uint16* Ref, int32 TstStride, int32 RefStride, int32 Width, int32 Height) { return xDistortionSTD::CalcSAD(Tst, Ref, TstStride, RefStride, Width,  Height); }
   static inline uint64 CalcSSD(const uint16* Tst, const uint16* Ref,                                   int32 Area               ) { return xDistortionSTD::CalcSSD(Tst, Ref,                       Area          ); }
   static inline uint64 CalcSSD(const uint16* Tst, const uint16* Ref, int32 TstStride, int32 RefStride, int32 Width, int32 Height) { return xDistortionSTD::CalcSSD(Tst, Ref, TstStride, RefStride, Width,  Height); }
-
-#endif //X_CAN_USE_???
+  static inline std::tuple<int32, uint64> CalcSDSSD(const uint16* Tst, const uint16* Ref, int32 Area) { return xDistortionSTD::CalcSDSSD(Tst, Ref, Area); }
 
   static inline  int64 CalcWeightedSD (const uint16* Tst, const uint16* Ref, const uint16* Mask,                                                    int32 Area               ) { return xDistortionSTD::CalcWeightedSD (Tst, Ref, Mask,                            Area          ); }
   static inline  int64 CalcWeightedSD (const uint16* Tst, const uint16* Ref, const uint16* Mask, int32 TstStride, int32 RefStride, int32 MskStride, int32 Width, int32 Height) { return xDistortionSTD::CalcWeightedSD (Tst, Ref, Mask, TstStride, RefStride, MskStride, Width,  Height); }
   static inline uint64 CalcWeightedSSD(const uint16* Tst, const uint16* Ref, const uint16* Mask,                                                    int32 Area               ) { return xDistortionSTD::CalcWeightedSSD(Tst, Ref, Mask,                            Area          ); }
   static inline uint64 CalcWeightedSSD(const uint16* Tst, const uint16* Ref, const uint16* Mask, int32 TstStride, int32 RefStride, int32 MskStride, int32 Width, int32 Height) { return xDistortionSTD::CalcWeightedSSD(Tst, Ref, Mask, TstStride, RefStride, MskStride, Width,  Height); }
+  static inline  int64 CalcWeightedSD (const uint16* Tst, const uint16* Ref, const uint8*  Mask    , int32 Area) { return xDistortionSTD::CalcWeightedSD (Tst, Ref, Mask    , Area); }
+  static inline uint64 CalcWeightedSSD(const uint16* Tst, const uint16* Ref, const uint8*  Mask    , int32 Area) { return xDistortionSTD::CalcWeightedSSD(Tst, Ref, Mask    , Area); }
+  static inline  int64 CalcMaskedSD   (const uint16* Tst, const uint16* Ref, const uint64* MaskBits, int32 Area) { return xDistortionSTD::CalcMaskedSD   (Tst, Ref, MaskBits, Area); }
+  static inline uint64 CalcMaskedSSD  (const uint16* Tst, const uint16* Ref, const uint64* MaskBits, int32 Area) { return xDistortionSTD::CalcMaskedSSD  (Tst, Ref, MaskBits, Area); }
 
+#endif //X_CAN_USE_???
 };
 
 //===============================================================================================================================================================================================================
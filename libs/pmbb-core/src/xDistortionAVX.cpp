@@ -342,9 +342,40 @@ uint64 xDistortionAVX::CalcSSD(const uint16* restrict Tst, const uint16* restric
   }
 }
 
+std::tuple<int32, uint64> xDistortionAVX::CalcSDSSD(const uint16* restrict Tst, const uint16* restrict Ref, int32 Area)
+{
+  //up to 14 bit input
+  const int32   Area16   = (int32)((uint32)Area & c_MultipleMask16);
+  const __m256i One_V256 = _mm256_set1_epi16(1);
+  __m256i       SD_V256  = _mm256_setzero_si256();
+  __m256i       SSD_V256 = _mm256_setzero_si256();
+
+  for(int32 i = 0; i < Area16; i += 16)
+  {
+    __m256i Tst_V256  = _mm256_loadu_si256((__m256i*) & Tst[i]);
+    __m256i Ref_V256  = _mm256_loadu_si256((__m256i*) & Ref[i]);
+    __m256i Diff_V256 = _mm256_sub_epi16     (Tst_V256 , Ref_V256);
+    __m256i Sum_V256  = _mm256_madd_epi16    (Diff_V256, One_V256 );
+    __m256i Pow_V256  = _mm256_madd_epi16    (Diff_V256, Diff_V256);
+    __m256i Pow_V256A = _mm256_unpacklo_epi32(Pow_V256 , _mm256_setzero_si256());
+    __m256i Pow_V256B = _mm256_unpackhi_epi32(Pow_V256 , _mm256_setzero_si256());
+    SD_V256           = _mm256_add_epi32     (SD_V256 , Sum_V256);
+    SSD_V256          = _mm256_add_epi64     (SSD_V256, _mm256_add_epi64(Pow_V256A, Pow_V256B));
+  } //i
+  int32  SD  = xHorVecSum_epi32(SD_V256);
+  uint64 SSD = xHorVecSum_epi64(SSD_V256);
+
+  for(int32 i = Area16; i < Area; i++)
+  {
+    const int32 Diff = (int32)Tst[i] - (int32)Ref[i];
+    SD  += Diff;
+    SSD += (uint64)xPow2(Diff);
+  }
+  return { SD, SSD };
+}
 int64 xDistortionAVX::CalcWeightedSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint16* restrict Msk, int32 Area)
 {
-  assert(0); //TODO - NOT TESTED
+  //up to 14 bit input, up to 16 bit mask (Diff*Msk in 32 bits, Diff^2*Msk in 64 bits)
   const int32 Area16 = (int32)((uint32)Area & c_MultipleMask16);
   __m256i SD_V256 = _mm256_setzero_si256();
 
@@ -353,232 +384,213 @@ int64 xDistortionAVX::CalcWeightedSD(const uint16* restrict Tst, const uint16* r
     __m256i Tst_V256   = _mm256_loadu_si256((__m256i*) & Tst[i]);
     __m256i Ref_V256   = _mm256_loadu_si256((__m256i*) & Ref[i]);
     __m256i Msk_V256   = _mm256_loadu_si256((__m256i*) & Msk[i]);
-    __m256i Diff_V256  = _mm256_sub_epi16     (Tst_V256, Ref_V256);
-    __m256i Diff_V256A = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(Diff_V256, 1));
-    __m256i Diff_V256B = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(Diff_V256));
-    Msk_V256           = _mm256_permute4x64_epi64(Msk_V256, 0xD8);
-    __m256i Msk_V256A  = _mm256_unpacklo_epi16(Msk_V256, Msk_V256);
-    __m256i Msk_V256B  = _mm256_unpackhi_epi16(Msk_V256, Msk_V256);
-    __m256i Wght_V256A = _mm256_mullo_epi32   (Diff_V256A, Msk_V256A);
-    __m256i Wght_V256B = _mm256_mullo_epi32   (Diff_V256B, Msk_V256B);
-    __m256i Wght_V256  = _mm256_add_epi32     (Wght_V256A, Wght_V256B);
-    __m256i Sum_V256A  = _mm256_unpacklo_epi32(Wght_V256, _mm256_setzero_si256());
-    __m256i Sum_V256B  = _mm256_unpackhi_epi32(Wght_V256, _mm256_setzero_si256());
-    __m256i Sum_V256   = _mm256_add_epi64     (Sum_V256A, Sum_V256B);
-    SD_V256 = _mm256_add_epi64(SD_V256, Sum_V256);
+    __m256i Diff_V256  = _mm256_sub_epi16(Tst_V256, Ref_V256);
+    __m256i Diff_V256A = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(Diff_V256));
+    __m256i Diff_V256B = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(Diff_V256, 1));
+    __m256i Msk_V256A  = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(Msk_V256));
+    __m256i Msk_V256B  = _mm256_cvtepu16_epi32(_mm256_extracti128_si256(Msk_V256, 1));
+    __m256i Wght_V256A = _mm256_mullo_epi32(Diff_V256A, Msk_V256A);
+    __m256i Wght_V256B = _mm256_mullo_epi32(Diff_V256B, Msk_V256B);
+    __m256i Sum_V256A  = _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(Wght_V256A)), _mm256_cvtepi32_epi64(_mm256_extracti128_si256(Wght_V256A, 1)));
+    __m256i Sum_V256B  = _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(Wght_V256B)), _mm256_cvtepi32_epi64(_mm256_extracti128_si256(Wght_V256B, 1)));
+    SD_V256            = _mm256_add_epi64(SD_V256, _mm256_add_epi64(Sum_V256A, Sum_V256B));
   } //i
-  __m128i SD_V128A = _mm256_extracti128_si256(SD_V256, 1);
-  __m128i SD_V128B = _mm256_castsi256_si128(SD_V256);
-  __m128i SD_V128  = _mm_add_epi64(SD_V128A, SD_V128B);
-  uint64  SD       = _mm_extract_epi64(SD_V128, 0) + _mm_extract_epi64(SD_V128, 1);
+  int64 SD = xHorVecSum_epi64(SD_V256);
 
   for(int32 i = Area16; i < Area; i++) { SD += ((int32)Tst[i] - (int32)Ref[i]) * (int32)Msk[i]; }
   return SD;
 }
 int64 xDistortionAVX::CalcWeightedSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint16* restrict Msk, int32 TstStride, int32 RefStride, int32 MskStride, int32 Width, int32 Height)
 {
-  assert(0); //TODO - NOT TESTED
+  //up to 14 bit input, up to 16 bit mask (Diff*Msk in 32 bits, Diff^2*Msk in 64 bits)
+  const int32 Width16 = (int32)((uint32)Width & c_MultipleMask16);
+  int64 SD = 0;
+  __m256i SD_V256 = _mm256_setzero_si256();
 
-  if(((uint32)Width & c_RemainderMask16)==0) //Width%16==0 - fast path without tail
+  for(int32 y=0; y<Height; y++)
   {
-    __m256i SD_V256 = _mm256_setzero_si256();
-    for(int32 y=0; y<Height; y++)
-    {
-      for(int32 x=0; x<Width; x+=16)
-      {
-        __m256i Tst_V256   = _mm256_loadu_si256((__m256i*) & Tst[x]);
-        __m256i Ref_V256   = _mm256_loadu_si256((__m256i*) & Ref[x]);
-        __m256i Msk_V256   = _mm256_loadu_si256((__m256i*) & Msk[x]);
-        __m256i Diff_V256  = _mm256_sub_epi16     (Tst_V256, Ref_V256);
-        __m256i Diff_V256A = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(Diff_V256, 1));
-        __m256i Diff_V256B = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(Diff_V256));
-        Msk_V256           = _mm256_permute4x64_epi64(Msk_V256, 0xD8);
-        __m256i Msk_V256A  = _mm256_unpacklo_epi16(Msk_V256, Msk_V256);
-        __m256i Msk_V256B  = _mm256_unpackhi_epi16(Msk_V256, Msk_V256);
-        __m256i Wght_V256A = _mm256_mullo_epi32   (Diff_V256A, Msk_V256A);
-        __m256i Wght_V256B = _mm256_mullo_epi32   (Diff_V256B, Msk_V256B);
-        __m256i Wght_V256  = _mm256_add_epi32     (Wght_V256A, Wght_V256B);
-        __m256i Sum_V256A  = _mm256_unpacklo_epi32(Wght_V256, _mm256_setzero_si256());
-        __m256i Sum_V256B  = _mm256_unpackhi_epi32(Wght_V256, _mm256_setzero_si256());
-        __m256i Sum_V256   = _mm256_add_epi64     (Sum_V256A, Sum_V256B);
-        SD_V256 = _mm256_add_epi64(SD_V256, Sum_V256);
-      } //x
-      Tst  += TstStride;
-      Ref += RefStride;
-      Msk += MskStride;
-    } //y
-    __m128i SD_V128A = _mm256_extracti128_si256(SD_V256, 1);
-    __m128i SD_V128B = _mm256_castsi256_si128(SD_V256);
-    __m128i SD_V128  = _mm_add_epi64(SD_V128A, SD_V128B);
-    uint64  SD       = _mm_extract_epi64(SD_V128, 0) + _mm_extract_epi64(SD_V128, 1);
-    return SD;
-  }
-  else //any other
-  {
-    const int32 Width16 = (int32)((uint32)Width & c_MultipleMask16);
-    int64   SD      = 0;
-    __m256i SD_V256 = _mm256_setzero_si256();
-
-    for(int32 y=0; y<Height; y++)
+    for(int32 x=0; x<Width16; x+=16)
     {
-      for (int32 x = 0; x < Width16; x += 16)
-      {
-        __m256i Tst_V256   = _mm256_loadu_si256((__m256i*) & Tst[x]);
-        __m256i Ref_V256   = _mm256_loadu_si256((__m256i*) & Ref[x]);
-        __m256i Msk_V256   = _mm256_loadu_si256((__m256i*) & Msk[x]);
-        __m256i Diff_V256  = _mm256_sub_epi16     (Tst_V256, Ref_V256);
-        __m256i Diff_V256A = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(Diff_V256, 1));
-        __m256i Diff_V256B = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(Diff_V256));
-        Msk_V256           = _mm256_permute4x64_epi64(Msk_V256, 0xD8);
-        __m256i Msk_V256A  = _mm256_unpacklo_epi16(Msk_V256, Msk_V256);
-        __m256i Msk_V256B  = _mm256_unpackhi_epi16(Msk_V256, Msk_V256);
-        __m256i Wght_V256A = _mm256_mullo_epi32   (Diff_V256A, Msk_V256A);
-        __m256i Wght_V256B = _mm256_mullo_epi32   (Diff_V256B, Msk_V256B);
-        __m256i Wght_V256  = _mm256_add_epi32     (Wght_V256A, Wght_V256B);
-        __m256i Sum_V256A  = _mm256_unpacklo_epi32(Wght_V256, _mm256_setzero_si256());
-        __m256i Sum_V256B  = _mm256_unpackhi_epi32(Wght_V256, _mm256_setzero_si256());
-        __m256i Sum_V256   = _mm256_add_epi64     (Sum_V256A, Sum_V256B);
-        SD_V256 = _mm256_add_epi64(SD_V256, Sum_V256);
-      } //x
-      for(int32 x= Width16; x<Width; x++)
-      {
-        SD += ((int32)Tst[x] - (int32)Ref[x]) * (int32)Msk[x];
-      } //x
-      Tst  += TstStride;
-      Ref += RefStride;
-      Msk += MskStride;
-    } //y
+      __m256i Tst_V256   = _mm256_loadu_si256((__m256i*) & Tst[x]);
+      __m256i Ref_V256   = _mm256_loadu_si256((__m256i*) & Ref[x]);
+      __m256i Msk_V256   = _mm256_loadu_si256((__m256i*) & Msk[x]);
+      __m256i Diff_V256  = _mm256_sub_epi16(Tst_V256, Ref_V256);
+      __m256i Diff_V256A = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(Diff_V256));
+      __m256i Diff_V256B = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(Diff_V256, 1));
+      __m256i Msk_V256A  = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(Msk_V256));
+      __m256i Msk_V256B  = _mm256_cvtepu16_epi32(_mm256_extracti128_si256(Msk_V256, 1));
+      __m256i Wght_V256A = _mm256_mullo_epi32(Diff_V256A, Msk_V256A);
+      __m256i Wght_V256B = _mm256_mullo_epi32(Diff_V256B, Msk_V256B);
+      __m256i Sum_V256A  = _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(Wght_V256A)), _mm256_cvtepi32_epi64(_mm256_extracti128_si256(Wght_V256A, 1)));
+      __m256i Sum_V256B  = _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(Wght_V256B)), _mm256_cvtepi32_epi64(_mm256_extracti128_si256(Wght_V256B, 1)));
+      SD_V256            = _mm256_add_epi64(SD_V256, _mm256_add_epi64(Sum_V256A, Sum_V256B));
+    } //x
+    for(int32 x=Width16; x<Width; x++) { SD += ((int32)Tst[x] - (int32)Ref[x]) * (int32)Msk[x]; }
+    Tst += TstStride;
+    Ref += RefStride;
+    Msk += MskStride;
+  } //y
 
-    __m128i SD_V128A = _mm256_extracti128_si256(SD_V256, 1);
-    __m128i SD_V128B = _mm256_castsi256_si128(SD_V256);
-    __m128i SD_V128 = _mm_add_epi64(SD_V128A, SD_V128B);
-    SD += _mm_extract_epi64(SD_V128, 0) + _mm_extract_epi64(SD_V128, 1);
-    return SD;
-  }
+  SD += xHorVecSum_epi64(SD_V256);
+  return SD;
 }
 uint64 xDistortionAVX::CalcWeightedSSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint16* restrict Msk, int32 Area)
 {
-  assert(0); //TODO - NOT TESTED
-
-  const int32 Area16   = (int32)((uint32)Area & c_MultipleMask16);
-  __m256i     SSD_V256 = _mm256_setzero_si256();
+  //up to 14 bit input, up to 16 bit mask (Diff*Msk in 32 bits, Diff^2*Msk in 64 bits)
+  const int32 Area16 = (int32)((uint32)Area & c_MultipleMask16);
+  __m256i SSD_V256 = _mm256_setzero_si256();
 
   for(int32 i = 0; i < Area16; i += 16)
   {
     __m256i Tst_V256   = _mm256_loadu_si256((__m256i*) & Tst[i]);
     __m256i Ref_V256   = _mm256_loadu_si256((__m256i*) & Ref[i]);
     __m256i Msk_V256   = _mm256_loadu_si256((__m256i*) & Msk[i]);
-    __m256i Diff_V256  = _mm256_sub_epi16     (Tst_V256 , Ref_V256);
-    __m256i Diff_V256A = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(Diff_V256, 1));
-    __m256i Diff_V256B = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(Diff_V256));
-    __m256i Pow_V256A  = _mm256_mullo_epi32   (Diff_V256A, Diff_V256A);
-    __m256i Pow_V256B  = _mm256_mullo_epi32   (Diff_V256B, Diff_V256B);
-    Msk_V256           = _mm256_permute4x64_epi64(Msk_V256, 0xD8);
-    __m256i Msk_V256A  = _mm256_unpacklo_epi16(Msk_V256, Msk_V256);
-    __m256i Msk_V256B  = _mm256_unpackhi_epi16(Msk_V256, Msk_V256);
-    __m256i Wght_V256A = _mm256_mullo_epi32   (Pow_V256A, Msk_V256A);
-    __m256i Wght_V256B = _mm256_mullo_epi32   (Pow_V256B, Msk_V256B);
-    __m256i Wght_V256  = _mm256_add_epi32     (Wght_V256A, Wght_V256B);
-    __m256i Sum_V256A  = _mm256_unpacklo_epi32(Wght_V256, _mm256_setzero_si256());
-    __m256i Sum_V256B  = _mm256_unpackhi_epi32(Wght_V256, _mm256_setzero_si256());
-    __m256i Sum_V256   = _mm256_add_epi64     (Sum_V256A, Sum_V256B);
-    SSD_V256 = _mm256_add_epi64(SSD_V256, Sum_V256);
-  }
-  __m128i SSD_V128A = _mm256_extracti128_si256(SSD_V256, 1);
-  __m128i SSD_V128B = _mm256_castsi256_si128  (SSD_V256);
-  __m128i SSD_V128  = _mm_add_epi64           (SSD_V128A, SSD_V128B);
-  uint64  SSD       = _mm_extract_epi64(SSD_V128, 0) + _mm_extract_epi64(SSD_V128, 1);
-
-  for(int32 i = Area16; i < Area; i++)
-  { 
-    SSD += ((uint64)xPow2(((int32)Tst[i]) - ((int32)Ref[i]))) * (uint64)Msk[i];
-  }
+    __m256i Diff_V256  = _mm256_sub_epi16(Tst_V256, Ref_V256);
+    __m256i Diff_V256A = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(Diff_V256));
+    __m256i Diff_V256B = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(Diff_V256, 1));
+    __m256i Msk_V256A  = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(Msk_V256));
+    __m256i Msk_V256B  = _mm256_cvtepu16_epi32(_mm256_extracti128_si256(Msk_V256, 1));
+    __m256i Pow_V256A  = _mm256_mullo_epi32(Diff_V256A, Diff_V256A);
+    __m256i Pow_V256B  = _mm256_mullo_epi32(Diff_V256B, Diff_V256B);
+    __m256i Sum_V256A  = _mm256_add_epi64(_mm256_mul_epu32(Pow_V256A, Msk_V256A), _mm256_mul_epu32(_mm256_srli_epi64(Pow_V256A, 32), _mm256_srli_epi64(Msk_V256A, 32)));
+    __m256i Sum_V256B  = _mm256_add_epi64(_mm256_mul_epu32(Pow_V256B, Msk_V256B), _mm256_mul_epu32(_mm256_srli_epi64(Pow_V256B, 32), _mm256_srli_epi64(Msk_V256B, 32)));
+    SSD_V256           = _mm256_add_epi64(SSD_V256, _mm256_add_epi64(Sum_V256A, Sum_V256B));
+  } //i
+  uint64 SSD = (uint64)xHorVecSum_epi64(SSD_V256);
 
+  for(int32 i = Area16; i < Area; i++) { SSD += ((uint64)xPow2(((int32)Tst[i]) - ((int32)Ref[i]))) * (uint64)Msk[i]; }
   return SSD;
 }
 uint64 xDistortionAVX::CalcWeightedSSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint16* restrict Msk, int32 TstStride, int32 RefStride, int32 MskStride, int32 Width, int32 Height)
 {
-  assert(0); //TODO - NOT TESTED
-  if(((uint32)Width & c_RemainderMask16)==0) //Width%16==0 - fast path without tail
+  //up to 14 bit input, up to 16 bit mask (Diff*Msk in 32 bits, Diff^2*Msk in 64 bits)
+  const int32 Width16 = (int32)((uint32)Width & c_MultipleMask16);
+  uint64 SSD = 0;
+  __m256i SSD_V256 = _mm256_setzero_si256();
+
+  for(int32 y=0; y<Height; y++)
   {
-    __m256i SSD_V256 = _mm256_setzero_si256();
-    for(int32 y=0; y<Height; y++)
+    for(int32 x=0; x<Width16; x+=16)
     {
-      for(int32 x=0; x<Width; x+=16)
-      {
-        __m256i Tst_V256   = _mm256_loadu_si256((__m256i*) & Tst[x]);
-        __m256i Ref_V256   = _mm256_loadu_si256((__m256i*) & Ref[x]);
-        __m256i Msk_V256   = _mm256_loadu_si256((__m256i*) & Msk[x]);
-        __m256i Diff_V256  = _mm256_sub_epi16     (Tst_V256 , Ref_V256);
-        __m256i Diff_V256A = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(Diff_V256, 1));
-        __m256i Diff_V256B = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(Diff_V256));
-        __m256i Pow_V256A  = _mm256_mullo_epi32   (Diff_V256A, Diff_V256A);
-        __m256i Pow_V256B  = _mm256_mullo_epi32   (Diff_V256B, Diff_V256B);
-        Msk_V256           = _mm256_permute4x64_epi64(Msk_V256, 0xD8);
-        __m256i Msk_V256A  = _mm256_unpacklo_epi16(Msk_V256, Msk_V256);
-        __m256i Msk_V256B  = _mm256_unpackhi_epi16(Msk_V256, Msk_V256);
-        __m256i Wght_V256A = _mm256_mullo_epi32   (Pow_V256A, Msk_V256A);
-        __m256i Wght_V256B = _mm256_mullo_epi32   (Pow_V256B, Msk_V256B);
-        __m256i Wght_V256  = _mm256_add_epi32     (Wght_V256A, Wght_V256B);
-        __m256i Sum_V256A  = _mm256_unpacklo_epi32(Wght_V256, _mm256_setzero_si256());
-        __m256i Sum_V256B  = _mm256_unpackhi_epi32(Wght_V256, _mm256_setzero_si256());
-        __m256i Sum_V256   = _mm256_add_epi64     (Sum_V256A, Sum_V256B);
-        SSD_V256 = _mm256_add_epi64(SSD_V256, Sum_V256);
-      } //x
-      Tst  += TstStride;
-      Ref += RefStride;
-      Msk += MskStride;
-    } //y
-    __m128i SSD_V128A = _mm256_extracti128_si256(SSD_V256, 1);
-    __m128i SSD_V128B = _mm256_castsi256_si128  (SSD_V256);
-    __m128i SSD_V128  = _mm_add_epi64           (SSD_V128A, SSD_V128B);
-    uint64 SSD        = _mm_extract_epi64(SSD_V128, 0) + _mm_extract_epi64(SSD_V128, 1);
-    return SSD;
-  }
-  else //any other
+      __m256i Tst_V256   = _mm256_loadu_si256((__m256i*) & Tst[x]);
+      __m256i Ref_V256   = _mm256_loadu_si256((__m256i*) & Ref[x]);
+      __m256i Msk_V256   = _mm256_loadu_si256((__m256i*) & Msk[x]);
+      __m256i Diff_V256  = _mm256_sub_epi16(Tst_V256, Ref_V256);
+      __m256i Diff_V256A = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(Diff_V256));
+      __m256i Diff_V256B = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(Diff_V256, 1));
+      __m256i Msk_V256A  = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(Msk_V256));
+      __m256i Msk_V256B  = _mm256_cvtepu16_epi32(_mm256_extracti128_si256(Msk_V256, 1));
+      __m256i Pow_V256A  = _mm256_mullo_epi32(Diff_V256A, Diff_V256A);
+      __m256i Pow_V256B  = _mm256_mullo_epi32(Diff_V256B, Diff_V256B);
+      __m256i Sum_V256A  = _mm256_add_epi64(_mm256_mul_epu32(Pow_V256A, Msk_V256A), _mm256_mul_epu32(_mm256_srli_epi64(Pow_V256A, 32), _mm256_srli_epi64(Msk_V256A, 32)));
+      __m256i Sum_V256B  = _mm256_add_epi64(_mm256_mul_epu32(Pow_V256B, Msk_V256B), _mm256_mul_epu32(_mm256_srli_epi64(Pow_V256B, 32), _mm256_srli_epi64(Msk_V256B, 32)));
+      SSD_V256           = _mm256_add_epi64(SSD_V256, _mm256_add_epi64(Sum_V256A, Sum_V256B));
+    } //x
+    for(int32 x=Width16; x<Width; x++) { SSD += ((uint64)xPow2(((int32)Tst[x]) - ((int32)Ref[x]))) * (uint64)Msk[x]; }
+    Tst += TstStride;
+    Ref += RefStride;
+    Msk += MskStride;
+  } //y
+
+  SSD += (uint64)xHorVecSum_epi64(SSD_V256);
+  return SSD;
+}
+int64 xDistortionAVX::CalcWeightedSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint8* restrict Msk, int32 Area)
+{
+  //up to 14 bit input, 8 bit mask (Diff*Msk pairs summed by madd fit in 32 bits)
+  const int32 Area16 = (int32)((uint32)Area & c_MultipleMask16);
+  __m256i SD_V256 = _mm256_setzero_si256();
+
+  for(int32 i = 0; i < Area16; i += 16)
   {
-    const int32 Width16 = (int32)((uint32)Width & c_MultipleMask16);
-    uint64  SSD = 0;
-    __m256i SSD_V256 = _mm256_setzero_si256();
-    __m128i SSD_V128 = _mm_setzero_si128   ();
+    __m256i Tst_V256  = _mm256_loadu_si256((__m256i*) & Tst[i]);
+    __m256i Ref_V256  = _mm256_loadu_si256((__m256i*) & Ref[i]);
+    __m256i Msk_V256  = _mm256_cvtepu8_epi16(_mm_loadu_si128((__m128i*) & Msk[i]));
+    __m256i Diff_V256 = _mm256_sub_epi16 (Tst_V256, Ref_V256);
+    __m256i Wght_V256 = _mm256_madd_epi16(Diff_V256, Msk_V256);
+    __m256i Sum_V256  = _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(Wght_V256)), _mm256_cvtepi32_epi64(_mm256_extracti128_si256(Wght_V256, 1)));
+    SD_V256           = _mm256_add_epi64(SD_V256, Sum_V256);
+  } //i
+  int64 SD = xHorVecSum_epi64(SD_V256);
 
-    for(int32 y=0; y<Height; y++)
-    {
-      for (int32 x = 0; x < Width16; x += 16)
-      {
-        __m256i Tst_V256   = _mm256_loadu_si256((__m256i*) & Tst[x]);
-        __m256i Ref_V256   = _mm256_loadu_si256((__m256i*) & Ref[x]);
-        __m256i Msk_V256   = _mm256_loadu_si256((__m256i*) & Msk[x]);
-        __m256i Diff_V256  = _mm256_sub_epi16     (Tst_V256 , Ref_V256);
-        __m256i Diff_V256A = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(Diff_V256, 1));
-        __m256i Diff_V256B = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(Diff_V256));
-        __m256i Pow_V256A  = _mm256_mullo_epi32   (Diff_V256A, Diff_V256A);
-        __m256i Pow_V256B  = _mm256_mullo_epi32   (Diff_V256B, Diff_V256B);
-        Msk_V256           = _mm256_permute4x64_epi64(Msk_V256, 0xD8);
-        __m256i Msk_V256A  = _mm256_unpacklo_epi16(Msk_V256, Msk_V256);
-        __m256i Msk_V256B  = _mm256_unpackhi_epi16(Msk_V256, Msk_V256);
-        __m256i Wght_V256A = _mm256_mullo_epi32   (Pow_V256A, Msk_V256A);
-        __m256i Wght_V256B = _mm256_mullo_epi32   (Pow_V256B, Msk_V256B);
-        __m256i Wght_V256  = _mm256_add_epi32     (Wght_V256A, Wght_V256B);
-        __m256i Sum_V256A  = _mm256_unpacklo_epi32(Wght_V256, _mm256_setzero_si256());
-        __m256i Sum_V256B  = _mm256_unpackhi_epi32(Wght_V256, _mm256_setzero_si256());
-        __m256i Sum_V256   = _mm256_add_epi64     (Sum_V256A, Sum_V256B);
-        SSD_V256 = _mm256_add_epi64(SSD_V256, Sum_V256);
-      } //x
-      for(int32 x= Width16; x<Width; x++)
-      {
-        SSD += ((uint64)xPow2(((int32)Tst[x]) - ((int32)Ref[x]))) * (uint64)Msk[x];
-      } //x
-      Tst  += TstStride;
-      Ref += RefStride;
-      Msk += MskStride;
-    } //y
-    __m128i SSD_V128A = _mm256_extracti128_si256(SSD_V256, 1);
-    __m128i SSD_V128B = _mm256_castsi256_si128(SSD_V256);
-    SSD_V128 = _mm_add_epi64(SSD_V128, _mm_add_epi64(SSD_V128A, SSD_V128B));
-    SSD += _mm_extract_epi64(SSD_V128, 0) + _mm_extract_epi64(SSD_V128, 1);
-    return SSD;
-  }
+  for(int32 i = Area16; i < Area; i++) { SD += ((int32)Tst[i] - (int32)Ref[i]) * (int32)Msk[i]; }
+  return SD;
+}
+uint64 xDistortionAVX::CalcWeightedSSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint8* restrict Msk, int32 Area)
+{
+  //up to 14 bit input, 8 bit mask (Diff^2 in 32 bits, Diff^2*Msk in 64 bits)
+  const int32 Area16 = (int32)((uint32)Area & c_MultipleMask16);
+  __m256i SSD_V256 = _mm256_setzero_si256();
+
+  for(int32 i = 0; i < Area16; i += 16)
+  {
+    __m256i Tst_V256   = _mm256_loadu_si256((__m256i*) & Tst[i]);
+    __m256i Ref_V256   = _mm256_loadu_si256((__m256i*) & Ref[i]);
+    __m128i Msk_V128   = _mm_loadu_si128   ((__m128i*) & Msk[i]);
+    __m256i Diff_V256  = _mm256_sub_epi16(Tst_V256, Ref_V256);
+    __m256i Diff_V256A = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(Diff_V256));
+    __m256i Diff_V256B = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(Diff_V256, 1));
+    __m256i Msk_V256A  = _mm256_cvtepu8_epi32(Msk_V128);
+    __m256i Msk_V256B  = _mm256_cvtepu8_epi32(_mm_srli_si128(Msk_V128, 8));
+    __m256i Pow_V256A  = _mm256_mullo_epi32(Diff_V256A, Diff_V256A);
+    __m256i Pow_V256B  = _mm256_mullo_epi32(Diff_V256B, Diff_V256B);
+    __m256i Sum_V256A  = _mm256_add_epi64(_mm256_mul_epu32(Pow_V256A, Msk_V256A), _mm256_mul_epu32(_mm256_srli_epi64(Pow_V256A, 32), _mm256_srli_epi64(Msk_V256A, 32)));
+    __m256i Sum_V256B  = _mm256_add_epi64(_mm256_mul_epu32(Pow_V256B, Msk_V256B), _mm256_mul_epu32(_mm256_srli_epi64(Pow_V256B, 32), _mm256_srli_epi64(Msk_V256B, 32)));
+    SSD_V256           = _mm256_add_epi64(SSD_V256, _mm256_add_epi64(Sum_V256A, Sum_V256B));
+  } //i
+  uint64 SSD = (uint64)xHorVecSum_epi64(SSD_V256);
+
+  for(int32 i = Area16; i < Area; i++) { SSD += ((uint64)xPow2(((int32)Tst[i]) - ((int32)Ref[i]))) * (uint64)Msk[i]; }
+  return SSD;
+}
+int64 xDistortionAVX::CalcMaskedSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint64* restrict MskBits, int32 Area)
+{
+  //up to 14 bit input, groups of 16 masked out pels are skipped
+  const int32   Area16    = (int32)((uint32)Area & c_MultipleMask16);
+  const __m256i One_V256  = _mm256_set1_epi16(1);
+  const __m256i Bits_V256 = _mm256_setr_epi16(0x0001, 0x0002, 0x0004, 0x0008, 0x0010, 0x0020, 0x0040, 0x0080, 0x0100, 0x0200, 0x0400, 0x0800, 0x1000, 0x2000, 0x4000, (int16)0x8000);
+  __m256i SD_V256 = _mm256_setzero_si256();
+
+  for(int32 i = 0; i < Area16; i += 16)
+  {
+    const uint32 Bits16 = (uint32)(MskBits[i >> 6] >> (i & 63)) & 0xFFFF;
+    if(Bits16 == 0) { continue; }
+    __m256i Msk_V256  = _mm256_cmpeq_epi16(_mm256_and_si256(_mm256_set1_epi16((int16)Bits16), Bits_V256), Bits_V256);
+    __m256i Tst_V256  = _mm256_loadu_si256((__m256i*) & Tst[i]);
+    __m256i Ref_V256  = _mm256_loadu_si256((__m256i*) & Ref[i]);
+    __m256i Diff_V256 = _mm256_and_si256 (_mm256_sub_epi16(Tst_V256, Ref_V256), Msk_V256);
+    __m256i Sum_V256  = _mm256_madd_epi16(Diff_V256, One_V256);
+    SD_V256           = _mm256_add_epi64(SD_V256, _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(Sum_V256)), _mm256_cvtepi32_epi64(_mm256_extracti128_si256(Sum_V256, 1))));
+  } //i
+  int64 SD = xHorVecSum_epi64(SD_V256);
+
+  for(int32 i = Area16; i < Area; i++) { if((MskBits[i >> 6] >> (i & 63)) & 1) { SD += (int32)Tst[i] - (int32)Ref[i]; } }
+  return SD;
+}
+uint64 xDistortionAVX::CalcMaskedSSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint64* restrict MskBits, int32 Area)
+{
+  //up to 14 bit input, groups of 16 masked out pels are skipped
+  const int32   Area16    = (int32)((uint32)Area & c_MultipleMask16);
+  const __m256i Bits_V256 = _mm256_setr_epi16(0x0001, 0x0002, 0x0004, 0x0008, 0x0010, 0x0020, 0x0040, 0x0080, 0x0100, 0x0200, 0x0400, 0x0800, 0x1000, 0x2000, 0x4000, (int16)0x8000);
+  __m256i SSD_V256 = _mm256_setzero_si256();
+
+  for(int32 i = 0; i < Area16; i += 16)
+  {
+    const uint32 Bits16 = (uint32)(MskBits[i >> 6] >> (i & 63)) & 0xFFFF;
+    if(Bits16 == 0) { continue; }
+    __m256i Msk_V256  = _mm256_cmpeq_epi16(_mm256_and_si256(_mm256_set1_epi16((int16)Bits16), Bits_V256), Bits_V256);
+    __m256i Tst_V256  = _mm256_loadu_si256((__m256i*) & Tst[i]);
+    __m256i Ref_V256  = _mm256_loadu_si256((__m256i*) & Ref[i]);
+    __m256i Diff_V256 = _mm256_and_si256     (_mm256_sub_epi16(Tst_V256, Ref_V256), Msk_V256);
+    __m256i Pow_V256  = _mm256_madd_epi16    (Diff_V256, Diff_V256);
+    __m256i Pow_V256A = _mm256_unpacklo_epi32(Pow_V256 , _mm256_setzero_si256());
+    __m256i Pow_V256B = _mm256_unpackhi_epi32(Pow_V256 , _mm256_setzero_si256());
+    SSD_V256          = _mm256_add_epi64     (SSD_V256, _mm256_add_epi64(Pow_V256A, Pow_V256B));
+  } //i
+  uint64 SSD = (uint64)xHorVecSum_epi64(SSD_V256);
+
+  for(int32 i = Area16; i < Area; i++) { if((MskBits[i >> 6] >> (i & 63)) & 1) { SSD += (uint64)xPow2(((int32)Tst[i]) - ((int32)Ref[i])); } }
+  return SSD;
 }
 
 //===============================================================================================================================================================================================================
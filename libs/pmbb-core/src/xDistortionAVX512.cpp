@@ -263,6 +263,254 @@ uint64 xDistortionAVX512::CalcSSD(const uint16* restrict Tst, const uint16* rest
   return SSD;
 }
 
+std::tuple<int32, uint64> xDistortionAVX512::CalcSDSSD(const uint16* restrict Tst, const uint16* restrict Ref, int32 Area)
+{
+  const int32   Area32   = (int32)((uint32)Area & c_MultipleMask32);
+  const __m512i One_V512 = _mm512_set1_epi16(1);
+  __m512i       SD_V512  = _mm512_setzero_si512();
+  __m512i       SSD_V512 = _mm512_setzero_si512();
+
+  for(int32 i = 0; i < Area32; i += 32)
+  {
+    __m512i Tst_V512  = _mm512_loadu_si512((__m512i*) & Tst[i]);
+    __m512i Ref_V512  = _mm512_loadu_si512((__m512i*) & Ref[i]);
+    __m512i Diff_V512 = _mm512_sub_epi16     (Tst_V512 , Ref_V512);
+    __m512i Sum_V512  = _mm512_madd_epi16    (Diff_V512, One_V512 );
+    __m512i Pow_V512  = _mm512_madd_epi16    (Diff_V512, Diff_V512);
+    __m512i Pow_V512A = _mm512_unpacklo_epi32(Pow_V512 , _mm512_setzero_si512());
+    __m512i Pow_V512B = _mm512_unpackhi_epi32(Pow_V512 , _mm512_setzero_si512());
+    SD_V512           = _mm512_add_epi32     (SD_V512 , Sum_V512);
+    SSD_V512          = _mm512_add_epi64     (SSD_V512, _mm512_add_epi64(Pow_V512A, Pow_V512B));
+  } //i
+  int32  SD  = xHorVecSum_epi32(SD_V512);
+  uint64 SSD = xHorVecSum_epi64(SSD_V512);
+
+  for(int32 i = Area32; i < Area; i++)
+  {
+    const int32 Diff = (int32)Tst[i] - (int32)Ref[i];
+    SD  += Diff;
+    SSD += (uint64)xPow2(Diff);
+  }
+  return { SD, SSD };
+}
+int64 xDistortionAVX512::CalcWeightedSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint16* restrict Msk, int32 Area)
+{
+  //up to 14 bit input, up to 16 bit mask (Diff*Msk in 32 bits, Diff^2*Msk in 64 bits)
+  const int32 Area32 = (int32)((uint32)Area & c_MultipleMask32);
+  __m512i SD_V512 = _mm512_setzero_si512();
+
+  for(int32 i = 0; i < Area32; i += 32)
+  {
+    __m512i Tst_V512   = _mm512_loadu_si512((__m512i*) & Tst[i]);
+    __m512i Ref_V512   = _mm512_loadu_si512((__m512i*) & Ref[i]);
+    __m512i Msk_V512   = _mm512_loadu_si512((__m512i*) & Msk[i]);
+    __m512i Diff_V512  = _mm512_sub_epi16(Tst_V512, Ref_V512);
+    __m512i Diff_V512A = _mm512_cvtepi16_epi32(_mm512_castsi512_si256(Diff_V512));
+    __m512i Diff_V512B = _mm512_cvtepi16_epi32(_mm512_extracti64x4_epi64(Diff_V512, 1));
+    __m512i Msk_V512A  = _mm512_cvtepu16_epi32(_mm512_castsi512_si256(Msk_V512));
+    __m512i Msk_V512B  = _mm512_cvtepu16_epi32(_mm512_extracti64x4_epi64(Msk_V512, 1));
+    __m512i Wght_V512A = _mm512_mullo_epi32(Diff_V512A, Msk_V512A);
+    __m512i Wght_V512B = _mm512_mullo_epi32(Diff_V512B, Msk_V512B);
+    __m512i Sum_V512A  = _mm512_add_epi64(_mm512_cvtepi32_epi64(_mm512_castsi512_si256(Wght_V512A)), _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(Wght_V512A, 1)));
+    __m512i Sum_V512B  = _mm512_add_epi64(_mm512_cvtepi32_epi64(_mm512_castsi512_si256(Wght_V512B)), _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(Wght_V512B, 1)));
+    SD_V512            = _mm512_add_epi64(SD_V512, _mm512_add_epi64(Sum_V512A, Sum_V512B));
+  } //i
+  int64 SD = xHorVecSum_epi64(SD_V512);
+
+  for(int32 i = Area32; i < Area; i++) { SD += ((int32)Tst[i] - (int32)Ref[i]) * (int32)Msk[i]; }
+  return SD;
+}
+int64 xDistortionAVX512::CalcWeightedSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint16* restrict Msk, int32 TstStride, int32 RefStride, int32 MskStride, int32 Width, int32 Height)
+{
+  //up to 14 bit input, up to 16 bit mask (Diff*Msk in 32 bits, Diff^2*Msk in 64 bits)
+  const int32 Width32 = (int32)((uint32)Width & c_MultipleMask32);
+  int64 SD = 0;
+  __m512i SD_V512 = _mm512_setzero_si512();
+
+  for(int32 y=0; y<Height; y++)
+  {
+    for(int32 x=0; x<Width32; x+=32)
+    {
+      __m512i Tst_V512   = _mm512_loadu_si512((__m512i*) & Tst[x]);
+      __m512i Ref_V512   = _mm512_loadu_si512((__m512i*) & Ref[x]);
+      __m512i Msk_V512   = _mm512_loadu_si512((__m512i*) & Msk[x]);
+      __m512i Diff_V512  = _mm512_sub_epi16(Tst_V512, Ref_V512);
+      __m512i Diff_V512A = _mm512_cvtepi16_epi32(_mm512_castsi512_si256(Diff_V512));
+      __m512i Diff_V512B = _mm512_cvtepi16_epi32(_mm512_extracti64x4_epi64(Diff_V512, 1));
+      __m512i Msk_V512A  = _mm512_cvtepu16_epi32(_mm512_castsi512_si256(Msk_V512));
+      __m512i Msk_V512B  = _mm512_cvtepu16_epi32(_mm512_extracti64x4_epi64(Msk_V512, 1));
+      __m512i Wght_V512A = _mm512_mullo_epi32(Diff_V512A, Msk_V512A);
+      __m512i Wght_V512B = _mm512_mullo_epi32(Diff_V512B, Msk_V512B);
+      __m512i Sum_V512A  = _mm512_add_epi64(_mm512_cvtepi32_epi64(_mm512_castsi512_si256(Wght_V512A)), _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(Wght_V512A, 1)));
+      __m512i Sum_V512B  = _mm512_add_epi64(_mm512_cvtepi32_epi64(_mm512_castsi512_si256(Wght_V512B)), _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(Wght_V512B, 1)));
+      SD_V512            = _mm512_add_epi64(SD_V512, _mm512_add_epi64(Sum_V512A, Sum_V512B));
+    } //x
+    for(int32 x=Width32; x<Width; x++) { SD += ((int32)Tst[x] - (int32)Ref[x]) * (int32)Msk[x]; }
+    Tst += TstStride;
+    Ref += RefStride;
+    Msk += MskStride;
+  } //y
+
+  SD += xHorVecSum_epi64(SD_V512);
+  return SD;
+}
+uint64 xDistortionAVX512::CalcWeightedSSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint16* restrict Msk, int32 Area)
+{
+  //up to 14 bit input, up to 16 bit mask (Diff*Msk in 32 bits, Diff^2*Msk in 64 bits)
+  const int32 Area32 = (int32)((uint32)Area & c_MultipleMask32);
+  __m512i SSD_V512 = _mm512_setzero_si512();
+
+  for(int32 i = 0; i < Area32; i += 32)
+  {
+    __m512i Tst_V512   = _mm512_loadu_si512((__m512i*) & Tst[i]);
+    __m512i Ref_V512   = _mm512_loadu_si512((__m512i*) & Ref[i]);
+    __m512i Msk_V512   = _mm512_loadu_si512((__m512i*) & Msk[i]);
+    __m512i Diff_V512  = _mm512_sub_epi16(Tst_V512, Ref_V512);
+    __m512i Diff_V512A = _mm512_cvtepi16_epi32(_mm512_castsi512_si256(Diff_V512));
+    __m512i Diff_V512B = _mm512_cvtepi16_epi32(_mm512_extracti64x4_epi64(Diff_V512, 1));
+    __m512i Msk_V512A  = _mm512_cvtepu16_epi32(_mm512_castsi512_si256(Msk_V512));
+    __m512i Msk_V512B  = _mm512_cvtepu16_epi32(_mm512_extracti64x4_epi64(Msk_V512, 1));
+    __m512i Pow_V512A  = _mm512_mullo_epi32(Diff_V512A, Diff_V512A);
+    __m512i Pow_V512B  = _mm512_mullo_epi32(Diff_V512B, Diff_V512B);
+    __m512i Sum_V512A  = _mm512_add_epi64(_mm512_mul_epu32(Pow_V512A, Msk_V512A), _mm512_mul_epu32(_mm512_srli_epi64(Pow_V512A, 32), _mm512_srli_epi64(Msk_V512A, 32)));
+    __m512i Sum_V512B  = _mm512_add_epi64(_mm512_mul_epu32(Pow_V512B, Msk_V512B), _mm512_mul_epu32(_mm512_srli_epi64(Pow_V512B, 32), _mm512_srli_epi64(Msk_V512B, 32)));
+    SSD_V512           = _mm512_add_epi64(SSD_V512, _mm512_add_epi64(Sum_V512A, Sum_V512B));
+  } //i
+  uint64 SSD = (uint64)xHorVecSum_epi64(SSD_V512);
+
+  for(int32 i = Area32; i < Area; i++) { SSD += ((uint64)xPow2(((int32)Tst[i]) - ((int32)Ref[i]))) * (uint64)Msk[i]; }
+  return SSD;
+}
+uint64 xDistortionAVX512::CalcWeightedSSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint16* restrict Msk, int32 TstStride, int32 RefStride, int32 MskStride, int32 Width, int32 Height)
+{
+  //up to 14 bit input, up to 16 bit mask (Diff*Msk in 32 bits, Diff^2*Msk in 64 bits)
+  const int32 Width32 = (int32)((uint32)Width & c_MultipleMask32);
+  uint64 SSD = 0;
+  __m512i SSD_V512 = _mm512_setzero_si512();
+
+  for(int32 y=0; y<Height; y++)
+  {
+    for(int32 x=0; x<Width32; x+=32)
+    {
+      __m512i Tst_V512   = _mm512_loadu_si512((__m512i*) & Tst[x]);
+      __m512i Ref_V512   = _mm512_loadu_si512((__m512i*) & Ref[x]);
+      __m512i Msk_V512   = _mm512_loadu_si512((__m512i*) & Msk[x]);
+      __m512i Diff_V512  = _mm512_sub_epi16(Tst_V512, Ref_V512);
+      __m512i Diff_V512A = _mm512_cvtepi16_epi32(_mm512_castsi512_si256(Diff_V512));
+      __m512i Diff_V512B = _mm512_cvtepi16_epi32(_mm512_extracti64x4_epi64(Diff_V512, 1));
+      __m512i Msk_V512A  = _mm512_cvtepu16_epi32(_mm512_castsi512_si256(Msk_V512));
+      __m512i Msk_V512B  = _mm512_cvtepu16_epi32(_mm512_extracti64x4_epi64(Msk_V512, 1));
+      __m512i Pow_V512A  = _mm512_mullo_epi32(Diff_V512A, Diff_V512A);
+      __m512i Pow_V512B  = _mm512_mullo_epi32(Diff_V512B, Diff_V512B);
+      __m512i Sum_V512A  = _mm512_add_epi64(_mm512_mul_epu32(Pow_V512A, Msk_V512A), _mm512_mul_epu32(_mm512_srli_epi64(Pow_V512A, 32), _mm512_srli_epi64(Msk_V512A, 32)));
+      __m512i Sum_V512B  = _mm512_add_epi64(_mm512_mul_epu32(Pow_V512B, Msk_V512B), _mm512_mul_epu32(_mm512_srli_epi64(Pow_V512B, 32), _mm512_srli_epi64(Msk_V512B, 32)));
+      SSD_V512           = _mm512_add_epi64(SSD_V512, _mm512_add_epi64(Sum_V512A, Sum_V512B));
+    } //x
+    for(int32 x=Width32; x<Width; x++) { SSD += ((uint64)xPow2(((int32)Tst[x]) - ((int32)Ref[x]))) * (uint64)Msk[x]; }
+    Tst += TstStride;
+    Ref += RefStride;
+    Msk += MskStride;
+  } //y
+
+  SSD += (uint64)xHorVecSum_epi64(SSD_V512);
+  return SSD;
+}
+int64 xDistortionAVX512::CalcWeightedSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint8* restrict Msk, int32 Area)
+{
+  //up to 14 bit input, 8 bit mask (Diff*Msk pairs summed by madd fit in 32 bits)
+  const int32 Area32 = (int32)((uint32)Area & c_MultipleMask32);
+  __m512i SD_V512 = _mm512_setzero_si512();
+
+  for(int32 i = 0; i < Area32; i += 32)
+  {
+    __m512i Tst_V512  = _mm512_loadu_si512((__m512i*) & Tst[i]);
+    __m512i Ref_V512  = _mm512_loadu_si512((__m512i*) & Ref[i]);
+    __m512i Msk_V512  = _mm512_cvtepu8_epi16(_mm256_loadu_si256((__m256i*) & Msk[i]));
+    __m512i Diff_V512 = _mm512_sub_epi16 (Tst_V512, Ref_V512);
+    __m512i Wght_V512 = _mm512_madd_epi16(Diff_V512, Msk_V512);
+    __m512i Sum_V512  = _mm512_add_epi64(_mm512_cvtepi32_epi64(_mm512_castsi512_si256(Wght_V512)), _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(Wght_V512, 1)));
+    SD_V512           = _mm512_add_epi64(SD_V512, Sum_V512);
+  } //i
+  int64 SD = xHorVecSum_epi64(SD_V512);
+
+  for(int32 i = Area32; i < Area; i++) { SD += ((int32)Tst[i] - (int32)Ref[i]) * (int32)Msk[i]; }
+  return SD;
+}
+uint64 xDistortionAVX512::CalcWeightedSSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint8* restrict Msk, int32 Area)
+{
+  //up to 14 bit input, 8 bit mask (Diff^2 in 32 bits, Diff^2*Msk in 64 bits)
+  const int32 Area32 = (int32)((uint32)Area & c_MultipleMask32);
+  __m512i SSD_V512 = _mm512_setzero_si512();
+
+  for(int32 i = 0; i < Area32; i += 32)
+  {
+    __m512i Tst_V512   = _mm512_loadu_si512((__m512i*) & Tst[i]);
+    __m512i Ref_V512   = _mm512_loadu_si512((__m512i*) & Ref[i]);
+    __m256i Msk_V256   = _mm256_loadu_si256((__m256i*) & Msk[i]);
+    __m512i Diff_V512  = _mm512_sub_epi16(Tst_V512, Ref_V512);
+    __m512i Diff_V512A = _mm512_cvtepi16_epi32(_mm512_castsi512_si256(Diff_V512));
+    __m512i Diff_V512B = _mm512_cvtepi16_epi32(_mm512_extracti64x4_epi64(Diff_V512, 1));
+    __m512i Msk_V512A  = _mm512_cvtepu8_epi32(_mm256_castsi256_si128(Msk_V256));
+    __m512i Msk_V512B  = _mm512_cvtepu8_epi32(_mm256_extracti128_si256(Msk_V256, 1));
+    __m512i Pow_V512A  = _mm512_mullo_epi32(Diff_V512A, Diff_V512A);
+    __m512i Pow_V512B  = _mm512_mullo_epi32(Diff_V512B, Diff_V512B);
+    __m512i Sum_V512A  = _mm512_add_epi64(_mm512_mul_epu32(Pow_V512A, Msk_V512A), _mm512_mul_epu32(_mm512_srli_epi64(Pow_V512A, 32), _mm512_srli_epi64(Msk_V512A, 32)));
+    __m512i Sum_V512B  = _mm512_add_epi64(_mm512_mul_epu32(Pow_V512B, Msk_V512B), _mm512_mul_epu32(_mm512_srli_epi64(Pow_V512B, 32), _mm512_srli_epi64(Msk_V512B, 32)));
+    SSD_V512           = _mm512_add_epi64(SSD_V512, _mm512_add_epi64(Sum_V512A, Sum_V512B));
+  } //i
+  uint64 SSD = (uint64)xHorVecSum_epi64(SSD_V512);
+
+  for(int32 i = Area32; i < Area; i++) { SSD += ((uint64)xPow2(((int32)Tst[i]) - ((int32)Ref[i]))) * (uint64)Msk[i]; }
+  return SSD;
+}
+int64 xDistortionAVX512::CalcMaskedSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint64* restrict MskBits, int32 Area)
+{
+  //up to 14 bit input, mask bits used directly as write mask, groups of 32 masked out pels are skipped
+  const int32   Area32   = (int32)((uint32)Area & c_MultipleMask32);
+  const __m512i One_V512 = _mm512_set1_epi16(1);
+  __m512i SD_V512 = _mm512_setzero_si512();
+
+  for(int32 i = 0; i < Area32; i += 32)
+  {
+    const uint32 Bits32 = (uint32)(MskBits[i >> 6] >> (i & 63));
+    if(Bits32 == 0) { continue; }
+    const __mmask32 Msk = _cvtu32_mask32(Bits32);
+    __m512i Tst_V512  = _mm512_maskz_loadu_epi16(Msk, &Tst[i]);
+    __m512i Ref_V512  = _mm512_maskz_loadu_epi16(Msk, &Ref[i]);
+    __m512i Diff_V512 = _mm512_sub_epi16 (Tst_V512, Ref_V512);
+    __m512i Sum_V512  = _mm512_madd_epi16(Diff_V512, One_V512);
+    SD_V512           = _mm512_add_epi64(SD_V512, _mm512_add_epi64(_mm512_cvtepi32_epi64(_mm512_castsi512_si256(Sum_V512)), _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(Sum_V512, 1))));
+  } //i
+  int64 SD = xHorVecSum_epi64(SD_V512);
+
+  for(int32 i = Area32; i < Area; i++) { if((MskBits[i >> 6] >> (i & 63)) & 1) { SD += (int32)Tst[i] - (int32)Ref[i]; } }
+  return SD;
+}
+uint64 xDistortionAVX512::CalcMaskedSSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint64* restrict MskBits, int32 Area)
+{
+  //up to 14 bit input, mask bits used directly as write mask, groups of 32 masked out pels are skipped
+  const int32 Area32 = (int32)((uint32)Area & c_MultipleMask32);
+  __m512i SSD_V512 = _mm512_setzero_si512();
+
+  for(int32 i = 0; i < Area32; i += 32)
+  {
+    const uint32 Bits32 = (uint32)(MskBits[i >> 6] >> (i & 63));
+    if(Bits32 == 0) { continue; }
+    const __mmask32 Msk = _cvtu32_mask32(Bits32);
+    __m512i Tst_V512  = _mm512_maskz_loadu_epi16(Msk, &Tst[i]);
+    __m512i Ref_V512  = _mm512_maskz_loadu_epi16(Msk, &Ref[i]);
+    __m512i Diff_V512 = _mm512_sub_epi16     (Tst_V512 , Ref_V512);
+    __m512i Pow_V512  = _mm512_madd_epi16    (Diff_V512, Diff_V512);
+    __m512i Pow_V512A = _mm512_unpacklo_epi32(Pow_V512 , _mm512_setzero_si512());
+    __m512i Pow_V512B = _mm512_unpackhi_epi32(Pow_V512 , _mm512_setzero_si512());
+    SSD_V512          = _mm512_add_epi64     (SSD_V512, _mm512_add_epi64(Pow_V512A, Pow_V512B));
+  } //i
+  uint64 SSD = (uint64)xHorVecSum_epi64(SSD_V512);
+
+  for(int32 i = Area32; i < Area; i++) { if((MskBits[i >> 6] >> (i & 63)) & 1) { SSD += (uint64)xPow2(((int32)Tst[i]) - ((int32)Ref[i])); } }
+  return SSD;
+}
+
 //===============================================================================================================================================================================================================
 
 } //end of namespace PMBB
@@ -279,9 +279,40 @@ uint64 xDistortionSSE::CalcSSD(const uint16* restrict Tst, const uint16* restric
   }  
 }
 
-int64 xDistortionSSE::CalcWeightedSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint16* restrict Mask, int32 Area)
+std::tuple<int32, uint64> xDistortionSSE::CalcSDSSD(const uint16* restrict Tst, const uint16* restrict Ref, int32 Area)
 {
-  assert(0); //TODO - NOT TESTED
+  //up to 14 bit input
+  const int32   Area8    = (int32)((uint32)Area & c_MultipleMask8);
+  const __m128i One_V128 = _mm_set1_epi16(1);
+  __m128i       SD_V128  = _mm_setzero_si128();
+  __m128i       SSD_V128 = _mm_setzero_si128();
+
+  for(int32 i = 0; i < Area8; i += 8)
+  {
+    __m128i Tst_V128  = _mm_loadu_si128((__m128i*) & Tst[i]);
+    __m128i Ref_V128  = _mm_loadu_si128((__m128i*) & Ref[i]);
+    __m128i Diff_V128 = _mm_sub_epi16     (Tst_V128 , Ref_V128);
+    __m128i Sum_V128  = _mm_madd_epi16    (Diff_V128, One_V128 );
+    __m128i Pow_V128  = _mm_madd_epi16    (Diff_V128, Diff_V128);
+    __m128i Pow_V128A = _mm_unpacklo_epi32(Pow_V128 , _mm_setzero_si128());
+    __m128i Pow_V128B = _mm_unpackhi_epi32(Pow_V128 , _mm_setzero_si128());
+    SD_V128           = _mm_add_epi32     (SD_V128 , Sum_V128);
+    SSD_V128          = _mm_add_epi64     (SSD_V128, _mm_add_epi64(Pow_V128A, Pow_V128B));
+  } //i
+  int32  SD  = xHorVecSum_epi32(SD_V128);
+  uint64 SSD = xHorVecSum_epi64(SSD_V128);
+
+  for(int32 i = Area8; i < Area; i++)
+  {
+    const int32 Diff = (int32)Tst[i] - (int32)Ref[i];
+    SD  += Diff;
+    SSD += (uint64)xPow2(Diff);
+  }
+  return { SD, SSD };
+}
+int64 xDistortionSSE::CalcWeightedSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint16* restrict Msk, int32 Area)
+{
+  //up to 14 bit input, up to 16 bit mask (Diff*Msk in 32 bits, Diff^2*Msk in 64 bits)
   const int32 Area8 = (int32)((uint32)Area & c_MultipleMask8);
   __m128i SD_V128 = _mm_setzero_si128();
 
@@ -289,201 +320,213 @@ int64 xDistortionSSE::CalcWeightedSD(const uint16* restrict Tst, const uint16* r
   {
     __m128i Tst_V128   = _mm_loadu_si128((__m128i*) & Tst[i]);
     __m128i Ref_V128   = _mm_loadu_si128((__m128i*) & Ref[i]);
-    __m128i Mask_V128  = _mm_loadu_si128((__m128i*) & Mask[i]);
-    __m128i Diff_V128  = _mm_sub_epi16     (Tst_V128 , Ref_V128);
+    __m128i Msk_V128   = _mm_loadu_si128((__m128i*) & Msk[i]);
+    __m128i Diff_V128  = _mm_sub_epi16(Tst_V128, Ref_V128);
     __m128i Diff_V128A = _mm_cvtepi16_epi32(Diff_V128);
     __m128i Diff_V128B = _mm_cvtepi16_epi32(_mm_srli_si128(Diff_V128, 8));
-    __m128i Mask_V128A = _mm_unpacklo_epi16(Mask_V128, _mm_setzero_si128());
-    __m128i Mask_V128B = _mm_unpackhi_epi16(Mask_V128, _mm_setzero_si128());
-    __m128i Wght_V128A = _mm_mullo_epi32   (Diff_V128A, Mask_V128A);
-    __m128i Wght_V128B = _mm_mullo_epi32   (Diff_V128B, Mask_V128B);
-    __m128i Wght_V128  = _mm_add_epi32     (Wght_V128A, Wght_V128B);
-    __m128i Sum_V128A  = _mm_unpacklo_epi32(Wght_V128, _mm_setzero_si128());
-    __m128i Sum_V128B  = _mm_unpackhi_epi32(Wght_V128, _mm_setzero_si128());
-    __m128i Sum_V128   = _mm_add_epi64     (Sum_V128A, Sum_V128B);
-    SD_V128 = _mm_add_epi64(SD_V128, Sum_V128);
+    __m128i Msk_V128A  = _mm_cvtepu16_epi32(Msk_V128);
+    __m128i Msk_V128B  = _mm_cvtepu16_epi32(_mm_srli_si128(Msk_V128, 8));
+    __m128i Wght_V128A = _mm_mullo_epi32(Diff_V128A, Msk_V128A);
+    __m128i Wght_V128B = _mm_mullo_epi32(Diff_V128B, Msk_V128B);
+    __m128i Sum_V128A  = _mm_add_epi64(_mm_cvtepi32_epi64(Wght_V128A), _mm_cvtepi32_epi64(_mm_srli_si128(Wght_V128A, 8)));
+    __m128i Sum_V128B  = _mm_add_epi64(_mm_cvtepi32_epi64(Wght_V128B), _mm_cvtepi32_epi64(_mm_srli_si128(Wght_V128B, 8)));
+    SD_V128            = _mm_add_epi64(SD_V128, _mm_add_epi64(Sum_V128A, Sum_V128B));
   } //i
-  int64 SD = _mm_extract_epi64(SD_V128, 0) + _mm_extract_epi64(SD_V128, 1);
+  int64 SD = xHorVecSum_epi64(SD_V128);
 
-  for(int32 i = Area8; i < Area; i++) { SD += ((int32)Tst[i] - (int32)Ref[i]) * (int32)Mask[i]; }
+  for(int32 i = Area8; i < Area; i++) { SD += ((int32)Tst[i] - (int32)Ref[i]) * (int32)Msk[i]; }
   return SD;
 }
-int64 xDistortionSSE::CalcWeightedSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint16* restrict Mask, int32 TstStride, int32 RefStride, int32 MskStride, int32 Width, int32 Height)
+int64 xDistortionSSE::CalcWeightedSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint16* restrict Msk, int32 TstStride, int32 RefStride, int32 MskStride, int32 Width, int32 Height)
 {
-  assert(0); //TODO - NOT TESTED
-  if(((uint32)Width & c_RemainderMask8)==0) //Width%8==0 - fast path without tail
+  //up to 14 bit input, up to 16 bit mask (Diff*Msk in 32 bits, Diff^2*Msk in 64 bits)
+  const int32 Width8 = (int32)((uint32)Width & c_MultipleMask8);
+  int64 SD = 0;
+  __m128i SD_V128 = _mm_setzero_si128();
+
+  for(int32 y=0; y<Height; y++)
   {
-    __m128i SD_V128 = _mm_setzero_si128();
-    for(int32 y=0; y<Height; y++)
+    for(int32 x=0; x<Width8; x+=8)
     {
-      for(int32 x=0; x<Width; x+=8)
-      {
-        __m128i Tst_V128   = _mm_loadu_si128((__m128i*) & Tst[x]);
-        __m128i Ref_V128   = _mm_loadu_si128((__m128i*) & Ref[x]);
-        __m128i Mask_V128  = _mm_loadu_si128((__m128i*) & Mask[x]);
-        __m128i Diff_V128  = _mm_sub_epi16     (Tst_V128 , Ref_V128);
-        __m128i Diff_V128A = _mm_cvtepi16_epi32(Diff_V128);
-        __m128i Diff_V128B = _mm_cvtepi16_epi32(_mm_srli_si128(Diff_V128, 8));
-        __m128i Mask_V128A = _mm_unpacklo_epi16(Mask_V128, _mm_setzero_si128());
-        __m128i Mask_V128B = _mm_unpackhi_epi16(Mask_V128, _mm_setzero_si128());
-        __m128i Wght_V128A = _mm_mullo_epi32   (Diff_V128A, Mask_V128A);
-        __m128i Wght_V128B = _mm_mullo_epi32   (Diff_V128B, Mask_V128B);
-        __m128i Wght_V128  = _mm_add_epi32     (Wght_V128A, Wght_V128B);
-        __m128i Sum_V128A  = _mm_unpacklo_epi32(Wght_V128, _mm_setzero_si128());
-        __m128i Sum_V128B  = _mm_unpackhi_epi32(Wght_V128, _mm_setzero_si128());
-        __m128i Sum_V128   = _mm_add_epi64     (Sum_V128A, Sum_V128B);
-        SD_V128 = _mm_add_epi64(SD_V128, Sum_V128);
-      } //x
-      Tst  += TstStride;
-      Ref += RefStride;
-      Mask += MskStride;
-    } //y
-    int64 SD = _mm_extract_epi64(SD_V128, 0) + _mm_extract_epi64(SD_V128, 1);
-    return SD;
-  }
-  else //any other
+      __m128i Tst_V128   = _mm_loadu_si128((__m128i*) & Tst[x]);
+      __m128i Ref_V128   = _mm_loadu_si128((__m128i*) & Ref[x]);
+      __m128i Msk_V128   = _mm_loadu_si128((__m128i*) & Msk[x]);
+      __m128i Diff_V128  = _mm_sub_epi16(Tst_V128, Ref_V128);
+      __m128i Diff_V128A = _mm_cvtepi16_epi32(Diff_V128);
+      __m128i Diff_V128B = _mm_cvtepi16_epi32(_mm_srli_si128(Diff_V128, 8));
+      __m128i Msk_V128A  = _mm_cvtepu16_epi32(Msk_V128);
+      __m128i Msk_V128B  = _mm_cvtepu16_epi32(_mm_srli_si128(Msk_V128, 8));
+      __m128i Wght_V128A = _mm_mullo_epi32(Diff_V128A, Msk_V128A);
+      __m128i Wght_V128B = _mm_mullo_epi32(Diff_V128B, Msk_V128B);
+      __m128i Sum_V128A  = _mm_add_epi64(_mm_cvtepi32_epi64(Wght_V128A), _mm_cvtepi32_epi64(_mm_srli_si128(Wght_V128A, 8)));
+      __m128i Sum_V128B  = _mm_add_epi64(_mm_cvtepi32_epi64(Wght_V128B), _mm_cvtepi32_epi64(_mm_srli_si128(Wght_V128B, 8)));
+      SD_V128            = _mm_add_epi64(SD_V128, _mm_add_epi64(Sum_V128A, Sum_V128B));
+    } //x
+    for(int32 x=Width8; x<Width; x++) { SD += ((int32)Tst[x] - (int32)Ref[x]) * (int32)Msk[x]; }
+    Tst += TstStride;
+    Ref += RefStride;
+    Msk += MskStride;
+  } //y
+
+  SD += xHorVecSum_epi64(SD_V128);
+  return SD;
+}
+uint64 xDistortionSSE::CalcWeightedSSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint16* restrict Msk, int32 Area)
+{
+  //up to 14 bit input, up to 16 bit mask (Diff*Msk in 32 bits, Diff^2*Msk in 64 bits)
+  const int32 Area8 = (int32)((uint32)Area & c_MultipleMask8);
+  __m128i SSD_V128 = _mm_setzero_si128();
+
+  for(int32 i = 0; i < Area8; i += 8)
   {
-    const int32 Width8 = (int32)((uint32)Width & c_MultipleMask8);
-    int64   SD      = 0;
-    __m128i SD_V128 = _mm_setzero_si128();
+    __m128i Tst_V128   = _mm_loadu_si128((__m128i*) & Tst[i]);
+    __m128i Ref_V128   = _mm_loadu_si128((__m128i*) & Ref[i]);
+    __m128i Msk_V128   = _mm_loadu_si128((__m128i*) & Msk[i]);
+    __m128i Diff_V128  = _mm_sub_epi16(Tst_V128, Ref_V128);
+    __m128i Diff_V128A = _mm_cvtepi16_epi32(Diff_V128);
+    __m128i Diff_V128B = _mm_cvtepi16_epi32(_mm_srli_si128(Diff_V128, 8));
+    __m128i Msk_V128A  = _mm_cvtepu16_epi32(Msk_V128);
+    __m128i Msk_V128B  = _mm_cvtepu16_epi32(_mm_srli_si128(Msk_V128, 8));
+    __m128i Pow_V128A  = _mm_mullo_epi32(Diff_V128A, Diff_V128A);
+    __m128i Pow_V128B  = _mm_mullo_epi32(Diff_V128B, Diff_V128B);
+    __m128i Sum_V128A  = _mm_add_epi64(_mm_mul_epu32(Pow_V128A, Msk_V128A), _mm_mul_epu32(_mm_srli_epi64(Pow_V128A, 32), _mm_srli_epi64(Msk_V128A, 32)));
+    __m128i Sum_V128B  = _mm_add_epi64(_mm_mul_epu32(Pow_V128B, Msk_V128B), _mm_mul_epu32(_mm_srli_epi64(Pow_V128B, 32), _mm_srli_epi64(Msk_V128B, 32)));
+    SSD_V128           = _mm_add_epi64(SSD_V128, _mm_add_epi64(Sum_V128A, Sum_V128B));
+  } //i
+  uint64 SSD = (uint64)xHorVecSum_epi64(SSD_V128);
 
-    for(int32 y=0; y<Height; y++)
+  for(int32 i = Area8; i < Area; i++) { SSD += ((uint64)xPow2(((int32)Tst[i]) - ((int32)Ref[i]))) * (uint64)Msk[i]; }
+  return SSD;
+}
+uint64 xDistortionSSE::CalcWeightedSSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint16* restrict Msk, int32 TstStride, int32 RefStride, int32 MskStride, int32 Width, int32 Height)
+{
+  //up to 14 bit input, up to 16 bit mask (Diff*Msk in 32 bits, Diff^2*Msk in 64 bits)
+  const int32 Width8 = (int32)((uint32)Width & c_MultipleMask8);
+  uint64 SSD = 0;
+  __m128i SSD_V128 = _mm_setzero_si128();
+
+  for(int32 y=0; y<Height; y++)
+  {
+    for(int32 x=0; x<Width8; x+=8)
     {
-      for(int32 x=0; x<Width8; x+=8)
-      {
-        __m128i Tst_V128   = _mm_loadu_si128((__m128i*) & Tst[x]);
-        __m128i Ref_V128   = _mm_loadu_si128((__m128i*) & Ref[x]);
-        __m128i Mask_V128  = _mm_loadu_si128((__m128i*) & Mask[x]);
-        __m128i Diff_V128  = _mm_sub_epi16     (Tst_V128 , Ref_V128);
-        __m128i Diff_V128A = _mm_cvtepi16_epi32(Diff_V128);
-        __m128i Diff_V128B = _mm_cvtepi16_epi32(_mm_srli_si128(Diff_V128, 8));
-        __m128i Mask_V128A = _mm_unpacklo_epi16(Mask_V128, _mm_setzero_si128());
-        __m128i Mask_V128B = _mm_unpackhi_epi16(Mask_V128, _mm_setzero_si128());
-        __m128i Wght_V128A = _mm_mullo_epi32   (Diff_V128A, Mask_V128A);
-        __m128i Wght_V128B = _mm_mullo_epi32   (Diff_V128B, Mask_V128B);
-        __m128i Wght_V128  = _mm_add_epi32     (Wght_V128A, Wght_V128B);
-        __m128i Sum_V128A  = _mm_unpacklo_epi32(Wght_V128, _mm_setzero_si128());
-        __m128i Sum_V128B  = _mm_unpackhi_epi32(Wght_V128, _mm_setzero_si128());
-        __m128i Sum_V128   = _mm_add_epi64     (Sum_V128A, Sum_V128B);
-        SD_V128 = _mm_add_epi64(SD_V128, Sum_V128);
-      } //x
-      for(int32 x=Width8; x<Width; x++)
-      {
-        SD += ((int32)Tst[x] - (int32)Ref[x]) * (int32)Mask[x];
-      } //x
-      Tst  += TstStride;
-      Ref += RefStride;
-      Mask += MskStride;
-    } //y
-    SD += _mm_extract_epi64(SD_V128, 0) + _mm_extract_epi64(SD_V128, 1);
-    return SD;
-  }
+      __m128i Tst_V128   = _mm_loadu_si128((__m128i*) & Tst[x]);
+      __m128i Ref_V128   = _mm_loadu_si128((__m128i*) & Ref[x]);
+      __m128i Msk_V128   = _mm_loadu_si128((__m128i*) & Msk[x]);
+      __m128i Diff_V128  = _mm_sub_epi16(Tst_V128, Ref_V128);
+      __m128i Diff_V128A = _mm_cvtepi16_epi32(Diff_V128);
+      __m128i Diff_V128B = _mm_cvtepi16_epi32(_mm_srli_si128(Diff_V128, 8));
+      __m128i Msk_V128A  = _mm_cvtepu16_epi32(Msk_V128);
+      __m128i Msk_V128B  = _mm_cvtepu16_epi32(_mm_srli_si128(Msk_V128, 8));
+      __m128i Pow_V128A  = _mm_mullo_epi32(Diff_V128A, Diff_V128A);
+      __m128i Pow_V128B  = _mm_mullo_epi32(Diff_V128B, Diff_V128B);
+      __m128i Sum_V128A  = _mm_add_epi64(_mm_mul_epu32(Pow_V128A, Msk_V128A), _mm_mul_epu32(_mm_srli_epi64(Pow_V128A, 32), _mm_srli_epi64(Msk_V128A, 32)));
+      __m128i Sum_V128B  = _mm_add_epi64(_mm_mul_epu32(Pow_V128B, Msk_V128B), _mm_mul_epu32(_mm_srli_epi64(Pow_V128B, 32), _mm_srli_epi64(Msk_V128B, 32)));
+      SSD_V128           = _mm_add_epi64(SSD_V128, _mm_add_epi64(Sum_V128A, Sum_V128B));
+    } //x
+    for(int32 x=Width8; x<Width; x++) { SSD += ((uint64)xPow2(((int32)Tst[x]) - ((int32)Ref[x]))) * (uint64)Msk[x]; }
+    Tst += TstStride;
+    Ref += RefStride;
+    Msk += MskStride;
+  } //y
+
+  SSD += (uint64)xHorVecSum_epi64(SSD_V128);
+  return SSD;
 }
-uint64 xDistortionSSE::CalcWeightedSSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint16* restrict Mask, int32 Area)
+int64 xDistortionSSE::CalcWeightedSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint8* restrict Msk, int32 Area)
 {
-  assert(0); //TODO - NOT TESTED
-  const int32 Area8    = (int32)((uint32)Area & c_MultipleMask8);
-  __m128i     SSD_V128 = _mm_setzero_si128();
+  //up to 14 bit input, 8 bit mask (Diff*Msk pairs summed by madd fit in 32 bits)
+  const int32 Area8 = (int32)((uint32)Area & c_MultipleMask8);
+  __m128i SD_V128 = _mm_setzero_si128();
+
+  for(int32 i = 0; i < Area8; i += 8)
+  {
+    __m128i Tst_V128  = _mm_loadu_si128((__m128i*) & Tst[i]);
+    __m128i Ref_V128  = _mm_loadu_si128((__m128i*) & Ref[i]);
+    __m128i Msk_V128  = _mm_cvtepu8_epi16(_mm_loadl_epi64((__m128i*) & Msk[i]));
+    __m128i Diff_V128 = _mm_sub_epi16 (Tst_V128, Ref_V128);
+    __m128i Wght_V128 = _mm_madd_epi16(Diff_V128, Msk_V128);
+    SD_V128           = _mm_add_epi64(SD_V128, _mm_add_epi64(_mm_cvtepi32_epi64(Wght_V128), _mm_cvtepi32_epi64(_mm_srli_si128(Wght_V128, 8))));
+  } //i
+  int64 SD = xHorVecSum_epi64(SD_V128);
+
+  for(int32 i = Area8; i < Area; i++) { SD += ((int32)Tst[i] - (int32)Ref[i]) * (int32)Msk[i]; }
+  return SD;
+}
+uint64 xDistortionSSE::CalcWeightedSSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint8* restrict Msk, int32 Area)
+{
+  //up to 14 bit input, 8 bit mask (Diff^2 in 32 bits, Diff^2*Msk in 64 bits)
+  const int32 Area8 = (int32)((uint32)Area & c_MultipleMask8);
+  __m128i SSD_V128 = _mm_setzero_si128();
 
   for(int32 i = 0; i < Area8; i += 8)
   {
     __m128i Tst_V128   = _mm_loadu_si128((__m128i*) & Tst[i]);
     __m128i Ref_V128   = _mm_loadu_si128((__m128i*) & Ref[i]);
-    __m128i Mask_V128  = _mm_loadu_si128((__m128i*) & Mask[i]);
-    __m128i Diff_V128  = _mm_sub_epi16     (Tst_V128 , Ref_V128);
+    __m128i Msk_V128   = _mm_loadl_epi64((__m128i*) & Msk[i]);
+    __m128i Diff_V128  = _mm_sub_epi16(Tst_V128, Ref_V128);
     __m128i Diff_V128A = _mm_cvtepi16_epi32(Diff_V128);
     __m128i Diff_V128B = _mm_cvtepi16_epi32(_mm_srli_si128(Diff_V128, 8));
-    __m128i Pow_V128A  = _mm_mullo_epi32   (Diff_V128A, Diff_V128A);
-    __m128i Pow_V128B  = _mm_mullo_epi32   (Diff_V128B, Diff_V128B);
-    __m128i Mask_V128A = _mm_unpacklo_epi16(Mask_V128, _mm_setzero_si128());
-    __m128i Mask_V128B = _mm_unpackhi_epi16(Mask_V128, _mm_setzero_si128());
-    __m128i Wght_V128A = _mm_mullo_epi32   (Pow_V128A, Mask_V128A);
-    __m128i Wght_V128B = _mm_mullo_epi32   (Pow_V128B, Mask_V128B);
-    __m128i Wght_V128  = _mm_add_epi32     (Wght_V128A, Wght_V128B);
-    __m128i Sum_V128A  = _mm_unpacklo_epi32(Wght_V128, _mm_setzero_si128());
-    __m128i Sum_V128B  = _mm_unpackhi_epi32(Wght_V128, _mm_setzero_si128());
-    __m128i Sum_V128   = _mm_add_epi64     (Sum_V128A, Sum_V128B);
-    SSD_V128 = _mm_add_epi64(SSD_V128, Sum_V128);
-  }
-  uint64 SSD = _mm_extract_epi64(SSD_V128, 0) + _mm_extract_epi64(SSD_V128, 1);
+    __m128i Msk_V128A  = _mm_cvtepu8_epi32(Msk_V128);
+    __m128i Msk_V128B  = _mm_cvtepu8_epi32(_mm_srli_si128(Msk_V128, 4));
+    __m128i Pow_V128A  = _mm_mullo_epi32(Diff_V128A, Diff_V128A);
+    __m128i Pow_V128B  = _mm_mullo_epi32(Diff_V128B, Diff_V128B);
+    __m128i Sum_V128A  = _mm_add_epi64(_mm_mul_epu32(Pow_V128A, Msk_V128A), _mm_mul_epu32(_mm_srli_epi64(Pow_V128A, 32), _mm_srli_epi64(Msk_V128A, 32)));
+    __m128i Sum_V128B  = _mm_add_epi64(_mm_mul_epu32(Pow_V128B, Msk_V128B), _mm_mul_epu32(_mm_srli_epi64(Pow_V128B, 32), _mm_srli_epi64(Msk_V128B, 32)));
+    SSD_V128           = _mm_add_epi64(SSD_V128, _mm_add_epi64(Sum_V128A, Sum_V128B));
+  } //i
+  uint64 SSD = (uint64)xHorVecSum_epi64(SSD_V128);
 
-  for(int32 i = Area8; i < Area; i++) { SSD += ((uint64)xPow2(((int32)Tst[i]) - ((int32)Ref[i]))) * (uint64)Mask[i]; }
+  for(int32 i = Area8; i < Area; i++) { SSD += ((uint64)xPow2(((int32)Tst[i]) - ((int32)Ref[i]))) * (uint64)Msk[i]; }
   return SSD;
 }
-uint64 xDistortionSSE::CalcWeightedSSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint16* restrict Mask, int32 TstStride, int32 RefStride, int32 MskStride, int32 Width, int32 Height)
+int64 xDistortionSSE::CalcMaskedSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint64* restrict MskBits, int32 Area)
 {
-  assert(0); //TODO - NOT TESTED
-  if(((uint32)Width & c_RemainderMask8)==0) //Width%8==0 - fast path without tail
+  //up to 14 bit input, groups of 8 masked out pels are skipped
+  const int32   Area8     = (int32)((uint32)Area & c_MultipleMask8);
+  const __m128i One_V128  = _mm_set1_epi16(1);
+  const __m128i Bits_V128 = _mm_setr_epi16(0x0001, 0x0002, 0x0004, 0x0008, 0x0010, 0x0020, 0x0040, 0x0080);
+  __m128i SD_V128 = _mm_setzero_si128();
+
+  for(int32 i = 0; i < Area8; i += 8)
   {
-    __m128i SSD_V128 = _mm_setzero_si128();
-    for(int32 y=0; y<Height; y++)
-    {
-      for(int32 x=0; x<Width; x+=8)
-      {
-        __m128i Tst_V128   = _mm_loadu_si128((__m128i*) & Tst[x]);
-        __m128i Ref_V128   = _mm_loadu_si128((__m128i*) & Ref[x]);
-        __m128i Mask_V128  = _mm_loadu_si128((__m128i*) & Mask[x]);
-        __m128i Diff_V128  = _mm_sub_epi16     (Tst_V128 , Ref_V128);
-        __m128i Diff_V128A = _mm_cvtepi16_epi32(Diff_V128);
-        __m128i Diff_V128B = _mm_cvtepi16_epi32(_mm_srli_si128(Diff_V128, 8));
-        __m128i Pow_V128A  = _mm_mullo_epi32   (Diff_V128A, Diff_V128A);
-        __m128i Pow_V128B  = _mm_mullo_epi32   (Diff_V128B, Diff_V128B);
-        __m128i Mask_V128A = _mm_unpacklo_epi16(Mask_V128, _mm_setzero_si128());
-        __m128i Mask_V128B = _mm_unpackhi_epi16(Mask_V128, _mm_setzero_si128());
-        __m128i Wght_V128A = _mm_mullo_epi32   (Pow_V128A, Mask_V128A);
-        __m128i Wght_V128B = _mm_mullo_epi32   (Pow_V128B, Mask_V128B);
-        __m128i Wght_V128  = _mm_add_epi32     (Wght_V128A, Wght_V128B);
-        __m128i Sum_V128A  = _mm_unpacklo_epi32(Wght_V128, _mm_setzero_si128());
-        __m128i Sum_V128B  = _mm_unpackhi_epi32(Wght_V128, _mm_setzero_si128());
-        __m128i Sum_V128   = _mm_add_epi64     (Sum_V128A, Sum_V128B);
-        SSD_V128 = _mm_add_epi64(SSD_V128, Sum_V128);
-      } //x
-      Tst  += TstStride;
-      Ref += RefStride;
-      Mask += MskStride;
-    } //y
-    uint64 SSD = _mm_extract_epi64(SSD_V128, 0) + _mm_extract_epi64(SSD_V128, 1);
-    return SSD;
-  }
-  else //any other
+    const uint32 Bits8 = (uint32)(MskBits[i >> 6] >> (i & 63)) & 0xFF;
+    if(Bits8 == 0) { continue; }
+    __m128i Msk_V128  = _mm_cmpeq_epi16(_mm_and_si128(_mm_set1_epi16((int16)Bits8), Bits_V128), Bits_V128);
+    __m128i Tst_V128  = _mm_loadu_si128((__m128i*) & Tst[i]);
+    __m128i Ref_V128  = _mm_loadu_si128((__m128i*) & Ref[i]);
+    __m128i Diff_V128 = _mm_and_si128 (_mm_sub_epi16(Tst_V128, Ref_V128), Msk_V128);
+    __m128i Sum_V128  = _mm_madd_epi16(Diff_V128, One_V128);
+    SD_V128           = _mm_add_epi64(SD_V128, _mm_add_epi64(_mm_cvtepi32_epi64(Sum_V128), _mm_cvtepi32_epi64(_mm_srli_si128(Sum_V128, 8))));
+  } //i
+  int64 SD = xHorVecSum_epi64(SD_V128);
+
+  for(int32 i = Area8; i < Area; i++) { if((MskBits[i >> 6] >> (i & 63)) & 1) { SD += (int32)Tst[i] - (int32)Ref[i]; } }
+  return SD;
+}
+uint64 xDistortionSSE::CalcMaskedSSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint64* restrict MskBits, int32 Area)
+{
+  //up to 14 bit input, groups of 8 masked out pels are skipped
+  const int32   Area8     = (int32)((uint32)Area & c_MultipleMask8);
+  const __m128i Bits_V128 = _mm_setr_epi16(0x0001, 0x0002, 0x0004, 0x0008, 0x0010, 0x0020, 0x0040, 0x0080);
+  __m128i SSD_V128 = _mm_setzero_si128();
+
+  for(int32 i = 0; i < Area8; i += 8)
   {
-    const int32 Width8 = (int32)((uint32)Width & c_MultipleMask8);
-    uint64  SSD = 0;
-    __m128i SSD_V128 = _mm_setzero_si128();
+    const uint32 Bits8 = (uint32)(MskBits[i >> 6] >> (i & 63)) & 0xFF;
+    if(Bits8 == 0) { continue; }
+    __m128i Msk_V128  = _mm_cmpeq_epi16(_mm_and_si128(_mm_set1_epi16((int16)Bits8), Bits_V128), Bits_V128);
+    __m128i Tst_V128  = _mm_loadu_si128((__m128i*) & Tst[i]);
+    __m128i Ref_V128  = _mm_loadu_si128((__m128i*) & Ref[i]);
+    __m128i Diff_V128 = _mm_and_si128     (_mm_sub_epi16(Tst_V128, Ref_V128), Msk_V128);
+    __m128i Pow_V128  = _mm_madd_epi16    (Diff_V128, Diff_V128);
+    __m128i Pow_V128A = _mm_unpacklo_epi32(Pow_V128 , _mm_setzero_si128());
+    __m128i Pow_V128B = _mm_unpackhi_epi32(Pow_V128 , _mm_setzero_si128());
+    SSD_V128          = _mm_add_epi64     (SSD_V128, _mm_add_epi64(Pow_V128A, Pow_V128B));
+  } //i
+  uint64 SSD = (uint64)xHorVecSum_epi64(SSD_V128);
 
-    for(int32 y=0; y<Height; y++)
-    {
-      for(int32 x=0; x<Width8; x+=8)
-      {
-        __m128i Tst_V128   = _mm_loadu_si128((__m128i*) & Tst[x]);
-        __m128i Ref_V128   = _mm_loadu_si128((__m128i*) & Ref[x]);
-        __m128i Mask_V128  = _mm_loadu_si128((__m128i*) & Mask[x]);
-        __m128i Diff_V128  = _mm_sub_epi16     (Tst_V128 , Ref_V128);
-        __m128i Diff_V128A = _mm_cvtepi16_epi32(Diff_V128);
-        __m128i Diff_V128B = _mm_cvtepi16_epi32(_mm_srli_si128(Diff_V128, 8));
-        __m128i Pow_V128A  = _mm_mullo_epi32   (Diff_V128A, Diff_V128A);
-        __m128i Pow_V128B  = _mm_mullo_epi32   (Diff_V128B, Diff_V128B);
-        __m128i Mask_V128A = _mm_unpacklo_epi16(Mask_V128, _mm_setzero_si128());
-        __m128i Mask_V128B = _mm_unpackhi_epi16(Mask_V128, _mm_setzero_si128());
-        __m128i Wght_V128A = _mm_mullo_epi32   (Pow_V128A, Mask_V128A);
-        __m128i Wght_V128B = _mm_mullo_epi32   (Pow_V128B, Mask_V128B);
-        __m128i Wght_V128  = _mm_add_epi32     (Wght_V128A, Wght_V128B);
-        __m128i Sum_V128A  = _mm_unpacklo_epi32(Wght_V128, _mm_setzero_si128());
-        __m128i Sum_V128B  = _mm_unpackhi_epi32(Wght_V128, _mm_setzero_si128());
-        __m128i Sum_V128   = _mm_add_epi64     (Sum_V128A, Sum_V128B);
-        SSD_V128 = _mm_add_epi64(SSD_V128, Sum_V128);
-      }
-      for(int32 x= Width8; x<Width; x++)
-      {
-        SSD += ((uint64)xPow2(((int32)Tst[x]) - ((int32)Ref[x]))) * (uint64)Mask[x];
-      }
-      Tst  += TstStride;
-      Ref += RefStride;
-      Mask += MskStride;
-    } //y
-    SSD += _mm_extract_epi64(SSD_V128, 0) + _mm_extract_epi64(SSD_V128, 1);
-    return SSD;
-  }
+  for(int32 i = Area8; i < Area; i++) { if((MskBits[i >> 6] >> (i & 63)) & 1) { SSD += (uint64)xPow2(((int32)Tst[i]) - ((int32)Ref[i])); } }
+  return SSD;
 }
 
 //===============================================================================================================================================================================================================
@@ -6,6 +6,7 @@
 #pragma once
 
 #include "xCommonDefCORE.h"
+#include <tuple>
 
 #if X_SIMD_CAN_USE_SSE
 
@@ -24,10 +25,19 @@ public:
   static uint64 CalcSSD(const uint16* restrict Tst, const uint16* restrict Ref,                                   int32 Area               );
   static uint64 CalcSSD(const uint16* restrict Tst, const uint16* restrict Ref, int32 TstStride, int32 RefStride, int32 Width, int32 Height);
 
+  //fused SD and SSD (single pass over both buffers)
+  static std::tuple<int32, uint64> CalcSDSSD(const uint16* restrict Tst, const uint16* restrict Ref, int32 Area);
+
   static  int64 CalcWeightedSD (const uint16* restrict Tst, const uint16* restrict Ref, const uint16* restrict Mask,                                                    int32 Area               );
   static  int64 CalcWeightedSD (const uint16* restrict Tst, const uint16* restrict Ref, const uint16* restrict Mask, int32 TstStride, int32 RefStride, int32 MskStride, int32 Width, int32 Height);
   static uint64 CalcWeightedSSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint16* restrict Mask,                                                    int32 Area               );
   static uint64 CalcWeightedSSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint16* restrict Mask, int32 TstStride, int32 RefStride, int32 MskStride, int32 Width, int32 Height);
+
+  //compact masks - 8-bit weights or binary mask packed as 1 bit per pel (LSB first)
+  static  int64 CalcWeightedSD (const uint16* restrict Tst, const uint16* restrict Ref, const uint8*  restrict Mask    , int32 Area);
+  static uint64 CalcWeightedSSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint8*  restrict Mask    , int32 Area);
+  static  int64 CalcMaskedSD   (const uint16* restrict Tst, const uint16* restrict Ref, const uint64* restrict MaskBits, int32 Area);
+  static uint64 CalcMaskedSSD  (const uint16* restrict Tst, const uint16* restrict Ref, const uint64* restrict MaskBits, int32 Area);
 };
 
 //===============================================================================================================================================================================================================
@@ -60,6 +60,18 @@ uint64 xDistortionSTD::CalcSSD(const uint16* restrict Tst, const uint16* restric
   }
   return SSD;
 }
+std::tuple<int32, uint64> xDistortionSTD::CalcSDSSD(const uint16* restrict Tst, const uint16* restrict Ref, int32 Area)
+{
+  int32  SD  = 0;
+  uint64 SSD = 0;
+  for(int32 i=0; i < Area; i++)
+  {
+    const int32 Diff = (int32)Tst[i] - (int32)Ref[i];
+    SD  += Diff;
+    SSD += (uint64)xPow2(Diff);
+  }
+  return { SD, SSD };
+}
 int64 xDistortionSTD::CalcWeightedSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint16* restrict Msk, int32 Area)
 {
   int64 SD = 0;
@@ -96,6 +108,30 @@ uint64 xDistortionSTD::CalcWeightedSSD(const uint16* restrict Tst, const uint16*
   }
   return SSD;
 }
+int64 xDistortionSTD::CalcWeightedSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint8* restrict Msk, int32 Area)
+{
+  int64 SD = 0;
+  for(int32 i=0; i < Area; i++) { SD += ((int32)Tst[i] - (int32)Ref[i]) * (int32)Msk[i]; }
+  return SD;
+}
+uint64 xDistortionSTD::CalcWeightedSSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint8* restrict Msk, int32 Area)
+{
+  uint64 SSD = 0;
+  for(int32 i=0; i < Area; i++) { SSD += ((uint64)xPow2(((int32)Tst[i]) - ((int32)Ref[i]))) * (uint64)Msk[i]; }
+  return SSD;
+}
+int64 xDistortionSTD::CalcMaskedSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint64* restrict MskBits, int32 Area)
+{
+  int64 SD = 0;
+  for(int32 i=0; i < Area; i++) { if((MskBits[i >> 6] >> (i & 63)) & 1) { SD += (int32)Tst[i] - (int32)Ref[i]; } }
+  return SD;
+}
+uint64 xDistortionSTD::CalcMaskedSSD(const uint16* restrict Tst, const uint16* restrict Ref, const uint64* restrict MskBits, int32 Area)
+{
+  uint64 SSD = 0;
+  for(int32 i=0; i < Area; i++) { if((MskBits[i >> 6] >> (i & 63)) & 1) { SSD += (uint64)xPow2(((int32)Tst[i]) - ((int32)Ref[i])); } }
+  return SSD;
+}
 
 //===============================================================================================================================================================================================================
 
@@ -17,14 +17,25 @@ namespace PMBB_NAMESPACE {
 //---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // xPicP - general functions
 //---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-void xPicP::create(int32V2 Size, int32 BitDepth, int32 Margin)
+void xPicP::create(int32V2 Size, int32 BitDepth, int32 Margin, eCrF ChromaFormat)
 {
+  assert(ChromaFormat == eCrF::CF444 || ChromaFormat == eCrF::CF422 || ChromaFormat == eCrF::CF420);
   xInit(Size, BitDepth, Margin, c_DefNumCmps, sizeof(uint16));
 
+  m_ChromaFormat = ChromaFormat;
+  for(int32 c = 0; c < c_MaxNumCmps; c++)
+  {
+    const bool IsChroma = c == (int32)eCmp::CB || c == (int32)eCmp::CR;
+    m_CmpShiftX     [c] = IsChroma && ChromaFormat != eCrF::CF444 ? 1 : 0;
+    m_CmpShiftY     [c] = IsChroma && ChromaFormat == eCrF::CF420 ? 1 : 0;
+    m_CmpStride     [c] = (m_Width >> m_CmpShiftX[c]) + (m_Margin << 1);
+    m_CmpBuffNumPels[c] = m_CmpStride[c] * ((m_Height >> m_CmpShiftY[c]) + (m_Margin << 1));
+  }
+
   for(int32 c = 0; c < m_NumCmps; c++)
   {
-    m_Buffer[c] = (uint16*)xMemory::xAlignedMallocPageAuto(m_BuffCmpNumBytes);
-    m_Origin[c] = m_Buffer[c] + (m_Margin * m_Stride) + m_Margin;
+    m_Buffer[c] = (uint16*)xMemory::xAlignedMallocPageAuto(m_CmpBuffNumPels[c] * sizeof(uint16));
+    m_Origin[c] = m_Buffer[c] + (m_Margin * m_CmpStride[c]) + m_Margin;
   }  
 }
 void xPicP::destroy()
@@ -34,11 +45,13 @@ void xPicP::destroy()
     if(m_Buffer[c] != nullptr) { xMemory::xAlignedFree(m_Buffer[c]); m_Buffer[c] = nullptr; }
     m_Origin[c] = nullptr;
   }
+  m_ChromaFormat = eCrF::CF444;
+  for(int32 c = 0; c < c_MaxNumCmps; c++) { m_CmpShiftX[c] = 0; m_CmpShiftY[c] = 0; m_CmpStride[c] = NOT_VALID; m_CmpBuffNumPels[c] = NOT_VALID; }
   xUnInit();
 }
 void xPicP::clear()
 {
-  for(int32 c=0; c < m_NumCmps; c++) { memset(m_Buffer[c], 0, m_BuffCmpNumBytes); }
+  for(int32 c=0; c < m_NumCmps; c++) { memset(m_Buffer[c], 0, m_CmpBuffNumPels[c] * sizeof(uint16)); }
   m_POC              = NOT_VALID;
   m_Timestamp        = NOT_VALID;
   m_IsMarginExtended = false;
@@ -46,7 +59,7 @@ void xPicP::clear()
 void xPicP::copy(const xPicP* Src)
 {
   assert(Src!=nullptr && isCompatible(Src));
-  for(int32 c=0; c < m_NumCmps; c++) { memcpy(m_Buffer[c], Src->m_Buffer[c], m_BuffCmpNumBytes); }
+  for(int32 c=0; c < m_NumCmps; c++) { memcpy(m_Buffer[c], Src->m_Buffer[c], m_CmpBuffNumPels[c] * sizeof(uint16)); }
   m_IsMarginExtended = Src->m_IsMarginExtended;
 }
 void xPicP::fill(uint16 Value)
@@ -56,7 +69,7 @@ void xPicP::fill(uint16 Value)
 }
 void xPicP::fill(uint16 Value, eCmp CmpId)
 { 
-  xPixelOps::Fill(m_Buffer[(int32)CmpId], Value, m_BuffCmpNumPels);
+  xPixelOps::Fill(m_Buffer[(int32)CmpId], Value, m_CmpBuffNumPels[(int32)CmpId]);
   m_IsMarginExtended = true;
 }
 bool xPicP::check(const std::string& Name) const
@@ -64,7 +77,7 @@ bool xPicP::check(const std::string& Name) const
   boolV4 Correct = xMakeVec4(true);
   for(int32 c = 0; c < m_NumCmps; c++)
   { 
-    Correct[c] = xPixelOps::CheckIfInRange(m_Origin[c], m_Stride, m_Width, m_Height, m_BitDepth);
+    Correct[c] = xPixelOps::CheckIfInRange(m_Origin[c], m_CmpStride[c], getWidth((eCmp)c), getHeight((eCmp)c), m_BitDepth);
   }
 
   for(int32 c = 0; c < m_NumCmps; c++)
@@ -72,7 +85,7 @@ bool xPicP::check(const std::string& Name) const
     if(!Correct[c])
     {
       fmt::print("FILE BROKEN " + Name + " (CMP={:d})\n", c);
-      std::string Msg = xPixelOps::FindOutOfRange(m_Origin[c], m_Stride, m_Width, m_Height, m_BitDepth, -1);
+      std::string Msg = xPixelOps::FindOutOfRange(m_Origin[c], m_CmpStride[c], getWidth((eCmp)c), getHeight((eCmp)c), m_BitDepth, -1);
       fmt::print(Msg);
       return false;
     }
@@ -84,13 +97,13 @@ void xPicP::conceal()
 {
   for(int32 c = 0; c < m_NumCmps; c++)
   {
-    xPixelOps::ClipToRange(m_Origin[c], m_Stride, m_Width, m_Height, m_BitDepth);
+    xPixelOps::ClipToRange(m_Origin[c], m_CmpStride[c], getWidth((eCmp)c), getHeight((eCmp)c), m_BitDepth);
   }
   m_IsMarginExtended = false;
 }
 void xPicP::extend()
 {
-  for(int32 c = 0; c < m_NumCmps; c++) { xPixelOps::ExtendMargin(m_Origin[c], m_Stride, m_Width, m_Height, m_Margin); }
+  for(int32 c = 0; c < m_NumCmps; c++) { xPixelOps::ExtendMargin(m_Origin[c], m_CmpStride[c], getWidth((eCmp)c), getHeight((eCmp)c), m_Margin); }
   m_IsMarginExtended = true;
 }
 
@@ -103,7 +116,7 @@ bool xPicP::equalPic(const xPicP* Src) const
 bool xPicP::equalCmp(const xPicP* Src, eCmp CmpId) const
 {
   assert(Src != nullptr && isCompatible(Src));
-  return xPixelOps::CompareEqual(Src->getAddr(CmpId), m_Origin[(int32)CmpId], Src->getStride(), m_Stride, m_Width, m_Height);
+  return xPixelOps::CompareEqual(Src->getAddr(CmpId), m_Origin[(int32)CmpId], Src->getStride(CmpId), getStride(CmpId), getWidth(CmpId), getHeight(CmpId));
 }
 boolV4 xPicP::equalCmps(const xPicP* Src) const
 {
@@ -120,7 +133,7 @@ bool xPicP::bindBuffer(uint16* Buffer, eCmp CmpId)
 {
   assert(Buffer!=nullptr); if(m_Buffer[(int32)CmpId]) { return false; }
   m_Buffer[(int32)CmpId] = Buffer;
-  m_Origin[(int32)CmpId] = m_Buffer[(int32)CmpId] + (m_Margin * m_Stride) + m_Margin;
+  m_Origin[(int32)CmpId] = m_Buffer[(int32)CmpId] + (m_Margin * m_CmpStride[(int32)CmpId]) + m_Margin;
   return true;
 }
 uint16* xPicP::unbindBuffer(eCmp CmpId)
@@ -135,15 +148,15 @@ bool xPicP::swapBuffer(uint16*& Buffer, eCmp CmpId)
 {
   assert(Buffer!=nullptr); if(m_Buffer[(int32)CmpId]==nullptr) { return false; }
   std::swap(m_Buffer[(int32)CmpId], Buffer);
-  m_Origin[(int32)CmpId] = m_Buffer[(int32)CmpId] + (m_Margin * m_Stride) + m_Margin;
+  m_Origin[(int32)CmpId] = m_Buffer[(int32)CmpId] + (m_Margin * m_CmpStride[(int32)CmpId]) + m_Margin;
   return true;
 }
 bool xPicP::swapBuffer(xPicP* TheOther, eCmp CmpId)
 {
   assert(TheOther != nullptr); if(TheOther==nullptr || !isCompatible(TheOther)) { return false; }
   std::swap(this->m_Buffer[(int32)CmpId], TheOther->m_Buffer[(int32)CmpId]);
-  this    ->m_Origin[(int32)CmpId] = this    ->m_Buffer[(int32)CmpId] + (this    ->m_Margin * this    ->m_Stride) + this    ->m_Margin;
-  TheOther->m_Origin[(int32)CmpId] = TheOther->m_Buffer[(int32)CmpId] + (TheOther->m_Margin * TheOther->m_Stride) + TheOther->m_Margin;
+  this    ->m_Origin[(int32)CmpId] = this    ->m_Buffer[(int32)CmpId] + (this    ->m_Margin * this    ->m_CmpStride[(int32)CmpId]) + this    ->m_Margin;
+  TheOther->m_Origin[(int32)CmpId] = TheOther->m_Buffer[(int32)CmpId] + (TheOther->m_Margin * TheOther->m_CmpStride[(int32)CmpId]) + TheOther->m_Margin;
   return true;
 }
 bool xPicP::swapBuffers(xPicP* TheOther)
@@ -158,6 +171,7 @@ bool xPicP::swapBuffers(xPicP* TheOther)
 bool xPicP::swapComponents(eCmp CmpIdA, eCmp CmpIdB)
 {
   if(m_Buffer[(int32)CmpIdA] == nullptr || m_Buffer[(int32)CmpIdB] == nullptr) { return false; }
+  if(m_CmpStride[(int32)CmpIdA] != m_CmpStride[(int32)CmpIdB] || m_CmpShiftY[(int32)CmpIdA] != m_CmpShiftY[(int32)CmpIdB]) { return false; }
   std::swap(m_Buffer[(int32)CmpIdA], m_Buffer[(int32)CmpIdB]);
   std::swap(m_Origin[(int32)CmpIdA], m_Origin[(int32)CmpIdB]);
   return true;
@@ -200,14 +214,14 @@ void xPicI::fill(uint16 Value)
 }
 void xPicI::rearrangeFromPlanar(const xPicP* Planar)
 {
-  assert(isCompatible(Planar));
+  assert(isCompatible(Planar) && !Planar->isChromaSubsampled());
   const int32 ExtWidth  = m_Width  + (m_Margin << 1);
   const int32 ExtHeight = m_Height + (m_Margin << 1);
   xPixelOps::AOS4fromSOA3(m_Buffer, Planar->getBuffer(eCmp::C0), Planar->getBuffer(eCmp::C1), Planar->getBuffer(eCmp::C2), 0, m_Stride * c_MaxNumCmps, Planar->getStride(), ExtWidth, ExtHeight);
 }
 void xPicI::rearrangeToPlanar(xPicP* Planar)
 {
-  assert(isCompatible(Planar));
+  assert(isCompatible(Planar) && !Planar->isChromaSubsampled());
   const int32 ExtWidth  = m_Width  + (m_Margin << 1);
   const int32 ExtHeight = m_Height + (m_Margin << 1);
   xPixelOps::SOA3fromAOS4(Planar->getBuffer(eCmp::C0), Planar->getBuffer(eCmp::C1), Planar->getBuffer(eCmp::C2), m_Buffer, Planar->getStride(), m_Stride * c_MaxNumCmps, ExtWidth, ExtHeight);
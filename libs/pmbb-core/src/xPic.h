@@ -21,20 +21,29 @@ protected:
   uint16* m_Buffer[c_MaxNumCmps] = { nullptr, nullptr, nullptr, nullptr }; //picture buffer
   uint16* m_Origin[c_MaxNumCmps] = { nullptr, nullptr, nullptr, nullptr }; //pel origin, pel access -> m_PelOrg[y*m_PelStride + x]
 
+  //chroma planes can be stored in native (subsampled) resolution - CF444 means all planes have size of luma plane
+  eCrF    m_ChromaFormat                 = eCrF::CF444;
+  int32   m_CmpShiftX     [c_MaxNumCmps] = { 0, 0, 0, 0 }; //log2 of horizontal subsampling factor
+  int32   m_CmpShiftY     [c_MaxNumCmps] = { 0, 0, 0, 0 }; //log2 of vertical subsampling factor
+  int32   m_CmpStride     [c_MaxNumCmps] = { NOT_VALID, NOT_VALID, NOT_VALID, NOT_VALID };
+  int32   m_CmpBuffNumPels[c_MaxNumCmps] = { NOT_VALID, NOT_VALID, NOT_VALID, NOT_VALID };
+
 public:
   //constructors $ destructors
   xPicP () { };
   xPicP (int32V2 Size, int32 BitDepth, int32 Margin = c_DefMargin) { create(Size, BitDepth, Margin); }
+  xPicP (int32V2 Size, int32 BitDepth, int32 Margin, eCrF ChromaFormat) { create(Size, BitDepth, Margin, ChromaFormat); }
   ~xPicP() { destroy(); }
 
   //genral functions
-  void   create (int32V2 Size, int32 BitDepth, int32 Margin = c_DefMargin);
-  void   create (const xPicP *Ref) { create(Ref->getSize(), Ref->getBitDepth(), Ref->getMargin()); }
+  void   create (int32V2 Size, int32 BitDepth, int32 Margin = c_DefMargin) { create(Size, BitDepth, Margin, eCrF::CF444); }
+  void   create (int32V2 Size, int32 BitDepth, int32 Margin, eCrF ChromaFormat); //ChromaFormat = CF444, CF422 or CF420
+  void   create (const xPicP *Ref) { create(Ref->getSize(), Ref->getBitDepth(), Ref->getMargin(), Ref->getChromaFormat()); }
   void   destroy();
 
   void   clear  (                            );
   void   copy   (const xPicP* Src            );
-  void   copy   (const xPicP* Src, eCmp CmpId) { assert(isCompatible(Src)); xMemcpyX(m_Buffer[(int32)CmpId], Src->m_Buffer[(int32)CmpId], m_BuffCmpNumPels); }
+  void   copy   (const xPicP* Src, eCmp CmpId) { assert(isCompatible(Src)); xMemcpyX(m_Buffer[(int32)CmpId], Src->m_Buffer[(int32)CmpId], m_CmpBuffNumPels[(int32)CmpId]); }
   void   fill   (uint16 Value                );
   void   fill   (uint16 Value    , eCmp CmpId);
   bool   check  (const std::string& Name     )  const;
@@ -45,17 +54,36 @@ public:
   bool   equalCmp (const xPicP* Src, eCmp CmpId)  const;
   boolV4 equalCmps(const xPicP* Src)  const;
 
+  //chroma format & per component geometry (differs from luma geometry for subsampled chroma planes only)
+  using xPicCommon::isCompatible;
+  using xPicCommon::getWidth;
+  using xPicCommon::getHeight;
+  using xPicCommon::getSize;
+  using xPicCommon::getArea;
+  inline bool          isSameChromaFormat(const xPicP* Pic) const { return m_ChromaFormat == Pic->m_ChromaFormat; }
+  inline bool          isCompatible      (const xPicP* Pic) const { return xPicCommon::isCompatible(Pic) && isSameChromaFormat(Pic); }
+  inline eCrF          getChromaFormat   (                ) const { return m_ChromaFormat; }
+  inline bool          isChromaSubsampled(                ) const { return m_ChromaFormat != eCrF::CF444; }
+  inline int32         getCmpShiftX(eCmp CmpId) const { return m_CmpShiftX[(int32)CmpId]; }
+  inline int32         getCmpShiftY(eCmp CmpId) const { return m_CmpShiftY[(int32)CmpId]; }
+  inline int32         getWidth (eCmp CmpId) const { return m_Width  >> m_CmpShiftX[(int32)CmpId]; }
+  inline int32         getHeight(eCmp CmpId) const { return m_Height >> m_CmpShiftY[(int32)CmpId]; }
+  inline int32V2       getSize  (eCmp CmpId) const { return int32V2(getWidth(CmpId), getHeight(CmpId)); }
+  inline int32         getArea  (eCmp CmpId) const { return getWidth(CmpId) * getHeight(CmpId); }
+
   //access picture data
   inline int32         getStride(                            ) const { return m_Stride              ; }
+  inline int32         getStride(                  eCmp CmpId) const { return m_CmpStride[(int32)CmpId]; }
   inline int32         getPitch (                            ) const { return 1                     ; }  
   inline uint16*       getAddr  (                  eCmp CmpId)       { return m_Origin[(int32)CmpId]; }
   inline const uint16* getAddr  (                  eCmp CmpId) const { return m_Origin[(int32)CmpId]; }
   inline int32         getOffset(int32V2 Position            ) const { return Position.getY() * m_Stride + Position.getX(); }
-  inline uint16*       getAddr  (int32V2 Position, eCmp CmpId)       { return getAddr(CmpId) + getOffset(Position); }
-  inline const uint16* getAddr  (int32V2 Position, eCmp CmpId) const { return getAddr(CmpId) + getOffset(Position); }
+  inline int32         getOffset(int32V2 Position, eCmp CmpId) const { return Position.getY() * m_CmpStride[(int32)CmpId] + Position.getX(); }
+  inline uint16*       getAddr  (int32V2 Position, eCmp CmpId)       { return getAddr(CmpId) + getOffset(Position, CmpId); }
+  inline const uint16* getAddr  (int32V2 Position, eCmp CmpId) const { return getAddr(CmpId) + getOffset(Position, CmpId); }
   //slow pel access
-  inline uint16&       accessPel(int32V2 Position, eCmp CmpId)       { return *(getAddr(CmpId) + getOffset(Position)); }
-  inline const uint16& accessPel(int32V2 Position, eCmp CmpId) const { return *(getAddr(CmpId) + getOffset(Position)); }
+  inline uint16&       accessPel(int32V2 Position, eCmp CmpId)       { return *(getAddr(CmpId) + getOffset(Position, CmpId)); }
+  inline const uint16& accessPel(int32V2 Position, eCmp CmpId) const { return *(getAddr(CmpId) + getOffset(Position, CmpId)); }
   inline uint16&       accessPel(int32   Offset  , eCmp CmpId)       { return *(getAddr(CmpId) + Offset); }
   inline const uint16& accessPel(int32   Offset  , eCmp CmpId) const { return *(getAddr(CmpId) + Offset); }
 
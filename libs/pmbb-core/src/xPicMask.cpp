@@ -0,0 +1,143 @@
+﻿/*
+    SPDX-FileCopyrightText: 2019-2024 Jakub Stankowski <jakub.stankowski@put.poznan.pl>
+    SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "xPicMask.h"
+#include "xMemory.h"
+#include "xPixelOps.h"
+#include <cassert>
+#include <cstring>
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+// xPicMask
+//===============================================================================================================================================================================================================
+void xPicMask::create(int32V2 Size, int32 Margin)
+{
+  //8 bit plane is allocated by pack() when needed (non-binary masks)
+  xInit(Size, 8, Margin, 1, sizeof(uint8));
+  m_BitsMargin = (Margin + 63) >> 6;
+  m_BitsStride = ((m_Width + 63) >> 6) + 2 * m_BitsMargin;
+  //one extra word - multi-bit reads (xMskBitPtr::getBits) may touch word following the last one
+  m_BitsBuffer = (uint64*)xMemory::xAlignedMallocPageAuto((m_BitsStride * (m_Height + 2 * Margin) + 1) * sizeof(uint64));
+  m_Bits       = m_BitsBuffer + Margin * m_BitsStride + m_BitsMargin;
+  m_NumTilesX  = CalcNumTiles(m_Width);
+  m_Tiles.resize(m_NumTilesX * CalcNumTiles(m_Height));
+}
+void xPicMask::destroy()
+{
+  if(m_BitsBuffer != nullptr) { xMemory::xAlignedFree(m_BitsBuffer); m_BitsBuffer = nullptr; }
+  m_Bits       = nullptr;
+  m_BitsStride = NOT_VALID;
+  m_BitsMargin = NOT_VALID;
+  m_IsBinary   = false;
+  m_Scale      = NOT_VALID;
+  m_NumNonZero = NOT_VALID;
+  m_Tiles.clear();
+  m_NumTilesX  = 0;
+  xPlane<uint8>::destroy();
+}
+bool xPicMask::pack(const xPicP* Src)
+{
+  assert(Src != nullptr && isSameSizeMargin(Src));
+  const uint16* SrcPtr    = Src->getAddr  (eCmp::LM);
+  const int32   SrcStride = Src->getStride(eCmp::LM);
+  const uint16  MaxValue  = Src->getMaxPelValue();
+
+  m_BitDepth   = Src->getBitDepth();
+  m_NumNonZero = xPixelOps::PackBinaryMask(m_Bits, SrcPtr, m_BitsStride, SrcStride, m_Width, m_Height, MaxValue);
+  m_IsBinary   = m_NumNonZero != NOT_VALID;
+
+  if(m_IsBinary)
+  {
+    //pels stored as bits, original weight restored by scale
+    xExtendBits();
+    m_Scale = MaxValue;
+  }
+  else
+  {
+    if(m_BitDepth > 8) { m_NumNonZero = NOT_VALID; return false; }
+    if(m_Buffer == nullptr)
+    {
+      m_Buffer = (uint8*)xMemory::xAlignedMallocPageAuto(m_BuffCmpNumBytes);
+      m_Origin = m_Buffer + m_Margin * m_Stride + m_Margin;
+    }
+    xPixelOps::Cvt(m_Origin, SrcPtr, m_Stride, SrcStride, m_Width, m_Height);
+    m_NumNonZero = xPixelOps::CountNonZero(m_Origin, m_Stride, m_Width, m_Height);
+    m_Scale      = 1;
+    extend();
+  }
+
+  xCalcTiles();
+  m_POC       = Src->getPOC();
+  m_Timestamp = Src->getTimestamp();
+  return true;
+}
+void xPicMask::xExtendBits()
+{
+  //replicates border pels into margin (the same as xPlane::extend for 8 bit plane)
+  const int32  NumWords  = (m_Width + 63) >> 6;
+  const int32  LastX     = m_Width - 1;
+  const int32  TailShift = m_Width & 63;
+
+  for(int32 y = 0; y < m_Height; y++)
+  {
+    uint64*      Row       = m_Bits + y * m_BitsStride;
+    const uint64 LeftWord  = (Row[0            ] & 1                        ) ? ~(uint64)0 : 0;
+    const uint64 RightWord = ((Row[LastX >> 6] >> (LastX & 63)) & 1) ? ~(uint64)0 : 0;
+    if(TailShift != 0) { Row[NumWords - 1] = (Row[NumWords - 1] & (((uint64)1 << TailShift) - 1)) | (RightWord << TailShift); }
+    for(int32 w = 1; w <= m_BitsMargin; w++) { Row[-w] = LeftWord; Row[NumWords - 1 + w] = RightWord; }
+  }
+
+  const uint64* FirstRow = m_Bits - m_BitsMargin;
+  const uint64* LastRow  = m_Bits - m_BitsMargin + (m_Height - 1) * m_BitsStride;
+  for(int32 y = 1; y <= m_Margin; y++)
+  {
+    std::memcpy(m_Bits - m_BitsMargin - y * m_BitsStride             , FirstRow, m_BitsStride * sizeof(uint64));
+    std::memcpy(m_Bits - m_BitsMargin + (m_Height - 1 + y) * m_BitsStride, LastRow , m_BitsStride * sizeof(uint64));
+  }
+}
+void xPicMask::xCalcTiles()
+{
+  const int32 NumTilesY = CalcNumTiles(m_Height);
+
+  for(int32 ty = 0; ty < NumTilesY; ty++)
+  {
+    const int32 BegY = ty << c_Log2TileSize;
+    const int32 EndY = xMin(BegY + c_TileSize, m_Height);
+    for(int32 tx = 0; tx < m_NumTilesX; tx++)
+    {
+      const int32 BegX       = tx << c_Log2TileSize;
+      const int32 EndX       = xMin(BegX + c_TileSize, m_Width);
+      bool        AnyNonZero = false;
+      bool        AllFull    = true;
+      if(m_IsBinary)
+      {
+        //single word per tile row, bits above EndX are ignored
+        const uint64 ValidBits = (EndX - BegX) == c_TileSize ? ~(uint64)0 : (((uint64)1 << (EndX - BegX)) - 1);
+        for(int32 y = BegY; y < EndY; y++)
+        {
+          const uint64 Bits = getBits(y)[tx] & ValidBits;
+          AnyNonZero |= Bits != 0;
+          AllFull    &= Bits == ValidBits;
+        }
+      }
+      else
+      {
+        const uint8 FullValue = (uint8)getFullValue();
+        for(int32 y = BegY; y < EndY; y++)
+        {
+          const uint8* Row = m_Origin + y * m_Stride;
+          for(int32 x = BegX; x < EndX; x++) { AnyNonZero |= Row[x] != 0; AllFull &= Row[x] == FullValue; }
+        }
+      }
+      m_Tiles[ty * m_NumTilesX + tx] = AllFull ? eTile::Full : (AnyNonZero ? eTile::Mixed : eTile::Empty);
+    }
+  }
+}
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
@@ -0,0 +1,135 @@
+﻿/*
+    SPDX-FileCopyrightText: 2019-2024 Jakub Stankowski <jakub.stankowski@put.poznan.pl>
+    SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+
+#include "xCommonDefCORE.h"
+#include "xPlane.h"
+#include "xPic.h"
+#include <vector>
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+// xPicMask - compact mask representation derived from luma plane of planar mask picture
+// binary masks (every pel is 0 or max value) are stored as 1 bit per pel only (bit plane with extended margin),
+// other masks up to 8 bits are stored as 8 bit plane (allocated when first non-binary mask is packed). Weight of pel = stored value * Scale.
+// Tile occupancy map classifies c_TileSize x c_TileSize tiles as empty (all weights 0), full (all weights max) or mixed.
+//===============================================================================================================================================================================================================
+class xPicMask : public xPlane<uint8>
+{
+public:
+  //tile width equals single word of binary mask, so tiles start at word boundary
+  static constexpr int32 c_Log2TileSize = 6;
+  static constexpr int32 c_TileSize     = 1 << c_Log2TileSize;
+  static inline int32 CalcNumTiles(const int32 Size) { return (Size + c_TileSize - 1) >> c_Log2TileSize; }
+
+  enum class eTile : uint8 { Empty = 0, Mixed = 1, Full = 2 };
+
+protected:
+  uint64* m_BitsBuffer = nullptr;   //binary mask buffer
+  uint64* m_Bits       = nullptr;   //binary mask origin - 1 bit per pel (LSB first), each row starts at new word
+  int32   m_BitsStride = NOT_VALID; //in 64-bit words (including margin words)
+  int32   m_BitsMargin = NOT_VALID; //horizontal margin in 64-bit words (vertical margin equals m_Margin rows)
+  bool    m_IsBinary   = false;
+  int32   m_Scale      = NOT_VALID;
+  int32   m_NumNonZero = NOT_VALID;
+
+  std::vector<eTile> m_Tiles;          //tile occupancy map (tile rows of m_NumTilesX entries)
+  int32              m_NumTilesX = 0;
+
+  void   xCalcTiles  ();
+  void   xExtendBits ();
+
+public:
+  xPicMask () = default;
+  xPicMask (int32V2 Size, int32 Margin = c_DefMargin) { create(Size, Margin); }
+  ~xPicMask() { destroy(); }
+
+  void   create (int32V2 Size, int32 Margin = c_DefMargin);
+  void   create (const xPicP* Ref) { create(Ref->getSize(), Ref->getMargin()); }
+  void   destroy();
+
+  //converts luma plane of Src, returns false if mask cannot be stored compactly (non-binary mask with BitDepth > 8), BitDepth is taken from Src
+  //8 bit plane (getAddr) is valid for non-binary masks only
+  bool   pack   (const xPicP* Src);
+
+  inline bool          isBinary     (       ) const { return m_IsBinary  ; }
+  inline int32         getScale     (       ) const { return m_Scale     ; }
+  inline int32         getNumNonZero(       ) const { return m_NumNonZero; }
+  inline int32         getBitsStride(       ) const { return m_BitsStride; }
+  inline const uint64* getBits      (       ) const { return m_Bits      ; }
+  inline const uint64* getBits      (int32 y) const { return m_Bits + y * m_BitsStride; }
+  inline const eTile*  getTiles     (       ) const { return m_Tiles.data(); }
+  inline const eTile*  getTilesRow  (int32 y) const { return m_Tiles.data() + (y >> c_Log2TileSize) * m_NumTilesX; } //tile row covering pel row y
+  inline int32         getNumTilesX (       ) const { return m_NumTilesX; }
+  inline int32         getNumTilesY (       ) const { return CalcNumTiles(m_Height); }
+
+  //max weight (max value of source mask), stored pels are in range [0, getMaxPelValue()/getScale()]
+  inline int32         getMaxPelValue(       ) const { return xBitDepth2MaxValue(m_BitDepth); }
+  //stored value of pels with max weight (pels within full tiles)
+  inline int32         getFullValue  (       ) const { return m_IsBinary ? 1 : getMaxPelValue(); }
+
+  //calls Func(BegX, EndX, Tile) for each run of neighbouring tiles of the same kind within tile row
+  template <class tFunc> static inline void ForEachTileRun(const eTile* TilesRow, const int32 Width, tFunc&& Func)
+  {
+    const int32 NumTilesX = CalcNumTiles(Width);
+    int32       BegT      = 0;
+    while(BegT < NumTilesX)
+    {
+      const eTile Tile = TilesRow[BegT];
+      int32       EndT = BegT + 1;
+      while(EndT < NumTilesX && TilesRow[EndT] == Tile) { EndT++; }
+      Func(BegT << c_Log2TileSize, xMin(EndT << c_Log2TileSize, Width), Tile);
+      BegT = EndT;
+    }
+  }
+};
+
+//===============================================================================================================================================================================================================
+// xPicMaskBits - bit plane of binary xPicMask seen as mask plane (stride in bits), xMskBitPtr - pointer-like access to its pels (0/1)
+//===============================================================================================================================================================================================================
+class xMskBitPtr
+{
+protected:
+  const uint64* m_Origin = nullptr;
+  int64         m_Pos    = 0; //bit position relative to m_Origin (negative within margin)
+
+public:
+  xMskBitPtr(const uint64* Origin, int64 Pos) : m_Origin(Origin), m_Pos(Pos) {}
+
+  inline xMskBitPtr operator+ (const int64 Offset) const { return xMskBitPtr(m_Origin, m_Pos + Offset); }
+  inline uint8      operator[](const int64 Idx   ) const { const int64 Pos = m_Pos + Idx; return (uint8)((m_Origin[Pos >> 6] >> (Pos & 63)) & 1); }
+  //NumBits (up to 32) consecutive pels starting at current position, LSB first
+  inline uint32     getBits   (const int32 NumBits) const
+  {
+    const int64  Word  = m_Pos >> 6;
+    const int32  Shift = (int32)(m_Pos & 63);
+    uint64       Bits  = m_Origin[Word] >> Shift;
+    if(Shift + NumBits > 64) { Bits |= m_Origin[Word + 1] << (64 - Shift); }
+    return (uint32)Bits & (uint32)(((uint64)1 << NumBits) - 1);
+  }
+};
+
+class xPicMaskBits
+{
+protected:
+  const xPicMask* m_Msk;
+
+public:
+  explicit xPicMaskBits(const xPicMask* Msk) : m_Msk(Msk) { assert(Msk->isBinary()); }
+
+  inline int32      getStride() const { return m_Msk->getBitsStride() << 6; }
+  inline xMskBitPtr getAddr  () const { return xMskBitPtr(m_Msk->getBits(), 0); }
+};
+
+//mask plane access for kernels templated on mask type (luma plane of planar mask picture, 8 bit plane of non-binary compact mask or bit plane of binary compact mask)
+static inline const uint16* xGetMskAddr(const xPicP*        Msk) { return Msk->getAddr(eCmp::LM); }
+static inline const uint8*  xGetMskAddr(const xPicMask*     Msk) { assert(!Msk->isBinary()); return Msk->getAddr(); }
+static inline xMskBitPtr    xGetMskAddr(const xPicMaskBits* Msk) { return Msk->getAddr(); }
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
@@ -63,6 +63,7 @@ public:
   static inline void  ClipToRange    (uint16*       Ptr, int32 Stride, int32 Width, int32 Height, int32 BitDepth) { return xPixelOpsSTD::ClipToRange   (Ptr, Stride, Width, Height, BitDepth); }
   static inline tStr  FindDiscrepancy(const uint16* Tst, const uint16* Ref, int32 TstStride, int32 RefStride, int32 Width, int32 Height, int32 MsgNumLimit) { return xPixelOpsSTD::FindDiscrepancy(Tst, Ref, TstStride, RefStride, Width, Height, MsgNumLimit); }
   static inline void  ExtendMargin   (uint16* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin) { xPixelOpsSTD::ExtendMargin(Addr, Stride, Width, Height, Margin); }
+  static inline void  ExtendMargin   (uint8*  Addr, int32 Stride, int32 Width, int32 Height, int32 Margin) { xPixelOpsSTD::ExtendMargin(Addr, Stride, Width, Height, Margin); }
 
 #if   X_CAN_USE_AVX512
   
@@ -80,6 +81,8 @@ public:
   static inline void  AOS4fromSOA3   (uint16* DstABCD, const uint16* SrcA, const uint16* SrcB, const uint16* SrcC, uint16 ValueD, int32 DstStride, int32 SrcStride, int32 Width, int32 Height) { xPixelOpsAVX512::AOS4fromSOA3(DstABCD, SrcA, SrcB, SrcC, ValueD, DstStride, SrcStride, Width, Height); }
   static inline void  SOA3fromAOS4   (uint16* DstA, uint16* DstB, uint16* DstC, const uint16* SrcABCD, int32 DstStride, int32 SrcStride, int32 Width, int32 Height) { xPixelOpsAVX512::SOA3fromAOS4(DstA, DstB, DstC, SrcABCD, DstStride, SrcStride, Width, Height); }
   static inline int32 CountNonZero   (const uint16* Src, int32 SrcStride, int32 Width, int32 Height) { return xPixelOpsAVX512::CountNonZero(Src, SrcStride, Width, Height); }
+  static inline int32 CountNonZero   (const uint8*  Src, int32 SrcStride, int32 Width, int32 Height) { return xPixelOpsAVX512::CountNonZero(Src, SrcStride, Width, Height); }
+  static inline int32 PackBinaryMask (uint64* Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 Width, int32 Height, uint16 MaxValue) { return xPixelOpsAVX512::PackBinaryMask(Dst, Src, DstStride, SrcStride, Width, Height, MaxValue); }
   static inline bool  CompareEqual   (const uint16* Tst, const uint16* Ref, int32 TstStride, int32 RefStride, int32 Width, int32 Height) { return xPixelOpsAVX512::CompareEqual(Tst, Ref, TstStride, RefStride, Width, Height); }
 
 #elif X_CAN_USE_AVX
@@ -98,6 +101,8 @@ public:
   static inline void  AOS4fromSOA3   (uint16* DstABCD, const uint16* SrcA, const uint16* SrcB, const uint16* SrcC, uint16 ValueD, int32 DstStride, int32 SrcStride, int32 Width, int32 Height) { xPixelOpsAVX::AOS4fromSOA3(DstABCD, SrcA, SrcB, SrcC, ValueD, DstStride, SrcStride, Width, Height); }
   static inline void  SOA3fromAOS4   (uint16* DstA, uint16* DstB, uint16* DstC, const uint16* SrcABCD, int32 DstStride, int32 SrcStride, int32 Width, int32 Height) { xPixelOpsAVX::SOA3fromAOS4(DstA, DstB, DstC, SrcABCD, DstStride, SrcStride, Width, Height); }
   static inline int32 CountNonZero   (const uint16* Src, int32 SrcStride, int32 Width, int32 Height) { return xPixelOpsAVX::CountNonZero(Src, SrcStride, Width, Height); }
+  static inline int32 CountNonZero   (const uint8*  Src, int32 SrcStride, int32 Width, int32 Height) { return xPixelOpsAVX::CountNonZero(Src, SrcStride, Width, Height); }
+  static inline int32 PackBinaryMask (uint64* Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 Width, int32 Height, uint16 MaxValue) { return xPixelOpsAVX::PackBinaryMask(Dst, Src, DstStride, SrcStride, Width, Height, MaxValue); }
   static inline bool  CompareEqual   (const uint16* Tst, const uint16* Ref, int32 TstStride, int32 RefStride, int32 Width, int32 Height) { return xPixelOpsAVX::CompareEqual(Tst, Ref, TstStride, RefStride, Width, Height); }
 
 #elif X_CAN_USE_SSE
@@ -116,6 +121,8 @@ public:
   static inline void  AOS4fromSOA3   (uint16* DstABCD, const uint16* SrcA, const uint16* SrcB, const uint16* SrcC, uint16 ValueD, int32 DstStride, int32 SrcStride, int32 Width, int32 Height) { xPixelOpsSSE::AOS4fromSOA3(DstABCD, SrcA, SrcB, SrcC, ValueD, DstStride, SrcStride, Width, Height); }
   static inline void  SOA3fromAOS4   (uint16* DstA, uint16* DstB, uint16* DstC, const uint16* SrcABCD, int32 DstStride, int32 SrcStride, int32 Width, int32 Height) { xPixelOpsSSE::SOA3fromAOS4(DstA, DstB, DstC, SrcABCD, DstStride, SrcStride, Width, Height); }
   static inline int32 CountNonZero   (const uint16* Src, int32 SrcStride, int32 Width, int32 Height) { return xPixelOpsSSE::CountNonZero(Src, SrcStride, Width, Height); }
+  static inline int32 CountNonZero   (const uint8*  Src, int32 SrcStride, int32 Width, int32 Height) { return xPixelOpsSSE::CountNonZero(Src, SrcStride, Width, Height); }
+  static inline int32 PackBinaryMask (uint64* Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 Width, int32 Height, uint16 MaxValue) { return xPixelOpsSSE::PackBinaryMask(Dst, Src, DstStride, SrcStride, Width, Height, MaxValue); }
   static inline bool  CompareEqual   (const uint16* Tst, const uint16* Ref, int32 TstStride, int32 RefStride, int32 Width, int32 Height) { return xPixelOpsSSE::CompareEqual(Tst, Ref, TstStride, RefStride, Width, Height); }
 
 #else //X_CAN_USE_???
@@ -134,6 +141,8 @@ public:
   static inline void  AOS4fromSOA3   (uint16* DstABCD, const uint16* SrcA, const uint16* SrcB, const uint16* SrcC, uint16 ValueD, int32 DstStride, int32 SrcStride, int32 Width, int32 Height) { xPixelOpsSTD::AOS4fromSOA3(DstABCD, SrcA, SrcB, SrcC, ValueD, DstStride, SrcStride, Width, Height); }
   static inline void  SOA3fromAOS4   (uint16* DstA, uint16* DstB, uint16* DstC, const uint16* SrcABCD, int32 DstStride, int32 SrcStride, int32 Width, int32 Height) { xPixelOpsSTD::SOA3fromAOS4(DstA, DstB, DstC, SrcABCD, DstStride, SrcStride, Width, Height); }
   static inline int32 CountNonZero   (const uint16* Src, int32 SrcStride, int32 Width, int32 Height) { return xPixelOpsSTD::CountNonZero(Src, SrcStride, Width, Height); }
+  static inline int32 CountNonZero   (const uint8*  Src, int32 SrcStride, int32 Width, int32 Height) { return xPixelOpsSTD::CountNonZero(Src, SrcStride, Width, Height); }
+  static inline int32 PackBinaryMask (uint64* Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 Width, int32 Height, uint16 MaxValue) { return xPixelOpsSTD::PackBinaryMask(Dst, Src, DstStride, SrcStride, Width, Height, MaxValue); }
   static inline bool  CompareEqual   (const uint16* Tst, const uint16* Ref, int32 TstStride, int32 RefStride, int32 Width, int32 Height) { return xPixelOpsSTD::CompareEqual(Tst, Ref, TstStride, RefStride, Width, Height); }
 
 #endif //X_CAN_USE_???
@@ -1242,6 +1242,68 @@ int32 xPixelOpsAVX::CountNonZero(const uint16* Src, int32 SrcStride, int32 Width
 
   return NumNonZero;
 }
+int32 xPixelOpsAVX::CountNonZero(const uint8* Src, int32 SrcStride, int32 Width, int32 Height)
+{
+  const int32   Width32 = (int32)((uint32)Width & c_MultipleMask32);
+  const __m256i ZeroV   = _mm256_setzero_si256();
+  int32 NumNonZero = 0;
+
+  for(int32 y=0; y<Height; y++)
+  {
+    for(int32 x=0; x<Width32; x+=32)
+    {
+      __m256i SrcV = _mm256_loadu_si256((__m256i*)&Src[x]);
+      uint32  Mask = ~(uint32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(SrcV, ZeroV));
+      NumNonZero += _mm_popcnt_u32(Mask);
+    }
+    for(int32 x=Width32; x<Width; x++) { if(Src[x] != 0) { NumNonZero++; } }
+    Src += SrcStride;
+  }
+
+  return NumNonZero;
+}
+int32 xPixelOpsAVX::PackBinaryMask(uint64* restrict Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 Width, int32 Height, uint16 MaxValue)
+{
+  const int32   Width32  = (int32)((uint32)Width & c_MultipleMask32);
+  const int32   NumWords = (Width + 63) >> 6;
+  const __m256i ZeroV    = _mm256_setzero_si256();
+  const __m256i MaxV     = _mm256_set1_epi16((int16)MaxValue);
+  int32 NumNonZero = 0;
+
+  for(int32 y=0; y<Height; y++)
+  {
+    for(int32 w=0; w<NumWords; w++) { Dst[w] = 0; }
+    uint32 InvalidMask = 0;
+    for(int32 x=0; x<Width32; x+=32)
+    {
+      __m256i SrcA    = _mm256_loadu_si256((__m256i*)&Src[x   ]);
+      __m256i SrcB    = _mm256_loadu_si256((__m256i*)&Src[x+16]);
+      __m256i IsZeroA = _mm256_cmpeq_epi16(SrcA, ZeroV);
+      __m256i IsZeroB = _mm256_cmpeq_epi16(SrcB, ZeroV);
+      __m256i IsMaxA  = _mm256_cmpeq_epi16(SrcA, MaxV );
+      __m256i IsMaxB  = _mm256_cmpeq_epi16(SrcB, MaxV );
+      //packs works within 128-bit lanes - permute restores raster order
+      __m256i IsZero  = _mm256_permute4x64_epi64(_mm256_packs_epi16(IsZeroA, IsZeroB), 0xD8);
+      __m256i Binary  = _mm256_packs_epi16(_mm256_or_si256(IsZeroA, IsMaxA), _mm256_or_si256(IsZeroB, IsMaxB));
+      uint32  NonZero = ~(uint32)_mm256_movemask_epi8(IsZero);
+      InvalidMask |= ~(uint32)_mm256_movemask_epi8(Binary);
+      Dst[x >> 6] |= (uint64)NonZero << (x & 63);
+      NumNonZero  += _mm_popcnt_u32(NonZero);
+    }
+    for(int32 x=Width32; x<Width; x++)
+    {
+      if(Src[x] == 0) { continue; }
+      if(Src[x] != MaxValue) { return NOT_VALID; }
+      Dst[x >> 6] |= (uint64)1 << (x & 63);
+      NumNonZero++;
+    }
+    if(InvalidMask) { return NOT_VALID; } //not a binary mask
+    Src += SrcStride;
+    Dst += DstStride;
+  }
+
+  return NumNonZero;
+}
 bool xPixelOpsAVX::CompareEqual(const uint16* Tst, const uint16* Ref, int32 TstStride, int32 RefStride, int32 Width, int32 Height)
 {
   if(((uint32)Width & c_RemainderMask32) == 0) //Width%32==0
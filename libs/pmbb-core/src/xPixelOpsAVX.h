@@ -31,6 +31,8 @@ public:
   static void  AOS4fromSOA3   (uint16* restrict DstABCD, const uint16* SrcA, const uint16* SrcB, const uint16* SrcC, uint16 ValueD, int32 DstStride, int32 SrcStride, int32 Width, int32 Height);
   static void  SOA3fromAOS4   (uint16* restrict DstA, uint16* restrict DstB, uint16* restrict DstC, const uint16* SrcABCD, int32 DstStride, int32 SrcStride, int32 Width, int32 Height);
   static int32 CountNonZero   (const uint16* Src, int32 SrcStride, int32 Width, int32 Height);
+  static int32 CountNonZero   (const uint8*  Src, int32 SrcStride, int32 Width, int32 Height);
+  static int32 PackBinaryMask (uint64* restrict Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 Width, int32 Height, uint16 MaxValue);
   static bool  CompareEqual   (const uint16* Tst, const uint16* Ref, int32 TstStride, int32 RefStride, int32 Width, int32 Height);
 };
 
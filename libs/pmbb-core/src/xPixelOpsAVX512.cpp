@@ -291,7 +291,7 @@ void xPixelOpsAVX512::CvtUpsampleHV(uint16* restrict Dst, const uint8* Src, int3
     const uint64 MaskL       = ((uint64)1 << Remainder64) - 1;
 
     const uint64 Remainder128 = (uint32)DstWidth & c_RemainderMask128;
-    const uint64 MaskS1t      = Remainder128 > 64 ? (uint64)0xFFFFFFFFFFFFFFFF : ((uint64)1 << (Remainder128)) - 1;
+    const uint64 MaskS1t      = Remainder128 >= 64 ? (uint64)0xFFFFFFFFFFFFFFFF : ((uint64)1 << (Remainder128)) - 1;
     const uint64 MaskS2t      = Remainder128 < 64 ? 0 : ((uint64)1 << (Remainder128 - 64)) - 1;
     const uint32 MaskS1       = (uint32)(MaskS1t & 0xFFFFFFFF);
     const uint32 MaskS2       = (uint32)(MaskS1t >>32);
@@ -436,7 +436,7 @@ void xPixelOpsAVX512::AOS4fromSOA3(uint16* restrict DstABCD, const uint16* SrcA,
     const uint32 MaskL       = ((uint32)1 << Remainder32) - 1;
 
     const uint64 Remainder128 = (uint32)(Width<<2) & c_RemainderMask128;
-    const uint64 MaskS1t      = Remainder128 > 64 ? (uint64)0xFFFFFFFFFFFFFFFF : ((uint64)1 << (Remainder128)) - 1;
+    const uint64 MaskS1t      = Remainder128 >= 64 ? (uint64)0xFFFFFFFFFFFFFFFF : ((uint64)1 << (Remainder128)) - 1;
     const uint64 MaskS2t      = Remainder128 < 64 ? 0 : ((uint64)1 << (Remainder128 - 64)) - 1;
     const uint32 MaskS1       = (uint32)(MaskS1t & 0xFFFFFFFF);
     const uint32 MaskS2       = (uint32)(MaskS1t >>32);
@@ -556,7 +556,7 @@ void xPixelOpsAVX512::SOA3fromAOS4(uint16* restrict DstA, uint16* restrict DstB,
     const uint32 MaskS       = ((uint32)1 << Remainder32) - 1;
 
     const uint64 Remainder128 = (uint32)(Width<<2) & c_RemainderMask128;
-    const uint64 MaskL1t      = Remainder128 > 64 ? (uint64)0xFFFFFFFFFFFFFFFF : ((uint64)1 << (Remainder128)) - 1;
+    const uint64 MaskL1t      = Remainder128 >= 64 ? (uint64)0xFFFFFFFFFFFFFFFF : ((uint64)1 << (Remainder128)) - 1;
     const uint64 MaskL2t      = Remainder128 < 64 ? 0 : ((uint64)1 << (Remainder128 - 64)) - 1;
     const uint32 MaskL1       = (uint32)(MaskL1t & 0xFFFFFFFF);
     const uint32 MaskL2       = (uint32)(MaskL1t >>32);
@@ -678,6 +678,68 @@ int32 xPixelOpsAVX512::CountNonZero(const uint16* Src, int32 SrcStride, int32 Wi
 
   return NumNonZero;
 }
+int32 xPixelOpsAVX512::CountNonZero(const uint8* Src, int32 SrcStride, int32 Width, int32 Height)
+{
+  const int32  Width64     = (int32)((uint32)Width & c_MultipleMask64);
+  const uint32 Remainder64 = (uint32)(Width) & 0x3F;
+  const uint64 MaskL       = ((uint64)1 << Remainder64) - 1;
+  int32 NumNonZero = 0;
+
+  for(int32 y = 0; y < Height; y++)
+  {
+    for(int32 x = 0; x < Width64; x += 64)
+    {
+      __m512i SrcV = _mm512_loadu_si512((__m512i*)&Src[x]);
+      NumNonZero += (int32)_mm_popcnt_u64(_mm512_test_epi8_mask(SrcV, SrcV));
+    } //x
+    if(Remainder64)
+    {
+      __m512i SrcV = _mm512_maskz_loadu_epi8(MaskL, &Src[Width64]);
+      NumNonZero += (int32)_mm_popcnt_u64(_mm512_test_epi8_mask(SrcV, SrcV));
+    }
+    Src += SrcStride;
+  } //y
+
+  return NumNonZero;
+}
+int32 xPixelOpsAVX512::PackBinaryMask(uint64* restrict Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 Width, int32 Height, uint16 MaxValue)
+{
+  const int32   Width32     = (int32)((uint32)Width & c_MultipleMask32);
+  const uint32  Remainder32 = (uint32)(Width) & c_RemainderMask32;
+  const uint32  MaskL       = ((uint32)1 << Remainder32) - 1;
+  const int32   NumWords    = (Width + 63) >> 6;
+  const __m512i MaxV        = _mm512_set1_epi16((int16)MaxValue);
+  int32 NumNonZero = 0;
+
+  for(int32 y = 0; y < Height; y++)
+  {
+    for(int32 w = 0; w < NumWords; w++) { Dst[w] = 0; }
+    uint32 InvalidMask = 0;
+    for(int32 x = 0; x < Width32; x += 32)
+    {
+      __m512i SrcV    = _mm512_loadu_si512((__m512i*)&Src[x]);
+      uint32  NonZero = _mm512_test_epi16_mask (SrcV, SrcV);
+      uint32  IsMax   = _mm512_cmpeq_epi16_mask(SrcV, MaxV);
+      InvalidMask |= NonZero & ~IsMax;
+      Dst[x >> 6] |= (uint64)NonZero << (x & 63);
+      NumNonZero  += _mm_popcnt_u32(NonZero);
+    } //x
+    if(Remainder32)
+    {
+      __m512i SrcV    = _mm512_maskz_loadu_epi16(MaskL, &Src[Width32]);
+      uint32  NonZero = _mm512_test_epi16_mask (SrcV, SrcV);
+      uint32  IsMax   = _mm512_cmpeq_epi16_mask(SrcV, MaxV);
+      InvalidMask |= NonZero & ~IsMax;
+      Dst[Width32 >> 6] |= (uint64)NonZero << (Width32 & 63);
+      NumNonZero  += _mm_popcnt_u32(NonZero);
+    }
+    if(InvalidMask) { return NOT_VALID; } //not a binary mask
+    Src += SrcStride;
+    Dst += DstStride;
+  } //y
+
+  return NumNonZero;
+}
 bool xPixelOpsAVX512::CompareEqual(const uint16* Tst, const uint16* Ref, int32 TstStride, int32 RefStride, int32 Width, int32 Height)
 {
   if(((uint32)Width & c_RemainderMask32) == 0) //Width%32==0
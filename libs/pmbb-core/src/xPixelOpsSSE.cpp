@@ -995,6 +995,66 @@ int32 xPixelOpsSSE::CountNonZero(const uint16* Src, int32 SrcStride, int32 Width
 
   return NumNonZero;
 }
+int32 xPixelOpsSSE::CountNonZero(const uint8* Src, int32 SrcStride, int32 Width, int32 Height)
+{
+  const int32   Width16 = (int32)((uint32)Width & c_MultipleMask16);
+  const __m128i ZeroV   = _mm_setzero_si128();
+  int32 NumNonZero = 0;
+
+  for(int32 y=0; y<Height; y++)
+  {
+    for(int32 x=0; x<Width16; x+=16)
+    {
+      __m128i SrcV = _mm_loadu_si128((__m128i*)&Src[x]);
+      uint32  Mask = (~_mm_movemask_epi8(_mm_cmpeq_epi8(SrcV, ZeroV))) & 0xFFFF;
+      NumNonZero += _mm_popcnt_u32(Mask);
+    }
+    for(int32 x=Width16; x<Width; x++) { if(Src[x] != 0) { NumNonZero++; } }
+    Src += SrcStride;
+  }
+
+  return NumNonZero;
+}
+int32 xPixelOpsSSE::PackBinaryMask(uint64* restrict Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 Width, int32 Height, uint16 MaxValue)
+{
+  const int32   Width16  = (int32)((uint32)Width & c_MultipleMask16);
+  const int32   NumWords = (Width + 63) >> 6;
+  const __m128i ZeroV    = _mm_setzero_si128();
+  const __m128i MaxV     = _mm_set1_epi16((int16)MaxValue);
+  int32 NumNonZero = 0;
+
+  for(int32 y=0; y<Height; y++)
+  {
+    for(int32 w=0; w<NumWords; w++) { Dst[w] = 0; }
+    uint32 InvalidMask = 0;
+    for(int32 x=0; x<Width16; x+=16)
+    {
+      __m128i SrcA    = _mm_loadu_si128((__m128i*)&Src[x  ]);
+      __m128i SrcB    = _mm_loadu_si128((__m128i*)&Src[x+8]);
+      __m128i IsZeroA = _mm_cmpeq_epi16(SrcA, ZeroV);
+      __m128i IsZeroB = _mm_cmpeq_epi16(SrcB, ZeroV);
+      __m128i IsMaxA  = _mm_cmpeq_epi16(SrcA, MaxV );
+      __m128i IsMaxB  = _mm_cmpeq_epi16(SrcB, MaxV );
+      uint32  NonZero = (~_mm_movemask_epi8(_mm_packs_epi16(IsZeroA, IsZeroB))) & 0xFFFF;
+      uint32  Binary  = _mm_movemask_epi8(_mm_packs_epi16(_mm_or_si128(IsZeroA, IsMaxA), _mm_or_si128(IsZeroB, IsMaxB)));
+      InvalidMask |= Binary ^ 0xFFFF;
+      Dst[x >> 6] |= (uint64)NonZero << (x & 63);
+      NumNonZero  += _mm_popcnt_u32(NonZero);
+    }
+    for(int32 x=Width16; x<Width; x++)
+    {
+      if(Src[x] == 0) { continue; }
+      if(Src[x] != MaxValue) { return NOT_VALID; }
+      Dst[x >> 6] |= (uint64)1 << (x & 63);
+      NumNonZero++;
+    }
+    if(InvalidMask) { return NOT_VALID; } //not a binary mask
+    Src += SrcStride;
+    Dst += DstStride;
+  }
+
+  return NumNonZero;
+}
 bool xPixelOpsSSE::CompareEqual(const uint16* Tst, const uint16* Ref, int32 TstStride, int32 RefStride, int32 Width, int32 Height)
 {
   if(((uint32)Width & c_RemainderMask8) == 0) //Width%16==0 - fast path without tail
@@ -207,13 +207,13 @@ void xPixelOpsSTD::ClipToRange(uint16* restrict Ptr, int32 SrcStride, int32 Widt
     Ptr += SrcStride;
   }
 }
-void xPixelOpsSTD::ExtendMargin(uint16* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin)
+template <typename PelType> static void xExtendMargin(PelType* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin)
 {
   //left/right
   for(int32 y = 0; y < Height; y++)
   {
-    uint16 Left  = Addr[0];
-    uint16 Right = Addr[Width - 1];
+    PelType Left  = Addr[0];
+    PelType Right = Addr[Width - 1];
     for(int32 x = 0; x < Margin; x++)
     {
       Addr[x - Margin] = Left;
@@ -225,15 +225,23 @@ void xPixelOpsSTD::ExtendMargin(uint16* Addr, int32 Stride, int32 Width, int32 H
   Addr -= (Stride + Margin);
   for(int32 y = 0; y < Margin; y++)
   {
-    ::memcpy(Addr + (y + 1) * Stride, Addr, sizeof(uint16) * (Width + (Margin << 1)));
+    ::memcpy(Addr + (y + 1) * Stride, Addr, sizeof(PelType) * (Width + (Margin << 1)));
   }
   //above
   Addr -= ((Height - 1) * Stride);
   for(int32 y = 0; y < Margin; y++)
   {
-    ::memcpy(Addr - (y + 1) * Stride, Addr, sizeof(uint16) * (Width + (Margin << 1)));
+    ::memcpy(Addr - (y + 1) * Stride, Addr, sizeof(PelType) * (Width + (Margin << 1)));
   }
 }
+void xPixelOpsSTD::ExtendMargin(uint16* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin)
+{
+  xExtendMargin(Addr, Stride, Width, Height, Margin);
+}
+void xPixelOpsSTD::ExtendMargin(uint8* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin)
+{
+  xExtendMargin(Addr, Stride, Width, Height, Margin);
+}
 void xPixelOpsSTD::AOS4fromSOA3(uint16* restrict DstABCD, const uint16* SrcA, const uint16* SrcB, const uint16* SrcC, uint16 ValueD, int32 DstStride, int32 SrcStride, int32 Width, int32 Height)
 {
   for(int32 y=0; y<Height; y++)
@@ -282,6 +290,39 @@ int32 xPixelOpsSTD::CountNonZero(const uint16* Src, int32 SrcStride, int32 Width
 
   return NumNonZero;
 }
+int32 xPixelOpsSTD::CountNonZero(const uint8* Src, int32 SrcStride, int32 Width, int32 Height)
+{
+  int32 NumNonZero = 0;
+
+  for(int32 y = 0; y < Height; y++)
+  {
+    for(int32 x = 0; x < Width; x++) { if(Src[x] != 0) { NumNonZero++; } }
+    Src += SrcStride;
+  }
+
+  return NumNonZero;
+}
+int32 xPixelOpsSTD::PackBinaryMask(uint64* restrict Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 Width, int32 Height, uint16 MaxValue)
+{
+  const int32 NumWords   = (Width + 63) >> 6;
+  int32       NumNonZero = 0;
+
+  for(int32 y = 0; y < Height; y++)
+  {
+    for(int32 w = 0; w < NumWords; w++) { Dst[w] = 0; }
+    for(int32 x = 0; x < Width; x++)
+    {
+      if(Src[x] == 0) { continue; }
+      if(Src[x] != MaxValue) { return NOT_VALID; } //not a binary mask
+      Dst[x >> 6] |= (uint64)1 << (x & 63);
+      NumNonZero++;
+    }
+    Src += SrcStride;
+    Dst += DstStride;
+  }
+
+  return NumNonZero;
+}
 bool xPixelOpsSTD::CompareEqual(const uint16* Tst, const uint16* Ref, int32 TstStride, int32 RefStride, int32 Width, int32 Height)
 {
   for(int32 y = 0; y < Height; y++)
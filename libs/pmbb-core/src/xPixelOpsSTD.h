@@ -29,9 +29,12 @@ public:
   static tStr  FindOutOfRange (const uint16* Src, int32 Stride, int32 Width, int32 Height, int32 BitDepth, int32 MsgNumLimit);
   static void  ClipToRange    (uint16* restrict Ptr, int32 Stride, int32 Width, int32 Height, int32 BitDepth);
   static void  ExtendMargin   (uint16* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin);
+  static void  ExtendMargin   (uint8*  Addr, int32 Stride, int32 Width, int32 Height, int32 Margin);
   static void  AOS4fromSOA3   (uint16* restrict DstABCD, const uint16* SrcA, const uint16* SrcB, const uint16* SrcC, uint16 ValueD, int32 DstStride, int32 SrcStride, int32 Width, int32 Height);
   static void  SOA3fromAOS4   (uint16* restrict DstA, uint16* restrict DstB, uint16* restrict DstC, const uint16* SrcABCD, int32 DstStride, int32 SrcStride, int32 Width, int32 Height);
   static int32 CountNonZero   (const uint16* Src, int32 SrcStride, int32 Width, int32 Height);
+  static int32 CountNonZero   (const uint8*  Src, int32 SrcStride, int32 Width, int32 Height);
+  static int32 PackBinaryMask (uint64* restrict Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 Width, int32 Height, uint16 MaxValue);  //1 bit per pel (LSB first, DstStride in words), returns number of non-zero pels or NOT_VALID if any pel is neither 0 nor MaxValue
   static bool  CompareEqual   (const uint16* Tst, const uint16* Ref, int32 TstStride, int32 RefStride, int32 Width, int32 Height);
   static tStr  FindDiscrepancy(const uint16* Tst, const uint16* Ref, int32 TstStride, int32 RefStride, int32 Width, int32 Height, int32 MsgNumLimit);
 };
@@ -84,7 +84,7 @@ template <typename PelType> void xPlane<PelType>::conceal()
 }
 template <typename PelType> void xPlane<PelType>::extend()
 {
-  if constexpr(std::is_same_v<PelType, uint16>)
+  if constexpr(std::is_same_v<PelType, uint16> || std::is_same_v<PelType, uint8>)
   {
     xPixelOps::ExtendMargin(m_Origin, m_Stride, m_Width, m_Height, m_Margin);
   }
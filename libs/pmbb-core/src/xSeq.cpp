@@ -178,12 +178,17 @@ xSeqBase::tResult xSeqBase::skipFrame(int32 NumFrames)
 
 bool xSeqBase::xUnpackFrame(xPicP* Pic)
 {
-  uint16* PtrLm      = Pic->getAddr  (eCmp::LM);
-  uint16* PtrCb      = Pic->getAddr  (eCmp::CB);
-  uint16* PtrCr      = Pic->getAddr  (eCmp::CR);
-  const int32 Stride = Pic->getStride();
-  const int32 Width  = m_Size.getX();
-  const int32 Height = m_Size.getY();
+  //picture with subsampled chroma planes receives chroma samples as they are stored in file (no upsampling)
+  if(Pic->isChromaSubsampled() && Pic->getChromaFormat() != m_ChromaFormat) { return false; }
+
+  uint16* PtrLm       = Pic->getAddr  (eCmp::LM);
+  uint16* PtrCb       = Pic->getAddr  (eCmp::CB);
+  uint16* PtrCr       = Pic->getAddr  (eCmp::CR);
+  const int32 Stride  = Pic->getStride();
+  const int32 StrideC = Pic->getStride(eCmp::CB);
+  const int32 Width   = m_Size.getX();
+  const int32 Height  = m_Size.getY();
+  const bool  Native  = Pic->isChromaSubsampled();
 
   //process luma
   if(m_BytesPerSample == 1) { xPixelOps::Cvt (PtrLm, m_Packed           , Stride, Width, Width, Height); }
@@ -198,7 +203,22 @@ bool xSeqBase::xUnpackFrame(xPicP* Pic)
     {
       const int32 ChromaFileCmpNumBytes = m_PackedCmpNumBytes >> 2;
       const int32 ChromaFileStride      = Width >> 1;
-      if(m_BytesPerSample == 1)
+      if(Native)
+      {
+        if(m_BytesPerSample == 1)
+        {
+          xPixelOps::Cvt(PtrCb, ChromaPtr, StrideC, ChromaFileStride, Width >> 1, Height >> 1);
+          ChromaPtr += ChromaFileCmpNumBytes;
+          xPixelOps::Cvt(PtrCr, ChromaPtr, StrideC, ChromaFileStride, Width >> 1, Height >> 1);
+        }
+        else
+        {
+          xPixelOps::Copy(PtrCb, (uint16*)ChromaPtr, StrideC, ChromaFileStride, Width >> 1, Height >> 1);
+          ChromaPtr += ChromaFileCmpNumBytes;
+          xPixelOps::Copy(PtrCr, (uint16*)ChromaPtr, StrideC, ChromaFileStride, Width >> 1, Height >> 1);
+        }
+      }
+      else if(m_BytesPerSample == 1)
       {
         xPixelOps::CvtUpsampleHV(PtrCb, ChromaPtr, Stride, ChromaFileStride, Width, Height);
         ChromaPtr += ChromaFileCmpNumBytes;
@@ -215,7 +235,22 @@ bool xSeqBase::xUnpackFrame(xPicP* Pic)
     {
       const int32 ChromaFileCmpNumBytes = m_PackedCmpNumBytes >> 1;
       const int32 ChromaFileStride      = Width >> 1;
-      if(m_BytesPerSample == 1)
+      if(Native)
+      {
+        if(m_BytesPerSample == 1)
+        {
+          xPixelOps::Cvt(PtrCb, ChromaPtr, StrideC, ChromaFileStride, Width >> 1, Height);
+          ChromaPtr += ChromaFileCmpNumBytes;
+          xPixelOps::Cvt(PtrCr, ChromaPtr, StrideC, ChromaFileStride, Width >> 1, Height);
+        }
+        else
+        {
+          xPixelOps::Copy(PtrCb, (uint16*)ChromaPtr, StrideC, ChromaFileStride, Width >> 1, Height);
+          ChromaPtr += ChromaFileCmpNumBytes;
+          xPixelOps::Copy(PtrCr, (uint16*)ChromaPtr, StrideC, ChromaFileStride, Width >> 1, Height);
+        }
+      }
+      else if(m_BytesPerSample == 1)
       {
         xPixelOps::CvtUpsampleH(PtrCb, ChromaPtr, Stride, ChromaFileStride, Width, Height);
         ChromaPtr += ChromaFileCmpNumBytes;
@@ -249,12 +284,17 @@ bool xSeqBase::xUnpackFrame(xPicP* Pic)
 }
 bool xSeqBase::xPackFrame(const xPicP* Pic)
 {
-  const uint16* PtrLm  = Pic->getAddr  (eCmp::LM);
-  const uint16* PtrCb  = Pic->getAddr  (eCmp::CB);
-  const uint16* PtrCr  = Pic->getAddr  (eCmp::CR);
-  const int32   Stride = Pic->getStride();
-  const int32   Width  = m_Size.getX();
-  const int32   Height = m_Size.getY();
+  //picture with subsampled chroma planes provides chroma samples as they are stored in file (no downsampling)
+  if(Pic->isChromaSubsampled() && Pic->getChromaFormat() != m_ChromaFormat) { return false; }
+
+  const uint16* PtrLm   = Pic->getAddr  (eCmp::LM);
+  const uint16* PtrCb   = Pic->getAddr  (eCmp::CB);
+  const uint16* PtrCr   = Pic->getAddr  (eCmp::CR);
+  const int32   Stride  = Pic->getStride();
+  const int32   StrideC = Pic->getStride(eCmp::CB);
+  const int32   Width   = m_Size.getX();
+  const int32   Height  = m_Size.getY();
+  const bool    Native  = Pic->isChromaSubsampled();
 
   //process luma
   if(m_BytesPerSample == 1) { xPixelOps::Cvt (m_Packed           , PtrLm, Width, Stride, Width, Height); }
@@ -268,7 +308,22 @@ bool xSeqBase::xPackFrame(const xPicP* Pic)
     {
       const int32 ChromaFileCmpNumBytes = m_PackedCmpNumBytes >> 2;
       const int32 ChromaFileStride      = Width >> 1;
-      if(m_BytesPerSample == 1)
+      if(Native)
+      {
+        if(m_BytesPerSample == 1)
+        {
+          xPixelOps::Cvt(ChromaPtr, PtrCb, ChromaFileStride, StrideC, Width >> 1, Height >> 1);
+          ChromaPtr += ChromaFileCmpNumBytes;
+          xPixelOps::Cvt(ChromaPtr, PtrCr, ChromaFileStride, StrideC, Width >> 1, Height >> 1);
+        }
+        else
+        {
+          xPixelOps::Copy((uint16*)ChromaPtr, PtrCb, ChromaFileStride, StrideC, Width >> 1, Height >> 1);
+          ChromaPtr += ChromaFileCmpNumBytes;
+          xPixelOps::Copy((uint16*)ChromaPtr, PtrCr, ChromaFileStride, StrideC, Width >> 1, Height >> 1);
+        }
+      }
+      else if(m_BytesPerSample == 1)
       {
         xPixelOps::CvtDownsampleHV(ChromaPtr, PtrCb, ChromaFileStride, Stride, Width>>1, Height>>1);
         ChromaPtr += ChromaFileCmpNumBytes;
@@ -285,7 +340,22 @@ bool xSeqBase::xPackFrame(const xPicP* Pic)
     {
       const int32 ChromaFileCmpNumBytes = m_PackedCmpNumBytes >> 1;
       const int32 ChromaFileStride      = Width >> 1;
-      if(m_BytesPerSample == 1)
+      if(Native)
+      {
+        if(m_BytesPerSample == 1)
+        {
+          xPixelOps::Cvt(ChromaPtr, PtrCb, ChromaFileStride, StrideC, Width >> 1, Height);
+          ChromaPtr += ChromaFileCmpNumBytes;
+          xPixelOps::Cvt(ChromaPtr, PtrCr, ChromaFileStride, StrideC, Width >> 1, Height);
+        }
+        else
+        {
+          xPixelOps::Copy((uint16*)ChromaPtr, PtrCb, ChromaFileStride, StrideC, Width >> 1, Height);
+          ChromaPtr += ChromaFileCmpNumBytes;
+          xPixelOps::Copy((uint16*)ChromaPtr, PtrCr, ChromaFileStride, StrideC, Width >> 1, Height);
+        }
+      }
+      else if(m_BytesPerSample == 1)
       {
         xPixelOps::CvtDownsampleH(ChromaPtr, PtrCb, ChromaFileStride, Stride, Width>>1, Height>>1);
         ChromaPtr += ChromaFileCmpNumBytes;
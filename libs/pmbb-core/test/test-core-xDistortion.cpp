@@ -206,6 +206,169 @@ void testDistortion(
 }
 
 
+void testDistortionSDSSD(std::function<std::tuple<int32, uint64>(const uint16*, const uint16*, int32)> RowSDSSD)
+{
+  for(const int32 y : c_Dimms)
+  {
+    for(const int32 x : c_Dimms)
+    {
+      int32V2 Size = { x, y };
+
+      for(const int32 m : c_Margs)
+      {
+        const std::string Description = fmt::format("Size={}x{} Margin={}", x, y, m);
+        CAPTURE(Description);
+
+        tPlane* PL = new tPlane(Size, 14, m);
+        tPlane* PU = new tPlane(Size, 14, m);
+
+        for(int32 Pattern = 0; Pattern < 3; Pattern++)
+        {
+          switch(Pattern)
+          {
+            case 0: PL->fill(0); PU->fill(c_Max); break;
+            case 1: xTestUtils::fillMidNoise  (PL->getAddr(), PL->getStride(), x, y, 14, 0); xTestUtils::fillMidNoise  (PU->getAddr(), PU->getStride(), x, y, 14, 1); break;
+            case 2: xTestUtils::fillGradientXY(PL->getAddr(), PL->getStride(), x, y, 14, 0); xTestUtils::fillGradientXY(PU->getAddr(), PU->getStride(), x, y, 14, 1); break;
+          }
+
+          for(int32 r = 0; r < y; r++)
+          {
+            const uint16* L = PL->getAddr() + r * PL->getStride();
+            const uint16* U = PU->getAddr() + r * PU->getStride();
+            const auto [SD_LU, SSD_LU] = RowSDSSD(L, U, x);
+            const auto [SD_UL, SSD_UL] = RowSDSSD(U, L, x);
+            CHECK(SD_LU  == xDistortionSTD::CalcSD (L, U, x));
+            CHECK(SD_UL  == xDistortionSTD::CalcSD (U, L, x));
+            CHECK(SSD_LU == xDistortionSTD::CalcSSD(L, U, x));
+            CHECK(SSD_UL == SSD_LU);
+          }
+        }
+
+        delete PL;
+        delete PU;
+      }
+    }
+  }
+}
+
+void testWeightedDistortion(
+  std::function< int64(const uint16*, const uint16*, const uint16*, int32                            )>AreaWSD,
+  std::function< int64(const uint16*, const uint16*, const uint16*, int32, int32, int32, int32, int32)>StrideWSD,
+  std::function<uint64(const uint16*, const uint16*, const uint16*, int32                            )>AreaWSSD,
+  std::function<uint64(const uint16*, const uint16*, const uint16*, int32, int32, int32, int32, int32)>StrideWSSD)
+{
+  for(const int32 y : c_Dimms)
+  {
+    for(const int32 x : c_Dimms)
+    {
+      int32V2 Size = { x, y };
+      int64   Area = x * y;
+
+      for(const int32 m : c_Margs)
+      {
+        const std::string Description = fmt::format("Size={}x{} Margin={}", x, y, m);
+
+        //buffers create
+        tPlane* PL = new tPlane(Size, 14, m);
+        tPlane* PU = new tPlane(Size, 14, m);
+        tPlane* PM = new tPlane(Size, 16, m);
+
+        //extreme values with max mask
+        CAPTURE(Description + " extreme values");
+        PL->fill(0);
+        PU->fill(uint16(c_Max));
+        PM->fill(uint16(xBitDepth2MaxValue(16)));
+        const int64 MaxMsk = xBitDepth2MaxValue(16);
+        if(m == 0)
+        {
+          CHECK(AreaWSD (PL->getAddr(), PU->getAddr(), PM->getAddr(), PL->getArea()) == -c_Max * MaxMsk * Area);
+          CHECK(AreaWSD (PU->getAddr(), PL->getAddr(), PM->getAddr(), PU->getArea()) ==  c_Max * MaxMsk * Area);
+          CHECK(AreaWSSD(PL->getAddr(), PU->getAddr(), PM->getAddr(), PL->getArea()) == (uint64)(xPow2<int64>(c_Max) * MaxMsk * Area));
+        }
+        CHECK(StrideWSD (PL->getAddr(), PU->getAddr(), PM->getAddr(), PL->getStride(), PU->getStride(), PM->getStride(), x, y) == -c_Max * MaxMsk * Area);
+        CHECK(StrideWSD (PU->getAddr(), PL->getAddr(), PM->getAddr(), PU->getStride(), PL->getStride(), PM->getStride(), x, y) ==  c_Max * MaxMsk * Area);
+        CHECK(StrideWSSD(PL->getAddr(), PU->getAddr(), PM->getAddr(), PL->getStride(), PU->getStride(), PM->getStride(), x, y) == (uint64)(xPow2<int64>(c_Max) * MaxMsk * Area));
+
+        //pseudo-random values and mask - compared against portable implementation
+        for(const int32 MskBitDepth : { 1, 8, 16 })
+        {
+          CAPTURE(Description + fmt::format(" pseudo-random values MskBitDepth={}", MskBitDepth));
+          xTestUtils::fillRandom(PL->getAddr(), PL->getStride(), x, y, 14, xTestUtils::c_XorShiftSeed + 1);
+          xTestUtils::fillRandom(PU->getAddr(), PU->getStride(), x, y, 14, xTestUtils::c_XorShiftSeed + 2);
+          xTestUtils::fillRandom(PM->getAddr(), PM->getStride(), x, y, MskBitDepth, xTestUtils::c_XorShiftSeed + 3);
+
+          const int64  RefWSD  = xDistortionSTD::CalcWeightedSD (PL->getAddr(), PU->getAddr(), PM->getAddr(), PL->getStride(), PU->getStride(), PM->getStride(), x, y);
+          const uint64 RefWSSD = xDistortionSTD::CalcWeightedSSD(PL->getAddr(), PU->getAddr(), PM->getAddr(), PL->getStride(), PU->getStride(), PM->getStride(), x, y);
+          if(m == 0)
+          {
+            CHECK(AreaWSD (PL->getAddr(), PU->getAddr(), PM->getAddr(), PL->getArea()) ==  RefWSD );
+            CHECK(AreaWSD (PU->getAddr(), PL->getAddr(), PM->getAddr(), PU->getArea()) == -RefWSD );
+            CHECK(AreaWSSD(PL->getAddr(), PU->getAddr(), PM->getAddr(), PL->getArea()) ==  RefWSSD);
+          }
+          CHECK(StrideWSD (PL->getAddr(), PU->getAddr(), PM->getAddr(), PL->getStride(), PU->getStride(), PM->getStride(), x, y) ==  RefWSD );
+          CHECK(StrideWSD (PU->getAddr(), PL->getAddr(), PM->getAddr(), PU->getStride(), PL->getStride(), PM->getStride(), x, y) == -RefWSD );
+          CHECK(StrideWSSD(PL->getAddr(), PU->getAddr(), PM->getAddr(), PL->getStride(), PU->getStride(), PM->getStride(), x, y) ==  RefWSSD);
+          CHECK(StrideWSSD(PU->getAddr(), PL->getAddr(), PM->getAddr(), PU->getStride(), PL->getStride(), PM->getStride(), x, y) ==  RefWSSD);
+        }
+
+        //buffers destroy
+        delete PL;
+        delete PU;
+        delete PM;
+      }
+    }
+  }
+}
+
+void testCompactMaskDistortion(
+  std::function< int64(const uint16*, const uint16*, const uint8* , int32)>WSD8,
+  std::function<uint64(const uint16*, const uint16*, const uint8* , int32)>WSSD8,
+  std::function< int64(const uint16*, const uint16*, const uint64*, int32)>MaskedSD,
+  std::function<uint64(const uint16*, const uint16*, const uint64*, int32)>MaskedSSD)
+{
+  for(const int32 x : c_Dimms)
+  {
+    const int32 NumWords = (x + 63) >> 6;
+
+    std::vector<uint16> L(x), U(x), M16(x);
+    std::vector<uint8 > M8(x);
+    std::vector<uint64> MB(NumWords);
+
+    for(const int32 MskBitDepth : { 1, 8 })
+    {
+      for(uint32 Seed = 0; Seed < 4; Seed++)
+      {
+        const std::string Description = fmt::format("Width={} MskBitDepth={} Seed={}", x, MskBitDepth, Seed);
+        CAPTURE(Description);
+
+        xTestUtils::fillRandom(L .data(), x, x, 1, 14         , xTestUtils::c_XorShiftSeed + 4 * Seed + 1);
+        xTestUtils::fillRandom(U .data(), x, x, 1, 14         , xTestUtils::c_XorShiftSeed + 4 * Seed + 2);
+        xTestUtils::fillRandom(M8.data(), x, x, 1, MskBitDepth, xTestUtils::c_XorShiftSeed + 4 * Seed + 3);
+        std::fill(MB.begin(), MB.end(), 0);
+        for(int32 i = 0; i < x; i++)
+        {
+          M16[i] = M8[i];
+          if(M8[i] != 0) { MB[i >> 6] |= (uint64)1 << (i & 63); }
+        }
+
+        //reference - portable implementation with 16-bit mask
+        const int64  RefWSD  = xDistortionSTD::CalcWeightedSD (L.data(), U.data(), M16.data(), x);
+        const uint64 RefWSSD = xDistortionSTD::CalcWeightedSSD(L.data(), U.data(), M16.data(), x);
+
+        CHECK(WSD8 (L.data(), U.data(), M8.data(), x) ==  RefWSD );
+        CHECK(WSD8 (U.data(), L.data(), M8.data(), x) == -RefWSD );
+        CHECK(WSSD8(L.data(), U.data(), M8.data(), x) ==  RefWSSD);
+        if(MskBitDepth == 1)
+        {
+          CHECK(MaskedSD (L.data(), U.data(), MB.data(), x) ==  RefWSD );
+          CHECK(MaskedSD (U.data(), L.data(), MB.data(), x) == -RefWSD );
+          CHECK(MaskedSSD(L.data(), U.data(), MB.data(), x) ==  RefWSSD);
+        }
+      }
+    }
+  }
+}
+
 //===============================================================================================================================================================================================================
 
 TEST_CASE("xDistortionSTD")
@@ -220,6 +383,21 @@ TEST_CASE("xDistortionSTD")
     static_cast<uint64(*)(const uint16*, const uint16*, int32                     )>(&xDistortionSTD::CalcSSD),
     static_cast<uint64(*)(const uint16*, const uint16*, int32, int32, int32, int32)>(&xDistortionSTD::CalcSSD)
   );
+  testDistortionSDSSD(&xDistortionSTD::CalcSDSSD);
+  testWeightedDistortion
+  (
+    static_cast< int64(*)(const uint16*, const uint16*, const uint16*, int32                            )>(&xDistortionSTD::CalcWeightedSD ),
+    static_cast< int64(*)(const uint16*, const uint16*, const uint16*, int32, int32, int32, int32, int32)>(&xDistortionSTD::CalcWeightedSD ),
+    static_cast<uint64(*)(const uint16*, const uint16*, const uint16*, int32                            )>(&xDistortionSTD::CalcWeightedSSD),
+    static_cast<uint64(*)(const uint16*, const uint16*, const uint16*, int32, int32, int32, int32, int32)>(&xDistortionSTD::CalcWeightedSSD)
+  );
+  testCompactMaskDistortion
+  (
+    static_cast< int64(*)(const uint16*, const uint16*, const uint8* , int32)>(&xDistortionSTD::CalcWeightedSD ),
+    static_cast<uint64(*)(const uint16*, const uint16*, const uint8* , int32)>(&xDistortionSTD::CalcWeightedSSD),
+    &xDistortionSTD::CalcMaskedSD,
+    &xDistortionSTD::CalcMaskedSSD
+  );
   fmt::print("TIME(xDistortionSTD   ) = {}s\n", std::chrono::duration_cast<tDurationS>(tClock::now() - T).count());
 }
 
@@ -236,6 +414,21 @@ TEST_CASE("xDistortionSSE")
     static_cast<uint64(*)(const uint16*, const uint16*, int32                     )>(&xDistortionSSE::CalcSSD),
     static_cast<uint64(*)(const uint16*, const uint16*, int32, int32, int32, int32)>(&xDistortionSSE::CalcSSD)
   );
+  testDistortionSDSSD(&xDistortionSSE::CalcSDSSD);
+  testWeightedDistortion
+  (
+    static_cast< int64(*)(const uint16*, const uint16*, const uint16*, int32                            )>(&xDistortionSSE::CalcWeightedSD ),
+    static_cast< int64(*)(const uint16*, const uint16*, const uint16*, int32, int32, int32, int32, int32)>(&xDistortionSSE::CalcWeightedSD ),
+    static_cast<uint64(*)(const uint16*, const uint16*, const uint16*, int32                            )>(&xDistortionSSE::CalcWeightedSSD),
+    static_cast<uint64(*)(const uint16*, const uint16*, const uint16*, int32, int32, int32, int32, int32)>(&xDistortionSSE::CalcWeightedSSD)
+  );
+  testCompactMaskDistortion
+  (
+    static_cast< int64(*)(const uint16*, const uint16*, const uint8* , int32)>(&xDistortionSSE::CalcWeightedSD ),
+    static_cast<uint64(*)(const uint16*, const uint16*, const uint8* , int32)>(&xDistortionSSE::CalcWeightedSSD),
+    &xDistortionSSE::CalcMaskedSD,
+    &xDistortionSSE::CalcMaskedSSD
+  );
   fmt::print("TIME(xDistortionSSE   ) = {}s\n", std::chrono::duration_cast<tDurationS>(tClock::now() - T).count());
 }
 #endif
@@ -253,6 +446,21 @@ TEST_CASE("xDistortionAVX")
     static_cast<uint64(*)(const uint16*, const uint16*, int32                     )>(&xDistortionAVX::CalcSSD),
     static_cast<uint64(*)(const uint16*, const uint16*, int32, int32, int32, int32)>(&xDistortionAVX::CalcSSD)
   );
+  testDistortionSDSSD(&xDistortionAVX::CalcSDSSD);
+  testWeightedDistortion
+  (
+    static_cast< int64(*)(const uint16*, const uint16*, const uint16*, int32                            )>(&xDistortionAVX::CalcWeightedSD ),
+    static_cast< int64(*)(const uint16*, const uint16*, const uint16*, int32, int32, int32, int32, int32)>(&xDistortionAVX::CalcWeightedSD ),
+    static_cast<uint64(*)(const uint16*, const uint16*, const uint16*, int32                            )>(&xDistortionAVX::CalcWeightedSSD),
+    static_cast<uint64(*)(const uint16*, const uint16*, const uint16*, int32, int32, int32, int32, int32)>(&xDistortionAVX::CalcWeightedSSD)
+  );
+  testCompactMaskDistortion
+  (
+    static_cast< int64(*)(const uint16*, const uint16*, const uint8* , int32)>(&xDistortionAVX::CalcWeightedSD ),
+    static_cast<uint64(*)(const uint16*, const uint16*, const uint8* , int32)>(&xDistortionAVX::CalcWeightedSSD),
+    &xDistortionAVX::CalcMaskedSD,
+    &xDistortionAVX::CalcMaskedSSD
+  );
   fmt::print("TIME(xDistortionAVX   ) = {}s\n", std::chrono::duration_cast<tDurationS>(tClock::now() - T).count());
 }
 #endif
@@ -270,6 +478,21 @@ TEST_CASE("xDistortionAVX512")
     static_cast<uint64(*)(const uint16*, const uint16*, int32                     )>(&xDistortionAVX512::CalcSSD),
     static_cast<uint64(*)(const uint16*, const uint16*, int32, int32, int32, int32)>(&xDistortionAVX512::CalcSSD)
   );
+  testDistortionSDSSD(&xDistortionAVX512::CalcSDSSD);
+  testWeightedDistortion
+  (
+    static_cast< int64(*)(const uint16*, const uint16*, const uint16*, int32                            )>(&xDistortionAVX512::CalcWeightedSD ),
+    static_cast< int64(*)(const uint16*, const uint16*, const uint16*, int32, int32, int32, int32, int32)>(&xDistortionAVX512::CalcWeightedSD ),
+    static_cast<uint64(*)(const uint16*, const uint16*, const uint16*, int32                            )>(&xDistortionAVX512::CalcWeightedSSD),
+    static_cast<uint64(*)(const uint16*, const uint16*, const uint16*, int32, int32, int32, int32, int32)>(&xDistortionAVX512::CalcWeightedSSD)
+  );
+  testCompactMaskDistortion
+  (
+    static_cast< int64(*)(const uint16*, const uint16*, const uint8* , int32)>(&xDistortionAVX512::CalcWeightedSD ),
+    static_cast<uint64(*)(const uint16*, const uint16*, const uint8* , int32)>(&xDistortionAVX512::CalcWeightedSSD),
+    &xDistortionAVX512::CalcMaskedSD,
+    &xDistortionAVX512::CalcMaskedSSD
+  );
   fmt::print("TIME(xDistortionAVX512) = {}s\n", std::chrono::duration_cast<tDurationS>(tClock::now() - T).count());
 }
 #endif
@@ -0,0 +1,189 @@
+/*
+    SPDX-FileCopyrightText: 2019-2024 Jakub Stankowski <jakub.stankowski@put.poznan.pl>
+    SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+#include "../src/xCommonDefCORE.h"
+#include "../src/xPicMask.h"
+#include "../src/xPic.h"
+#include "../src/xPixelOps.h"
+#include "../src/xTestUtils.h"
+
+using namespace PMBB_NAMESPACE;
+
+//===============================================================================================================================================================================================================
+
+static const std::vector<int32V2> c_Sizes = { { 1, 1 }, { 5, 3 }, { 64, 64 }, { 65, 70 }, { 130, 7 }, { 200, 130 } }; //smaller than single tile or word, tile aligned, partial tiles
+static const std::vector<int32  > c_Margs = { 0, 5, 32 };
+
+//===============================================================================================================================================================================================================
+
+//tiles are filled according to (TileX + TileY + Phase) % 3: 0 - all pels 0, 1 - all pels max, 2 - random pels (binary: 0 or max, weighted: any value)
+void genMask(xPicP* Msk, bool Binary, int32 Phase, uint32 Seed)
+{
+  const int32 MaxValue = Msk->getMaxPelValue();
+  for(int32 y = 0; y < Msk->getHeight(); y++)
+  {
+    for(int32 x = 0; x < Msk->getWidth(); x++)
+    {
+      Seed = xTestUtils::xXorShift32(Seed);
+      const int32 Kind  = ((x >> xPicMask::c_Log2TileSize) + (y >> xPicMask::c_Log2TileSize) + Phase) % 3;
+      const int32 Value = Kind == 0 ? 0 : Kind == 1 ? MaxValue : Binary ? ((Seed & 1) ? MaxValue : 0) : (int32)(Seed % (MaxValue + 1));
+      Msk->accessPel({ x, y }, eCmp::LM) = (uint16)Value;
+    }
+  }
+  Msk->extend();
+}
+
+void testPack(xPicMask* PicMsk, xPicP* Msk, bool Binary)
+{
+  const int32V2 Size   = Msk->getSize();
+  const int32   Margin = Msk->getMargin();
+
+  const int32 RefNumNonZero = xPixelOps::CountNonZero(Msk->getAddr(eCmp::LM), Msk->getStride(eCmp::LM), Size.getX(), Size.getY());
+
+  CHECK(PicMsk->pack(Msk));
+  CHECK(PicMsk->isBinary     () == Binary);
+  CHECK(PicMsk->getScale     () == (Binary ? Msk->getMaxPelValue() : 1));
+  CHECK(PicMsk->getNumNonZero() == RefNumNonZero);
+
+  //stored pels multiplied by scale have to be equal to pels of extended planar mask (margins included)
+  bool AllPelsMatch  = true;
+  bool AllWordsMatch = true;
+  for(int32 y = -Margin; y < Size.getY() + Margin; y++)
+  {
+    for(int32 x = -Margin; x < Size.getX() + Margin; x++)
+    {
+      const int32 RefValue = Msk->accessPel({ x, y }, eCmp::LM);
+      if(Binary)
+      {
+        const xPicMaskBits MskBits(PicMsk);
+        const xMskBitPtr   Ptr     = MskBits.getAddr() + ((int64)y * MskBits.getStride() + x);
+        if(Ptr[0] * PicMsk->getScale() != RefValue) { AllPelsMatch = false; }
+
+        //multi-bit read has to be equal to single pel reads (up to the end of right margin)
+        const int32  NumBits = xMin(32, Size.getX() + Margin - x);
+        const uint32 Bits    = Ptr.getBits(NumBits);
+        for(int32 i = 0; i < NumBits; i++) { if(((Bits >> i) & 1) != Ptr[i]) { AllWordsMatch = false; } }
+      }
+      else
+      {
+        if(PicMsk->accessPel({ x, y }) * PicMsk->getScale() != RefValue) { AllPelsMatch = false; }
+      }
+    }
+  }
+  CHECK(AllPelsMatch );
+  CHECK(AllWordsMatch);
+}
+
+//tile has to be empty if all its pels are 0, full if all its pels are max, mixed otherwise (pels outside picture are not taken into account)
+void testTiles(const xPicMask* PicMsk, const xPicP* Msk)
+{
+  using eTile = xPicMask::eTile;
+  const int32 Width    = Msk->getWidth ();
+  const int32 Height   = Msk->getHeight();
+  const int32 MaxValue = Msk->getMaxPelValue();
+
+  CHECK(PicMsk->getNumTilesX() == xPicMask::CalcNumTiles(Width ));
+  CHECK(PicMsk->getNumTilesY() == xPicMask::CalcNumTiles(Height));
+
+  bool AllTilesMatch = true;
+  bool AllRunsMatch  = true;
+  for(int32 ty = 0; ty < PicMsk->getNumTilesY(); ty++)
+  {
+    const int32 BegY = ty * xPicMask::c_TileSize;
+    const int32 EndY = xMin(BegY + xPicMask::c_TileSize, Height);
+    for(int32 tx = 0; tx < PicMsk->getNumTilesX(); tx++)
+    {
+      const int32 BegX = tx * xPicMask::c_TileSize;
+      const int32 EndX = xMin(BegX + xPicMask::c_TileSize, Width);
+      int32 NumZero = 0, NumFull = 0;
+      for(int32 y = BegY; y < EndY; y++)
+      {
+        for(int32 x = BegX; x < EndX; x++) { const int32 Value = Msk->accessPel({ x, y }, eCmp::LM); NumZero += Value == 0; NumFull += Value == MaxValue; }
+      }
+      const int32 NumPels = (EndX - BegX) * (EndY - BegY);
+      const eTile RefTile = NumFull == NumPels ? eTile::Full : NumZero == NumPels ? eTile::Empty : eTile::Mixed;
+      for(int32 y = BegY; y < EndY; y++) { if(PicMsk->getTilesRow(y)[tx] != RefTile) { AllTilesMatch = false; } }
+    }
+
+    //runs have to cover whole row without gaps, neighbouring runs have to differ
+    int32 NextX    = 0;
+    eTile LastTile = eTile::Empty;
+    xPicMask::ForEachTileRun(PicMsk->getTilesRow(BegY), Width, [&](int32 RunBegX, int32 RunEndX, eTile Tile)
+    {
+      if(RunBegX != NextX || RunEndX <= RunBegX || (RunBegX > 0 && Tile == LastTile)) { AllRunsMatch = false; }
+      for(int32 x = RunBegX; x < RunEndX; x += xPicMask::c_TileSize) { if(PicMsk->getTilesRow(BegY)[x >> xPicMask::c_Log2TileSize] != Tile) { AllRunsMatch = false; } }
+      NextX    = RunEndX;
+      LastTile = Tile;
+    });
+    if(NextX != Width) { AllRunsMatch = false; }
+  }
+  CHECK(AllTilesMatch);
+  CHECK(AllRunsMatch );
+}
+
+//===============================================================================================================================================================================================================
+
+TEST_CASE("xPicMask::pack")
+{
+  for(const int32V2& Size : c_Sizes)
+  {
+    for(const int32 Margin : c_Margs)
+    {
+      xPicMask PicMsk(Size, Margin);
+
+      for(const int32 BitDepth : { 8, 10 })
+      {
+        for(const int32 Phase : { 0, 1, 2 })
+        {
+          const std::string Description = fmt::format("Size={}x{} Margin={} BitDepth={} Phase={}", Size.getX(), Size.getY(), Margin, BitDepth, Phase);
+          CAPTURE(Description);
+
+          xPicP Msk(Size, BitDepth, Margin);
+
+          //the same xPicMask is reused for binary and weighted masks (8 bit plane allocated on first weighted mask, bit plane kept valid for binary masks)
+          genMask(&Msk, true, Phase, xTestUtils::c_XorShiftSeed + Phase);
+          testPack(&PicMsk, &Msk, true);
+
+          //weighted mask without random tile is binary, non-binary mask with BitDepth > 8 cannot be stored compactly
+          genMask(&Msk, false, Phase, xTestUtils::c_XorShiftSeed + Phase);
+          const bool Packed = PicMsk.pack(&Msk);
+          if     (PicMsk.isBinary()) { CHECK(Packed); }
+          else if(BitDepth <= 8    ) { testPack(&PicMsk, &Msk, false); }
+          else                       { CHECK(!Packed); CHECK(PicMsk.getNumNonZero() == NOT_VALID); }
+
+          genMask(&Msk, true, Phase, xTestUtils::c_XorShiftSeed + Phase + 3);
+          testPack(&PicMsk, &Msk, true);
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("xPicMask::Tiles")
+{
+  //tile occupancy map of binary (bit plane) and weighted (8 bit plane) masks - pictures smaller than single tile and partial tiles included
+  for(const int32V2& Size : c_Sizes)
+  {
+    xPicMask PicMsk(Size, c_Margs.back());
+    xPicP    Msk   (Size, 8, c_Margs.back());
+
+    for(const bool Binary : { true, false })
+    {
+      for(const int32 Phase : { 0, 1, 2 })
+      {
+        const std::string Description = fmt::format("Size={}x{} Binary={} Phase={}", Size.getX(), Size.getY(), Binary, Phase);
+        CAPTURE(Description);
+
+        genMask(&Msk, Binary, Phase, xTestUtils::c_XorShiftSeed + Phase);
+        CHECK(PicMsk.pack(&Msk));
+        testTiles(&PicMsk, &Msk);
+      }
+    }
+  }
+}
+
+//===============================================================================================================================================================================================================
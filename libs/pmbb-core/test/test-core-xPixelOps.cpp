@@ -20,6 +20,7 @@ using namespace PMBB_NAMESPACE;
 //===============================================================================================================================================================================================================
 
 static const std::vector<int32> c_Dimms = { 128, 127, 129, 512, 511, 513 };
+static const std::vector<int32> c_DimmX = { 128, 127, 129, 136, 144, 512, 511, 513 }; //also widths with half register remainder (AVX512 masked tails)
 static const std::vector<int32> c_Margs = { 0, 4, 32 };
 static const std::vector<int32> c_BitDs = { 8, 10 ,12, 14 };
 static constexpr int32          c_DefBitDepth    = 14;
@@ -204,7 +205,7 @@ void testCvtResample(
 
   for(const int32 y : c_Dimms)
   {
-    for(const int32 x : c_Dimms)
+    for(const int32 x : c_DimmX)
     {
       int32V2 Size = { x, y };
 
@@ -260,7 +261,7 @@ void testRearrange(
 
   for(const int32 y : c_Dimms)
   {
-    for(const int32 x : c_Dimms)
+    for(const int32 x : c_DimmX)
     {
       int32V2 Size = { x, y };
 
@@ -373,8 +374,11 @@ void testCheckIfInRange(std::function<bool(const uint16*, int32, int32, int32, i
   }
 }
 
-void testCountNonZero(std::function<int32(const uint16*, int32, int32, int32)> CountNonZero)
+template <typename PelType> void testCountNonZero(std::function<int32(const PelType*, int32, int32, int32)> CountNonZero)
 {
+  const int32   BitDepth = sizeof(PelType) == 1 ? 8 : c_DefBitDepth;
+  const PelType MaxValue = (PelType)xBitDepth2MaxValue(BitDepth);
+
   for(const int32 y : c_Dimms)
   {
     for(const int32 x : c_Dimms)
@@ -388,7 +392,7 @@ void testCountNonZero(std::function<int32(const uint16*, int32, int32, int32)> C
         CAPTURE(Description);
 
         //buffers create
-        xPlane<uint16>* P = new xPlane<uint16>(Size, 14, m);
+        xPlane<PelType>* P = new xPlane<PelType>(Size, BitDepth, m);
 
         P->fill(0);
         CHECK(CountNonZero(P->getAddr(), P->getStride(), P->getWidth(), P->getHeight()) == 0);
@@ -407,7 +411,7 @@ void testCountNonZero(std::function<int32(const uint16*, int32, int32, int32)> C
         P->accessPel({ x-1, y-1 }) = 1;
         CHECK(CountNonZero(P->getAddr(), P->getStride(), P->getWidth(), P->getHeight()) == 7);
 
-        P->fill(c_DefMaxValue);
+        P->fill(MaxValue);
         CHECK(CountNonZero(P->getAddr(), P->getStride(), P->getWidth(), P->getHeight()) == Area - 0);
         P->accessPel({ 0, 0 }) = 0;
         CHECK(CountNonZero(P->getAddr(), P->getStride(), P->getWidth(), P->getHeight()) == Area - 1);
@@ -431,6 +435,61 @@ void testCountNonZero(std::function<int32(const uint16*, int32, int32, int32)> C
   }
 }
 
+void testPackBinaryMask(std::function<int32(uint64*, const uint16*, int32, int32, int32, int32, uint16)> PackBinaryMask)
+{
+  for(const int32 y : c_Dimms)
+  {
+    for(const int32 x : c_Dimms)
+    {
+      int32V2 Size = { x, y };
+
+      for(const int32 m : c_Margs)
+      {
+        for(const int32 b : c_BitDs)
+        {
+          const std::string Description = fmt::format("SizeXxY={}x{} Margin={} BitDepth={}", x, y, m, b);
+          CAPTURE(Description);
+
+          const uint16 MaxValue    = (uint16)xBitDepth2MaxValue(b);
+          const int32  BitsStride  = (x + 63) >> 6;
+
+          //buffers create
+          xPlane<uint16>*     P = new xPlane<uint16>(Size, b, m);
+          std::vector<uint64> Bits(BitsStride * y);
+
+          for(int32 t = 0; t < c_NumRandomTests; t++)
+          {
+            xTestUtils::fillRandom(P->getAddr(), P->getStride(), x, y, 1, xTestUtils::c_XorShiftSeed + t);
+            int32 RefNumNonZero = 0;
+            for(int32 j = 0; j < y; j++) { for(int32 i = 0; i < x; i++) { uint16& Pel = P->accessPel({ i, j }); RefNumNonZero += Pel; Pel *= MaxValue; } }
+
+            std::fill(Bits.begin(), Bits.end(), (uint64)0x5555555555555555);
+            CHECK(PackBinaryMask(Bits.data(), P->getAddr(), BitsStride, P->getStride(), x, y, MaxValue) == RefNumNonZero);
+
+            bool AllBitsMatch = true;
+            for(int32 j = 0; j < y; j++)
+            {
+              for(int32 i = 0; i < x; i++)
+              {
+                const bool Bit = (Bits[j * BitsStride + (i >> 6)] >> (i & 63)) & 1;
+                if(Bit != (P->accessPel({ i, j }) != 0)) { AllBitsMatch = false; }
+              }
+            }
+            CHECK(AllBitsMatch);
+
+            //non-binary mask
+            P->accessPel({ x - 1, y - 1 }) = uint16(MaxValue >> 1);
+            CHECK(PackBinaryMask(Bits.data(), P->getAddr(), BitsStride, P->getStride(), x, y, MaxValue) == NOT_VALID);
+          }
+
+          //buffers destroy
+          delete P;
+        }
+      }
+    }
+  }
+}
+
 void testCompareEqual(std::function<bool(const uint16*, const uint16*, int32, int32, int32, int32)> CompareEqual)
 {
   for(const int32 y : c_Dimms)
@@ -541,9 +600,17 @@ TEST_CASE("xPixelOpsSTD")
   (
     &xPixelOpsSTD::CheckIfInRange
   );
-  testCountNonZero
+  testCountNonZero<uint16>
+  (
+    static_cast<int32(*)(const uint16*, int32, int32, int32)>(&xPixelOpsSTD::CountNonZero)
+  );
+  testCountNonZero<uint8>
   (
-    &xPixelOpsSTD::CountNonZero
+    static_cast<int32(*)(const uint8* , int32, int32, int32)>(&xPixelOpsSTD::CountNonZero)
+  );
+  testPackBinaryMask
+  (
+    &xPixelOpsSTD::PackBinaryMask
   );
   testCompareEqual
   (
@@ -596,9 +663,17 @@ TEST_CASE("xPixelOpsSSE")
   (
     &xPixelOpsSSE::CheckIfInRange
   );
-  testCountNonZero
+  testCountNonZero<uint16>
   (
-    &xPixelOpsSSE::CountNonZero
+    static_cast<int32(*)(const uint16*, int32, int32, int32)>(&xPixelOpsSSE::CountNonZero)
+  );
+  testCountNonZero<uint8>
+  (
+    static_cast<int32(*)(const uint8* , int32, int32, int32)>(&xPixelOpsSSE::CountNonZero)
+  );
+  testPackBinaryMask
+  (
+    &xPixelOpsSSE::PackBinaryMask
   );
   testCompareEqual
   (
@@ -653,9 +728,17 @@ TEST_CASE("xPixelOpsAVX")
   (
     &xPixelOpsAVX::CheckIfInRange
   );
-  testCountNonZero
+  testCountNonZero<uint16>
   (
-    &xPixelOpsAVX::CountNonZero
+    static_cast<int32(*)(const uint16*, int32, int32, int32)>(&xPixelOpsAVX::CountNonZero)
+  );
+  testCountNonZero<uint8>
+  (
+    static_cast<int32(*)(const uint8* , int32, int32, int32)>(&xPixelOpsAVX::CountNonZero)
+  );
+  testPackBinaryMask
+  (
+    &xPixelOpsAVX::PackBinaryMask
   );
   testCompareEqual
   (
@@ -709,9 +792,17 @@ TEST_CASE("xPixelOpsAVX512")
   (
     &xPixelOpsAVX512::CheckIfInRange
   );
-  testCountNonZero
+  testCountNonZero<uint16>
+  (
+    static_cast<int32(*)(const uint16*, int32, int32, int32)>(&xPixelOpsAVX512::CountNonZero)
+  );
+  testCountNonZero<uint8>
+  (
+    static_cast<int32(*)(const uint8* , int32, int32, int32)>(&xPixelOpsAVX512::CountNonZero)
+  );
+  testPackBinaryMask
   (
-    &xPixelOpsAVX512::CountNonZero
+    &xPixelOpsAVX512::PackBinaryMask
   );
   testCompareEqual
   (
@@ -1,7 +1,7 @@
 set(SRCLIST_COMMON_H src/xCommonDefIVQM.h)
 
-set(SRCLIST_MTC_H src/xMetricCommon.h  )
-set(SRCLIST_MTC_C src/xMetricCommon.cpp)
+set(SRCLIST_MTC_H src/xMetricCommon.h   src/xDiffStats.h  )
+set(SRCLIST_MTC_C src/xMetricCommon.cpp src/xDiffStats.cpp)
 
 set(SRCLIST_WS_H src/xWeightedSpherically.h  )
 set(SRCLIST_WS_C src/xWeightedSpherically.cpp)
@@ -9,14 +9,14 @@ set(SRCLIST_WS_C src/xWeightedSpherically.cpp)
 set(SRCLIST_GCD_H src/xGlobClrDiff.h  )
 set(SRCLIST_GCD_C src/xGlobClrDiff.cpp)
 
-set(SRCLIST_CPS_H src/xCorrespPixelShift.h   src/xCorrespPixelShiftSTD.h   src/xCorrespPixelShiftSSE.h   src/xShftCompPic.h  )
-set(SRCLIST_CPS_C src/xCorrespPixelShift.cpp src/xCorrespPixelShiftSTD.cpp src/xCorrespPixelShiftSSE.cpp src/xShftCompPic.cpp)
+set(SRCLIST_CPS_H src/xCorrespPixelShift.h   src/xCorrespPixelShiftSTD.h   src/xCorrespPixelShiftSSE.h   src/xCorrespPixelShiftAVX.h   src/xCorrespPixelShiftAVX512.h   src/xShftCompPic.h  )
+set(SRCLIST_CPS_C src/xCorrespPixelShift.cpp src/xCorrespPixelShiftSTD.cpp src/xCorrespPixelShiftSSE.cpp src/xCorrespPixelShiftAVX.cpp src/xCorrespPixelShiftAVX512.cpp src/xShftCompPic.cpp)
 
 set(SRCLIST_IVPSNR_H src/xPSNR.h   src/xWSPSNR.h   src/xIVPSNR.h   )
 set(SRCLIST_IVPSNR_C src/xPSNR.cpp src/xWSPSNR.cpp src/xIVPSNR.cpp )
 
-set(SRCLIST_IVSSIM_H src/xStructSimConsts.h src/xStructSim.h   src/xSSIM.h   )
-set(SRCLIST_IVSSIM_C                        src/xStructSim.cpp src/xSSIM.cpp )
+set(SRCLIST_IVSSIM_H src/xStructSimConsts.h src/xStructSim.h   src/xStructSimAVX.h   src/xStructSimAVX512.h   src/xStructSimBox.h   src/xSSIM.h   )
+set(SRCLIST_IVSSIM_C                        src/xStructSim.cpp src/xStructSimAVX.cpp src/xStructSimAVX512.cpp src/xStructSimBox.cpp src/xSSIM.cpp )
 
 
 
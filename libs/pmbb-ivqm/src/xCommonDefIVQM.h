@@ -11,6 +11,7 @@
 //===============================================================================================================================================================================================================
 #include "xCommonDefCORE.h"
 #include "xThreadPool.h"
+#include "xVec.h"
 
 namespace PMBB_NAMESPACE {
 
@@ -32,9 +33,75 @@ public:
 //===============================================================================================================================================================================================================
 // Compile time settings
 //===============================================================================================================================================================================================================
-static constexpr bool xc_USE_RUNTIME_CMPWEIGHTS  = true ; // use component weights provided at runtime
 static constexpr bool xc_CLIP_CURR_TST_RANGE     = false; // introduces consistency beetwen both IVPSNR methods, breaks compatibility
 
+//===============================================================================================================================================================================================================
+// Search range specialization
+//===============================================================================================================================================================================================================
+// Kernels templated with tSR use compile time search range for tSR > 0 (fully unrolled window) and runtime SearchRange argument for tSR == 0 (generic fallback)
+template <class tFunc> static inline auto xSwitchSearchRange(const int32 SearchRange, tFunc&& Func)
+{
+  switch(SearchRange)
+  {
+    case 1 : return Func(std::integral_constant<int32, 1>());
+    case 2 : return Func(std::integral_constant<int32, 2>());
+    case 3 : return Func(std::integral_constant<int32, 3>());
+    case 4 : return Func(std::integral_constant<int32, 4>());
+    default: return Func(std::integral_constant<int32, 0>());
+  }
+}
+
+//===============================================================================================================================================================================================================
+// Component weights specialization
+//===============================================================================================================================================================================================================
+enum class eCmpWgh : int32 //component weights used during search
+{
+  GENERIC = 0, //any weights - multiplication
+  W4110   = 1, //4:1:1:0 (default) - shift and add
+  W1110   = 2, //1:1:1:0 (equal)   - add only
+};
+
+static inline eCmpWgh xClassifyCmpWeights(const int32V4& CmpWeights)
+{
+  if(CmpWeights == int32V4(4, 1, 1, 0)) { return eCmpWgh::W4110; }
+  if(CmpWeights == int32V4(1, 1, 1, 0)) { return eCmpWgh::W1110; }
+  return eCmpWgh::GENERIC;
+}
+
+// Kernels templated with tCW use shift/add for W4110 and W1110, generic kernel (tCW == GENERIC) multiplies by runtime CmpWeights argument
+template <class tFunc> static inline auto xSwitchCmpWeights(const int32V4& CmpWeights, tFunc&& Func)
+{
+  switch(xClassifyCmpWeights(CmpWeights))
+  {
+    case eCmpWgh::W4110: return Func(std::integral_constant<eCmpWgh, eCmpWgh::W4110>());
+    case eCmpWgh::W1110: return Func(std::integral_constant<eCmpWgh, eCmpWgh::W1110>());
+    default            : return Func(std::integral_constant<eCmpWgh, eCmpWgh::GENERIC>());
+  }
+}
+
+template <eCmpWgh tCW> static inline int32 xCalcWeightedError(const int32 DistLm, const int32 DistCb, const int32 DistCr, const int32V4& CmpWeights)
+{
+  if constexpr(tCW == eCmpWgh::W4110) { return (DistLm << 2) + DistCb + DistCr; }
+  if constexpr(tCW == eCmpWgh::W1110) { return  DistLm       + DistCb + DistCr; }
+  return DistLm * CmpWeights[0] + DistCb * CmpWeights[1] + DistCr * CmpWeights[2];
+}
+template <eCmpWgh tCW> static inline int32 xCalcWeightedError(const int32V4& Dist, const int32V4& CmpWeights)
+{
+  if constexpr(tCW == eCmpWgh::GENERIC) { return (Dist * CmpWeights).getSum(); }
+  return xCalcWeightedError<tCW>(Dist[0], Dist[1], Dist[2], CmpWeights);
+}
+
+//===============================================================================================================================================================================================================
+// Narrow (16-bit) search arithmetic
+//===============================================================================================================================================================================================================
+// SIMD search kernels can keep samples in 16-bit lanes (multiply-add of 16-bit pairs, twice as many candidates per instruction)
+// if differences multiplied by component weights fit in int16 - always true for 8-bit content with default weights
+static inline bool xCanUseNarrowSearch(const int32 BitDepth, const int32V4& GlobalColorShift, const int32V4& CmpWeights)
+{
+  const int32 MaxDiff = ((1 << BitDepth) - 1) + GlobalColorShift.getMaxAbs();
+  return CmpWeights.getMin() >= 0 && MaxDiff * CmpWeights.getMax() <= (int32)std::numeric_limits<int16>::max();
+}
+
 //===============================================================================================================================================================================================================
 
 } //end of namespace PMBB
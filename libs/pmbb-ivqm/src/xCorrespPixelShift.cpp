@@ -5,6 +5,7 @@
 */
 
 #include "xCorrespPixelShift.h"
+#include "xPixelOps.h"
 #include <cassert>
 #include <numeric>
 
@@ -14,14 +15,171 @@ namespace PMBB_NAMESPACE {
 // xBaseIV
 //===============================================================================================================================================================================================================
 
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// equal tiles pre-pass
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+int32 xCorrespPixelShift::xCalcEqualTilesRow(const xPicP* Tst, const xPicP* Ref, const int32 TileY, uint8* EqualTilesRow)
+{
+  assert(Tst->isCompatible(Ref));
+
+  const int32 Width        = Tst->getWidth();
+  const int32 NumTilesX    = xCorrespPixelShiftPrms::CalcNumEqualTiles(Width);
+  const int32 BegY         = TileY << xCorrespPixelShiftPrms::c_Log2EqualTileSize;
+  const int32 TileHeight   = xMin(xCorrespPixelShiftPrms::c_EqualTileSize, Tst->getHeight() - BegY);
+  int32       NumEqualPels = 0;
+
+  for(int32 t = 0; t < NumTilesX; t++)
+  {
+    const int32 BegX      = t << xCorrespPixelShiftPrms::c_Log2EqualTileSize;
+    const int32 TileWidth = xMin(xCorrespPixelShiftPrms::c_EqualTileSize, Width - BegX);
+    bool Equal = true;
+    for(int32 CmpIdx = 0; CmpIdx < 3 && Equal; CmpIdx++)
+    {
+      Equal = xPixelOps::CompareEqual(Tst->getAddr({ BegX, BegY }, (eCmp)CmpIdx), Ref->getAddr({ BegX, BegY }, (eCmp)CmpIdx), Tst->getStride(), Ref->getStride(), TileWidth, TileHeight);
+    }
+    EqualTilesRow[t] = (uint8)Equal;
+    if(Equal) { NumEqualPels += TileWidth * TileHeight; }
+  }
+
+  return NumEqualPels;
+}
+int32 xCorrespPixelShift::xCalcEqualTilesRow(const xPicI* Tst, const xPicI* Ref, const int32 TileY, uint8* EqualTilesRow)
+{
+  assert(Tst->isCompatible(Ref));
+
+  //interleaved picture is compared as planar one with c_MaxNumCmps times wider rows (unused 4th component is zero in both pictures)
+  const int32 Width        = Tst->getWidth();
+  const int32 NumTilesX    = xCorrespPixelShiftPrms::CalcNumEqualTiles(Width);
+  const int32 BegY         = TileY << xCorrespPixelShiftPrms::c_Log2EqualTileSize;
+  const int32 TileHeight   = xMin(xCorrespPixelShiftPrms::c_EqualTileSize, Tst->getHeight() - BegY);
+  int32       NumEqualPels = 0;
+
+  for(int32 t = 0; t < NumTilesX; t++)
+  {
+    const int32   BegX      = t << xCorrespPixelShiftPrms::c_Log2EqualTileSize;
+    const int32   TileWidth = xMin(xCorrespPixelShiftPrms::c_EqualTileSize, Width - BegX);
+    const uint16* TstPtr    = (const uint16*)(Tst->getAddr() + Tst->getOffset({ BegX, BegY }));
+    const uint16* RefPtr    = (const uint16*)(Ref->getAddr() + Ref->getOffset({ BegX, BegY }));
+    const bool    Equal     = xPixelOps::CompareEqual(TstPtr, RefPtr, Tst->getStride() * xPicI::c_MaxNumCmps, Ref->getStride() * xPicI::c_MaxNumCmps, TileWidth * xPicI::c_MaxNumCmps, TileHeight);
+    EqualTilesRow[t] = (uint8)Equal;
+    if(Equal) { NumEqualPels += TileWidth * TileHeight; }
+  }
+
+  return NumEqualPels;
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// asymetric Q - equal tiles skipping
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+uint64V4 xCorrespPixelShift::xCalcDistAsymmetricRowSkip(const xPicP* Tst, const xPicP* Ref, const int32 y, const uint8* EqualTilesRow, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp)
+{
+  return xCalcDistAsymmetricRowSkipT(Tst, Ref, y, EqualTilesRow, GlobalColorShift, SearchRange, CmpWeights, ShftComp);
+}
+uint64V4 xCorrespPixelShift::xCalcDistAsymmetricRowSkip(const xPicI* Tst, const xPicI* Ref, const int32 y, const uint8* EqualTilesRow, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp)
+{
+  return xCalcDistAsymmetricRowSkipT(Tst, Ref, y, EqualTilesRow, GlobalColorShift, SearchRange, CmpWeights, ShftComp);
+}
+template <class tPic> uint64V4 xCorrespPixelShift::xCalcDistAsymmetricRowSkipT(const tPic* Tst, const tPic* Ref, const int32 y, const uint8* EqualTilesRow, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp)
+{
+  const int32 Width = Tst->getWidth();
+  if(EqualTilesRow == nullptr) { return xCalcDistAsymmetricRow(Tst, Ref, y, 0, Width, GlobalColorShift, SearchRange, CmpWeights, ShftComp); }
+
+  //equal tiles contribute zero distance - search runs of non-equal tiles only, best match within equal tile is the co-located pel (or pel of the same value)
+  const int32 NumTilesX = xCorrespPixelShiftPrms::CalcNumEqualTiles(Width);
+  uint64V4    RowDist   = { 0, 0, 0, 0 };
+  int32       BegT      = 0;
+  while(BegT < NumTilesX)
+  {
+    const bool Equal = EqualTilesRow[BegT] != 0;
+    int32 EndT = BegT + 1;
+    while(EndT < NumTilesX && (EqualTilesRow[EndT] != 0) == Equal) { EndT++; }
+    const int32 BegX = BegT << xCorrespPixelShiftPrms::c_Log2EqualTileSize;
+    const int32 EndX = xMin(EndT << xCorrespPixelShiftPrms::c_Log2EqualTileSize, Width);
+    if     (!Equal              ) { RowDist += xCalcDistAsymmetricRow(Tst, Ref, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights, ShftComp); }
+    else if(ShftComp != nullptr) { xStoreColocatedRow(ShftComp, Ref, y, BegX, EndX, GlobalColorShift); }
+    BegT = EndT;
+  }
+
+  return RowDist;
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// asymetric Q - compact mask tiles skipping
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void xCorrespPixelShift::xCalcSearchTilesRow(const xPicMask* Msk, const int32 TileY, const int32 SearchRange, xPicMask::eTile* SearchTilesRow)
+{
+  using eTile = xPicMask::eTile;
+
+  const int32  NumTilesX = Msk->getNumTilesX();
+  const int32  NumTilesY = Msk->getNumTilesY();
+  const eTile* Tiles     = Msk->getTiles();
+  //search window has to fit within neighbouring tiles, tiles outside picture are ignored (margin replicates pixels of border tiles)
+  const bool   CanBeFull = SearchRange <= xPicMask::c_TileSize;
+  const int32  BegTY     = xMax(TileY - 1, 0);
+  const int32  EndTY     = xMin(TileY + 1, NumTilesY - 1);
+
+  for(int32 tx = 0; tx < NumTilesX; tx++)
+  {
+    const eTile Tile = Tiles[TileY * NumTilesX + tx];
+    if(Tile != eTile::Full) { SearchTilesRow[tx] = Tile        ; continue; }
+    if(!CanBeFull         ) { SearchTilesRow[tx] = eTile::Mixed; continue; }
+
+    const int32 BegTX = xMax(tx - 1, 0);
+    const int32 EndTX = xMin(tx + 1, NumTilesX - 1);
+    bool AllFull = true;
+    for(int32 ty = BegTY; ty <= EndTY && AllFull; ty++)
+    {
+      for(int32 nx = BegTX; nx <= EndTX; nx++) { AllFull &= Tiles[ty * NumTilesX + nx] == eTile::Full; }
+    }
+    SearchTilesRow[tx] = AllFull ? eTile::Full : eTile::Mixed;
+  }
+}
+uint64V4 xCorrespPixelShift::xCalcDistAsymmetricRowSkipM(const xPicI* Tst, const xPicI* Ref, const xPicMask* Msk, const int32 y, const xPicMask::eTile* SearchTilesRow, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp)
+{
+  //compact mask stores weights divided by Scale, pixels within full tiles have weight equal to FullValue * Scale
+  const uint64 FullValue = (uint64)Msk->getFullValue();
+  uint64V4     RowDist   = { 0, 0, 0, 0 };
+  uint64V4     FullDist  = { 0, 0, 0, 0 };
+
+  //shift compensated row has to cover masked pels too (IV-SSIM is not masked) - empty and mixed tiles are searched by unmasked kernel (distortion discarded)
+  xPicMask::ForEachTileRun(SearchTilesRow, Tst->getWidth(), [&](int32 BegX, int32 EndX, xPicMask::eTile Tile)
+  {
+    if(ShftComp != nullptr && Tile != xPicMask::eTile::Full) { xCalcDistAsymmetricRow(Tst, Ref, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights, ShftComp); }
+    switch(Tile)
+    {
+      case xPicMask::eTile::Empty: break;
+      case xPicMask::eTile::Full : FullDist += xCalcDistAsymmetricRow (Tst, Ref,      y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights, ShftComp); break;
+      case xPicMask::eTile::Mixed: RowDist  += xCalcDistAsymmetricRowM(Tst, Ref, Msk, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights          ); break;
+    }
+  });
+
+  return (RowDist + FullDist * FullValue) * (uint64)Msk->getScale();
+}
+
 //---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // asymetric Q planar
 //---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-uint64V4 xCorrespPixelShift::xCalcDistAsymmetricRow(const xPicP* Tst, const xPicP* Ref, const int32 y, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights)
+uint64V4 xCorrespPixelShift::xCalcDistAsymmetricRow(const xPicP* Tst, const xPicP* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp)
+{
+  uint64V4 RowDist = { 0, 0, 0, 0 };
+  int32    TailX   = BegX;
+  if constexpr(c_NumPelsPlanarSIMD > 0)
+  {
+    TailX = EndX - (EndX - BegX) % c_NumPelsPlanarSIMD;
+    if(TailX > BegX) { RowDist = xCalcDistAsymmetricRowSIMD(Tst, Ref, y, BegX, TailX, GlobalColorShift, SearchRange, CmpWeights, ShftComp); }
+  }
+  if(TailX < EndX) { RowDist += xSwitchCmpWeights(CmpWeights, [&](auto CW) { return xSwitchSearchRange(SearchRange, [&](auto SR) { return xCalcDistAsymmetricRowT<SR, CW>(Tst, Ref, y, TailX, EndX, GlobalColorShift, SearchRange, CmpWeights, ShftComp); }); }); }
+  return RowDist;
+}
+int32 xCorrespPixelShift::xFindBestPixelWithinBlock(const int32V4& TstPel, const xPicP* Ref, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  return xSwitchCmpWeights(CmpWeights, [&](auto CW) { return xSwitchSearchRange(SearchRange, [&](auto SR) { return xFindBestPixelWithinBlockT<SR, CW>(TstPel, Ref, CenterX, CenterY, SearchRange, CmpWeights); }); });
+}
+template <int32 tSR, eCmpWgh tCW> uint64V4 xCorrespPixelShift::xCalcDistAsymmetricRowT(const xPicP* Tst, const xPicP* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp)
 {
-  const int32  Width     = Tst->getWidth();
   const int32  TstStride = Tst->getStride();
   const int32  TstOffset = y * TstStride;
+  const int32  ShftCompY = ShftComp != nullptr ? y % ShftComp->getHeight() : 0;
 
   uint64V4 RowDist = { 0, 0, 0, 0 };
 
@@ -29,10 +187,10 @@ uint64V4 xCorrespPixelShift::xCalcDistAsymmetricRow(const xPicP* Tst, const xPic
   const uint16* TstPtrCb = Tst->getAddr(eCmp::CB) + TstOffset;
   const uint16* TstPtrCr = Tst->getAddr(eCmp::CR) + TstOffset;
 
-  for(int32 x = 0; x < Width; x++)
+  for(int32 x = BegX; x < EndX; x++)
   {
     const int32V4 CurrTstValue  = int32V4((int32)(TstPtrLm[x]), (int32)(TstPtrCb[x]), (int32)(TstPtrCr[x]), 0) + GlobalColorShift;
-    const int32   BestRefOffset = xFindBestPixelWithinBlock(CurrTstValue, Ref, x, y, SearchRange, CmpWeights);
+    const int32   BestRefOffset = xFindBestPixelWithinBlockT<tSR, tCW>(CurrTstValue, Ref, x, y, SearchRange, CmpWeights);
 
     for(uint32 CmpIdx = 0; CmpIdx < 3; CmpIdx++)
     {
@@ -41,16 +199,22 @@ uint64V4 xCorrespPixelShift::xCalcDistAsymmetricRow(const xPicP* Tst, const xPic
       int32 Dist = xPow2(Diff);
       RowDist[CmpIdx] += Dist;
     }
+    if(ShftComp != nullptr)
+    {
+      const int32V4 BestRefValue = int32V4((int32)Ref->getAddr(eCmp::LM)[BestRefOffset], (int32)Ref->getAddr(eCmp::CB)[BestRefOffset], (int32)Ref->getAddr(eCmp::CR)[BestRefOffset], 0);
+      xStorePel(ShftComp, x, ShftCompY, (BestRefValue - GlobalColorShift).getClipU(xMakeVec4<int32>(xBitDepth2MaxValue(Ref->getBitDepth()))));
+    }
   }//x
 
   return RowDist;
 }
-int32 xCorrespPixelShift::xFindBestPixelWithinBlock(const int32V4& TstPel, const xPicP* Ref, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const int32V4& CmpWeights)
+template <int32 tSR, eCmpWgh tCW> int32 xCorrespPixelShift::xFindBestPixelWithinBlockT(const int32V4& TstPel, const xPicP* Ref, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const int32V4& CmpWeights)
 {
-  const int32 BegY = CenterY - SearchRange;
-  const int32 EndY = CenterY + SearchRange;
-  const int32 BegX = CenterX - SearchRange;
-  const int32 EndX = CenterX + SearchRange;
+  const int32 SR   = tSR > 0 ? tSR : SearchRange;
+  const int32 BegY = CenterY - SR;
+  const int32 EndY = CenterY + SR;
+  const int32 BegX = CenterX - SR;
+  const int32 EndX = CenterX + SR;
 
   const uint16* RefPtrLm = Ref->getAddr  (eCmp::LM);
   const uint16* RefPtrCb = Ref->getAddr  (eCmp::CB);
@@ -68,22 +232,247 @@ int32 xCorrespPixelShift::xFindBestPixelWithinBlock(const int32V4& TstPel, const
       const int32 DistLm = xPow2(TstPel[0] - (int32)(RefPtrLm[Offset]));
       const int32 DistCb = xPow2(TstPel[1] - (int32)(RefPtrCb[Offset]));
       const int32 DistCr = xPow2(TstPel[2] - (int32)(RefPtrCr[Offset]));
-      if constexpr (xCorrespPixelShiftPrms::c_UseRuntimeCmpWeights)
-      {
-        const int32 Error = DistLm * CmpWeights[0] + DistCb * CmpWeights[1] + DistCr * CmpWeights[2];
-        if(Error < BestError) { BestError = Error; BestOffset = Offset; }
-      }
-      else
-      {
-        const int32 Error = (DistLm << 2) + DistCb + DistCr;
-        if (Error < BestError) { BestError = Error; BestOffset = Offset; }
-      }
+      const int32 Error  = xCalcWeightedError<tCW>(DistLm, DistCb, DistCr, CmpWeights);
+      if(Error < BestError) { BestError = Error; BestOffset = Offset; }
     } //x
   } //y
 
   return BestOffset;
 }
 
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// symmetric Q - shared displacement errors
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void xCorrespPixelShift::xCalcDistSymmetricRows(const xPicP* Tst, const xPicP* Ref, const int32 BegY, const int32 EndY, const uint8* EqualTiles, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, uint64V4* RowDistR2T, uint64V4* RowDistT2R, xPicP* ShftCompTst, xPicP* ShftCompRef, xSymmetricBuffers& Buffers)
+{
+  xCalcDistSymmetricRowsT(Tst, Ref, BegY, EndY, EqualTiles, GlobalColorShift, SearchRange, CmpWeights, RowDistR2T, RowDistT2R, ShftCompTst, ShftCompRef, Buffers);
+}
+void xCorrespPixelShift::xCalcDistSymmetricRows(const xPicI* Tst, const xPicI* Ref, const int32 BegY, const int32 EndY, const uint8* EqualTiles, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, uint64V4* RowDistR2T, uint64V4* RowDistT2R, xPicP* ShftCompTst, xPicP* ShftCompRef, xSymmetricBuffers& Buffers)
+{
+  xCalcDistSymmetricRowsT(Tst, Ref, BegY, EndY, EqualTiles, GlobalColorShift, SearchRange, CmpWeights, RowDistR2T, RowDistT2R, ShftCompTst, ShftCompRef, Buffers);
+}
+template <class tPic> void xCorrespPixelShift::xCalcDistSymmetricRowsT(const tPic* Tst, const tPic* Ref, const int32 BegY, const int32 EndY, const uint8* EqualTiles, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, uint64V4* RowDistR2T, uint64V4* RowDistT2R, xPicP* ShftCompTst, xPicP* ShftCompRef, xSymmetricBuffers& Buffers)
+{
+  //Weighted error of pair (Tst[q], Ref[q+d]) is the same for R2T (test position q, displacement d) and T2R (reference position q+d, displacement -d).
+  //Test rows are processed in order, row kernel calculates errors of test row q.y against all displacements once and uses each of them twice: R2T best match
+  //of test row q.y is found in registers, T2R running minimum of reference rows q.y+d.y (ring of WindowSize rows) is updated in memory. T2R row is complete
+  //after test row q.y+SR. Both directions select candidate with lowest error and then lowest plane index (raster order of displacements), same as strict
+  //less-than raster scan of xFindBestPixelWithinBlock. Pixels within equal tiles are skipped in both directions (zero distance). Error of pair is needed
+  //by R2T at q and T2R at q+d only, so it is not calculated if all tiles within SearchRange around q are equal (quiet tiles).
+  //Shift compensated pictures: ShftCompRef(q) = Ref(q+d) - GCS for R2T best match, ShftCompTst(q) = Tst(q+d) + GCS for T2R best match. Best match of pixel
+  //within equal tile has zero error, so it has the same value as the co-located pixel (GCS is zero if EqualTiles != nullptr).
+  //Row kernels may process pixels beyond requested range (rows are padded), such candidates are genuine pairs or land outside of picture - never used.
+  static_assert(xSymmetricBuffers::c_RowPadding >= c_NumPelsPlanarSIMD);
+  assert(Tst->isCompatible(Ref));
+  assert((ShftCompTst == nullptr && ShftCompRef == nullptr) || (ShftCompTst != nullptr && ShftCompRef != nullptr && Tst->isSameSize(ShftCompTst) && Tst->isSameSize(ShftCompRef)));
+
+  const int32 SR         = SearchRange;
+  assert(Tst->getMargin() >= SR);
+
+  const int32 Width      = Tst->getWidth ();
+  const int32 Height     = Tst->getHeight();
+  const int32 WindowSize = 2 * SR + 1;
+  const int32 NumPlanes  = WindowSize * WindowSize;
+  const int32 ExtWidth   = Width + 2 * SR; //fetched columns [-SearchRange, Width + SearchRange)
+  const int32 RowWidth   = Width + 4 * SR + xSymmetricBuffers::c_RowPadding; //columns [-2 * SearchRange, Width + 2 * SearchRange + c_RowPadding)
+  const int32 RowOrigin  = 2 * SR;
+  const int32 NumTilesX  = xCorrespPixelShiftPrms::CalcNumEqualTiles(Width );
+  const int32 NumTilesY  = xCorrespPixelShiftPrms::CalcNumEqualTiles(Height);
+  const int32 TileRange  = (SR + xCorrespPixelShiftPrms::c_EqualTileSize - 1) >> xCorrespPixelShiftPrms::c_Log2EqualTileSize;
+  const bool  StoreSCP   = ShftCompTst != nullptr;
+  const int32V4 MaxValue = xMakeVec4<int32>(StoreSCP ? ShftCompRef->getMaxPelValue() : 0);
+
+  Buffers.resize(WindowSize, RowWidth, NumTilesX);
+  std::vector<uint8  >& QuietTiles   = Buffers.m_QuietTiles;
+  std::vector<int32V2>& CostRuns     = Buffers.m_CostRuns;   //column ranges [beg, end) of errors to be calculated
+  std::vector<int32V2>& SearchRuns   = Buffers.m_SearchRuns; //column ranges [beg, end) of pixels to be searched
+  int32*                PlaneOffsets = Buffers.m_PlaneOffsets.data();
+
+  //pointers to column 0 of ring slots
+  auto getRingSlot = [&](const int32 y) { return (y + 2 * WindowSize) % WindowSize; };
+  auto getTstRow   = [&](const int32 y, const int32 CmpIdx) { return Buffers.m_TstRows     .data() + (getRingSlot(y) * 3 + CmpIdx) * RowWidth + RowOrigin; };
+  auto getRefRow   = [&](const int32 y, const int32 CmpIdx) { return Buffers.m_RefRows     .data() + (getRingSlot(y) * 3 + CmpIdx) * RowWidth + RowOrigin; };
+  auto getErrorT2R = [&](const int32 y                    ) { return Buffers.m_BestErrorT2R.data() +  getRingSlot(y)                * RowWidth + RowOrigin; };
+  auto getPlaneT2R = [&](const int32 y                    ) { return Buffers.m_BestPlaneT2R.data() +  getRingSlot(y)                * RowWidth + RowOrigin; };
+  auto fetchRow    = [&](const tPic* Pic, const int32 y, int32* DstRow, const int32V4& Offset) { xFetchRow(Pic, y, -SR, ExtWidth, Offset, DstRow - SR, DstRow + RowWidth - SR, DstRow + 2 * RowWidth - SR); };
+
+  //offsets of displaced positions within ring (both rings have the same layout) for pixels of row y, component CmpIdx is located at Offset + x + CmpIdx * RowWidth
+  auto calcPlaneOffsets = [&](const int32 y)
+  {
+    for(int32 dy = -SR; dy <= SR; dy++)
+    {
+      const int32 RowOffset = getRingSlot(y + dy) * 3 * RowWidth + RowOrigin;
+      for(int32 dx = -SR; dx <= SR; dx++) { PlaneOffsets[(dy + SR) * WindowSize + dx + SR] = RowOffset + dx; }
+    }
+  };
+
+  auto getTileY = [&](const int32 y) { return xClipU(y >> xCorrespPixelShiftPrms::c_Log2EqualTileSize, NumTilesY - 1); };
+
+  //collects runs of tiles with Flags[t] == 0, first and last run are extended to columns [-Margin, Width + Margin)
+  auto collectRuns = [&](const uint8* Flags, const int32 Margin, std::vector<int32V2>& Runs)
+  {
+    Runs.clear();
+    if(Flags == nullptr) { Runs.push_back({ -Margin, Width + Margin }); return; }
+    for(int32 BegT = 0; BegT < NumTilesX; )
+    {
+      if(Flags[BegT]) { BegT++; continue; }
+      int32 EndT = BegT + 1;
+      while(EndT < NumTilesX && !Flags[EndT]) { EndT++; }
+      const int32 BegX = BegT == 0         ? -Margin        : BegT << xCorrespPixelShiftPrms::c_Log2EqualTileSize;
+      const int32 EndX = EndT == NumTilesX ? Width + Margin : EndT << xCorrespPixelShiftPrms::c_Log2EqualTileSize;
+      Runs.push_back({ BegX, EndX });
+      BegT = EndT;
+    }
+  };
+
+  //tile is quiet if all tiles within TileRange are equal
+  auto collectCostRuns = [&](const int32 y)
+  {
+    if(EqualTiles == nullptr) { collectRuns(nullptr, SR, CostRuns); return; }
+    const int32 TileY = getTileY(y);
+    const int32 BegTY = xMax(TileY - TileRange, 0);
+    const int32 EndTY = xMin(TileY + TileRange, NumTilesY - 1);
+    for(int32 t = 0; t < NumTilesX; t++)
+    {
+      const int32 BegTX = xMax(t - TileRange, 0);
+      const int32 EndTX = xMin(t + TileRange, NumTilesX - 1);
+      bool Quiet = true;
+      for(int32 ty = BegTY; ty <= EndTY && Quiet; ty++) { for(int32 tx = BegTX; tx <= EndTX && Quiet; tx++) { Quiet = EqualTiles[ty * NumTilesX + tx] != 0; } }
+      QuietTiles[t] = (uint8)Quiet;
+    }
+    collectRuns(QuietTiles.data(), SR, CostRuns);
+  };
+
+  //errors of test row y against all displacements
+  auto calcCostRow = [&](const int32 y, const bool DoR2T)
+  {
+    collectCostRuns(y);
+    if(CostRuns.empty()) { return; }
+
+    for(int32 dy = -SR; dy <= SR; dy++)
+    {
+      const int32 RefY  = y + dy;
+      const bool  DoT2R = RefY >= BegY && RefY < EndY;
+      for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++) { Buffers.m_RefRowPtrs[3 * (dy + SR) + CmpIdx] = getRefRow(RefY, CmpIdx); }
+      Buffers.m_ErrorT2RPtrs[dy + SR] = DoT2R ? getErrorT2R(RefY) : nullptr;
+      Buffers.m_PlaneT2RPtrs[dy + SR] = DoT2R ? getPlaneT2R(RefY) : nullptr;
+    }
+
+    for(const int32V2& Run : CostRuns)
+    {
+      xUpdateBestSymmetricRow(getTstRow(y, 0), getTstRow(y, 1), getTstRow(y, 2), Buffers.m_RefRowPtrs.data(), DoR2T ? Buffers.m_BestPlaneR2T.data() + RowOrigin : nullptr,
+                              Buffers.m_ErrorT2RPtrs.data(), Buffers.m_PlaneT2RPtrs.data(), Run[0], Run[1], SR, CmpWeights);
+    }
+  };
+
+  //R2T - test position (x,y), reference position (x+dx,y+dy)
+  auto finishR2T = [&](const int32 y)
+  {
+    collectRuns(EqualTiles != nullptr ? EqualTiles + getTileY(y) * NumTilesX : nullptr, 0, SearchRuns);
+    //shift compensated pixels within equal tiles are co-located ones (searched pixels are overwritten below)
+    if(StoreSCP && EqualTiles != nullptr) { for(int32 x = 0; x < Width; x++) { xStorePel(ShftCompRef, x, y, xFetchPel(Ref, x, y)); } }
+
+    calcPlaneOffsets(y);
+    const int32* BestPlane = Buffers.m_BestPlaneR2T.data() + RowOrigin;
+    const int32* TstLm     = getTstRow(y, 0);
+    const int32* RefRing   = Buffers.m_RefRows.data();
+    uint64V4 RowDist = { 0, 0, 0, 0 };
+    if(!StoreSCP)
+    {
+      for(const int32V2& Run : SearchRuns) { RowDist += xCalcDistBestMatchRow(TstLm, RefRing, BestPlane, PlaneOffsets, RowWidth, Run[0], Run[1]); }
+      RowDistR2T[y] = RowDist;
+      return;
+    }
+    for(const int32V2& Run : SearchRuns)
+    {
+      for(int32 x = Run[0]; x < Run[1]; x++)
+      {
+        assert(BestPlane[x] >= 0 && BestPlane[x] < NumPlanes);
+        const int32   Offset = PlaneOffsets[BestPlane[x]] + x;
+        const int32V4 RefPel = int32V4(RefRing[Offset], RefRing[Offset + RowWidth], RefRing[Offset + 2 * RowWidth], 0);
+        const int32V4 Diff   = int32V4(TstLm[x], TstLm[x + RowWidth], TstLm[x + 2 * RowWidth], 0) - RefPel; //TODO - xc_CLIP_CURR_TST_RANGE
+        RowDist += (uint64V4)(Diff.getVecPow2());
+        if(StoreSCP) { xStorePel(ShftCompRef, x, y, (RefPel - GlobalColorShift).getClipU(MaxValue)); }
+      } //x
+    } //Run
+    RowDistR2T[y] = RowDist;
+  };
+
+  //T2R - reference position (x,y), test position (x+dx,y+dy)
+  auto finishT2R = [&](const int32 y)
+  {
+    collectRuns(EqualTiles != nullptr ? EqualTiles + getTileY(y) * NumTilesX : nullptr, 0, SearchRuns);
+    if(StoreSCP && EqualTiles != nullptr) { for(int32 x = 0; x < Width; x++) { xStorePel(ShftCompTst, x, y, xFetchPel(Tst, x, y)); } }
+
+    calcPlaneOffsets(y);
+    const int32* BestPlane = getPlaneT2R(y);
+    const int32* RefLm     = getRefRow(y, 0);
+    const int32* TstRing   = Buffers.m_TstRows.data();
+    uint64V4 RowDist = { 0, 0, 0, 0 };
+    if(!StoreSCP)
+    {
+      for(const int32V2& Run : SearchRuns) { RowDist += xCalcDistBestMatchRow(RefLm, TstRing, BestPlane, PlaneOffsets, RowWidth, Run[0], Run[1]); }
+      RowDistT2R[y] = RowDist;
+      return;
+    }
+    for(const int32V2& Run : SearchRuns)
+    {
+      for(int32 x = Run[0]; x < Run[1]; x++)
+      {
+        assert(BestPlane[x] >= 0 && BestPlane[x] < NumPlanes);
+        const int32   Offset = PlaneOffsets[BestPlane[x]] + x;
+        const int32V4 TstPel = int32V4(TstRing[Offset], TstRing[Offset + RowWidth], TstRing[Offset + 2 * RowWidth], 0);
+        const int32V4 Diff   = TstPel - int32V4(RefLm[x], RefLm[x + RowWidth], RefLm[x + 2 * RowWidth], 0); //TODO - xc_CLIP_CURR_TST_RANGE
+        RowDist += (uint64V4)(Diff.getVecPow2());
+        if(StoreSCP) { xStorePel(ShftCompTst, x, y, TstPel.getClipU(MaxValue)); }
+      } //x
+    } //Run
+    RowDistT2R[y] = RowDist;
+  };
+
+  //rings hold test rows [y - 2SR, y] and reference rows [y - SR, y + SR] (rows outside of [BegY - SR, EndY + SR) are never used)
+  for(int32 y = BegY - SR; y < BegY; y++) { fetchRow(Ref, y, getRefRow(y, 0), xMakeVec4<int32>(0)); }
+
+  for(int32 y = BegY - SR; y < EndY + SR; y++)
+  {
+    const int32 NextRefY = y + SR;
+    if(NextRefY < EndY + SR) { fetchRow(Ref, NextRefY, getRefRow(NextRefY, 0), xMakeVec4<int32>(0)); }
+    fetchRow(Tst, y, getTstRow(y, 0), GlobalColorShift);
+
+    //first candidates of reference row y + SR come from test row y
+    if(NextRefY >= BegY && NextRefY < EndY)
+    {
+      std::fill_n(getErrorT2R(NextRefY) - RowOrigin, RowWidth, std::numeric_limits<int32>::max());
+      std::fill_n(getPlaneT2R(NextRefY) - RowOrigin, RowWidth, NumPlanes);
+    }
+
+    const bool DoR2T = y >= BegY && y < EndY;
+    calcCostRow(y, DoR2T);
+
+    if(DoR2T                          ) { finishR2T(y     ); }
+    if(y - SR >= BegY && y - SR < EndY) { finishT2R(y - SR); } //last candidates of reference row y - SR come from test row y
+  } //y
+}
+void xCorrespPixelShift::xFetchRow(const xPicP* Pic, const int32 y, const int32 BegX, const int32 Length, const int32V4& Offset, int32* restrict DstLm, int32* restrict DstCb, int32* restrict DstCr)
+{
+  const uint16* restrict SrcLm = Pic->getAddr({ BegX, y }, eCmp::LM);
+  const uint16* restrict SrcCb = Pic->getAddr({ BegX, y }, eCmp::CB);
+  const uint16* restrict SrcCr = Pic->getAddr({ BegX, y }, eCmp::CR);
+  for(int32 x = 0; x < Length; x++) { DstLm[x] = (int32)SrcLm[x] + Offset[0]; }
+  for(int32 x = 0; x < Length; x++) { DstCb[x] = (int32)SrcCb[x] + Offset[1]; }
+  for(int32 x = 0; x < Length; x++) { DstCr[x] = (int32)SrcCr[x] + Offset[2]; }
+}
+void xCorrespPixelShift::xFetchRow(const xPicI* Pic, const int32 y, const int32 BegX, const int32 Length, const int32V4& Offset, int32* restrict DstLm, int32* restrict DstCb, int32* restrict DstCr)
+{
+  const uint16V4* restrict Src = Pic->getAddr() + Pic->getOffset({ BegX, y });
+  for(int32 x = 0; x < Length; x++)
+  {
+    DstLm[x] = (int32)Src[x][0] + Offset[0];
+    DstCb[x] = (int32)Src[x][1] + Offset[1];
+    DstCr[x] = (int32)Src[x][2] + Offset[2];
+  }
+}
+
 //===============================================================================================================================================================================================================
 
 } //end of namespace PMBB
\ No newline at end of file
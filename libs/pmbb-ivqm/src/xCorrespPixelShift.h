@@ -6,7 +6,7 @@
 
 #pragma once
 #include "xCommonDefIVQM.h"
-#include "xPic.h"
+#include "xPicMask.h"
 
 //portable implementation
 #include "xCorrespPixelShiftSTD.h"
@@ -19,6 +19,22 @@
 #define X_CORRESPPIXELSHIFT_CAN_USE_SSE 0
 #endif
 
+//AVX implementation
+#if X_SIMD_CAN_USE_AVX && __has_include("xCorrespPixelShiftAVX.h")
+#define X_CORRESPPIXELSHIFT_CAN_USE_AVX 1
+#include "xCorrespPixelShiftAVX.h"
+#else
+#define X_CORRESPPIXELSHIFT_CAN_USE_AVX 0
+#endif
+
+//AVX512 implementation
+#if X_SIMD_CAN_USE_AVX512 && __has_include("xCorrespPixelShiftAVX512.h")
+#define X_CORRESPPIXELSHIFT_CAN_USE_AVX512 1
+#include "xCorrespPixelShiftAVX512.h"
+#else
+#define X_CORRESPPIXELSHIFT_CAN_USE_AVX512 0
+#endif
+
 namespace PMBB_NAMESPACE {
 
 //===============================================================================================================================================================================================================
@@ -28,20 +44,27 @@ namespace PMBB_NAMESPACE {
 class xCorrespPixelShiftPrms
 {
 public:
-  static constexpr bool    c_UseRuntimeCmpWeights = xc_USE_RUNTIME_CMPWEIGHTS;
   static constexpr int32   c_DefaultSearchRange   = 2;
   static constexpr int32V4 c_DefaultCmpWeights    = { 4, 1, 1, 0 };
   static constexpr int32V4 c_EqualCmpWeights      = { 1, 1, 1, 0 };
+  static constexpr bool    c_DefaultUseCostVolume = false;
+  static constexpr int32   c_CostVolumeBandHeight = 32;
+  static constexpr int32   c_Log2EqualTileSize    = 4; //16x16 tiles used by equal tiles pre-pass
+  static constexpr int32   c_EqualTileSize        = 1 << c_Log2EqualTileSize;
+
+  static inline int32 CalcNumEqualTiles(const int32 Size) { return (Size + c_EqualTileSize - 1) >> c_Log2EqualTileSize; }
 
 protected:
   int32   m_SearchRange       = c_DefaultSearchRange;
   int32V4 m_CmpWeightsAverage = c_DefaultCmpWeights;
   int32V4 m_CmpWeightsSearch  = c_DefaultCmpWeights;
+  bool    m_UseCostVolume     = c_DefaultUseCostVolume;
 
 public:
   void  setSearchRange      (const int32    SearchRange      ) { m_SearchRange       = SearchRange      ; }
   void  setCmpWeightsSearch (const int32V4& CmpWeightsSearch ) { m_CmpWeightsSearch  = CmpWeightsSearch ; }
   void  setCmpWeightsAverage(const int32V4& CmpWeightsAverage) { m_CmpWeightsAverage = CmpWeightsAverage; }
+  void  setUseCostVolume    (const bool     UseCostVolume    ) { m_UseCostVolume     = UseCostVolume    ; }
 };
 
 //===============================================================================================================================================================================================================
@@ -49,19 +72,152 @@ public:
 class xCorrespPixelShift
 {
 public:
-  //asymetric Q planar
-  static uint64V4 xCalcDistAsymmetricRow   (const xPicP* Tst, const xPicP* Ref, const int32 y, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights);
+  //equal tiles pre-pass - tile is equal if Tst and Ref are identical within it. If GlobalColorShift is zero and all CmpWeights are positive
+  //the center candidate gives zero error, so each candidate selected by search has zero distance --> search for pixels within equal tile can be skipped
+  static inline bool xCanSkipEqualTiles(const int32V4& GlobalColorShift, const int32V4& CmpWeights) { return GlobalColorShift.isZero() && CmpWeights[0] > 0 && CmpWeights[1] > 0 && CmpWeights[2] > 0; }
+  static int32 xCalcEqualTilesRow(const xPicP* Tst, const xPicP* Ref, const int32 TileY, uint8* EqualTilesRow); //returns number of pixels within equal tiles
+  static int32 xCalcEqualTilesRow(const xPicI* Tst, const xPicI* Ref, const int32 TileY, uint8* EqualTilesRow); //returns number of pixels within equal tiles
+
+  //asymetric Q - processes columns outside equal tiles only (EqualTilesRow == nullptr --> whole row)
+  //unmasked asymetric Q functions optionally store shift compensated row (same as scalar interleaved xShftCompPic::GenShftCompPics) found by the same search (ShftComp == nullptr --> not stored)
+  //ShftComp lower than picture works as ring buffer of rows (row y is stored in row y % ShftComp->getHeight())
+  static uint64V4 xCalcDistAsymmetricRowSkip(const xPicP* Tst, const xPicP* Ref, const int32 y, const uint8* EqualTilesRow, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp);
+  static uint64V4 xCalcDistAsymmetricRowSkip(const xPicI* Tst, const xPicI* Ref, const int32 y, const uint8* EqualTilesRow, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp);
+
+  //compact mask tiles pre-pass - search tile is empty if mask tile is empty, full if mask tile and all neighbouring tiles are full (search window
+  //of each pixel within full tile contains only pixels with max weight, so search can be performed without mask), mixed otherwise
+  static void     xCalcSearchTilesRow        (const xPicMask* Msk, const int32 TileY, const int32 SearchRange, xPicMask::eTile* SearchTilesRow);
+  //asymetric Q interleaved - with compact mask, skips empty tiles, searches within full tiles without mask (SearchTilesRow - see xCalcSearchTilesRow)
+  static uint64V4 xCalcDistAsymmetricRowSkipM(const xPicI* Tst, const xPicI* Ref, const xPicMask* Msk, const int32 y, const xPicMask::eTile* SearchTilesRow, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp);
+
+  //shift compensated pels of columns [BegX, EndX) not covered by search (equal tiles) - co-located reference pel with GlobalColorShift removed
+  template <class tPic> static void xStoreColocatedRow(xPicP* ShftComp, const tPic* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift)
+  {
+    const int32V4 MaxValue  = xMakeVec4<int32>(ShftComp->getMaxPelValue());
+    const int32   ShftCompY = y % ShftComp->getHeight();
+    for(int32 x = BegX; x < EndX; x++) { xStorePel(ShftComp, x, ShftCompY, (xFetchPel(Ref, x, y) - GlobalColorShift).getClipU(MaxValue)); }
+  }
+
+  //asymetric Q planar - processes columns [BegX, EndX)
+  static uint64V4 xCalcDistAsymmetricRow   (const xPicP* Tst, const xPicP* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp);
   static int32    xFindBestPixelWithinBlock(const int32V4& TstPel, const xPicP* Ref, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const int32V4& CmpWeights);
-  
-  //asymetric Q interleaved
-#if X_CORRESPPIXELSHIFT_CAN_USE_SSE
-  static inline uint64V4 xCalcDistAsymmetricRow(const xPicI* Tst, const xPicI* Ref, const int32 y, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights) { return xCorrespPixelShiftSSE::CalcDistAsymmetricRow(Tst, Ref, y, GlobalColorShift, SearchRange, CmpWeights); }
-#else //X_CORRESPPIXELSHIFT_CAN_USE_SSE
-  static inline uint64V4 xCalcDistAsymmetricRow(const xPicI* Tst, const xPicI* Ref, const int32 y, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights) { return xCorrespPixelShiftSTD::CalcDistAsymmetricRow(Tst, Ref, y, GlobalColorShift, SearchRange, CmpWeights); }
-#endif //X_CORRESPPIXELSHIFT_CAN_USE_SSE
-
-  //asymetric Q interleaved - with mask
+
+  //asymetric Q planar SIMD - processes groups of c_NumPelsPlanarSIMD pixels within columns [BegX, EndX), remaining columns are processed by scalar code
+#if   X_CORRESPPIXELSHIFT_CAN_USE_AVX512
+  static constexpr int32 c_NumPelsPlanarSIMD = xCorrespPixelShiftAVX512::c_NumPelsPlanar;
+  static inline uint64V4 xCalcDistAsymmetricRowSIMD(const xPicP* Tst, const xPicP* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp) { return xCorrespPixelShiftAVX512::CalcDistAsymmetricRow(Tst, Ref, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights, ShftComp); }
+#elif X_CORRESPPIXELSHIFT_CAN_USE_AVX
+  static constexpr int32 c_NumPelsPlanarSIMD = xCorrespPixelShiftAVX::c_NumPelsPlanar;
+  static inline uint64V4 xCalcDistAsymmetricRowSIMD(const xPicP* Tst, const xPicP* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp) { return xCorrespPixelShiftAVX::CalcDistAsymmetricRow(Tst, Ref, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights, ShftComp); }
+#elif X_CORRESPPIXELSHIFT_CAN_USE_SSE
+  static constexpr int32 c_NumPelsPlanarSIMD = xCorrespPixelShiftSSE::c_NumPelsPlanar;
+  static inline uint64V4 xCalcDistAsymmetricRowSIMD(const xPicP* Tst, const xPicP* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp) { return xCorrespPixelShiftSSE::CalcDistAsymmetricRow(Tst, Ref, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights, ShftComp); }
+#else //X_CORRESPPIXELSHIFT_CAN_USE_AVX512 || X_CORRESPPIXELSHIFT_CAN_USE_AVX || X_CORRESPPIXELSHIFT_CAN_USE_SSE
+  static constexpr int32 c_NumPelsPlanarSIMD = 0; //scalar only
+  static inline uint64V4 xCalcDistAsymmetricRowSIMD(const xPicP*, const xPicP*, const int32, const int32, const int32, const int32V4&, const int32, const int32V4&, xPicP*) { return { 0, 0, 0, 0 }; }
+#endif //X_CORRESPPIXELSHIFT_CAN_USE_AVX512 || X_CORRESPPIXELSHIFT_CAN_USE_AVX || X_CORRESPPIXELSHIFT_CAN_USE_SSE
+
+  //asymetric Q interleaved - processes columns [BegX, EndX)
+#if   X_CORRESPPIXELSHIFT_CAN_USE_AVX512
+  static inline uint64V4 xCalcDistAsymmetricRow(const xPicI* Tst, const xPicI* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp) { return xCorrespPixelShiftAVX512::CalcDistAsymmetricRow(Tst, Ref, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights, ShftComp); }
+#elif X_CORRESPPIXELSHIFT_CAN_USE_AVX
+  static inline uint64V4 xCalcDistAsymmetricRow(const xPicI* Tst, const xPicI* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp) { return xCorrespPixelShiftAVX::CalcDistAsymmetricRow(Tst, Ref, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights, ShftComp); }
+#elif X_CORRESPPIXELSHIFT_CAN_USE_SSE
+  static inline uint64V4 xCalcDistAsymmetricRow(const xPicI* Tst, const xPicI* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp) { return xCorrespPixelShiftSSE::CalcDistAsymmetricRow(Tst, Ref, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights, ShftComp); }
+#else //X_CORRESPPIXELSHIFT_CAN_USE_AVX512 || X_CORRESPPIXELSHIFT_CAN_USE_AVX || X_CORRESPPIXELSHIFT_CAN_USE_SSE
+  static inline uint64V4 xCalcDistAsymmetricRow(const xPicI* Tst, const xPicI* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp) { return xCorrespPixelShiftSTD::CalcDistAsymmetricRow(Tst, Ref, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights, ShftComp); }
+#endif //X_CORRESPPIXELSHIFT_CAN_USE_AVX512 || X_CORRESPPIXELSHIFT_CAN_USE_AVX || X_CORRESPPIXELSHIFT_CAN_USE_SSE
+
+  //asymetric Q interleaved - with mask (luma plane of planar picture - whole row, compact mask - columns [BegX, EndX))
+#if   X_CORRESPPIXELSHIFT_CAN_USE_AVX512
+  static inline uint64V4 xCalcDistAsymmetricRowM(const xPicI* Tst, const xPicI* Ref, const xPicP* Msk, const int32 y, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights) { return xCorrespPixelShiftAVX512::CalcDistAsymmetricRowM(Tst, Ref, Msk, y, GlobalColorShift, SearchRange, CmpWeights); }
+  static inline uint64V4 xCalcDistAsymmetricRowM(const xPicI* Tst, const xPicI* Ref, const xPicMask* Msk, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights) { return xCorrespPixelShiftAVX512::CalcDistAsymmetricRowM(Tst, Ref, Msk, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights); }
+#elif X_CORRESPPIXELSHIFT_CAN_USE_AVX
+  static inline uint64V4 xCalcDistAsymmetricRowM(const xPicI* Tst, const xPicI* Ref, const xPicP* Msk, const int32 y, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights) { return xCorrespPixelShiftAVX::CalcDistAsymmetricRowM(Tst, Ref, Msk, y, GlobalColorShift, SearchRange, CmpWeights); }
+  static inline uint64V4 xCalcDistAsymmetricRowM(const xPicI* Tst, const xPicI* Ref, const xPicMask* Msk, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights) { return xCorrespPixelShiftAVX::CalcDistAsymmetricRowM(Tst, Ref, Msk, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights); }
+#elif X_CORRESPPIXELSHIFT_CAN_USE_SSE
+  static inline uint64V4 xCalcDistAsymmetricRowM(const xPicI* Tst, const xPicI* Ref, const xPicP* Msk, const int32 y, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights) { return xCorrespPixelShiftSSE::CalcDistAsymmetricRowM(Tst, Ref, Msk, y, GlobalColorShift, SearchRange, CmpWeights); }
+  static inline uint64V4 xCalcDistAsymmetricRowM(const xPicI* Tst, const xPicI* Ref, const xPicMask* Msk, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights) { return xCorrespPixelShiftSSE::CalcDistAsymmetricRowM(Tst, Ref, Msk, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights); }
+#else //X_CORRESPPIXELSHIFT_CAN_USE_AVX512 || X_CORRESPPIXELSHIFT_CAN_USE_AVX || X_CORRESPPIXELSHIFT_CAN_USE_SSE
   static inline uint64V4 xCalcDistAsymmetricRowM(const xPicI* Tst, const xPicI* Ref, const xPicP* Msk, const int32 y, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights) { return xCorrespPixelShiftSTD::CalcDistAsymmetricRowM(Tst, Ref, Msk, y, GlobalColorShift, SearchRange, CmpWeights); }
+  static inline uint64V4 xCalcDistAsymmetricRowM(const xPicI* Tst, const xPicI* Ref, const xPicMask* Msk, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights) { return xCorrespPixelShiftSTD::CalcDistAsymmetricRowM(Tst, Ref, Msk, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights); }
+#endif //X_CORRESPPIXELSHIFT_CAN_USE_AVX512 || X_CORRESPPIXELSHIFT_CAN_USE_AVX || X_CORRESPPIXELSHIFT_CAN_USE_SSE
+
+  //symmetric Q - weighted errors of test row against all displacements, updates best match of both directions
+#if   X_CORRESPPIXELSHIFT_CAN_USE_AVX512
+  static inline void xUpdateBestSymmetricRow(const int32* TstLm, const int32* TstCb, const int32* TstCr, const int32* const* RefRows, int32* BestPlaneR2T, int32* const* BestErrorT2R, int32* const* BestPlaneT2R, const int32 BegX, const int32 EndX, const int32 SearchRange, const int32V4& CmpWeights) { xCorrespPixelShiftAVX512::UpdateBestSymmetricRow(TstLm, TstCb, TstCr, RefRows, BestPlaneR2T, BestErrorT2R, BestPlaneT2R, BegX, EndX, SearchRange, CmpWeights); }
+#elif X_CORRESPPIXELSHIFT_CAN_USE_AVX
+  static inline void xUpdateBestSymmetricRow(const int32* TstLm, const int32* TstCb, const int32* TstCr, const int32* const* RefRows, int32* BestPlaneR2T, int32* const* BestErrorT2R, int32* const* BestPlaneT2R, const int32 BegX, const int32 EndX, const int32 SearchRange, const int32V4& CmpWeights) { xCorrespPixelShiftAVX::UpdateBestSymmetricRow(TstLm, TstCb, TstCr, RefRows, BestPlaneR2T, BestErrorT2R, BestPlaneT2R, BegX, EndX, SearchRange, CmpWeights); }
+#elif X_CORRESPPIXELSHIFT_CAN_USE_SSE
+  static inline void xUpdateBestSymmetricRow(const int32* TstLm, const int32* TstCb, const int32* TstCr, const int32* const* RefRows, int32* BestPlaneR2T, int32* const* BestErrorT2R, int32* const* BestPlaneT2R, const int32 BegX, const int32 EndX, const int32 SearchRange, const int32V4& CmpWeights) { xCorrespPixelShiftSSE::UpdateBestSymmetricRow(TstLm, TstCb, TstCr, RefRows, BestPlaneR2T, BestErrorT2R, BestPlaneT2R, BegX, EndX, SearchRange, CmpWeights); }
+#else //X_CORRESPPIXELSHIFT_CAN_USE_AVX512 || X_CORRESPPIXELSHIFT_CAN_USE_AVX || X_CORRESPPIXELSHIFT_CAN_USE_SSE
+  static inline void xUpdateBestSymmetricRow(const int32* TstLm, const int32* TstCb, const int32* TstCr, const int32* const* RefRows, int32* BestPlaneR2T, int32* const* BestErrorT2R, int32* const* BestPlaneT2R, const int32 BegX, const int32 EndX, const int32 SearchRange, const int32V4& CmpWeights) { xCorrespPixelShiftSTD::UpdateBestSymmetricRow(TstLm, TstCb, TstCr, RefRows, BestPlaneR2T, BestErrorT2R, BestPlaneT2R, BegX, EndX, SearchRange, CmpWeights); }
+#endif //X_CORRESPPIXELSHIFT_CAN_USE_AVX512 || X_CORRESPPIXELSHIFT_CAN_USE_AVX || X_CORRESPPIXELSHIFT_CAN_USE_SSE
+
+  //symmetric Q - distance of best matches (gathered from ring of rows)
+#if   X_CORRESPPIXELSHIFT_CAN_USE_AVX512
+  static inline uint64V4 xCalcDistBestMatchRow(const int32* CurLm, const int32* RingLm, const int32* BestPlane, const int32* PlaneOffsets, const int32 CmpStride, const int32 BegX, const int32 EndX) { return xCorrespPixelShiftAVX512::CalcDistBestMatchRow(CurLm, RingLm, BestPlane, PlaneOffsets, CmpStride, BegX, EndX); }
+#elif X_CORRESPPIXELSHIFT_CAN_USE_AVX
+  static inline uint64V4 xCalcDistBestMatchRow(const int32* CurLm, const int32* RingLm, const int32* BestPlane, const int32* PlaneOffsets, const int32 CmpStride, const int32 BegX, const int32 EndX) { return xCorrespPixelShiftAVX::CalcDistBestMatchRow(CurLm, RingLm, BestPlane, PlaneOffsets, CmpStride, BegX, EndX); }
+#else //X_CORRESPPIXELSHIFT_CAN_USE_AVX512 || X_CORRESPPIXELSHIFT_CAN_USE_AVX
+  static inline uint64V4 xCalcDistBestMatchRow(const int32* CurLm, const int32* RingLm, const int32* BestPlane, const int32* PlaneOffsets, const int32 CmpStride, const int32 BegX, const int32 EndX) { return xCorrespPixelShiftSTD::CalcDistBestMatchRow(CurLm, RingLm, BestPlane, PlaneOffsets, CmpStride, BegX, EndX); }
+#endif //X_CORRESPPIXELSHIFT_CAN_USE_AVX512 || X_CORRESPPIXELSHIFT_CAN_USE_AVX
+
+  //symmetric Q - scratch buffers reused by consecutive calls (one instance per worker thread), resized on demand
+  //all rows cover columns [-2 * SearchRange, Width + 2 * SearchRange + c_RowPadding), row kernels may process up to c_RowPadding pixels beyond the requested range
+  class xSymmetricBuffers
+  {
+  public:
+    static constexpr int32 c_RowPadding = 16;
+
+    std::vector<int32        > m_TstRows;       //ring of WindowSize test rows (with GlobalColorShift), Lm, Cb and Cr as int32
+    std::vector<int32        > m_RefRows;       //ring of WindowSize reference rows, Lm, Cb and Cr as int32
+    std::vector<int32        > m_BestPlaneR2T;  //best match of current test row
+    std::vector<int32        > m_BestErrorT2R;  //ring of WindowSize running minimums of reference rows
+    std::vector<int32        > m_BestPlaneT2R;
+    std::vector<const int32* > m_RefRowPtrs;    //reference rows of current test row (per dy) - row kernel arguments
+    std::vector<int32*       > m_ErrorT2RPtrs;
+    std::vector<int32*       > m_PlaneT2RPtrs;
+    std::vector<int32        > m_PlaneOffsets;  //offset of displaced position within ring (per plane) - final pass
+    std::vector<uint8        > m_QuietTiles;
+    std::vector<int32V2      > m_CostRuns;
+    std::vector<int32V2      > m_SearchRuns;
+
+  public:
+    void resize(const int32 WindowSize, const int32 RowWidth, const int32 NumTilesX)
+    {
+      m_TstRows     .resize(WindowSize * 3 * RowWidth);
+      m_RefRows     .resize(WindowSize * 3 * RowWidth);
+      m_BestPlaneR2T.resize(RowWidth);
+      m_BestErrorT2R.resize(WindowSize * RowWidth);
+      m_BestPlaneT2R.resize(WindowSize * RowWidth);
+      m_RefRowPtrs  .resize(WindowSize * 3);
+      m_ErrorT2RPtrs.resize(WindowSize);
+      m_PlaneT2RPtrs.resize(WindowSize);
+      m_PlaneOffsets.resize(WindowSize * WindowSize);
+      m_QuietTiles  .resize(NumTilesX);
+    }
+  };
+
+  //symmetric Q (R2T and T2R at once) - shared displacement errors, processes rows [BegY, EndY), skips equal tiles (EqualTiles == nullptr --> no skipping)
+  //optionally stores shift compensated pictures (same as xShftCompPic::GenShftCompPics) found by the same search (ShftCompTst/ShftCompRef == nullptr --> not stored)
+  static void xCalcDistSymmetricRows(const xPicP* Tst, const xPicP* Ref, const int32 BegY, const int32 EndY, const uint8* EqualTiles, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, uint64V4* RowDistR2T, uint64V4* RowDistT2R, xPicP* ShftCompTst, xPicP* ShftCompRef, xSymmetricBuffers& Buffers);
+  static void xCalcDistSymmetricRows(const xPicI* Tst, const xPicI* Ref, const int32 BegY, const int32 EndY, const uint8* EqualTiles, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, uint64V4* RowDistR2T, uint64V4* RowDistT2R, xPicP* ShftCompTst, xPicP* ShftCompRef, xSymmetricBuffers& Buffers);
+
+protected:
+  //tSR > 0 - compile time search range, tSR == 0 - generic (runtime SearchRange), tCW - component weights specialization
+  template <int32 tSR, eCmpWgh tCW> static uint64V4 xCalcDistAsymmetricRowT   (const xPicP* Tst, const xPicP* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp);
+  template <int32 tSR, eCmpWgh tCW> static int32    xFindBestPixelWithinBlockT(const int32V4& TstPel, const xPicP* Ref, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const int32V4& CmpWeights);
+
+  template <class tPic> static uint64V4 xCalcDistAsymmetricRowSkipT(const tPic* Tst, const tPic* Ref, const int32 y, const uint8* EqualTilesRow, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp);
+
+  template <class tPic> static void xCalcDistSymmetricRowsT(const tPic* Tst, const tPic* Ref, const int32 BegY, const int32 EndY, const uint8* EqualTiles, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, uint64V4* RowDistR2T, uint64V4* RowDistT2R, xPicP* ShftCompTst, xPicP* ShftCompRef, xSymmetricBuffers& Buffers);
+
+  static void     xFetchRow(const xPicP* Pic, const int32 y, const int32 BegX, const int32 Length, const int32V4& Offset, int32* restrict DstLm, int32* restrict DstCb, int32* restrict DstCr);
+  static void     xFetchRow(const xPicI* Pic, const int32 y, const int32 BegX, const int32 Length, const int32V4& Offset, int32* restrict DstLm, int32* restrict DstCb, int32* restrict DstCr);
+  static inline int32V4 xFetchPel(const xPicP* Pic, const int32 x, const int32 y) { const int32 Offset = Pic->getOffset({ x, y }); return int32V4((int32)Pic->getAddr(eCmp::LM)[Offset], (int32)Pic->getAddr(eCmp::CB)[Offset], (int32)Pic->getAddr(eCmp::CR)[Offset], 0); }
+  static inline int32V4 xFetchPel(const xPicI* Pic, const int32 x, const int32 y) { return (int32V4)(Pic->getAddr()[Pic->getOffset({ x, y })]); }
+  static inline void     xStorePel(xPicP* Pic, const int32 x, const int32 y, const int32V4& Value) { const int32 Offset = Pic->getOffset({ x, y }); Pic->getAddr(eCmp::LM)[Offset] = (uint16)Value[0]; Pic->getAddr(eCmp::CB)[Offset] = (uint16)Value[1]; Pic->getAddr(eCmp::CR)[Offset] = (uint16)Value[2]; }
 };
 
 //===============================================================================================================================================================================================================
@@ -0,0 +1,643 @@
+/*
+    SPDX-FileCopyrightText: 2019-2023 Jakub Stankowski <jakub.stankowski@put.poznan.pl>
+    SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "xCorrespPixelShiftAVX.h"
+
+#if X_SIMD_CAN_USE_AVX
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+// xCorrespPixelShiftAVX
+//===============================================================================================================================================================================================================
+
+template <eCmpWgh tCW> inline __m256i xCorrespPixelShiftAVX::xCalcWeightedErrorV(const __m256i& DistV, const __m256i& CmpWeightsV)
+{
+  if constexpr(tCW == eCmpWgh::W4110) { return _mm256_sllv_epi32 (DistV, _mm256_setr_epi32(2, 0, 0, 32, 2, 0, 0, 32)); }
+  if constexpr(tCW == eCmpWgh::W1110) { return _mm256_blend_epi32(DistV, _mm256_setzero_si256(), 0x88); }
+  return _mm256_mullo_epi32(DistV, CmpWeightsV);
+}
+template <eCmpWgh tCW> inline __m128i xCorrespPixelShiftAVX::xCalcWeightedErrorV(const __m128i& DistV, const __m128i& CmpWeightsV)
+{
+  if constexpr(tCW == eCmpWgh::W4110) { return _mm_sllv_epi32 (DistV, _mm_setr_epi32(2, 0, 0, 32)); }
+  if constexpr(tCW == eCmpWgh::W1110) { return _mm_blend_epi32(DistV, _mm_setzero_si128(), 0x8); }
+  return _mm_mullo_epi32(DistV, CmpWeightsV);
+}
+inline __m128i xCorrespPixelShiftAVX::xLoadMskPair(const uint16* MskPtr)
+{
+  return _mm_cvtepu16_epi32(_mm_cvtsi32_si128(*(const int32*)MskPtr));
+}
+inline __m128i xCorrespPixelShiftAVX::xLoadMskPair(const uint8* MskPtr)
+{
+  return _mm_cvtepu8_epi32(_mm_cvtsi32_si128(*(const uint16*)MskPtr));
+}
+inline __m128i xCorrespPixelShiftAVX::xLoadMskPair(const xMskBitPtr& MskPtr)
+{
+  const uint32 Bits = MskPtr.getBits(2);
+  return _mm_setr_epi32(Bits & 1, Bits >> 1, 0, 0);
+}
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+uint64V4 xCorrespPixelShiftAVX::CalcDistAsymmetricRow(const xPicI* Tst, const xPicI* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp)
+{
+  if(xCanUseNarrowSearch(Tst->getBitDepth(), GlobalColorShift, CmpWeights)) { return xSwitchSearchRange(SearchRange, [&](auto SR) { return xCalcDistAsymmetricRowN<SR>(Tst, Ref, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights, ShftComp); }); }
+  return xSwitchCmpWeights(CmpWeights, [&](auto CW) { return xSwitchSearchRange(SearchRange, [&](auto SR) { return xCalcDistAsymmetricRow<SR, CW>(Tst, Ref, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights, ShftComp); }); });
+}
+template <int32 tSR, eCmpWgh tCW> uint64V4 xCorrespPixelShiftAVX::xCalcDistAsymmetricRow(const xPicI* Tst, const xPicI* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp)
+{
+  assert(Tst->isCompatible(Ref));
+
+  const int32  TstStride = Tst->getStride();
+  const int32  TstOffset = y * TstStride;
+  const __m256i CmpWeightsV       = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i*) &CmpWeights      ));
+  const __m128i GlobalColorShiftV =                             _mm_loadu_si128((__m128i*) &GlobalColorShift) ;
+  const __m128i MaxValueV         = _mm_set1_epi32(xBitDepth2MaxValue(Ref->getBitDepth()));
+  const int32   ShftCompY         = ShftComp != nullptr ? y % ShftComp->getHeight() : 0;
+
+  const uint16V4* TstPtr = Tst->getAddr() + TstOffset;
+  __m256i RowDistV = _mm256_setzero_si256();
+  for (int32 x = BegX; x < EndX; x++)
+  {
+    __m128i TstU16V  = _mm_loadl_epi64((__m128i*)(TstPtr + x));
+    __m128i TstV     = _mm_add_epi32(_mm_cvtepu16_epi32(TstU16V), GlobalColorShiftV); //TODO - xc_CLIP_CURR_TST_RANGE
+    __m128i BestRefV = xFindBestPelWithinBlock<tSR, tCW>(_mm256_broadcastsi128_si256(TstV), Ref, x, y, SearchRange, CmpWeightsV);
+    __m128i DiffV    = _mm_sub_epi32(TstV, BestRefV);
+    __m128i BestDist = _mm_mullo_epi32(DiffV, DiffV);
+    if(ShftComp != nullptr) { xStoreShftCompPel(ShftComp, x, ShftCompY, BestRefV, GlobalColorShiftV, MaxValueV); }
+    RowDistV = _mm256_add_epi64(RowDistV, _mm256_cvtepu32_epi64(BestDist));
+  }//x
+
+  uint64V4 RowDist;
+  _mm256_storeu_si256((__m256i*)&RowDist, RowDistV);
+  return RowDist;
+}
+template <int32 tSR, eCmpWgh tCW> __m128i xCorrespPixelShiftAVX::xFindBestPelWithinBlock(const __m256i& TstPelV, const xPicI* Ref, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const __m256i& CmpWeightsV)
+{
+  //window width is always odd - pairs of candidates are processed in 256-bit registers, the last candidate in each row in 128-bit register
+  const int32 SR         = tSR > 0 ? tSR : SearchRange;
+  const int32 WindowSize = 2 * SR + 1;
+  const int32 NumPairs   = WindowSize >> 1;
+  const int32 BegY = CenterY - SR;
+  const int32 BegX = CenterX - SR;
+
+  const int32     Stride = Ref->getStride();
+  const uint16V4* RefPtr = Ref->getAddr() + BegY * Stride + BegX;
+
+  const __m128i TstPelV128     = _mm256_castsi256_si128(TstPelV    );
+  const __m128i CmpWeightsV128 = _mm256_castsi256_si128(CmpWeightsV);
+
+  int32   BestError = std::numeric_limits<int32>::max();
+  __m128i BestRefV  = _mm_setzero_si128();
+
+  for (int32 y = 0; y < WindowSize; y++)
+  {
+    const uint16V4* RefPtrY = RefPtr + y * Stride;
+    for (int32 p = 0; p < NumPairs; p++)
+    {
+      __m128i RefU16V = _mm_loadu_si128      ((__m128i*)(RefPtrY + 2 * p));
+      __m256i RefV    = _mm256_cvtepu16_epi32(RefU16V);
+      __m256i DiffV   = _mm256_sub_epi32     (TstPelV, RefV);
+      __m256i DistV   = _mm256_mullo_epi32   (DiffV, DiffV);
+      __m256i ErrorV  = xCalcWeightedErrorV<tCW>(DistV, CmpWeightsV);
+      __m256i Tmp1    = _mm256_hadd_epi32    (ErrorV, ErrorV);
+      __m256i Tmp2    = _mm256_hadd_epi32    (Tmp1, Tmp1);
+      int32   Error0  = _mm256_extract_epi32 (Tmp2, 0);
+      int32   Error1  = _mm256_extract_epi32 (Tmp2, 4);
+      //preserve raster scan order - first candidate with minimal error wins
+      if (Error0 < BestError) { BestError = Error0; BestRefV  = _mm256_castsi256_si128  (RefV   ); }
+      if (Error1 < BestError) { BestError = Error1; BestRefV  = _mm256_extracti128_si256(RefV, 1); }
+    } //p
+
+    {
+      __m128i RefU16V = _mm_loadl_epi64   ((__m128i*)(RefPtrY + WindowSize - 1));
+      __m128i RefV    = _mm_cvtepu16_epi32(RefU16V);
+      __m128i DiffV   = _mm_sub_epi32     (TstPelV128, RefV);
+      __m128i DistV   = _mm_mullo_epi32   (DiffV, DiffV);
+      __m128i ErrorV  = xCalcWeightedErrorV<tCW>(DistV, CmpWeightsV128);
+      __m128i Tmp1    = _mm_hadd_epi32    (ErrorV, ErrorV);
+      __m128i Tmp2    = _mm_hadd_epi32    (Tmp1, Tmp1);
+      int32   Error   = _mm_extract_epi32 (Tmp2, 0);
+      if (Error < BestError) { BestError = Error; BestRefV = RefV; }
+    }
+  } //y
+
+  return BestRefV;
+}
+uint64V4 xCorrespPixelShiftAVX::CalcDistAsymmetricRowM(const xPicI* Tst, const xPicI* Ref, const xPicP* Msk, const int32 y, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  return xCalcDistAsymmetricRowMT(Tst, Ref, Msk, y, 0, Tst->getWidth(), GlobalColorShift, SearchRange, CmpWeights);
+}
+uint64V4 xCorrespPixelShiftAVX::CalcDistAsymmetricRowM(const xPicI* Tst, const xPicI* Ref, const xPicMask* Msk, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  //binary mask is read directly from bit plane
+  if(Msk->isBinary()) { const xPicMaskBits MskBits(Msk); return xCalcDistAsymmetricRowMT(Tst, Ref, &MskBits, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights); }
+  return xCalcDistAsymmetricRowMT(Tst, Ref, Msk, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights);
+}
+template <class tMsk> uint64V4 xCorrespPixelShiftAVX::xCalcDistAsymmetricRowMT(const xPicI* Tst, const xPicI* Ref, const tMsk* Msk, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  if(xCanUseNarrowSearch(Tst->getBitDepth(), GlobalColorShift, CmpWeights)) { return xSwitchSearchRange(SearchRange, [&](auto SR) { return xCalcDistAsymmetricRowNM<SR>(Tst, Ref, Msk, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights); }); }
+  return xSwitchCmpWeights(CmpWeights, [&](auto CW) { return xSwitchSearchRange(SearchRange, [&](auto SR) { return xCalcDistAsymmetricRowM<SR, CW>(Tst, Ref, Msk, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights); }); });
+}
+template <int32 tSR, eCmpWgh tCW, class tMsk> uint64V4 xCorrespPixelShiftAVX::xCalcDistAsymmetricRowM(const xPicI* Tst, const xPicI* Ref, const tMsk* Msk, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  assert(Tst->isCompatible(Ref));
+
+  const int32  TstStride = Tst->getStride();
+  const int32  TstOffset = y * TstStride;
+  const int32  MskStride = Msk->getStride();
+  const int32  MskOffset = y * MskStride;
+  const __m256i CmpWeightsV       = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i*) &CmpWeights      ));
+  const __m128i GlobalColorShiftV =                             _mm_loadu_si128((__m128i*) &GlobalColorShift) ;
+
+  const uint16V4* TstPtr = Tst->getAddr(        ) + TstOffset;
+  const auto      MskPtr = xGetMskAddr(Msk) + MskOffset;
+  __m256i RowDistV = _mm256_setzero_si256();
+  for (int32 x = BegX; x < EndX; x++)
+  {
+    const int32 CurrMskValue = (int32)MskPtr[x];
+    if(CurrMskValue == 0) { continue; } //skip masked pixels
+    __m128i TstU16V  = _mm_loadl_epi64((__m128i*)(TstPtr + x));
+    __m128i TstV     = _mm_add_epi32(_mm_cvtepu16_epi32(TstU16V), GlobalColorShiftV); //TODO - xc_CLIP_CURR_TST_RANGE
+    __m128i BestRefV = xFindBestPelWithinBlockM<tSR, tCW>(_mm256_broadcastsi128_si256(TstV), Ref, Msk, x, y, SearchRange, CmpWeightsV);
+    __m128i DiffV    = _mm_sub_epi32(TstV, BestRefV);
+    __m128i BestDist = _mm_mullo_epi32(DiffV, DiffV);
+    RowDistV = _mm256_add_epi64(RowDistV, _mm256_mul_epu32(_mm256_cvtepu32_epi64(BestDist), _mm256_set1_epi64x(CurrMskValue)));
+  }//x
+
+  uint64V4 RowDist;
+  _mm256_storeu_si256((__m256i*)&RowDist, RowDistV);
+  return RowDist;
+}
+template <int32 tSR, eCmpWgh tCW, class tMsk> __m128i xCorrespPixelShiftAVX::xFindBestPelWithinBlockM(const __m256i& TstPelV, const xPicI* Ref, const tMsk* Msk, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const __m256i& CmpWeightsV)
+{
+  //window width is always odd - pairs of candidates are processed in 256-bit registers, the last candidate in each row in 128-bit register
+  const int32 SR         = tSR > 0 ? tSR : SearchRange;
+  const int32 WindowSize = 2 * SR + 1;
+  const int32 NumPairs   = WindowSize >> 1;
+  const int32 BegY = CenterY - SR;
+  const int32 BegX = CenterX - SR;
+
+  const int32     Stride    = Ref->getStride();
+  const int32     MskStride = Msk->getStride();
+  const uint16V4* RefPtr    = Ref->getAddr(        ) + BegY * Stride    + BegX;
+  const auto      MskPtr    = xGetMskAddr(Msk) + BegY * MskStride + BegX;
+
+  const __m128i TstPelV128     = _mm256_castsi256_si128(TstPelV    );
+  const __m128i CmpWeightsV128 = _mm256_castsi256_si128(CmpWeightsV);
+  const __m256i MaxV           = _mm256_set1_epi32(std::numeric_limits<int32>::max());
+  const __m256i MskPermV       = _mm256_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1);
+
+  int32   BestError = std::numeric_limits<int32>::max();
+  __m128i BestRefV  = _mm_setzero_si128();
+
+  for (int32 y = 0; y < WindowSize; y++)
+  {
+    const uint16V4* RefPtrY = RefPtr + y * Stride;
+    const auto      MskPtrY = MskPtr + y * MskStride;
+    for (int32 p = 0; p < NumPairs; p++)
+    {
+      __m128i RefU16V = _mm_loadu_si128      ((__m128i*)(RefPtrY + 2 * p));
+      __m256i RefV    = _mm256_cvtepu16_epi32(RefU16V);
+      __m256i DiffV   = _mm256_sub_epi32     (TstPelV, RefV);
+      __m256i DistV   = _mm256_mullo_epi32   (DiffV, DiffV);
+      __m256i ErrorV  = xCalcWeightedErrorV<tCW>(DistV, CmpWeightsV);
+      __m256i Tmp1    = _mm256_hadd_epi32    (ErrorV, ErrorV);
+      __m256i Tmp2    = _mm256_hadd_epi32    (Tmp1, Tmp1);
+      //masked candidates get maximal error and are never selected
+      __m256i MskV    = _mm256_permutevar8x32_epi32(_mm256_castsi128_si256(xLoadMskPair(MskPtrY + 2 * p)), MskPermV);
+      __m256i Tmp3    = _mm256_blendv_epi8   (Tmp2, MaxV, _mm256_cmpeq_epi32(MskV, _mm256_setzero_si256()));
+      int32   Error0  = _mm256_extract_epi32 (Tmp3, 0);
+      int32   Error1  = _mm256_extract_epi32 (Tmp3, 4);
+      //preserve raster scan order - first candidate with minimal error wins
+      if (Error0 < BestError) { BestError = Error0; BestRefV  = _mm256_castsi256_si128  (RefV   ); }
+      if (Error1 < BestError) { BestError = Error1; BestRefV  = _mm256_extracti128_si256(RefV, 1); }
+    } //p
+
+    {
+      __m128i RefU16V = _mm_loadl_epi64   ((__m128i*)(RefPtrY + WindowSize - 1));
+      __m128i RefV    = _mm_cvtepu16_epi32(RefU16V);
+      __m128i DiffV   = _mm_sub_epi32     (TstPelV128, RefV);
+      __m128i DistV   = _mm_mullo_epi32   (DiffV, DiffV);
+      __m128i ErrorV  = xCalcWeightedErrorV<tCW>(DistV, CmpWeightsV128);
+      __m128i Tmp1    = _mm_hadd_epi32    (ErrorV, ErrorV);
+      __m128i Tmp2    = _mm_hadd_epi32    (Tmp1, Tmp1);
+      __m128i MskV    = _mm_cmpeq_epi32   (_mm_set1_epi32(MskPtrY[WindowSize - 1]), _mm_setzero_si128());
+      __m128i Tmp3    = _mm_blendv_epi8   (Tmp2, _mm256_castsi256_si128(MaxV), MskV);
+      int32   Error   = _mm_extract_epi32 (Tmp3, 0);
+      if (Error < BestError) { BestError = Error; BestRefV = RefV; }
+    }
+  } //y
+
+  return BestRefV;
+}
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// planar
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template <eCmpWgh tCW> inline __m256i xCorrespPixelShiftAVX::xCalcWeightedErrorP(const __m256i& DistLmV, const __m256i& DistCbV, const __m256i& DistCrV, const __m256i& CmpWeightLmV, const __m256i& CmpWeightCbV, const __m256i& CmpWeightCrV)
+{
+  if constexpr(tCW == eCmpWgh::W4110) { return _mm256_add_epi32(_mm256_slli_epi32(DistLmV, 2), _mm256_add_epi32(DistCbV, DistCrV)); }
+  if constexpr(tCW == eCmpWgh::W1110) { return _mm256_add_epi32(DistLmV, _mm256_add_epi32(DistCbV, DistCrV)); }
+  return _mm256_add_epi32(_mm256_mullo_epi32(DistLmV, CmpWeightLmV), _mm256_add_epi32(_mm256_mullo_epi32(DistCbV, CmpWeightCbV), _mm256_mullo_epi32(DistCrV, CmpWeightCrV)));
+}
+uint64V4 xCorrespPixelShiftAVX::CalcDistAsymmetricRow(const xPicP* Tst, const xPicP* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp)
+{
+  return xSwitchCmpWeights(CmpWeights, [&](auto CW) { return xSwitchSearchRange(SearchRange, [&](auto SR) { return xCalcDistAsymmetricRowP<SR, CW>(Tst, Ref, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights, ShftComp); }); });
+}
+template <int32 tSR, eCmpWgh tCW> uint64V4 xCorrespPixelShiftAVX::xCalcDistAsymmetricRowP(const xPicP* Tst, const xPicP* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp)
+{
+  assert(Tst->isCompatible(Ref));
+  assert(((EndX - BegX) % c_NumPelsPlanar) == 0);
+
+  const int32 SR         = tSR > 0 ? tSR : SearchRange;
+  const int32 WindowSize = 2 * SR + 1;
+  const int32 TstStride  = Tst->getStride();
+  const int32 RefStride  = Ref->getStride();
+
+  const uint16* TstPtrLm = Tst->getAddr(eCmp::LM) + y * TstStride;
+  const uint16* TstPtrCb = Tst->getAddr(eCmp::CB) + y * TstStride;
+  const uint16* TstPtrCr = Tst->getAddr(eCmp::CR) + y * TstStride;
+  const uint16* RefPtrLm = Ref->getAddr(eCmp::LM) + (y - SR) * RefStride - SR;
+  const uint16* RefPtrCb = Ref->getAddr(eCmp::CB) + (y - SR) * RefStride - SR;
+  const uint16* RefPtrCr = Ref->getAddr(eCmp::CR) + (y - SR) * RefStride - SR;
+
+  const __m256i GlobalColorShiftLmV = _mm256_set1_epi32(GlobalColorShift[0]);
+  const __m256i GlobalColorShiftCbV = _mm256_set1_epi32(GlobalColorShift[1]);
+  const __m256i GlobalColorShiftCrV = _mm256_set1_epi32(GlobalColorShift[2]);
+  const __m256i CmpWeightLmV        = _mm256_set1_epi32(CmpWeights      [0]);
+  const __m256i CmpWeightCbV        = _mm256_set1_epi32(CmpWeights      [1]);
+  const __m256i CmpWeightCrV        = _mm256_set1_epi32(CmpWeights      [2]);
+  const __m256i MaxV                = _mm256_set1_epi32(std::numeric_limits<int32>::max());
+  const __m256i MaxValueV           = _mm256_set1_epi32(xBitDepth2MaxValue(Ref->getBitDepth()));
+  const int32   ShftCompY           = ShftComp != nullptr ? y % ShftComp->getHeight() : 0;
+
+  __m256i RowDistLmV = _mm256_setzero_si256();
+  __m256i RowDistCbV = _mm256_setzero_si256();
+  __m256i RowDistCrV = _mm256_setzero_si256();
+
+  for(int32 x = BegX; x < EndX; x += c_NumPelsPlanar)
+  {
+    const __m256i TstLmV = _mm256_add_epi32(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(TstPtrLm + x))), GlobalColorShiftLmV); //TODO - xc_CLIP_CURR_TST_RANGE
+    const __m256i TstCbV = _mm256_add_epi32(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(TstPtrCb + x))), GlobalColorShiftCbV); //TODO - xc_CLIP_CURR_TST_RANGE
+    const __m256i TstCrV = _mm256_add_epi32(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(TstPtrCr + x))), GlobalColorShiftCrV); //TODO - xc_CLIP_CURR_TST_RANGE
+
+    __m256i BestErrorV = MaxV;
+    __m256i BestRefLmV = _mm256_setzero_si256();
+    __m256i BestRefCbV = _mm256_setzero_si256();
+    __m256i BestRefCrV = _mm256_setzero_si256();
+
+    for(int32 wy = 0; wy < WindowSize; wy++)
+    {
+      const int32 Offset = wy * RefStride + x;
+      for(int32 wx = 0; wx < WindowSize; wx++)
+      {
+        const __m256i RefLmV   = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(RefPtrLm + Offset + wx)));
+        const __m256i RefCbV   = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(RefPtrCb + Offset + wx)));
+        const __m256i RefCrV   = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(RefPtrCr + Offset + wx)));
+        const __m256i DiffLmV  = _mm256_sub_epi32(TstLmV, RefLmV);
+        const __m256i DiffCbV  = _mm256_sub_epi32(TstCbV, RefCbV);
+        const __m256i DiffCrV  = _mm256_sub_epi32(TstCrV, RefCrV);
+        const __m256i ErrorV   = xCalcWeightedErrorP<tCW>(_mm256_mullo_epi32(DiffLmV, DiffLmV), _mm256_mullo_epi32(DiffCbV, DiffCbV), _mm256_mullo_epi32(DiffCrV, DiffCrV), CmpWeightLmV, CmpWeightCbV, CmpWeightCrV);
+        //preserve raster scan order - first candidate with minimal error wins
+        const __m256i IsBetter = _mm256_cmpgt_epi32(BestErrorV, ErrorV);
+        BestErrorV = _mm256_min_epi32  (ErrorV, BestErrorV);
+        BestRefLmV = _mm256_blendv_epi8(BestRefLmV, RefLmV, IsBetter);
+        BestRefCbV = _mm256_blendv_epi8(BestRefCbV, RefCbV, IsBetter);
+        BestRefCrV = _mm256_blendv_epi8(BestRefCrV, RefCrV, IsBetter);
+      } //wx
+    } //wy
+
+    const __m256i BestDiffLmV = _mm256_sub_epi32(TstLmV, BestRefLmV);
+    const __m256i BestDiffCbV = _mm256_sub_epi32(TstCbV, BestRefCbV);
+    const __m256i BestDiffCrV = _mm256_sub_epi32(TstCrV, BestRefCrV);
+    const __m256i BestDistLmV = _mm256_mullo_epi32(BestDiffLmV, BestDiffLmV);
+    const __m256i BestDistCbV = _mm256_mullo_epi32(BestDiffCbV, BestDiffCbV);
+    const __m256i BestDistCrV = _mm256_mullo_epi32(BestDiffCrV, BestDiffCrV);
+
+    if(ShftComp != nullptr)
+    {
+      const int32   Offset  = ShftComp->getOffset({ x, ShftCompY });
+      const __m256i ShftLmV = _mm256_min_epi32(_mm256_max_epi32(_mm256_sub_epi32(BestRefLmV, GlobalColorShiftLmV), _mm256_setzero_si256()), MaxValueV);
+      const __m256i ShftCbV = _mm256_min_epi32(_mm256_max_epi32(_mm256_sub_epi32(BestRefCbV, GlobalColorShiftCbV), _mm256_setzero_si256()), MaxValueV);
+      const __m256i ShftCrV = _mm256_min_epi32(_mm256_max_epi32(_mm256_sub_epi32(BestRefCrV, GlobalColorShiftCrV), _mm256_setzero_si256()), MaxValueV);
+      _mm_storeu_si128((__m128i*)(ShftComp->getAddr(eCmp::LM) + Offset), _mm_packus_epi32(_mm256_castsi256_si128(ShftLmV), _mm256_extracti128_si256(ShftLmV, 1)));
+      _mm_storeu_si128((__m128i*)(ShftComp->getAddr(eCmp::CB) + Offset), _mm_packus_epi32(_mm256_castsi256_si128(ShftCbV), _mm256_extracti128_si256(ShftCbV, 1)));
+      _mm_storeu_si128((__m128i*)(ShftComp->getAddr(eCmp::CR) + Offset), _mm_packus_epi32(_mm256_castsi256_si128(ShftCrV), _mm256_extracti128_si256(ShftCrV, 1)));
+    }
+
+    RowDistLmV = _mm256_add_epi64(RowDistLmV, _mm256_add_epi64(_mm256_cvtepu32_epi64(_mm256_castsi256_si128(BestDistLmV)), _mm256_cvtepu32_epi64(_mm256_extracti128_si256(BestDistLmV, 1))));
+    RowDistCbV = _mm256_add_epi64(RowDistCbV, _mm256_add_epi64(_mm256_cvtepu32_epi64(_mm256_castsi256_si128(BestDistCbV)), _mm256_cvtepu32_epi64(_mm256_extracti128_si256(BestDistCbV, 1))));
+    RowDistCrV = _mm256_add_epi64(RowDistCrV, _mm256_add_epi64(_mm256_cvtepu32_epi64(_mm256_castsi256_si128(BestDistCrV)), _mm256_cvtepu32_epi64(_mm256_extracti128_si256(BestDistCrV, 1))));
+  }//x
+
+  uint64V4 RowDistLm, RowDistCb, RowDistCr;
+  _mm256_storeu_si256((__m256i*)&RowDistLm, RowDistLmV);
+  _mm256_storeu_si256((__m256i*)&RowDistCb, RowDistCbV);
+  _mm256_storeu_si256((__m256i*)&RowDistCr, RowDistCrV);
+  return { RowDistLm.getSum(), RowDistCb.getSum(), RowDistCr.getSum(), 0 };
+}
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// narrow (16-bit) arithmetic - valid if xCanUseNarrowSearch()
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template <int32 tSR> uint64V4 xCorrespPixelShiftAVX::xCalcDistAsymmetricRowN(const xPicI* Tst, const xPicI* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp)
+{
+  assert(Tst->isCompatible(Ref));
+
+  const int32  TstStride = Tst->getStride();
+  const int32  TstOffset = y * TstStride;
+  const __m256i CmpWeightsV       = _mm256_broadcastq_epi64(_mm_packs_epi32(_mm_loadu_si128((__m128i*) &CmpWeights      ), _mm_setzero_si128()));
+  const __m128i GlobalColorShiftV =                         _mm_packs_epi32(_mm_loadu_si128((__m128i*) &GlobalColorShift), _mm_setzero_si128()) ;
+  const __m128i GlobalColorShift32V = _mm_loadu_si128((__m128i*) &GlobalColorShift);
+  const __m128i MaxValueV           = _mm_set1_epi32(xBitDepth2MaxValue(Ref->getBitDepth()));
+  const int32   ShftCompY           = ShftComp != nullptr ? y % ShftComp->getHeight() : 0;
+
+  const uint16V4* TstPtr = Tst->getAddr() + TstOffset;
+  __m256i RowDistV = _mm256_setzero_si256();
+  for (int32 x = BegX; x < EndX; x++)
+  {
+    __m128i TstU16V  = _mm_loadl_epi64((__m128i*)(TstPtr + x));
+    __m128i TstV     = _mm_add_epi16(TstU16V, GlobalColorShiftV); //TODO - xc_CLIP_CURR_TST_RANGE
+    __m128i BestRefV = xFindBestPelWithinBlockN<tSR>(_mm256_broadcastq_epi64(TstV), Ref, x, y, SearchRange, CmpWeightsV);
+    __m128i DiffV    = _mm_sub_epi32(_mm_cvtepi16_epi32(TstV), BestRefV);
+    __m128i BestDist = _mm_mullo_epi32(DiffV, DiffV);
+    if(ShftComp != nullptr) { xStoreShftCompPel(ShftComp, x, ShftCompY, BestRefV, GlobalColorShift32V, MaxValueV); }
+    RowDistV = _mm256_add_epi64(RowDistV, _mm256_cvtepu32_epi64(BestDist));
+  }//x
+
+  uint64V4 RowDist;
+  _mm256_storeu_si256((__m256i*)&RowDist, RowDistV);
+  return RowDist;
+}
+template <int32 tSR> __m128i xCorrespPixelShiftAVX::xFindBestPelWithinBlockN(const __m256i& TstPelV, const xPicI* Ref, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const __m256i& CmpWeightsV)
+{
+  //quads of candidates are processed in 256-bit registers, remaining pair and single candidate in 128-bit registers
+  //weighted error is calculated in 16-bit lanes (multiply-add), best candidate pel is widened to 32 bits at the end
+  const int32 SR         = tSR > 0 ? tSR : SearchRange;
+  const int32 WindowSize = 2 * SR + 1;
+  const int32 NumQuads   = WindowSize >> 2;
+  const int32 BegY = CenterY - SR;
+  const int32 BegX = CenterX - SR;
+
+  const int32     Stride = Ref->getStride();
+  const uint16V4* RefPtr = Ref->getAddr() + BegY * Stride + BegX;
+
+  const __m128i TstPelV128     = _mm256_castsi256_si128(TstPelV    );
+  const __m128i CmpWeightsV128 = _mm256_castsi256_si128(CmpWeightsV);
+
+  int32 BestError  = std::numeric_limits<int32>::max();
+  int32 BestOffset = 0;
+
+  for (int32 y = 0; y < WindowSize; y++)
+  {
+    const uint16V4* RefPtrY = RefPtr + y * Stride;
+    const int32     OffsetY = y * Stride;
+    int32 x = 0;
+    for (int32 q = 0; q < NumQuads; q++, x += 4)
+    {
+      __m256i RefV   = _mm256_loadu_si256  ((__m256i*)(RefPtrY + x));
+      __m256i DiffV  = _mm256_sub_epi16    (TstPelV, RefV);
+      __m256i ErrorV = _mm256_madd_epi16   (DiffV, _mm256_mullo_epi16(DiffV, CmpWeightsV));
+      __m256i Tmp1   = _mm256_hadd_epi32   (ErrorV, ErrorV);
+      int32   Error0 = _mm256_extract_epi32(Tmp1, 0);
+      int32   Error1 = _mm256_extract_epi32(Tmp1, 1);
+      int32   Error2 = _mm256_extract_epi32(Tmp1, 4);
+      int32   Error3 = _mm256_extract_epi32(Tmp1, 5);
+      //preserve raster scan order - first candidate with minimal error wins
+      if (Error0 < BestError) { BestError = Error0; BestOffset = OffsetY + x    ; }
+      if (Error1 < BestError) { BestError = Error1; BestOffset = OffsetY + x + 1; }
+      if (Error2 < BestError) { BestError = Error2; BestOffset = OffsetY + x + 2; }
+      if (Error3 < BestError) { BestError = Error3; BestOffset = OffsetY + x + 3; }
+    } //q
+
+    if (WindowSize - x >= 2)
+    {
+      __m128i RefV   = _mm_loadu_si128  ((__m128i*)(RefPtrY + x));
+      __m128i DiffV  = _mm_sub_epi16    (TstPelV128, RefV);
+      __m128i ErrorV = _mm_madd_epi16   (DiffV, _mm_mullo_epi16(DiffV, CmpWeightsV128));
+      __m128i Tmp1   = _mm_hadd_epi32   (ErrorV, ErrorV);
+      int32   Error0 = _mm_extract_epi32(Tmp1, 0);
+      int32   Error1 = _mm_extract_epi32(Tmp1, 1);
+      if (Error0 < BestError) { BestError = Error0; BestOffset = OffsetY + x    ; }
+      if (Error1 < BestError) { BestError = Error1; BestOffset = OffsetY + x + 1; }
+      x += 2;
+    }
+
+    if (x < WindowSize)
+    {
+      __m128i RefV   = _mm_loadl_epi64  ((__m128i*)(RefPtrY + x));
+      __m128i DiffV  = _mm_sub_epi16    (TstPelV128, RefV);
+      __m128i ErrorV = _mm_madd_epi16   (DiffV, _mm_mullo_epi16(DiffV, CmpWeightsV128));
+      __m128i Tmp1   = _mm_hadd_epi32   (ErrorV, ErrorV);
+      int32   Error  = _mm_extract_epi32(Tmp1, 0);
+      if (Error < BestError) { BestError = Error; BestOffset = OffsetY + x; }
+    }
+  } //y
+
+  return _mm_cvtepu16_epi32(_mm_loadl_epi64((__m128i*)(RefPtr + BestOffset)));
+}
+template <int32 tSR, class tMsk> uint64V4 xCorrespPixelShiftAVX::xCalcDistAsymmetricRowNM(const xPicI* Tst, const xPicI* Ref, const tMsk* Msk, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  assert(Tst->isCompatible(Ref));
+
+  const int32  TstStride = Tst->getStride();
+  const int32  TstOffset = y * TstStride;
+  const int32  MskStride = Msk->getStride();
+  const int32  MskOffset = y * MskStride;
+  const __m256i CmpWeightsV       = _mm256_broadcastq_epi64(_mm_packs_epi32(_mm_loadu_si128((__m128i*) &CmpWeights      ), _mm_setzero_si128()));
+  const __m128i GlobalColorShiftV =                         _mm_packs_epi32(_mm_loadu_si128((__m128i*) &GlobalColorShift), _mm_setzero_si128()) ;
+
+  const uint16V4* TstPtr = Tst->getAddr(        ) + TstOffset;
+  const auto      MskPtr = xGetMskAddr(Msk) + MskOffset;
+  __m256i RowDistV = _mm256_setzero_si256();
+  for (int32 x = BegX; x < EndX; x++)
+  {
+    const int32 CurrMskValue = (int32)MskPtr[x];
+    if(CurrMskValue == 0) { continue; } //skip masked pixels
+    __m128i TstU16V  = _mm_loadl_epi64((__m128i*)(TstPtr + x));
+    __m128i TstV     = _mm_add_epi16(TstU16V, GlobalColorShiftV); //TODO - xc_CLIP_CURR_TST_RANGE
+    __m128i BestRefV = xFindBestPelWithinBlockNM<tSR>(_mm256_broadcastq_epi64(TstV), Ref, Msk, x, y, SearchRange, CmpWeightsV);
+    __m128i DiffV    = _mm_sub_epi32(_mm_cvtepi16_epi32(TstV), BestRefV);
+    __m128i BestDist = _mm_mullo_epi32(DiffV, DiffV);
+    RowDistV = _mm256_add_epi64(RowDistV, _mm256_mul_epu32(_mm256_cvtepu32_epi64(BestDist), _mm256_set1_epi64x(CurrMskValue)));
+  }//x
+
+  uint64V4 RowDist;
+  _mm256_storeu_si256((__m256i*)&RowDist, RowDistV);
+  return RowDist;
+}
+template <int32 tSR, class tMsk> __m128i xCorrespPixelShiftAVX::xFindBestPelWithinBlockNM(const __m256i& TstPelV, const xPicI* Ref, const tMsk* Msk, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const __m256i& CmpWeightsV)
+{
+  //as xFindBestPelWithinBlockN, candidates with zero mask value are skipped
+  const int32 SR         = tSR > 0 ? tSR : SearchRange;
+  const int32 WindowSize = 2 * SR + 1;
+  const int32 NumQuads   = WindowSize >> 2;
+  const int32 BegY = CenterY - SR;
+  const int32 BegX = CenterX - SR;
+
+  const int32     Stride    = Ref->getStride();
+  const int32     MskStride = Msk->getStride();
+  const uint16V4* RefPtr    = Ref->getAddr(        ) + BegY * Stride    + BegX;
+  const auto      MskPtr    = xGetMskAddr(Msk) + BegY * MskStride + BegX;
+
+  const __m128i TstPelV128     = _mm256_castsi256_si128(TstPelV    );
+  const __m128i CmpWeightsV128 = _mm256_castsi256_si128(CmpWeightsV);
+
+  //center candidate is always valid (masked test pixels are skipped by caller)
+  int32 BestError  = std::numeric_limits<int32>::max();
+  int32 BestOffset = 0;
+
+  for (int32 y = 0; y < WindowSize; y++)
+  {
+    const uint16V4* RefPtrY = RefPtr + y * Stride;
+    const auto      MskPtrY = MskPtr + y * MskStride;
+    const int32     OffsetY = y * Stride;
+    int32 x = 0;
+    for (int32 q = 0; q < NumQuads; q++, x += 4)
+    {
+      __m256i RefV   = _mm256_loadu_si256  ((__m256i*)(RefPtrY + x));
+      __m256i DiffV  = _mm256_sub_epi16    (TstPelV, RefV);
+      __m256i ErrorV = _mm256_madd_epi16   (DiffV, _mm256_mullo_epi16(DiffV, CmpWeightsV));
+      __m256i Tmp1   = _mm256_hadd_epi32   (ErrorV, ErrorV);
+      int32   Error0 = _mm256_extract_epi32(Tmp1, 0);
+      int32   Error1 = _mm256_extract_epi32(Tmp1, 1);
+      int32   Error2 = _mm256_extract_epi32(Tmp1, 4);
+      int32   Error3 = _mm256_extract_epi32(Tmp1, 5);
+      if (MskPtrY[x    ] != 0 && Error0 < BestError) { BestError = Error0; BestOffset = OffsetY + x    ; }
+      if (MskPtrY[x + 1] != 0 && Error1 < BestError) { BestError = Error1; BestOffset = OffsetY + x + 1; }
+      if (MskPtrY[x + 2] != 0 && Error2 < BestError) { BestError = Error2; BestOffset = OffsetY + x + 2; }
+      if (MskPtrY[x + 3] != 0 && Error3 < BestError) { BestError = Error3; BestOffset = OffsetY + x + 3; }
+    } //q
+
+    if (WindowSize - x >= 2)
+    {
+      __m128i RefV   = _mm_loadu_si128  ((__m128i*)(RefPtrY + x));
+      __m128i DiffV  = _mm_sub_epi16    (TstPelV128, RefV);
+      __m128i ErrorV = _mm_madd_epi16   (DiffV, _mm_mullo_epi16(DiffV, CmpWeightsV128));
+      __m128i Tmp1   = _mm_hadd_epi32   (ErrorV, ErrorV);
+      int32   Error0 = _mm_extract_epi32(Tmp1, 0);
+      int32   Error1 = _mm_extract_epi32(Tmp1, 1);
+      if (MskPtrY[x    ] != 0 && Error0 < BestError) { BestError = Error0; BestOffset = OffsetY + x    ; }
+      if (MskPtrY[x + 1] != 0 && Error1 < BestError) { BestError = Error1; BestOffset = OffsetY + x + 1; }
+      x += 2;
+    }
+
+    if (x < WindowSize)
+    {
+      __m128i RefV   = _mm_loadl_epi64  ((__m128i*)(RefPtrY + x));
+      __m128i DiffV  = _mm_sub_epi16    (TstPelV128, RefV);
+      __m128i ErrorV = _mm_madd_epi16   (DiffV, _mm_mullo_epi16(DiffV, CmpWeightsV128));
+      __m128i Tmp1   = _mm_hadd_epi32   (ErrorV, ErrorV);
+      int32   Error  = _mm_extract_epi32(Tmp1, 0);
+      if (MskPtrY[x] != 0 && Error < BestError) { BestError = Error; BestOffset = OffsetY + x; }
+    }
+  } //y
+
+  return _mm_cvtepu16_epi32(_mm_loadl_epi64((__m128i*)(RefPtr + BestOffset)));
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// symmetric Q - planar int32 rows
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void xCorrespPixelShiftAVX::UpdateBestSymmetricRow(const int32* TstLm, const int32* TstCb, const int32* TstCr, const int32* const* RefRows, int32* BestPlaneR2T, int32* const* BestErrorT2R, int32* const* BestPlaneT2R, const int32 BegX, const int32 EndX, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  xSwitchCmpWeights(CmpWeights, [&](auto CW) { xSwitchSearchRange(SearchRange, [&](auto SR) { xUpdateBestSymmetricRow<SR, CW>(TstLm, TstCb, TstCr, RefRows, BestPlaneR2T, BestErrorT2R, BestPlaneT2R, BegX, EndX, SearchRange, CmpWeights); }); });
+}
+uint64V4 xCorrespPixelShiftAVX::CalcDistBestMatchRow(const int32* CurLm, const int32* RingLm, const int32* BestPlane, const int32* PlaneOffsets, const int32 CmpStride, const int32 BegX, const int32 EndX)
+{
+  const __m256i IdxV = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+  __m256i RowDistLmV = _mm256_setzero_si256();
+  __m256i RowDistCbV = _mm256_setzero_si256();
+  __m256i RowDistCrV = _mm256_setzero_si256();
+
+  int32 x = BegX;
+  for(; x <= EndX - c_NumPelsPlanar; x += c_NumPelsPlanar)
+  {
+    const __m256i OffsetV = _mm256_add_epi32(_mm256_i32gather_epi32(PlaneOffsets, _mm256_loadu_si256((const __m256i*)(BestPlane + x)), 4), _mm256_add_epi32(IdxV, _mm256_set1_epi32(x)));
+    const __m256i DiffLmV = _mm256_sub_epi32(_mm256_loadu_si256((const __m256i*)(CurLm + x                )), _mm256_i32gather_epi32(RingLm                , OffsetV, 4));
+    const __m256i DiffCbV = _mm256_sub_epi32(_mm256_loadu_si256((const __m256i*)(CurLm + x +     CmpStride)), _mm256_i32gather_epi32(RingLm +     CmpStride, OffsetV, 4));
+    const __m256i DiffCrV = _mm256_sub_epi32(_mm256_loadu_si256((const __m256i*)(CurLm + x + 2 * CmpStride)), _mm256_i32gather_epi32(RingLm + 2 * CmpStride, OffsetV, 4));
+    const __m256i DistLmV = _mm256_mullo_epi32(DiffLmV, DiffLmV);
+    const __m256i DistCbV = _mm256_mullo_epi32(DiffCbV, DiffCbV);
+    const __m256i DistCrV = _mm256_mullo_epi32(DiffCrV, DiffCrV);
+    RowDistLmV = _mm256_add_epi64(RowDistLmV, _mm256_add_epi64(_mm256_cvtepu32_epi64(_mm256_castsi256_si128(DistLmV)), _mm256_cvtepu32_epi64(_mm256_extracti128_si256(DistLmV, 1))));
+    RowDistCbV = _mm256_add_epi64(RowDistCbV, _mm256_add_epi64(_mm256_cvtepu32_epi64(_mm256_castsi256_si128(DistCbV)), _mm256_cvtepu32_epi64(_mm256_extracti128_si256(DistCbV, 1))));
+    RowDistCrV = _mm256_add_epi64(RowDistCrV, _mm256_add_epi64(_mm256_cvtepu32_epi64(_mm256_castsi256_si128(DistCrV)), _mm256_cvtepu32_epi64(_mm256_extracti128_si256(DistCrV, 1))));
+  } //x
+
+  uint64V4 RowDistLm, RowDistCb, RowDistCr;
+  _mm256_storeu_si256((__m256i*)&RowDistLm, RowDistLmV);
+  _mm256_storeu_si256((__m256i*)&RowDistCb, RowDistCbV);
+  _mm256_storeu_si256((__m256i*)&RowDistCr, RowDistCrV);
+  uint64V4 RowDist = { RowDistLm.getSum(), RowDistCb.getSum(), RowDistCr.getSum(), 0 };
+
+  for(; x < EndX; x++)
+  {
+    const int32 Offset = PlaneOffsets[BestPlane[x]] + x;
+    RowDist[0] += (uint64)xPow2(CurLm[x                ] - RingLm[Offset                ]);
+    RowDist[1] += (uint64)xPow2(CurLm[x +     CmpStride] - RingLm[Offset +     CmpStride]);
+    RowDist[2] += (uint64)xPow2(CurLm[x + 2 * CmpStride] - RingLm[Offset + 2 * CmpStride]);
+  } //x
+  return RowDist;
+}
+template <int32 tSR, eCmpWgh tCW> void xCorrespPixelShiftAVX::xUpdateBestSymmetricRow(const int32* TstLm, const int32* TstCb, const int32* TstCr, const int32* const* RefRows, int32* BestPlaneR2T, int32* const* BestErrorT2R, int32* const* BestPlaneT2R, const int32 BegX, const int32 EndX, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  //displacements are scanned column by column (dy inner loop) - consecutive T2R updates hit different rows, so store of one candidate is not reloaded by the next one
+  //candidates are not scanned in raster order, so ties are resolved by plane index in both directions
+  const int32 SR         = tSR > 0 ? tSR : SearchRange;
+  const int32 WindowSize = 2 * SR + 1;
+  const int32 NumPlanes  = WindowSize * WindowSize;
+
+  const __m256i CmpWeightLmV = _mm256_set1_epi32(CmpWeights[0]);
+  const __m256i CmpWeightCbV = _mm256_set1_epi32(CmpWeights[1]);
+  const __m256i CmpWeightCrV = _mm256_set1_epi32(CmpWeights[2]);
+  const __m256i LastPlaneV   = _mm256_set1_epi32(NumPlanes - 1);
+
+  for(int32 x = BegX; x < EndX; x += c_NumPelsPlanar)
+  {
+    const __m256i TstLmV = _mm256_loadu_si256((__m256i*)(TstLm + x));
+    const __m256i TstCbV = _mm256_loadu_si256((__m256i*)(TstCb + x));
+    const __m256i TstCrV = _mm256_loadu_si256((__m256i*)(TstCr + x));
+    __m256i BestErrorR2TV = _mm256_set1_epi32(std::numeric_limits<int32>::max());
+    __m256i BestPlaneR2TV = _mm256_set1_epi32(NOT_VALID);
+
+    for(int32 dx = -SR; dx <= SR; dx++)
+    {
+      for(int32 dy = -SR; dy <= SR; dy++)
+      {
+        const int32* RefLm    = RefRows[3 * (dy + SR) + 0] + x + dx;
+        const int32* RefCb    = RefRows[3 * (dy + SR) + 1] + x + dx;
+        const int32* RefCr    = RefRows[3 * (dy + SR) + 2] + x + dx;
+        int32*       ErrorT2R = BestErrorT2R[dy + SR] != nullptr ? BestErrorT2R[dy + SR] + x : nullptr;
+        int32*       PlaneT2R = BestErrorT2R[dy + SR] != nullptr ? BestPlaneT2R[dy + SR] + x : nullptr;
+        if(BestPlaneR2T == nullptr && ErrorT2R == nullptr) { continue; } //halo row of band - only some T2R rows are needed
+
+        const __m256i PlaneIdxV = _mm256_set1_epi32((dy + SR) * WindowSize + dx + SR);
+        const __m256i DiffLmV   = _mm256_sub_epi32(TstLmV, _mm256_loadu_si256((__m256i*)RefLm));
+        const __m256i DiffCbV   = _mm256_sub_epi32(TstCbV, _mm256_loadu_si256((__m256i*)RefCb));
+        const __m256i DiffCrV   = _mm256_sub_epi32(TstCrV, _mm256_loadu_si256((__m256i*)RefCr));
+        const __m256i ErrorV    = xCalcWeightedErrorP<tCW>(_mm256_mullo_epi32(DiffLmV, DiffLmV), _mm256_mullo_epi32(DiffCbV, DiffCbV), _mm256_mullo_epi32(DiffCrV, DiffCrV), CmpWeightLmV, CmpWeightCbV, CmpWeightCrV);
+        const __m256i IsBetterR2TV = _mm256_or_si256(_mm256_cmpgt_epi32(BestErrorR2TV, ErrorV), _mm256_and_si256(_mm256_cmpeq_epi32(BestErrorR2TV, ErrorV), _mm256_cmpgt_epi32(BestPlaneR2TV, PlaneIdxV)));
+        BestErrorR2TV = _mm256_min_epi32   (ErrorV, BestErrorR2TV);
+        BestPlaneR2TV = _mm256_blendv_epi8 (BestPlaneR2TV, PlaneIdxV, IsBetterR2TV);
+        if(ErrorT2R != nullptr)
+        {
+          const __m256i ErrorT2RV    = _mm256_loadu_si256((__m256i*)(ErrorT2R + dx));
+          const __m256i PlaneT2RV    = _mm256_loadu_si256((__m256i*)(PlaneT2R + dx));
+          const __m256i PlaneInvV    = _mm256_sub_epi32(LastPlaneV, PlaneIdxV);
+          const __m256i IsBetterT2RV = _mm256_or_si256(_mm256_cmpgt_epi32(ErrorT2RV, ErrorV), _mm256_and_si256(_mm256_cmpeq_epi32(ErrorT2RV, ErrorV), _mm256_cmpgt_epi32(PlaneT2RV, PlaneInvV)));
+          _mm256_storeu_si256((__m256i*)(ErrorT2R + dx), _mm256_blendv_epi8(ErrorT2RV, ErrorV   , IsBetterT2RV));
+          _mm256_storeu_si256((__m256i*)(PlaneT2R + dx), _mm256_blendv_epi8(PlaneT2RV, PlaneInvV, IsBetterT2RV));
+        }
+      } //dy
+    } //dx
+
+    if(BestPlaneR2T != nullptr) { _mm256_storeu_si256((__m256i*)(BestPlaneR2T + x), BestPlaneR2TV); }
+  } //x
+}
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
+
+#endif //X_SIMD_CAN_USE_AVX
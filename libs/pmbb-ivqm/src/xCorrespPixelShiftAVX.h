@@ -0,0 +1,81 @@
+/*
+    SPDX-FileCopyrightText: 2019-2023 Jakub Stankowski <jakub.stankowski@put.poznan.pl>
+    SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+#include "xCommonDefIVQM.h"
+#include "xPicMask.h"
+
+#if X_SIMD_CAN_USE_AVX
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+
+class xCorrespPixelShiftAVX
+{
+public:
+  static uint64V4 CalcDistAsymmetricRow (const xPicI* Tst, const xPicI* Ref,                   const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp);
+  static uint64V4 CalcDistAsymmetricRowM(const xPicI* Tst, const xPicI* Ref, const xPicP* Msk, const int32 y, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights);
+  static uint64V4 CalcDistAsymmetricRowM(const xPicI* Tst, const xPicI* Ref, const xPicMask* Msk, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights);
+
+  //planar - processes groups of c_NumPelsPlanar neighbouring pixels, (EndX - BegX) has to be multiple of c_NumPelsPlanar
+  static constexpr int32 c_NumPelsPlanar = 8;
+  static uint64V4 CalcDistAsymmetricRow (const xPicP* Tst, const xPicP* Ref,                   const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp);
+
+  //symmetric Q - weighted errors of test row [BegX, EndX) against all displacements (RefRows - Lm, Cb and Cr of WindowSize reference rows, int32, column 0), best candidate: lower error, then lower plane index
+  //R2T best plane stored at test positions (BestPlaneR2T == nullptr --> not stored), T2R running minimum updated at reference positions (BestErrorT2R[dy + SearchRange] == nullptr --> row skipped)
+  //c_NumPelsPlanar pixels are processed at once, rows have to be padded
+  static void     UpdateBestSymmetricRow(const int32* TstLm, const int32* TstCb, const int32* TstCr, const int32* const* RefRows, int32* BestPlaneR2T, int32* const* BestErrorT2R, int32* const* BestPlaneT2R, const int32 BegX, const int32 EndX, const int32 SearchRange, const int32V4& CmpWeights);
+  //symmetric Q - distance of best matches, best match of pixel x is RingLm[PlaneOffsets[BestPlane[x]] + x] (Cb and Cr at CmpStride and 2 * CmpStride)
+  static uint64V4 CalcDistBestMatchRow(const int32* CurLm, const int32* RingLm, const int32* BestPlane, const int32* PlaneOffsets, const int32 CmpStride, const int32 BegX, const int32 EndX);
+
+protected:
+  //tSR > 0 - compile time search range, tSR == 0 - generic (runtime SearchRange), tCW - component weights specialization, tMsk - mask type (xPicP, xPicMask or xPicMaskBits)
+  template <class tMsk> static uint64V4 xCalcDistAsymmetricRowMT(const xPicI* Tst, const xPicI* Ref, const tMsk* Msk, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights); //narrow/wide and compile time variants dispatch
+  template <int32 tSR, eCmpWgh tCW> static uint64V4 xCalcDistAsymmetricRow (const xPicI* Tst, const xPicI* Ref,                   const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp);
+  template <int32 tSR, eCmpWgh tCW, class tMsk> static uint64V4 xCalcDistAsymmetricRowM(const xPicI* Tst, const xPicI* Ref, const tMsk* Msk, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights);
+
+  //best matching reference pel (int32 components) within search window, TstPelV and CmpWeightsV are expected to be duplicated in both 128-bit lanes
+  template <int32 tSR, eCmpWgh tCW> static __m128i  xFindBestPelWithinBlock  (const __m256i& TstPelV, const xPicI* Ref,                   const int32 CenterX, const int32 CenterY, const int32 SearchRange, const __m256i& CmpWeightsV);
+  template <int32 tSR, eCmpWgh tCW, class tMsk> static __m128i  xFindBestPelWithinBlockM (const __m256i& TstPelV, const xPicI* Ref, const tMsk* Msk, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const __m256i& CmpWeightsV);
+
+  //weighted error - variable shift/blend for W4110 and W1110 (shift by 32 clears component 3), multiplication for GENERIC
+  template <eCmpWgh tCW> static inline __m256i xCalcWeightedErrorV(const __m256i& DistV, const __m256i& CmpWeightsV);
+  template <eCmpWgh tCW> static inline __m128i xCalcWeightedErrorV(const __m128i& DistV, const __m128i& CmpWeightsV);
+
+  //stores shift compensated pel - (RefPelV - GlobalColorShiftV) clipped to [0, MaxValue]
+  static inline void xStoreShftCompPel(xPicP* ShftComp, const int32 x, const int32 y, const __m128i& RefPelV, const __m128i& GlobalColorShiftV, const __m128i& MaxValueV)
+  {
+    const __m128i ShftCompV = _mm_min_epi32(_mm_max_epi32(_mm_sub_epi32(RefPelV, GlobalColorShiftV), _mm_setzero_si128()), MaxValueV);
+    const int32   Offset    = ShftComp->getOffset({ x, y });
+    ShftComp->getAddr(eCmp::LM)[Offset] = (uint16)_mm_extract_epi32(ShftCompV, 0);
+    ShftComp->getAddr(eCmp::CB)[Offset] = (uint16)_mm_extract_epi32(ShftCompV, 1);
+    ShftComp->getAddr(eCmp::CR)[Offset] = (uint16)_mm_extract_epi32(ShftCompV, 2);
+  }
+
+  //mask values of two neighbouring candidates converted to int32
+  static inline __m128i xLoadMskPair(const uint16* MskPtr);
+  static inline __m128i xLoadMskPair(const uint8*  MskPtr);
+  static inline __m128i xLoadMskPair(const xMskBitPtr& MskPtr);
+
+  //narrow (16-bit) variants - TstPelV and CmpWeightsV hold int16 values duplicated for four candidates
+  template <int32 tSR> static uint64V4 xCalcDistAsymmetricRowN (const xPicI* Tst, const xPicI* Ref,                   const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp);
+  template <int32 tSR, class tMsk> static uint64V4 xCalcDistAsymmetricRowNM(const xPicI* Tst, const xPicI* Ref, const tMsk* Msk, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights);
+  template <int32 tSR> static __m128i  xFindBestPelWithinBlockN   (const __m256i& TstPelV, const xPicI* Ref,                   const int32 CenterX, const int32 CenterY, const int32 SearchRange, const __m256i& CmpWeightsV);
+  template <int32 tSR, class tMsk> static __m128i  xFindBestPelWithinBlockNM  (const __m256i& TstPelV, const xPicI* Ref, const tMsk* Msk, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const __m256i& CmpWeightsV);
+
+  //planar variants - one pixel per 32-bit lane, components kept in separate registers, best candidate tracked independently in each lane
+  template <int32 tSR, eCmpWgh tCW> static uint64V4 xCalcDistAsymmetricRowP(const xPicP* Tst, const xPicP* Ref,                   const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp);
+  template <eCmpWgh tCW> static inline __m256i xCalcWeightedErrorP(const __m256i& DistLmV, const __m256i& DistCbV, const __m256i& DistCrV, const __m256i& CmpWeightLmV, const __m256i& CmpWeightCbV, const __m256i& CmpWeightCrV);
+
+  //symmetric Q - tSR and tCW as for asymmetric Q
+  template <int32 tSR, eCmpWgh tCW> static void xUpdateBestSymmetricRow(const int32* TstLm, const int32* TstCb, const int32* TstCr, const int32* const* RefRows, int32* BestPlaneR2T, int32* const* BestErrorT2R, int32* const* BestPlaneT2R, const int32 BegX, const int32 EndX, const int32 SearchRange, const int32V4& CmpWeights);
+};
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
+
+#endif //X_SIMD_CAN_USE_AVX
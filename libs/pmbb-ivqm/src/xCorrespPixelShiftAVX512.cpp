@@ -0,0 +1,584 @@
+/*
+    SPDX-FileCopyrightText: 2019-2023 Jakub Stankowski <jakub.stankowski@put.poznan.pl>
+    SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "xCorrespPixelShiftAVX512.h"
+
+#if X_SIMD_CAN_USE_AVX512
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+// xCorrespPixelShiftAVX512
+//===============================================================================================================================================================================================================
+
+template <eCmpWgh tCW> inline __m512i xCorrespPixelShiftAVX512::xCalcWeightedErrorV(const __m512i& DistV, const __m512i& CmpWeightsV)
+{
+  if constexpr(tCW == eCmpWgh::W4110) { return _mm512_maskz_sllv_epi32(0x7777, DistV, _mm512_set4_epi32(0, 0, 0, 2)); }
+  if constexpr(tCW == eCmpWgh::W1110) { return _mm512_maskz_mov_epi32 (0x7777, DistV); }
+  return _mm512_mullo_epi32(DistV, CmpWeightsV);
+}
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+uint64V4 xCorrespPixelShiftAVX512::CalcDistAsymmetricRow(const xPicI* Tst, const xPicI* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp)
+{
+  if(xCanUseNarrowSearch(Tst->getBitDepth(), GlobalColorShift, CmpWeights)) { return xSwitchSearchRange(SearchRange, [&](auto SR) { return xCalcDistAsymmetricRowN<SR>(Tst, Ref, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights, ShftComp); }); }
+  return xSwitchCmpWeights(CmpWeights, [&](auto CW) { return xSwitchSearchRange(SearchRange, [&](auto SR) { return xCalcDistAsymmetricRow<SR, CW>(Tst, Ref, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights, ShftComp); }); });
+}
+template <int32 tSR, eCmpWgh tCW> uint64V4 xCorrespPixelShiftAVX512::xCalcDistAsymmetricRow(const xPicI* Tst, const xPicI* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp)
+{
+  assert(Tst->isCompatible(Ref));
+
+  const int32  TstStride = Tst->getStride();
+  const int32  TstOffset = y * TstStride;
+  const __m512i CmpWeightsV       = _mm512_broadcast_i32x4(_mm_loadu_si128((__m128i*) &CmpWeights      ));
+  const __m128i GlobalColorShiftV =                        _mm_loadu_si128((__m128i*) &GlobalColorShift) ;
+  const __m128i MaxValueV         = _mm_set1_epi32(xBitDepth2MaxValue(Ref->getBitDepth()));
+  const int32   ShftCompY         = ShftComp != nullptr ? y % ShftComp->getHeight() : 0;
+
+  const uint16V4* TstPtr = Tst->getAddr() + TstOffset;
+  __m256i RowDistV = _mm256_setzero_si256();
+  for (int32 x = BegX; x < EndX; x++)
+  {
+    __m128i TstU16V  = _mm_loadl_epi64((__m128i*)(TstPtr + x));
+    __m128i TstV     = _mm_add_epi32(_mm_cvtepu16_epi32(TstU16V), GlobalColorShiftV); //TODO - xc_CLIP_CURR_TST_RANGE
+    __m128i BestRefV = xFindBestPelWithinBlock<tSR, tCW>(_mm512_broadcast_i32x4(TstV), Ref, x, y, SearchRange, CmpWeightsV);
+    __m128i DiffV    = _mm_sub_epi32(TstV, BestRefV);
+    __m128i BestDist = _mm_mullo_epi32(DiffV, DiffV);
+    if(ShftComp != nullptr) { xStoreShftCompPel(ShftComp, x, ShftCompY, BestRefV, GlobalColorShiftV, MaxValueV); }
+    RowDistV = _mm256_add_epi64(RowDistV, _mm256_cvtepu32_epi64(BestDist));
+  }//x
+
+  uint64V4 RowDist;
+  _mm256_storeu_si256((__m256i*)&RowDist, RowDistV);
+  return RowDist;
+}
+template <int32 tSR, eCmpWgh tCW> __m128i xCorrespPixelShiftAVX512::xFindBestPelWithinBlock(const __m512i& TstPelV, const xPicI* Ref, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const __m512i& CmpWeightsV)
+{
+  //window row (up to 8 candidates) is loaded with single masked load, each 128-bit lane holds one candidate after widening to 32 bits
+  const int32 SR         = tSR > 0 ? tSR : SearchRange;
+  const int32 WindowSize = 2 * SR + 1;
+  const int32 BegY = CenterY - SR;
+  const int32 BegX = CenterX - SR;
+
+  const int32     Stride = Ref->getStride();
+  const uint16V4* RefPtr = Ref->getAddr() + BegY * Stride + BegX;
+
+  //per lane best candidates - each lane receives candidates in raster scan order
+  __m512i BestErrorV = _mm512_set1_epi32(std::numeric_limits<int32>::max());
+  __m512i BestIdxV   = _mm512_set1_epi32(std::numeric_limits<int32>::max());
+  __m512i BestRefV   = _mm512_setzero_si512();
+
+  for (int32 y = 0; y < WindowSize; y++)
+  {
+    const uint16V4* RefPtrY = RefPtr + y * Stride;
+    for (int32 x = 0; x < WindowSize; x += 8)
+    {
+      const int32   NumCands = xMin(WindowSize - x, 8);
+      const uint32  LoadMask = (uint32)(((uint64)1 << (NumCands << 2)) - 1);
+      const __m512i RefU16V  = _mm512_maskz_loadu_epi16(_cvtu32_mask32(LoadMask), RefPtrY + x);
+      const int32   CandIdx  = y * WindowSize + x;
+      xUpdateBestCandidates<tCW>(TstPelV, _mm512_castsi512_si256(RefU16V), (__mmask16)LoadMask, CandIdx, CmpWeightsV, BestErrorV, BestIdxV, BestRefV);
+      if (NumCands > 4) { xUpdateBestCandidates<tCW>(TstPelV, _mm512_extracti64x4_epi64(RefU16V, 1), (__mmask16)(LoadMask >> 16), CandIdx + 4, CmpWeightsV, BestErrorV, BestIdxV, BestRefV); }
+    } //x
+  } //y
+
+  return xSelectBestCandidate(BestErrorV, BestIdxV, BestRefV);
+}
+uint64V4 xCorrespPixelShiftAVX512::CalcDistAsymmetricRowM(const xPicI* Tst, const xPicI* Ref, const xPicP* Msk, const int32 y, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  return xCalcDistAsymmetricRowMT(Tst, Ref, Msk, y, 0, Tst->getWidth(), GlobalColorShift, SearchRange, CmpWeights);
+}
+uint64V4 xCorrespPixelShiftAVX512::CalcDistAsymmetricRowM(const xPicI* Tst, const xPicI* Ref, const xPicMask* Msk, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  //binary mask is read directly from bit plane
+  if(Msk->isBinary()) { const xPicMaskBits MskBits(Msk); return xCalcDistAsymmetricRowMT(Tst, Ref, &MskBits, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights); }
+  return xCalcDistAsymmetricRowMT(Tst, Ref, Msk, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights);
+}
+template <class tMsk> uint64V4 xCorrespPixelShiftAVX512::xCalcDistAsymmetricRowMT(const xPicI* Tst, const xPicI* Ref, const tMsk* Msk, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  if(xCanUseNarrowSearch(Tst->getBitDepth(), GlobalColorShift, CmpWeights)) { return xSwitchSearchRange(SearchRange, [&](auto SR) { return xCalcDistAsymmetricRowNM<SR>(Tst, Ref, Msk, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights); }); }
+  return xSwitchCmpWeights(CmpWeights, [&](auto CW) { return xSwitchSearchRange(SearchRange, [&](auto SR) { return xCalcDistAsymmetricRowM<SR, CW>(Tst, Ref, Msk, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights); }); });
+}
+template <int32 tSR, eCmpWgh tCW, class tMsk> uint64V4 xCorrespPixelShiftAVX512::xCalcDistAsymmetricRowM(const xPicI* Tst, const xPicI* Ref, const tMsk* Msk, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  assert(Tst->isCompatible(Ref));
+
+  const int32  TstStride = Tst->getStride();
+  const int32  TstOffset = y * TstStride;
+  const int32  MskStride = Msk->getStride();
+  const int32  MskOffset = y * MskStride;
+  const __m512i CmpWeightsV       = _mm512_broadcast_i32x4(_mm_loadu_si128((__m128i*) &CmpWeights      ));
+  const __m128i GlobalColorShiftV =                        _mm_loadu_si128((__m128i*) &GlobalColorShift) ;
+
+  const uint16V4* TstPtr = Tst->getAddr(        ) + TstOffset;
+  const auto      MskPtr = xGetMskAddr(Msk) + MskOffset;
+  __m256i RowDistV = _mm256_setzero_si256();
+  for (int32 x = BegX; x < EndX; x++)
+  {
+    const int32 CurrMskValue = (int32)MskPtr[x];
+    if(CurrMskValue == 0) { continue; } //skip masked pixels
+    __m128i TstU16V  = _mm_loadl_epi64((__m128i*)(TstPtr + x));
+    __m128i TstV     = _mm_add_epi32(_mm_cvtepu16_epi32(TstU16V), GlobalColorShiftV); //TODO - xc_CLIP_CURR_TST_RANGE
+    __m128i BestRefV = xFindBestPelWithinBlockM<tSR, tCW>(_mm512_broadcast_i32x4(TstV), Ref, Msk, x, y, SearchRange, CmpWeightsV);
+    __m128i DiffV    = _mm_sub_epi32(TstV, BestRefV);
+    __m128i BestDist = _mm_mullo_epi32(DiffV, DiffV);
+    RowDistV = _mm256_add_epi64(RowDistV, _mm256_mul_epu32(_mm256_cvtepu32_epi64(BestDist), _mm256_set1_epi64x(CurrMskValue)));
+  }//x
+
+  uint64V4 RowDist;
+  _mm256_storeu_si256((__m256i*)&RowDist, RowDistV);
+  return RowDist;
+}
+template <int32 tSR, eCmpWgh tCW, class tMsk> __m128i xCorrespPixelShiftAVX512::xFindBestPelWithinBlockM(const __m512i& TstPelV, const xPicI* Ref, const tMsk* Msk, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const __m512i& CmpWeightsV)
+{
+  //as xFindBestPelWithinBlock, candidates with zero mask value are excluded by clearing their lanes in validity mask
+  const int32 SR         = tSR > 0 ? tSR : SearchRange;
+  const int32 WindowSize = 2 * SR + 1;
+  const int32 BegY = CenterY - SR;
+  const int32 BegX = CenterX - SR;
+
+  const int32     Stride    = Ref->getStride();
+  const int32     MskStride = Msk->getStride();
+  const uint16V4* RefPtr    = Ref->getAddr(        ) + BegY * Stride    + BegX;
+  const auto      MskPtr    = xGetMskAddr(Msk) + BegY * MskStride + BegX;
+
+  const __m512i MskPermV = _mm512_set_epi32(3, 3, 3, 3, 2, 2, 2, 2, 1, 1, 1, 1, 0, 0, 0, 0);
+
+  __m512i BestErrorV = _mm512_set1_epi32(std::numeric_limits<int32>::max());
+  __m512i BestIdxV   = _mm512_set1_epi32(std::numeric_limits<int32>::max());
+  __m512i BestRefV   = _mm512_setzero_si512();
+
+  for (int32 y = 0; y < WindowSize; y++)
+  {
+    const uint16V4* RefPtrY = RefPtr + y * Stride;
+    const auto      MskPtrY = MskPtr + y * MskStride;
+    for (int32 x = 0; x < WindowSize; x += 8)
+    {
+      const int32     NumCands   = xMin(WindowSize - x, 8);
+      const uint32    LoadMask   = (uint32)(((uint64)1 << (NumCands << 2)) - 1);
+      const __m512i   RefU16V    = _mm512_maskz_loadu_epi16(_cvtu32_mask32(LoadMask), RefPtrY + x);
+      const __m512i   MskV       = xLoadMskCands(MskPtrY + x, NumCands);
+      const int32     CandIdx    = y * WindowSize + x;
+      const __m512i   MskV0      = _mm512_permutexvar_epi32(MskPermV, MskV);
+      const __mmask16 ValidMask0 = _mm512_test_epi32_mask(MskV0, MskV0);
+      xUpdateBestCandidates<tCW>(TstPelV, _mm512_castsi512_si256(RefU16V), (__mmask16)LoadMask & ValidMask0, CandIdx, CmpWeightsV, BestErrorV, BestIdxV, BestRefV);
+      if (NumCands > 4)
+      {
+        const __m512i   MskV1      = _mm512_permutexvar_epi32(_mm512_add_epi32(MskPermV, _mm512_set1_epi32(4)), MskV);
+        const __mmask16 ValidMask1 = _mm512_test_epi32_mask(MskV1, MskV1);
+        xUpdateBestCandidates<tCW>(TstPelV, _mm512_extracti64x4_epi64(RefU16V, 1), (__mmask16)(LoadMask >> 16) & ValidMask1, CandIdx + 4, CmpWeightsV, BestErrorV, BestIdxV, BestRefV);
+      }
+    } //x
+  } //y
+
+  return xSelectBestCandidate(BestErrorV, BestIdxV, BestRefV);
+}
+template <eCmpWgh tCW> inline void xCorrespPixelShiftAVX512::xUpdateBestCandidates(const __m512i& TstPelV, const __m256i& RefU16V, const __mmask16 ValidMask, const int32 CandIdx, const __m512i& CmpWeightsV, __m512i& BestErrorV, __m512i& BestIdxV, __m512i& BestRefV)
+{
+  const __m512i LaneIdxV = _mm512_set_epi32(3, 3, 3, 3, 2, 2, 2, 2, 1, 1, 1, 1, 0, 0, 0, 0);
+
+  __m512i RefV   = _mm512_cvtepu16_epi32(RefU16V);
+  __m512i DiffV  = _mm512_sub_epi32     (TstPelV, RefV);
+  __m512i DistV  = _mm512_mullo_epi32   (DiffV, DiffV);
+  __m512i ErrorV = xCalcWeightedErrorV<tCW>(DistV, CmpWeightsV);
+  ErrorV = _mm512_add_epi32(ErrorV, _mm512_shuffle_epi32(ErrorV, (_MM_PERM_ENUM)_MM_SHUFFLE(2, 3, 0, 1)));
+  ErrorV = _mm512_add_epi32(ErrorV, _mm512_shuffle_epi32(ErrorV, (_MM_PERM_ENUM)_MM_SHUFFLE(1, 0, 3, 2)));
+  //strict less than within lane - first candidate with minimal error wins
+  __mmask16 LessMask = _mm512_mask_cmplt_epi32_mask(ValidMask, ErrorV, BestErrorV);
+  BestErrorV = _mm512_mask_mov_epi32(BestErrorV, LessMask, ErrorV);
+  BestRefV   = _mm512_mask_mov_epi32(BestRefV  , LessMask, RefV  );
+  BestIdxV   = _mm512_mask_mov_epi32(BestIdxV  , LessMask, _mm512_add_epi32(LaneIdxV, _mm512_set1_epi32(CandIdx)));
+}
+inline __m128i xCorrespPixelShiftAVX512::xSelectBestCandidate(const __m512i& BestErrorV, const __m512i& BestIdxV, const __m512i& BestRefV)
+{
+  //branchless cross-lane selection - minimal error first, then minimal raster scan index
+  const __m512i MaxV = _mm512_set1_epi32(std::numeric_limits<int32>::max());
+
+  __m512i MinErrorV = _mm512_min_epi32(BestErrorV, _mm512_shuffle_i32x4(BestErrorV, BestErrorV, _MM_SHUFFLE(2, 3, 0, 1)));
+          MinErrorV = _mm512_min_epi32(MinErrorV , _mm512_shuffle_i32x4(MinErrorV , MinErrorV , _MM_SHUFFLE(1, 0, 3, 2)));
+  __mmask16 EqualMask = _mm512_cmpeq_epi32_mask(BestErrorV, MinErrorV);
+  __m512i TieIdxV   = _mm512_mask_mov_epi32(MaxV, EqualMask, BestIdxV);
+  __m512i MinIdxV   = _mm512_min_epi32(TieIdxV, _mm512_shuffle_i32x4(TieIdxV, TieIdxV, _MM_SHUFFLE(2, 3, 0, 1)));
+          MinIdxV   = _mm512_min_epi32(MinIdxV, _mm512_shuffle_i32x4(MinIdxV, MinIdxV, _MM_SHUFFLE(1, 0, 3, 2)));
+  __mmask16 SelectMask = _mm512_mask_cmpeq_epi32_mask(EqualMask, TieIdxV, MinIdxV);
+
+  return _mm512_castsi512_si128(_mm512_maskz_compress_epi32(SelectMask, BestRefV));
+}
+inline __m512i xCorrespPixelShiftAVX512::xLoadMskCands(const uint16* MskPtr, const int32 NumCands)
+{
+  return _mm512_cvtepu16_epi32(_mm256_zextsi128_si256(_mm_maskz_loadu_epi16(_cvtu32_mask8((1 << NumCands) - 1), MskPtr)));
+}
+inline __m512i xCorrespPixelShiftAVX512::xLoadMskCands(const uint8* MskPtr, const int32 NumCands)
+{
+  return _mm512_cvtepu8_epi32(_mm_maskz_loadu_epi8(_cvtu32_mask16((1 << NumCands) - 1), MskPtr));
+}
+inline __m512i xCorrespPixelShiftAVX512::xLoadMskCands(const xMskBitPtr& MskPtr, const int32 NumCands)
+{
+  return _mm512_maskz_mov_epi32(_cvtu32_mask16(MskPtr.getBits(NumCands)), _mm512_set1_epi32(1));
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// planar
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template <eCmpWgh tCW> inline __m512i xCorrespPixelShiftAVX512::xCalcWeightedErrorP(const __m512i& DistLmV, const __m512i& DistCbV, const __m512i& DistCrV, const __m512i& CmpWeightLmV, const __m512i& CmpWeightCbV, const __m512i& CmpWeightCrV)
+{
+  if constexpr(tCW == eCmpWgh::W4110) { return _mm512_add_epi32(_mm512_slli_epi32(DistLmV, 2), _mm512_add_epi32(DistCbV, DistCrV)); }
+  if constexpr(tCW == eCmpWgh::W1110) { return _mm512_add_epi32(DistLmV, _mm512_add_epi32(DistCbV, DistCrV)); }
+  return _mm512_add_epi32(_mm512_mullo_epi32(DistLmV, CmpWeightLmV), _mm512_add_epi32(_mm512_mullo_epi32(DistCbV, CmpWeightCbV), _mm512_mullo_epi32(DistCrV, CmpWeightCrV)));
+}
+uint64V4 xCorrespPixelShiftAVX512::CalcDistAsymmetricRow(const xPicP* Tst, const xPicP* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp)
+{
+  return xSwitchCmpWeights(CmpWeights, [&](auto CW) { return xSwitchSearchRange(SearchRange, [&](auto SR) { return xCalcDistAsymmetricRowP<SR, CW>(Tst, Ref, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights, ShftComp); }); });
+}
+template <int32 tSR, eCmpWgh tCW> uint64V4 xCorrespPixelShiftAVX512::xCalcDistAsymmetricRowP(const xPicP* Tst, const xPicP* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp)
+{
+  assert(Tst->isCompatible(Ref));
+  assert(((EndX - BegX) % c_NumPelsPlanar) == 0);
+
+  const int32 SR         = tSR > 0 ? tSR : SearchRange;
+  const int32 WindowSize = 2 * SR + 1;
+  const int32 TstStride  = Tst->getStride();
+  const int32 RefStride  = Ref->getStride();
+
+  const uint16* TstPtrLm = Tst->getAddr(eCmp::LM) + y * TstStride;
+  const uint16* TstPtrCb = Tst->getAddr(eCmp::CB) + y * TstStride;
+  const uint16* TstPtrCr = Tst->getAddr(eCmp::CR) + y * TstStride;
+  const uint16* RefPtrLm = Ref->getAddr(eCmp::LM) + (y - SR) * RefStride - SR;
+  const uint16* RefPtrCb = Ref->getAddr(eCmp::CB) + (y - SR) * RefStride - SR;
+  const uint16* RefPtrCr = Ref->getAddr(eCmp::CR) + (y - SR) * RefStride - SR;
+
+  const __m512i GlobalColorShiftLmV = _mm512_set1_epi32(GlobalColorShift[0]);
+  const __m512i GlobalColorShiftCbV = _mm512_set1_epi32(GlobalColorShift[1]);
+  const __m512i GlobalColorShiftCrV = _mm512_set1_epi32(GlobalColorShift[2]);
+  const __m512i CmpWeightLmV        = _mm512_set1_epi32(CmpWeights      [0]);
+  const __m512i CmpWeightCbV        = _mm512_set1_epi32(CmpWeights      [1]);
+  const __m512i CmpWeightCrV        = _mm512_set1_epi32(CmpWeights      [2]);
+  const __m512i MaxV                = _mm512_set1_epi32(std::numeric_limits<int32>::max());
+  const __m512i MaxValueV           = _mm512_set1_epi32(xBitDepth2MaxValue(Ref->getBitDepth()));
+  const int32   ShftCompY           = ShftComp != nullptr ? y % ShftComp->getHeight() : 0;
+
+  __m512i RowDistLmV = _mm512_setzero_si512();
+  __m512i RowDistCbV = _mm512_setzero_si512();
+  __m512i RowDistCrV = _mm512_setzero_si512();
+
+  for(int32 x = BegX; x < EndX; x += c_NumPelsPlanar)
+  {
+    const __m512i TstLmV = _mm512_add_epi32(_mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i*)(TstPtrLm + x))), GlobalColorShiftLmV); //TODO - xc_CLIP_CURR_TST_RANGE
+    const __m512i TstCbV = _mm512_add_epi32(_mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i*)(TstPtrCb + x))), GlobalColorShiftCbV); //TODO - xc_CLIP_CURR_TST_RANGE
+    const __m512i TstCrV = _mm512_add_epi32(_mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i*)(TstPtrCr + x))), GlobalColorShiftCrV); //TODO - xc_CLIP_CURR_TST_RANGE
+
+    __m512i BestErrorV = MaxV;
+    __m512i BestRefLmV = _mm512_setzero_si512();
+    __m512i BestRefCbV = _mm512_setzero_si512();
+    __m512i BestRefCrV = _mm512_setzero_si512();
+
+    for(int32 wy = 0; wy < WindowSize; wy++)
+    {
+      const int32 Offset = wy * RefStride + x;
+      for(int32 wx = 0; wx < WindowSize; wx++)
+      {
+        const __m512i RefLmV   = _mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i*)(RefPtrLm + Offset + wx)));
+        const __m512i RefCbV   = _mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i*)(RefPtrCb + Offset + wx)));
+        const __m512i RefCrV   = _mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i*)(RefPtrCr + Offset + wx)));
+        const __m512i DiffLmV  = _mm512_sub_epi32(TstLmV, RefLmV);
+        const __m512i DiffCbV  = _mm512_sub_epi32(TstCbV, RefCbV);
+        const __m512i DiffCrV  = _mm512_sub_epi32(TstCrV, RefCrV);
+        const __m512i ErrorV   = xCalcWeightedErrorP<tCW>(_mm512_mullo_epi32(DiffLmV, DiffLmV), _mm512_mullo_epi32(DiffCbV, DiffCbV), _mm512_mullo_epi32(DiffCrV, DiffCrV), CmpWeightLmV, CmpWeightCbV, CmpWeightCrV);
+        //preserve raster scan order - first candidate with minimal error wins
+        const __mmask16 IsBetter = _mm512_cmplt_epi32_mask(ErrorV, BestErrorV);
+        BestErrorV = _mm512_min_epi32     (ErrorV, BestErrorV);
+        BestRefLmV = _mm512_mask_mov_epi32(BestRefLmV, IsBetter, RefLmV);
+        BestRefCbV = _mm512_mask_mov_epi32(BestRefCbV, IsBetter, RefCbV);
+        BestRefCrV = _mm512_mask_mov_epi32(BestRefCrV, IsBetter, RefCrV);
+      } //wx
+    } //wy
+
+    const __m512i BestDiffLmV = _mm512_sub_epi32(TstLmV, BestRefLmV);
+    const __m512i BestDiffCbV = _mm512_sub_epi32(TstCbV, BestRefCbV);
+    const __m512i BestDiffCrV = _mm512_sub_epi32(TstCrV, BestRefCrV);
+    const __m512i BestDistLmV = _mm512_mullo_epi32(BestDiffLmV, BestDiffLmV);
+    const __m512i BestDistCbV = _mm512_mullo_epi32(BestDiffCbV, BestDiffCbV);
+    const __m512i BestDistCrV = _mm512_mullo_epi32(BestDiffCrV, BestDiffCrV);
+
+    if(ShftComp != nullptr)
+    {
+      const int32   Offset  = ShftComp->getOffset({ x, ShftCompY });
+      const __m512i ShftLmV = _mm512_min_epi32(_mm512_max_epi32(_mm512_sub_epi32(BestRefLmV, GlobalColorShiftLmV), _mm512_setzero_si512()), MaxValueV);
+      const __m512i ShftCbV = _mm512_min_epi32(_mm512_max_epi32(_mm512_sub_epi32(BestRefCbV, GlobalColorShiftCbV), _mm512_setzero_si512()), MaxValueV);
+      const __m512i ShftCrV = _mm512_min_epi32(_mm512_max_epi32(_mm512_sub_epi32(BestRefCrV, GlobalColorShiftCrV), _mm512_setzero_si512()), MaxValueV);
+      _mm256_storeu_si256((__m256i*)(ShftComp->getAddr(eCmp::LM) + Offset), _mm512_cvtepi32_epi16(ShftLmV));
+      _mm256_storeu_si256((__m256i*)(ShftComp->getAddr(eCmp::CB) + Offset), _mm512_cvtepi32_epi16(ShftCbV));
+      _mm256_storeu_si256((__m256i*)(ShftComp->getAddr(eCmp::CR) + Offset), _mm512_cvtepi32_epi16(ShftCrV));
+    }
+
+    RowDistLmV = _mm512_add_epi64(RowDistLmV, _mm512_add_epi64(_mm512_cvtepu32_epi64(_mm512_castsi512_si256(BestDistLmV)), _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(BestDistLmV, 1))));
+    RowDistCbV = _mm512_add_epi64(RowDistCbV, _mm512_add_epi64(_mm512_cvtepu32_epi64(_mm512_castsi512_si256(BestDistCbV)), _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(BestDistCbV, 1))));
+    RowDistCrV = _mm512_add_epi64(RowDistCrV, _mm512_add_epi64(_mm512_cvtepu32_epi64(_mm512_castsi512_si256(BestDistCrV)), _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(BestDistCrV, 1))));
+  }//x
+
+  return { (uint64)_mm512_reduce_add_epi64(RowDistLmV), (uint64)_mm512_reduce_add_epi64(RowDistCbV), (uint64)_mm512_reduce_add_epi64(RowDistCrV), 0 };
+}
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// narrow (16-bit) arithmetic - valid if xCanUseNarrowSearch()
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template <int32 tSR> uint64V4 xCorrespPixelShiftAVX512::xCalcDistAsymmetricRowN(const xPicI* Tst, const xPicI* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp)
+{
+  assert(Tst->isCompatible(Ref));
+
+  const int32  TstStride = Tst->getStride();
+  const int32  TstOffset = y * TstStride;
+  const __m512i CmpWeightsV       = _mm512_broadcastq_epi64(_mm_packs_epi32(_mm_loadu_si128((__m128i*) &CmpWeights      ), _mm_setzero_si128()));
+  const __m128i GlobalColorShiftV =                         _mm_packs_epi32(_mm_loadu_si128((__m128i*) &GlobalColorShift), _mm_setzero_si128()) ;
+  const __m128i GlobalColorShift32V = _mm_loadu_si128((__m128i*) &GlobalColorShift);
+  const __m128i MaxValueV           = _mm_set1_epi32(xBitDepth2MaxValue(Ref->getBitDepth()));
+  const int32   ShftCompY           = ShftComp != nullptr ? y % ShftComp->getHeight() : 0;
+
+  const uint16V4* TstPtr = Tst->getAddr() + TstOffset;
+  __m256i RowDistV = _mm256_setzero_si256();
+  for (int32 x = BegX; x < EndX; x++)
+  {
+    __m128i TstU16V  = _mm_loadl_epi64((__m128i*)(TstPtr + x));
+    __m128i TstV     = _mm_add_epi16(TstU16V, GlobalColorShiftV); //TODO - xc_CLIP_CURR_TST_RANGE
+    __m128i BestRefV = xFindBestPelWithinBlockN<tSR>(_mm512_broadcastq_epi64(TstV), Ref, x, y, SearchRange, CmpWeightsV);
+    __m128i DiffV    = _mm_sub_epi32(_mm_cvtepi16_epi32(TstV), BestRefV);
+    __m128i BestDist = _mm_mullo_epi32(DiffV, DiffV);
+    if(ShftComp != nullptr) { xStoreShftCompPel(ShftComp, x, ShftCompY, BestRefV, GlobalColorShift32V, MaxValueV); }
+    RowDistV = _mm256_add_epi64(RowDistV, _mm256_cvtepu32_epi64(BestDist));
+  }//x
+
+  uint64V4 RowDist;
+  _mm256_storeu_si256((__m256i*)&RowDist, RowDistV);
+  return RowDist;
+}
+template <int32 tSR> __m128i xCorrespPixelShiftAVX512::xFindBestPelWithinBlockN(const __m512i& TstPelV, const xPicI* Ref, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const __m512i& CmpWeightsV)
+{
+  //window row (up to 8 candidates) is loaded with single masked load, weighted error is calculated in 16-bit lanes (multiply-add), best candidate pel is widened to 32 bits at the end
+  const int32 SR         = tSR > 0 ? tSR : SearchRange;
+  const int32 WindowSize = 2 * SR + 1;
+  const int32 BegY = CenterY - SR;
+  const int32 BegX = CenterX - SR;
+
+  const int32     Stride = Ref->getStride();
+  const uint16V4* RefPtr = Ref->getAddr() + BegY * Stride + BegX;
+
+  __m256i BestErrorV = _mm256_set1_epi32(std::numeric_limits<int32>::max());
+  __m256i BestIdxV   = _mm256_set1_epi32(std::numeric_limits<int32>::max());
+
+  for (int32 y = 0; y < WindowSize; y++)
+  {
+    const uint16V4* RefPtrY = RefPtr + y * Stride;
+    for (int32 x = 0; x < WindowSize; x += 8)
+    {
+      const int32   NumCands = xMin(WindowSize - x, 8);
+      const uint32  LoadMask = (uint32)(((uint64)1 << (NumCands << 2)) - 1);
+      const __m512i RefV     = _mm512_maskz_loadu_epi16(_cvtu32_mask32(LoadMask), RefPtrY + x);
+      xUpdateBestCandidatesN(TstPelV, RefV, _cvtu32_mask8((1 << NumCands) - 1), y * WindowSize + x, CmpWeightsV, BestErrorV, BestIdxV);
+    } //x
+  } //y
+
+  const int32   BestIdx    = xSelectBestCandidateN(BestErrorV, BestIdxV);
+  const int32   BestOffset = (BestIdx / WindowSize) * Stride + (BestIdx % WindowSize);
+  return _mm_cvtepu16_epi32(_mm_loadl_epi64((__m128i*)(RefPtr + BestOffset)));
+}
+template <int32 tSR, class tMsk> uint64V4 xCorrespPixelShiftAVX512::xCalcDistAsymmetricRowNM(const xPicI* Tst, const xPicI* Ref, const tMsk* Msk, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  assert(Tst->isCompatible(Ref));
+
+  const int32  TstStride = Tst->getStride();
+  const int32  TstOffset = y * TstStride;
+  const int32  MskStride = Msk->getStride();
+  const int32  MskOffset = y * MskStride;
+  const __m512i CmpWeightsV       = _mm512_broadcastq_epi64(_mm_packs_epi32(_mm_loadu_si128((__m128i*) &CmpWeights      ), _mm_setzero_si128()));
+  const __m128i GlobalColorShiftV =                         _mm_packs_epi32(_mm_loadu_si128((__m128i*) &GlobalColorShift), _mm_setzero_si128()) ;
+
+  const uint16V4* TstPtr = Tst->getAddr(        ) + TstOffset;
+  const auto      MskPtr = xGetMskAddr(Msk) + MskOffset;
+  __m256i RowDistV = _mm256_setzero_si256();
+  for (int32 x = BegX; x < EndX; x++)
+  {
+    const int32 CurrMskValue = (int32)MskPtr[x];
+    if(CurrMskValue == 0) { continue; } //skip masked pixels
+    __m128i TstU16V  = _mm_loadl_epi64((__m128i*)(TstPtr + x));
+    __m128i TstV     = _mm_add_epi16(TstU16V, GlobalColorShiftV); //TODO - xc_CLIP_CURR_TST_RANGE
+    __m128i BestRefV = xFindBestPelWithinBlockNM<tSR>(_mm512_broadcastq_epi64(TstV), Ref, Msk, x, y, SearchRange, CmpWeightsV);
+    __m128i DiffV    = _mm_sub_epi32(_mm_cvtepi16_epi32(TstV), BestRefV);
+    __m128i BestDist = _mm_mullo_epi32(DiffV, DiffV);
+    RowDistV = _mm256_add_epi64(RowDistV, _mm256_mul_epu32(_mm256_cvtepu32_epi64(BestDist), _mm256_set1_epi64x(CurrMskValue)));
+  }//x
+
+  uint64V4 RowDist;
+  _mm256_storeu_si256((__m256i*)&RowDist, RowDistV);
+  return RowDist;
+}
+template <int32 tSR, class tMsk> __m128i xCorrespPixelShiftAVX512::xFindBestPelWithinBlockNM(const __m512i& TstPelV, const xPicI* Ref, const tMsk* Msk, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const __m512i& CmpWeightsV)
+{
+  //as xFindBestPelWithinBlockN, candidates with zero mask value are excluded by clearing their lanes in validity mask
+  const int32 SR         = tSR > 0 ? tSR : SearchRange;
+  const int32 WindowSize = 2 * SR + 1;
+  const int32 BegY = CenterY - SR;
+  const int32 BegX = CenterX - SR;
+
+  const int32     Stride    = Ref->getStride();
+  const int32     MskStride = Msk->getStride();
+  const uint16V4* RefPtr    = Ref->getAddr(        ) + BegY * Stride    + BegX;
+  const auto      MskPtr    = xGetMskAddr(Msk) + BegY * MskStride + BegX;
+
+  __m256i BestErrorV = _mm256_set1_epi32(std::numeric_limits<int32>::max());
+  __m256i BestIdxV   = _mm256_set1_epi32(std::numeric_limits<int32>::max());
+
+  for (int32 y = 0; y < WindowSize; y++)
+  {
+    const uint16V4* RefPtrY = RefPtr + y * Stride;
+    const auto      MskPtrY = MskPtr + y * MskStride;
+    for (int32 x = 0; x < WindowSize; x += 8)
+    {
+      const int32    NumCands  = xMin(WindowSize - x, 8);
+      const uint32   LoadMask  = (uint32)(((uint64)1 << (NumCands << 2)) - 1);
+      const __mmask8 CandMask  = _cvtu32_mask8((1 << NumCands) - 1);
+      const __m512i  RefV      = _mm512_maskz_loadu_epi16(_cvtu32_mask32(LoadMask), RefPtrY + x);
+      const __mmask8 ValidMask = xTestMskCands(MskPtrY + x, CandMask);
+      xUpdateBestCandidatesN(TstPelV, RefV, ValidMask, y * WindowSize + x, CmpWeightsV, BestErrorV, BestIdxV);
+    } //x
+  } //y
+
+  //center candidate is always valid (masked test pixels are skipped by caller)
+  const int32   BestIdx    = xSelectBestCandidateN(BestErrorV, BestIdxV);
+  const int32   BestOffset = (BestIdx / WindowSize) * Stride + (BestIdx % WindowSize);
+  return _mm_cvtepu16_epi32(_mm_loadl_epi64((__m128i*)(RefPtr + BestOffset)));
+}
+inline void xCorrespPixelShiftAVX512::xUpdateBestCandidatesN(const __m512i& TstPelV, const __m512i& RefV, const __mmask8 ValidMask, const int32 CandIdx, const __m512i& CmpWeightsV, __m256i& BestErrorV, __m256i& BestIdxV)
+{
+  const __m256i LaneIdxV = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+  __m512i DiffV  = _mm512_sub_epi16 (TstPelV, RefV);
+  __m512i ProdV  = _mm512_madd_epi16(DiffV, _mm512_mullo_epi16(DiffV, CmpWeightsV));
+  __m256i ErrorV = _mm512_cvtepi64_epi32(_mm512_add_epi32(ProdV, _mm512_srli_epi64(ProdV, 32)));
+  //strict less than within lane - first candidate with minimal error wins
+  __mmask8 LessMask = _mm256_mask_cmplt_epi32_mask(ValidMask, ErrorV, BestErrorV);
+  BestErrorV = _mm256_mask_mov_epi32(BestErrorV, LessMask, ErrorV);
+  BestIdxV   = _mm256_mask_mov_epi32(BestIdxV  , LessMask, _mm256_add_epi32(LaneIdxV, _mm256_set1_epi32(CandIdx)));
+}
+inline int32 xCorrespPixelShiftAVX512::xSelectBestCandidateN(const __m256i& BestErrorV, const __m256i& BestIdxV)
+{
+  //minimal error first, then minimal raster scan index
+  const __m256i MaxV = _mm256_set1_epi32(std::numeric_limits<int32>::max());
+
+  __m256i MinErrorV = _mm256_min_epi32(BestErrorV, _mm256_permute2x128_si256(BestErrorV, BestErrorV, 1));
+          MinErrorV = _mm256_min_epi32(MinErrorV , _mm256_shuffle_epi32(MinErrorV, _MM_SHUFFLE(1, 0, 3, 2)));
+          MinErrorV = _mm256_min_epi32(MinErrorV , _mm256_shuffle_epi32(MinErrorV, _MM_SHUFFLE(2, 3, 0, 1)));
+  __m256i TieIdxV   = _mm256_mask_mov_epi32(MaxV, _mm256_cmpeq_epi32_mask(BestErrorV, MinErrorV), BestIdxV);
+  __m256i MinIdxV   = _mm256_min_epi32(TieIdxV, _mm256_permute2x128_si256(TieIdxV, TieIdxV, 1));
+          MinIdxV   = _mm256_min_epi32(MinIdxV, _mm256_shuffle_epi32(MinIdxV, _MM_SHUFFLE(1, 0, 3, 2)));
+          MinIdxV   = _mm256_min_epi32(MinIdxV, _mm256_shuffle_epi32(MinIdxV, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm256_cvtsi256_si32(MinIdxV);
+}
+inline __mmask8 xCorrespPixelShiftAVX512::xTestMskCands(const uint16* MskPtr, const __mmask8 CandMask)
+{
+  const __m128i MskV = _mm_maskz_loadu_epi16(CandMask, MskPtr);
+  return _mm_mask_test_epi16_mask(CandMask, MskV, MskV);
+}
+inline __mmask8 xCorrespPixelShiftAVX512::xTestMskCands(const uint8* MskPtr, const __mmask8 CandMask)
+{
+  const __m128i MskV = _mm_maskz_loadu_epi8((__mmask16)CandMask, MskPtr);
+  return (__mmask8)_mm_mask_test_epi8_mask((__mmask16)CandMask, MskV, MskV);
+}
+inline __mmask8 xCorrespPixelShiftAVX512::xTestMskCands(const xMskBitPtr& MskPtr, const __mmask8 CandMask)
+{
+  return (__mmask8)(MskPtr.getBits(8) & CandMask);
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// symmetric Q - planar int32 rows
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void xCorrespPixelShiftAVX512::UpdateBestSymmetricRow(const int32* TstLm, const int32* TstCb, const int32* TstCr, const int32* const* RefRows, int32* BestPlaneR2T, int32* const* BestErrorT2R, int32* const* BestPlaneT2R, const int32 BegX, const int32 EndX, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  xSwitchCmpWeights(CmpWeights, [&](auto CW) { xSwitchSearchRange(SearchRange, [&](auto SR) { xUpdateBestSymmetricRow<SR, CW>(TstLm, TstCb, TstCr, RefRows, BestPlaneR2T, BestErrorT2R, BestPlaneT2R, BegX, EndX, SearchRange, CmpWeights); }); });
+}
+uint64V4 xCorrespPixelShiftAVX512::CalcDistBestMatchRow(const int32* CurLm, const int32* RingLm, const int32* BestPlane, const int32* PlaneOffsets, const int32 CmpStride, const int32 BegX, const int32 EndX)
+{
+  const __m512i IdxV = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+  __m512i RowDistLmV = _mm512_setzero_si512();
+  __m512i RowDistCbV = _mm512_setzero_si512();
+  __m512i RowDistCrV = _mm512_setzero_si512();
+
+  for(int32 x = BegX; x < EndX; x += c_NumPelsPlanar)
+  {
+    const __mmask16 Mask    = EndX - x >= c_NumPelsPlanar ? (__mmask16)0xFFFF : (__mmask16)((1u << (EndX - x)) - 1); //remaining pixels
+    const __m512i   PlaneV  = _mm512_maskz_loadu_epi32(Mask, BestPlane + x);
+    const __m512i   OffsetV = _mm512_add_epi32(_mm512_mask_i32gather_epi32(_mm512_setzero_si512(), Mask, PlaneV, PlaneOffsets, 4), _mm512_add_epi32(IdxV, _mm512_set1_epi32(x)));
+    const __m512i   DiffLmV = _mm512_sub_epi32(_mm512_maskz_loadu_epi32(Mask, CurLm + x                ), _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), Mask, OffsetV, RingLm                , 4));
+    const __m512i   DiffCbV = _mm512_sub_epi32(_mm512_maskz_loadu_epi32(Mask, CurLm + x +     CmpStride), _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), Mask, OffsetV, RingLm +     CmpStride, 4));
+    const __m512i   DiffCrV = _mm512_sub_epi32(_mm512_maskz_loadu_epi32(Mask, CurLm + x + 2 * CmpStride), _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), Mask, OffsetV, RingLm + 2 * CmpStride, 4));
+    const __m512i   DistLmV = _mm512_mullo_epi32(DiffLmV, DiffLmV);
+    const __m512i   DistCbV = _mm512_mullo_epi32(DiffCbV, DiffCbV);
+    const __m512i   DistCrV = _mm512_mullo_epi32(DiffCrV, DiffCrV);
+    RowDistLmV = _mm512_add_epi64(RowDistLmV, _mm512_add_epi64(_mm512_cvtepu32_epi64(_mm512_castsi512_si256(DistLmV)), _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(DistLmV, 1))));
+    RowDistCbV = _mm512_add_epi64(RowDistCbV, _mm512_add_epi64(_mm512_cvtepu32_epi64(_mm512_castsi512_si256(DistCbV)), _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(DistCbV, 1))));
+    RowDistCrV = _mm512_add_epi64(RowDistCrV, _mm512_add_epi64(_mm512_cvtepu32_epi64(_mm512_castsi512_si256(DistCrV)), _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(DistCrV, 1))));
+  } //x
+
+  return { (uint64)_mm512_reduce_add_epi64(RowDistLmV), (uint64)_mm512_reduce_add_epi64(RowDistCbV), (uint64)_mm512_reduce_add_epi64(RowDistCrV), 0 };
+}
+template <int32 tSR, eCmpWgh tCW> void xCorrespPixelShiftAVX512::xUpdateBestSymmetricRow(const int32* TstLm, const int32* TstCb, const int32* TstCr, const int32* const* RefRows, int32* BestPlaneR2T, int32* const* BestErrorT2R, int32* const* BestPlaneT2R, const int32 BegX, const int32 EndX, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  //displacements are scanned column by column (dy inner loop) - consecutive T2R updates hit different rows, so store of one candidate is not reloaded by the next one
+  //candidates are not scanned in raster order, so ties are resolved by plane index in both directions
+  const int32 SR         = tSR > 0 ? tSR : SearchRange;
+  const int32 WindowSize = 2 * SR + 1;
+  const int32 NumPlanes  = WindowSize * WindowSize;
+
+  const __m512i CmpWeightLmV = _mm512_set1_epi32(CmpWeights[0]);
+  const __m512i CmpWeightCbV = _mm512_set1_epi32(CmpWeights[1]);
+  const __m512i CmpWeightCrV = _mm512_set1_epi32(CmpWeights[2]);
+  const __m512i LastPlaneV   = _mm512_set1_epi32(NumPlanes - 1);
+
+  for(int32 x = BegX; x < EndX; x += c_NumPelsPlanar)
+  {
+    const __m512i TstLmV = _mm512_loadu_si512((__m512i*)(TstLm + x));
+    const __m512i TstCbV = _mm512_loadu_si512((__m512i*)(TstCb + x));
+    const __m512i TstCrV = _mm512_loadu_si512((__m512i*)(TstCr + x));
+    __m512i BestErrorR2TV = _mm512_set1_epi32(std::numeric_limits<int32>::max());
+    __m512i BestPlaneR2TV = _mm512_set1_epi32(NOT_VALID);
+
+    for(int32 dx = -SR; dx <= SR; dx++)
+    {
+      for(int32 dy = -SR; dy <= SR; dy++)
+      {
+        const int32* RefLm    = RefRows[3 * (dy + SR) + 0] + x + dx;
+        const int32* RefCb    = RefRows[3 * (dy + SR) + 1] + x + dx;
+        const int32* RefCr    = RefRows[3 * (dy + SR) + 2] + x + dx;
+        int32*       ErrorT2R = BestErrorT2R[dy + SR] != nullptr ? BestErrorT2R[dy + SR] + x : nullptr;
+        int32*       PlaneT2R = BestErrorT2R[dy + SR] != nullptr ? BestPlaneT2R[dy + SR] + x : nullptr;
+        if(BestPlaneR2T == nullptr && ErrorT2R == nullptr) { continue; } //halo row of band - only some T2R rows are needed
+
+        const __m512i PlaneIdxV = _mm512_set1_epi32((dy + SR) * WindowSize + dx + SR);
+        const __m512i DiffLmV   = _mm512_sub_epi32(TstLmV, _mm512_loadu_si512((__m512i*)RefLm));
+        const __m512i DiffCbV   = _mm512_sub_epi32(TstCbV, _mm512_loadu_si512((__m512i*)RefCb));
+        const __m512i DiffCrV   = _mm512_sub_epi32(TstCrV, _mm512_loadu_si512((__m512i*)RefCr));
+        const __m512i ErrorV    = xCalcWeightedErrorP<tCW>(_mm512_mullo_epi32(DiffLmV, DiffLmV), _mm512_mullo_epi32(DiffCbV, DiffCbV), _mm512_mullo_epi32(DiffCrV, DiffCrV), CmpWeightLmV, CmpWeightCbV, CmpWeightCrV);
+        const __mmask16 IsBetterR2T = _mm512_cmplt_epi32_mask(ErrorV, BestErrorR2TV) | (_mm512_cmpeq_epi32_mask(ErrorV, BestErrorR2TV) & _mm512_cmplt_epi32_mask(PlaneIdxV, BestPlaneR2TV));
+        BestErrorR2TV = _mm512_min_epi32     (ErrorV, BestErrorR2TV);
+        BestPlaneR2TV = _mm512_mask_mov_epi32(BestPlaneR2TV, IsBetterR2T, PlaneIdxV);
+        if(ErrorT2R != nullptr)
+        {
+          const __m512i   ErrorT2RV   = _mm512_loadu_si512(ErrorT2R + dx);
+          const __m512i   PlaneT2RV   = _mm512_loadu_si512(PlaneT2R + dx);
+          const __m512i   PlaneInvV   = _mm512_sub_epi32  (LastPlaneV, PlaneIdxV);
+          const __mmask16 IsBetterT2R = _mm512_cmplt_epi32_mask(ErrorV, ErrorT2RV) | (_mm512_cmpeq_epi32_mask(ErrorV, ErrorT2RV) & _mm512_cmplt_epi32_mask(PlaneInvV, PlaneT2RV));
+          _mm512_mask_storeu_epi32(ErrorT2R + dx, IsBetterT2R, ErrorV   );
+          _mm512_mask_storeu_epi32(PlaneT2R + dx, IsBetterT2R, PlaneInvV);
+        }
+      } //dy
+    } //dx
+
+    if(BestPlaneR2T != nullptr) { _mm512_storeu_si512((__m512i*)(BestPlaneR2T + x), BestPlaneR2TV); }
+  } //x
+}
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
+
+#endif //X_SIMD_CAN_USE_AVX512
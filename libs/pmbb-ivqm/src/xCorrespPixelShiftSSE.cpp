@@ -10,44 +10,60 @@
 namespace PMBB_NAMESPACE {
 
 //===============================================================================================================================================================================================================
-// xCorrespPixelShiftSTD
+// xCorrespPixelShiftSSE
 //===============================================================================================================================================================================================================
 
-uint64V4 xCorrespPixelShiftSSE::CalcDistAsymmetricRow(const xPicI* Tst, const xPicI* Ref, const int32 y, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights)
+template <eCmpWgh tCW> inline __m128i xCorrespPixelShiftSSE::xCalcWeightedErrorV(const __m128i& DistV, const __m128i& CmpWeightsV)
+{
+  if constexpr(tCW == eCmpWgh::W4110) { return _mm_blend_epi16(_mm_blend_epi16(DistV, _mm_slli_epi32(DistV, 2), 0x03), _mm_setzero_si128(), 0xC0); }
+  if constexpr(tCW == eCmpWgh::W1110) { return _mm_blend_epi16(DistV, _mm_setzero_si128(), 0xC0); }
+  return _mm_mullo_epi32(DistV, CmpWeightsV);
+}
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+uint64V4 xCorrespPixelShiftSSE::CalcDistAsymmetricRow(const xPicI* Tst, const xPicI* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp)
+{
+  if(xCanUseNarrowSearch(Tst->getBitDepth(), GlobalColorShift, CmpWeights)) { return xSwitchSearchRange(SearchRange, [&](auto SR) { return xCalcDistAsymmetricRowN<SR>(Tst, Ref, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights, ShftComp); }); }
+  return xSwitchCmpWeights(CmpWeights, [&](auto CW) { return xSwitchSearchRange(SearchRange, [&](auto SR) { return xCalcDistAsymmetricRow<SR, CW>(Tst, Ref, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights, ShftComp); }); });
+}
+template <int32 tSR, eCmpWgh tCW> uint64V4 xCorrespPixelShiftSSE::xCalcDistAsymmetricRow(const xPicI* Tst, const xPicI* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp)
 {
   assert(Tst->isCompatible(Ref));
 
-  const int32  Width     = Tst->getWidth();
   const int32  TstStride = Tst->getStride();
   const int32  TstOffset = y * TstStride;
   const __m128i CmpWeightsV       = _mm_loadu_si128((__m128i*) &CmpWeights);
   const __m128i GlobalColorShiftV = _mm_loadu_si128((__m128i*) &GlobalColorShift);
+  const __m128i MaxValueV         = _mm_set1_epi32(xBitDepth2MaxValue(Ref->getBitDepth()));
+  const int32   ShftCompY         = ShftComp != nullptr ? y % ShftComp->getHeight() : 0;
 
   const uint16V4* TstPtr = Tst->getAddr() + TstOffset;
   __m128i RowDistV = _mm_setzero_si128();
-  for (int32 x = 0; x < Width; x++)
+  for (int32 x = BegX; x < EndX; x++)
   {
     __m128i TstU16V  = _mm_loadl_epi64((__m128i*)(TstPtr + x));
     __m128i TstV     = _mm_add_epi32(_mm_unpacklo_epi16(TstU16V, _mm_setzero_si128()), GlobalColorShiftV); //TODO - xc_CLIP_CURR_TST_RANGE
-    __m128i BestDist = xCalcDistWithinBlock(TstV, Ref, x, y, SearchRange, CmpWeightsV);
-    RowDistV = _mm_add_epi32(RowDistV, BestDist);
+    __m128i BestRefV = xFindBestPelWithinBlock<tSR, tCW>(TstV, Ref, x, y, SearchRange, CmpWeightsV);
+    __m128i DiffV    = _mm_sub_epi32(TstV, BestRefV);
+    RowDistV = _mm_add_epi32(RowDistV, _mm_mullo_epi32(DiffV, DiffV));
+    if(ShftComp != nullptr) { xStoreShftCompPel(ShftComp, x, ShftCompY, BestRefV, GlobalColorShiftV, MaxValueV); }
   }//x
 
   int32V4 RowDist;
   _mm_storeu_si128((__m128i*)&RowDist, RowDistV);
   return (uint64V4)RowDist;
 }
-__m128i xCorrespPixelShiftSSE::xCalcDistWithinBlock(const __m128i& TstPelV, const xPicI* Ref, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const __m128i& CmpWeightsV)
+template <int32 tSR, eCmpWgh tCW> __m128i xCorrespPixelShiftSSE::xFindBestPelWithinBlock(const __m128i& TstPelV, const xPicI* Ref, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const __m128i& CmpWeightsV)
 {
-  const int32 WindowSize = 2 * SearchRange + 1;
-  const int32 BegY = CenterY - SearchRange;
-  const int32 BegX = CenterX - SearchRange;
+  const int32 SR         = tSR > 0 ? tSR : SearchRange;
+  const int32 WindowSize = 2 * SR + 1;
+  const int32 BegY = CenterY - SR;
+  const int32 BegX = CenterX - SR;
 
   const int32     Stride = Ref->getStride();
   const uint16V4* RefPtr = Ref->getAddr() + BegY * Stride + BegX;
 
   int32   BestError = std::numeric_limits<int32>::max();
-  __m128i BestDistV = _mm_setzero_si128();
+  __m128i BestRefV  = _mm_setzero_si128();
 
   for (int32 y = 0; y < WindowSize; y++)
   {
@@ -59,15 +75,429 @@ __m128i xCorrespPixelShiftSSE::xCalcDistWithinBlock(const __m128i& TstPelV, cons
       __m128i RefV    = _mm_cvtepu16_epi32(RefU16V);
       __m128i DiffV   = _mm_sub_epi32     (TstPelV, RefV);
       __m128i DistV   = _mm_mullo_epi32   (DiffV, DiffV);
-      __m128i ErrorV  = _mm_mullo_epi32   (DistV, CmpWeightsV);
+      __m128i ErrorV  = xCalcWeightedErrorV<tCW>(DistV, CmpWeightsV);
       __m128i Tmp1    = _mm_hadd_epi32    (ErrorV, ErrorV);
       __m128i Tmp2    = _mm_hadd_epi32    (Tmp1, Tmp1);
       int32   Error   = _mm_extract_epi32 (Tmp2, 0);
-      if (Error < BestError) { BestError = Error; BestDistV = DistV; }
+      if (Error < BestError) { BestError = Error; BestRefV = RefV; }
     } //x
   } //y
 
-  return BestDistV;
+  return BestRefV;
+}
+uint64V4 xCorrespPixelShiftSSE::CalcDistAsymmetricRowM(const xPicI* Tst, const xPicI* Ref, const xPicP* Msk, const int32 y, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  return xCalcDistAsymmetricRowMT(Tst, Ref, Msk, y, 0, Tst->getWidth(), GlobalColorShift, SearchRange, CmpWeights);
+}
+uint64V4 xCorrespPixelShiftSSE::CalcDistAsymmetricRowM(const xPicI* Tst, const xPicI* Ref, const xPicMask* Msk, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  //binary mask is read directly from bit plane
+  if(Msk->isBinary()) { const xPicMaskBits MskBits(Msk); return xCalcDistAsymmetricRowMT(Tst, Ref, &MskBits, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights); }
+  return xCalcDistAsymmetricRowMT(Tst, Ref, Msk, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights);
+}
+template <class tMsk> uint64V4 xCorrespPixelShiftSSE::xCalcDistAsymmetricRowMT(const xPicI* Tst, const xPicI* Ref, const tMsk* Msk, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  if(xCanUseNarrowSearch(Tst->getBitDepth(), GlobalColorShift, CmpWeights)) { return xSwitchSearchRange(SearchRange, [&](auto SR) { return xCalcDistAsymmetricRowNM<SR>(Tst, Ref, Msk, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights); }); }
+  return xSwitchCmpWeights(CmpWeights, [&](auto CW) { return xSwitchSearchRange(SearchRange, [&](auto SR) { return xCalcDistAsymmetricRowM<SR, CW>(Tst, Ref, Msk, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights); }); });
+}
+template <int32 tSR, eCmpWgh tCW, class tMsk> uint64V4 xCorrespPixelShiftSSE::xCalcDistAsymmetricRowM(const xPicI* Tst, const xPicI* Ref, const tMsk* Msk, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  assert(Tst->isCompatible(Ref));
+
+  const int32  TstStride = Tst->getStride();
+  const int32  TstOffset = y * TstStride;
+  const int32  MskStride = Msk->getStride();
+  const int32  MskOffset = y * MskStride;
+  const __m128i CmpWeightsV       = _mm_loadu_si128((__m128i*) &CmpWeights);
+  const __m128i GlobalColorShiftV = _mm_loadu_si128((__m128i*) &GlobalColorShift);
+
+  const uint16V4* TstPtr = Tst->getAddr(        ) + TstOffset;
+  const auto      MskPtr = xGetMskAddr(Msk) + MskOffset;
+  __m128i RowDistV0 = _mm_setzero_si128();
+  __m128i RowDistV1 = _mm_setzero_si128();
+  for (int32 x = BegX; x < EndX; x++)
+  {
+    const int32 CurrMskValue = (int32)MskPtr[x];
+    if(CurrMskValue == 0) { continue; } //skip masked pixels
+    __m128i TstU16V  = _mm_loadl_epi64((__m128i*)(TstPtr + x));
+    __m128i TstV     = _mm_add_epi32(_mm_unpacklo_epi16(TstU16V, _mm_setzero_si128()), GlobalColorShiftV); //TODO - xc_CLIP_CURR_TST_RANGE
+    __m128i BestRefV = xFindBestPelWithinBlockM<tSR, tCW>(TstV, Ref, Msk, x, y, SearchRange, CmpWeightsV);
+    __m128i DiffV    = _mm_sub_epi32(TstV, BestRefV);
+    __m128i BestDist = _mm_mullo_epi32(DiffV, DiffV);
+    __m128i MskV     = _mm_set1_epi64x(CurrMskValue);
+    RowDistV0 = _mm_add_epi64(RowDistV0, _mm_mul_epu32(_mm_cvtepu32_epi64(BestDist                   ), MskV));
+    RowDistV1 = _mm_add_epi64(RowDistV1, _mm_mul_epu32(_mm_cvtepu32_epi64(_mm_srli_si128(BestDist, 8)), MskV));
+  }//x
+
+  uint64V4 RowDist;
+  _mm_storeu_si128((__m128i*)&RowDist    , RowDistV0);
+  _mm_storeu_si128((__m128i*)&RowDist + 1, RowDistV1);
+  return RowDist;
+}
+template <int32 tSR, eCmpWgh tCW, class tMsk> __m128i xCorrespPixelShiftSSE::xFindBestPelWithinBlockM(const __m128i& TstPelV, const xPicI* Ref, const tMsk* Msk, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const __m128i& CmpWeightsV)
+{
+  const int32 SR         = tSR > 0 ? tSR : SearchRange;
+  const int32 WindowSize = 2 * SR + 1;
+  const int32 BegY = CenterY - SR;
+  const int32 BegX = CenterX - SR;
+
+  const int32     Stride    = Ref->getStride();
+  const int32     MskStride = Msk->getStride();
+  const uint16V4* RefPtr    = Ref->getAddr(        ) + BegY * Stride    + BegX;
+  const auto      MskPtr    = xGetMskAddr(Msk) + BegY * MskStride + BegX;
+
+  const __m128i MaxV = _mm_set1_epi32(std::numeric_limits<int32>::max());
+
+  int32   BestError = std::numeric_limits<int32>::max();
+  __m128i BestRefV  = _mm_setzero_si128();
+
+  for (int32 y = 0; y < WindowSize; y++)
+  {
+    const uint16V4* RefPtrY = RefPtr + y * Stride;
+    const auto      MskPtrY = MskPtr + y * MskStride;
+    for (int32 x = 0; x < WindowSize; x++)
+    {
+      __m128i RefU16V = _mm_loadl_epi64((__m128i*)(RefPtrY + x));
+      __m128i RefV    = _mm_cvtepu16_epi32(RefU16V);
+      __m128i DiffV   = _mm_sub_epi32     (TstPelV, RefV);
+      __m128i DistV   = _mm_mullo_epi32   (DiffV, DiffV);
+      __m128i ErrorV  = xCalcWeightedErrorV<tCW>(DistV, CmpWeightsV);
+      __m128i Tmp1    = _mm_hadd_epi32    (ErrorV, ErrorV);
+      __m128i Tmp2    = _mm_hadd_epi32    (Tmp1, Tmp1);
+      //masked candidates get maximal error and are never selected
+      __m128i MskV    = _mm_cmpeq_epi32   (_mm_set1_epi32(MskPtrY[x]), _mm_setzero_si128());
+      __m128i Tmp3    = _mm_blendv_epi8   (Tmp2, MaxV, MskV);
+      int32   Error   = _mm_extract_epi32 (Tmp3, 0);
+      if (Error < BestError) { BestError = Error; BestRefV = RefV; }
+    } //x
+  } //y
+
+  return BestRefV;
+}
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// planar
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template <eCmpWgh tCW> inline __m128i xCorrespPixelShiftSSE::xCalcWeightedErrorP(const __m128i& DistLmV, const __m128i& DistCbV, const __m128i& DistCrV, const __m128i& CmpWeightLmV, const __m128i& CmpWeightCbV, const __m128i& CmpWeightCrV)
+{
+  if constexpr(tCW == eCmpWgh::W4110) { return _mm_add_epi32(_mm_slli_epi32(DistLmV, 2), _mm_add_epi32(DistCbV, DistCrV)); }
+  if constexpr(tCW == eCmpWgh::W1110) { return _mm_add_epi32(DistLmV, _mm_add_epi32(DistCbV, DistCrV)); }
+  return _mm_add_epi32(_mm_mullo_epi32(DistLmV, CmpWeightLmV), _mm_add_epi32(_mm_mullo_epi32(DistCbV, CmpWeightCbV), _mm_mullo_epi32(DistCrV, CmpWeightCrV)));
+}
+uint64V4 xCorrespPixelShiftSSE::CalcDistAsymmetricRow(const xPicP* Tst, const xPicP* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp)
+{
+  return xSwitchCmpWeights(CmpWeights, [&](auto CW) { return xSwitchSearchRange(SearchRange, [&](auto SR) { return xCalcDistAsymmetricRowP<SR, CW>(Tst, Ref, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights, ShftComp); }); });
+}
+template <int32 tSR, eCmpWgh tCW> uint64V4 xCorrespPixelShiftSSE::xCalcDistAsymmetricRowP(const xPicP* Tst, const xPicP* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp)
+{
+  assert(Tst->isCompatible(Ref));
+  assert(((EndX - BegX) % c_NumPelsPlanar) == 0);
+
+  const int32 SR         = tSR > 0 ? tSR : SearchRange;
+  const int32 WindowSize = 2 * SR + 1;
+  const int32 TstStride  = Tst->getStride();
+  const int32 RefStride  = Ref->getStride();
+
+  const uint16* TstPtrLm = Tst->getAddr(eCmp::LM) + y * TstStride;
+  const uint16* TstPtrCb = Tst->getAddr(eCmp::CB) + y * TstStride;
+  const uint16* TstPtrCr = Tst->getAddr(eCmp::CR) + y * TstStride;
+  const uint16* RefPtrLm = Ref->getAddr(eCmp::LM) + (y - SR) * RefStride - SR;
+  const uint16* RefPtrCb = Ref->getAddr(eCmp::CB) + (y - SR) * RefStride - SR;
+  const uint16* RefPtrCr = Ref->getAddr(eCmp::CR) + (y - SR) * RefStride - SR;
+
+  const __m128i GlobalColorShiftLmV = _mm_set1_epi32(GlobalColorShift[0]);
+  const __m128i GlobalColorShiftCbV = _mm_set1_epi32(GlobalColorShift[1]);
+  const __m128i GlobalColorShiftCrV = _mm_set1_epi32(GlobalColorShift[2]);
+  const __m128i CmpWeightLmV        = _mm_set1_epi32(CmpWeights      [0]);
+  const __m128i CmpWeightCbV        = _mm_set1_epi32(CmpWeights      [1]);
+  const __m128i CmpWeightCrV        = _mm_set1_epi32(CmpWeights      [2]);
+  const __m128i MaxV                = _mm_set1_epi32(std::numeric_limits<int32>::max());
+  const __m128i MaxValueV           = _mm_set1_epi32(xBitDepth2MaxValue(Ref->getBitDepth()));
+  const int32   ShftCompY           = ShftComp != nullptr ? y % ShftComp->getHeight() : 0;
+
+  __m128i RowDistLmV = _mm_setzero_si128();
+  __m128i RowDistCbV = _mm_setzero_si128();
+  __m128i RowDistCrV = _mm_setzero_si128();
+
+  for(int32 x = BegX; x < EndX; x += c_NumPelsPlanar)
+  {
+    const __m128i TstLmV = _mm_add_epi32(_mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)(TstPtrLm + x))), GlobalColorShiftLmV); //TODO - xc_CLIP_CURR_TST_RANGE
+    const __m128i TstCbV = _mm_add_epi32(_mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)(TstPtrCb + x))), GlobalColorShiftCbV); //TODO - xc_CLIP_CURR_TST_RANGE
+    const __m128i TstCrV = _mm_add_epi32(_mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)(TstPtrCr + x))), GlobalColorShiftCrV); //TODO - xc_CLIP_CURR_TST_RANGE
+
+    __m128i BestErrorV = MaxV;
+    __m128i BestRefLmV = _mm_setzero_si128();
+    __m128i BestRefCbV = _mm_setzero_si128();
+    __m128i BestRefCrV = _mm_setzero_si128();
+
+    for(int32 wy = 0; wy < WindowSize; wy++)
+    {
+      const int32 Offset = wy * RefStride + x;
+      for(int32 wx = 0; wx < WindowSize; wx++)
+      {
+        const __m128i RefLmV   = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)(RefPtrLm + Offset + wx)));
+        const __m128i RefCbV   = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)(RefPtrCb + Offset + wx)));
+        const __m128i RefCrV   = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)(RefPtrCr + Offset + wx)));
+        const __m128i DiffLmV  = _mm_sub_epi32(TstLmV, RefLmV);
+        const __m128i DiffCbV  = _mm_sub_epi32(TstCbV, RefCbV);
+        const __m128i DiffCrV  = _mm_sub_epi32(TstCrV, RefCrV);
+        const __m128i ErrorV   = xCalcWeightedErrorP<tCW>(_mm_mullo_epi32(DiffLmV, DiffLmV), _mm_mullo_epi32(DiffCbV, DiffCbV), _mm_mullo_epi32(DiffCrV, DiffCrV), CmpWeightLmV, CmpWeightCbV, CmpWeightCrV);
+        //preserve raster scan order - first candidate with minimal error wins
+        const __m128i IsBetter = _mm_cmplt_epi32(ErrorV, BestErrorV);
+        BestErrorV = _mm_min_epi32  (ErrorV, BestErrorV);
+        BestRefLmV = _mm_blendv_epi8(BestRefLmV, RefLmV, IsBetter);
+        BestRefCbV = _mm_blendv_epi8(BestRefCbV, RefCbV, IsBetter);
+        BestRefCrV = _mm_blendv_epi8(BestRefCrV, RefCrV, IsBetter);
+      } //wx
+    } //wy
+
+    const __m128i BestDiffLmV = _mm_sub_epi32(TstLmV, BestRefLmV);
+    const __m128i BestDiffCbV = _mm_sub_epi32(TstCbV, BestRefCbV);
+    const __m128i BestDiffCrV = _mm_sub_epi32(TstCrV, BestRefCrV);
+    const __m128i BestDistLmV = _mm_mullo_epi32(BestDiffLmV, BestDiffLmV);
+    const __m128i BestDistCbV = _mm_mullo_epi32(BestDiffCbV, BestDiffCbV);
+    const __m128i BestDistCrV = _mm_mullo_epi32(BestDiffCrV, BestDiffCrV);
+
+    if(ShftComp != nullptr)
+    {
+      const int32   Offset    = ShftComp->getOffset({ x, ShftCompY });
+      const __m128i ShftLmV   = _mm_min_epi32(_mm_max_epi32(_mm_sub_epi32(BestRefLmV, GlobalColorShiftLmV), _mm_setzero_si128()), MaxValueV);
+      const __m128i ShftCbV   = _mm_min_epi32(_mm_max_epi32(_mm_sub_epi32(BestRefCbV, GlobalColorShiftCbV), _mm_setzero_si128()), MaxValueV);
+      const __m128i ShftCrV   = _mm_min_epi32(_mm_max_epi32(_mm_sub_epi32(BestRefCrV, GlobalColorShiftCrV), _mm_setzero_si128()), MaxValueV);
+      _mm_storel_epi64((__m128i*)(ShftComp->getAddr(eCmp::LM) + Offset), _mm_packus_epi32(ShftLmV, ShftLmV));
+      _mm_storel_epi64((__m128i*)(ShftComp->getAddr(eCmp::CB) + Offset), _mm_packus_epi32(ShftCbV, ShftCbV));
+      _mm_storel_epi64((__m128i*)(ShftComp->getAddr(eCmp::CR) + Offset), _mm_packus_epi32(ShftCrV, ShftCrV));
+    }
+
+    RowDistLmV = _mm_add_epi64(RowDistLmV, _mm_add_epi64(_mm_cvtepu32_epi64(BestDistLmV), _mm_cvtepu32_epi64(_mm_srli_si128(BestDistLmV, 8))));
+    RowDistCbV = _mm_add_epi64(RowDistCbV, _mm_add_epi64(_mm_cvtepu32_epi64(BestDistCbV), _mm_cvtepu32_epi64(_mm_srli_si128(BestDistCbV, 8))));
+    RowDistCrV = _mm_add_epi64(RowDistCrV, _mm_add_epi64(_mm_cvtepu32_epi64(BestDistCrV), _mm_cvtepu32_epi64(_mm_srli_si128(BestDistCrV, 8))));
+  }//x
+
+  const uint64 RowDistLm = (uint64)_mm_extract_epi64(RowDistLmV, 0) + (uint64)_mm_extract_epi64(RowDistLmV, 1);
+  const uint64 RowDistCb = (uint64)_mm_extract_epi64(RowDistCbV, 0) + (uint64)_mm_extract_epi64(RowDistCbV, 1);
+  const uint64 RowDistCr = (uint64)_mm_extract_epi64(RowDistCrV, 0) + (uint64)_mm_extract_epi64(RowDistCrV, 1);
+  return { RowDistLm, RowDistCb, RowDistCr, 0 };
+}
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// narrow (16-bit) arithmetic - valid if xCanUseNarrowSearch()
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template <int32 tSR> uint64V4 xCorrespPixelShiftSSE::xCalcDistAsymmetricRowN(const xPicI* Tst, const xPicI* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp)
+{
+  assert(Tst->isCompatible(Ref));
+
+  const int32  TstStride = Tst->getStride();
+  const int32  TstOffset = y * TstStride;
+  const __m128i CmpWeightsV       = _mm_shuffle_epi32(_mm_packs_epi32(_mm_loadu_si128((__m128i*) &CmpWeights      ), _mm_setzero_si128()), _MM_SHUFFLE(1, 0, 1, 0));
+  const __m128i GlobalColorShiftV =                   _mm_packs_epi32(_mm_loadu_si128((__m128i*) &GlobalColorShift), _mm_setzero_si128()) ;
+  const __m128i GlobalColorShift32V = _mm_loadu_si128((__m128i*) &GlobalColorShift);
+  const __m128i MaxValueV           = _mm_set1_epi32(xBitDepth2MaxValue(Ref->getBitDepth()));
+  const int32   ShftCompY           = ShftComp != nullptr ? y % ShftComp->getHeight() : 0;
+
+  const uint16V4* TstPtr = Tst->getAddr() + TstOffset;
+  __m128i RowDistV0 = _mm_setzero_si128();
+  __m128i RowDistV1 = _mm_setzero_si128();
+  for (int32 x = BegX; x < EndX; x++)
+  {
+    __m128i TstU16V  = _mm_loadl_epi64((__m128i*)(TstPtr + x));
+    __m128i TstV     = _mm_add_epi16(TstU16V, GlobalColorShiftV); //TODO - xc_CLIP_CURR_TST_RANGE
+    __m128i BestRefV = xFindBestPelWithinBlockN<tSR>(_mm_unpacklo_epi64(TstV, TstV), Ref, x, y, SearchRange, CmpWeightsV);
+    __m128i DiffV    = _mm_sub_epi32(_mm_cvtepi16_epi32(TstV), BestRefV);
+    __m128i BestDist = _mm_mullo_epi32(DiffV, DiffV);
+    if(ShftComp != nullptr) { xStoreShftCompPel(ShftComp, x, ShftCompY, BestRefV, GlobalColorShift32V, MaxValueV); }
+    RowDistV0 = _mm_add_epi64(RowDistV0, _mm_cvtepu32_epi64(BestDist                   ));
+    RowDistV1 = _mm_add_epi64(RowDistV1, _mm_cvtepu32_epi64(_mm_srli_si128(BestDist, 8)));
+  }//x
+
+  uint64V4 RowDist;
+  _mm_storeu_si128((__m128i*)&RowDist    , RowDistV0);
+  _mm_storeu_si128((__m128i*)&RowDist + 1, RowDistV1);
+  return RowDist;
+}
+template <int32 tSR> __m128i xCorrespPixelShiftSSE::xFindBestPelWithinBlockN(const __m128i& TstPelV, const xPicI* Ref, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const __m128i& CmpWeightsV)
+{
+  //pairs of candidates are processed in 16-bit lanes (weighted error via multiply-add), best candidate pel is widened to 32 bits at the end
+  const int32 SR         = tSR > 0 ? tSR : SearchRange;
+  const int32 WindowSize = 2 * SR + 1;
+  const int32 NumPairs   = WindowSize >> 1;
+  const int32 BegY = CenterY - SR;
+  const int32 BegX = CenterX - SR;
+
+  const int32     Stride = Ref->getStride();
+  const uint16V4* RefPtr = Ref->getAddr() + BegY * Stride + BegX;
+
+  int32 BestError  = std::numeric_limits<int32>::max();
+  int32 BestOffset = 0;
+
+  for (int32 y = 0; y < WindowSize; y++)
+  {
+    const uint16V4* RefPtrY = RefPtr + y * Stride;
+    for (int32 p = 0; p < NumPairs; p++)
+    {
+      __m128i RefV   = _mm_loadu_si128  ((__m128i*)(RefPtrY + 2 * p));
+      __m128i DiffV  = _mm_sub_epi16    (TstPelV, RefV);
+      __m128i ErrorV = _mm_madd_epi16   (DiffV, _mm_mullo_epi16(DiffV, CmpWeightsV));
+      __m128i Tmp1   = _mm_hadd_epi32   (ErrorV, ErrorV);
+      int32   Error0 = _mm_extract_epi32(Tmp1, 0);
+      int32   Error1 = _mm_extract_epi32(Tmp1, 1);
+      //preserve raster scan order - first candidate with minimal error wins
+      if (Error0 < BestError) { BestError = Error0; BestOffset = y * Stride + 2 * p    ; }
+      if (Error1 < BestError) { BestError = Error1; BestOffset = y * Stride + 2 * p + 1; }
+    } //p
+
+    {
+      __m128i RefV   = _mm_loadl_epi64  ((__m128i*)(RefPtrY + WindowSize - 1));
+      __m128i DiffV  = _mm_sub_epi16    (TstPelV, RefV);
+      __m128i ErrorV = _mm_madd_epi16   (DiffV, _mm_mullo_epi16(DiffV, CmpWeightsV));
+      __m128i Tmp1   = _mm_hadd_epi32   (ErrorV, ErrorV);
+      int32   Error  = _mm_extract_epi32(Tmp1, 0);
+      if (Error < BestError) { BestError = Error; BestOffset = y * Stride + WindowSize - 1; }
+    }
+  } //y
+
+  return _mm_cvtepu16_epi32(_mm_loadl_epi64((__m128i*)(RefPtr + BestOffset)));
+}
+template <int32 tSR, class tMsk> uint64V4 xCorrespPixelShiftSSE::xCalcDistAsymmetricRowNM(const xPicI* Tst, const xPicI* Ref, const tMsk* Msk, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  assert(Tst->isCompatible(Ref));
+
+  const int32  TstStride = Tst->getStride();
+  const int32  TstOffset = y * TstStride;
+  const int32  MskStride = Msk->getStride();
+  const int32  MskOffset = y * MskStride;
+  const __m128i CmpWeightsV       = _mm_shuffle_epi32(_mm_packs_epi32(_mm_loadu_si128((__m128i*) &CmpWeights      ), _mm_setzero_si128()), _MM_SHUFFLE(1, 0, 1, 0));
+  const __m128i GlobalColorShiftV =                   _mm_packs_epi32(_mm_loadu_si128((__m128i*) &GlobalColorShift), _mm_setzero_si128()) ;
+
+  const uint16V4* TstPtr = Tst->getAddr(        ) + TstOffset;
+  const auto      MskPtr = xGetMskAddr(Msk) + MskOffset;
+  __m128i RowDistV0 = _mm_setzero_si128();
+  __m128i RowDistV1 = _mm_setzero_si128();
+  for (int32 x = BegX; x < EndX; x++)
+  {
+    const int32 CurrMskValue = (int32)MskPtr[x];
+    if(CurrMskValue == 0) { continue; } //skip masked pixels
+    __m128i TstU16V  = _mm_loadl_epi64((__m128i*)(TstPtr + x));
+    __m128i TstV     = _mm_add_epi16(TstU16V, GlobalColorShiftV); //TODO - xc_CLIP_CURR_TST_RANGE
+    __m128i BestRefV = xFindBestPelWithinBlockNM<tSR>(_mm_unpacklo_epi64(TstV, TstV), Ref, Msk, x, y, SearchRange, CmpWeightsV);
+    __m128i DiffV    = _mm_sub_epi32(_mm_cvtepi16_epi32(TstV), BestRefV);
+    __m128i BestDist = _mm_mullo_epi32(DiffV, DiffV);
+    __m128i MskV     = _mm_set1_epi64x(CurrMskValue);
+    RowDistV0 = _mm_add_epi64(RowDistV0, _mm_mul_epu32(_mm_cvtepu32_epi64(BestDist                   ), MskV));
+    RowDistV1 = _mm_add_epi64(RowDistV1, _mm_mul_epu32(_mm_cvtepu32_epi64(_mm_srli_si128(BestDist, 8)), MskV));
+  }//x
+
+  uint64V4 RowDist;
+  _mm_storeu_si128((__m128i*)&RowDist    , RowDistV0);
+  _mm_storeu_si128((__m128i*)&RowDist + 1, RowDistV1);
+  return RowDist;
+}
+template <int32 tSR, class tMsk> __m128i xCorrespPixelShiftSSE::xFindBestPelWithinBlockNM(const __m128i& TstPelV, const xPicI* Ref, const tMsk* Msk, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const __m128i& CmpWeightsV)
+{
+  //as xFindBestPelWithinBlockN, candidates with zero mask value are skipped
+  const int32 SR         = tSR > 0 ? tSR : SearchRange;
+  const int32 WindowSize = 2 * SR + 1;
+  const int32 NumPairs   = WindowSize >> 1;
+  const int32 BegY = CenterY - SR;
+  const int32 BegX = CenterX - SR;
+
+  const int32     Stride    = Ref->getStride();
+  const int32     MskStride = Msk->getStride();
+  const uint16V4* RefPtr    = Ref->getAddr(        ) + BegY * Stride    + BegX;
+  const auto      MskPtr    = xGetMskAddr(Msk) + BegY * MskStride + BegX;
+
+  //center candidate is always valid (masked test pixels are skipped by caller)
+  int32 BestError  = std::numeric_limits<int32>::max();
+  int32 BestOffset = 0;
+
+  for (int32 y = 0; y < WindowSize; y++)
+  {
+    const uint16V4* RefPtrY = RefPtr + y * Stride;
+    const auto      MskPtrY = MskPtr + y * MskStride;
+    for (int32 p = 0; p < NumPairs; p++)
+    {
+      __m128i RefV   = _mm_loadu_si128  ((__m128i*)(RefPtrY + 2 * p));
+      __m128i DiffV  = _mm_sub_epi16    (TstPelV, RefV);
+      __m128i ErrorV = _mm_madd_epi16   (DiffV, _mm_mullo_epi16(DiffV, CmpWeightsV));
+      __m128i Tmp1   = _mm_hadd_epi32   (ErrorV, ErrorV);
+      int32   Error0 = _mm_extract_epi32(Tmp1, 0);
+      int32   Error1 = _mm_extract_epi32(Tmp1, 1);
+      if (MskPtrY[2 * p    ] != 0 && Error0 < BestError) { BestError = Error0; BestOffset = y * Stride + 2 * p    ; }
+      if (MskPtrY[2 * p + 1] != 0 && Error1 < BestError) { BestError = Error1; BestOffset = y * Stride + 2 * p + 1; }
+    } //p
+
+    {
+      __m128i RefV   = _mm_loadl_epi64  ((__m128i*)(RefPtrY + WindowSize - 1));
+      __m128i DiffV  = _mm_sub_epi16    (TstPelV, RefV);
+      __m128i ErrorV = _mm_madd_epi16   (DiffV, _mm_mullo_epi16(DiffV, CmpWeightsV));
+      __m128i Tmp1   = _mm_hadd_epi32   (ErrorV, ErrorV);
+      int32   Error  = _mm_extract_epi32(Tmp1, 0);
+      if (MskPtrY[WindowSize - 1] != 0 && Error < BestError) { BestError = Error; BestOffset = y * Stride + WindowSize - 1; }
+    }
+  } //y
+
+  return _mm_cvtepu16_epi32(_mm_loadl_epi64((__m128i*)(RefPtr + BestOffset)));
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// symmetric Q - planar int32 rows
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void xCorrespPixelShiftSSE::UpdateBestSymmetricRow(const int32* TstLm, const int32* TstCb, const int32* TstCr, const int32* const* RefRows, int32* BestPlaneR2T, int32* const* BestErrorT2R, int32* const* BestPlaneT2R, const int32 BegX, const int32 EndX, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  xSwitchCmpWeights(CmpWeights, [&](auto CW) { xSwitchSearchRange(SearchRange, [&](auto SR) { xUpdateBestSymmetricRow<SR, CW>(TstLm, TstCb, TstCr, RefRows, BestPlaneR2T, BestErrorT2R, BestPlaneT2R, BegX, EndX, SearchRange, CmpWeights); }); });
+}
+template <int32 tSR, eCmpWgh tCW> void xCorrespPixelShiftSSE::xUpdateBestSymmetricRow(const int32* TstLm, const int32* TstCb, const int32* TstCr, const int32* const* RefRows, int32* BestPlaneR2T, int32* const* BestErrorT2R, int32* const* BestPlaneT2R, const int32 BegX, const int32 EndX, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  //displacements are scanned column by column (dy inner loop) - consecutive T2R updates hit different rows, so store of one candidate is not reloaded by the next one
+  //candidates are not scanned in raster order, so ties are resolved by plane index in both directions
+  const int32 SR         = tSR > 0 ? tSR : SearchRange;
+  const int32 WindowSize = 2 * SR + 1;
+  const int32 NumPlanes  = WindowSize * WindowSize;
+
+  const __m128i CmpWeightLmV = _mm_set1_epi32(CmpWeights[0]);
+  const __m128i CmpWeightCbV = _mm_set1_epi32(CmpWeights[1]);
+  const __m128i CmpWeightCrV = _mm_set1_epi32(CmpWeights[2]);
+  const __m128i LastPlaneV   = _mm_set1_epi32(NumPlanes - 1);
+
+  for(int32 x = BegX; x < EndX; x += c_NumPelsPlanar)
+  {
+    const __m128i TstLmV = _mm_loadu_si128((__m128i*)(TstLm + x));
+    const __m128i TstCbV = _mm_loadu_si128((__m128i*)(TstCb + x));
+    const __m128i TstCrV = _mm_loadu_si128((__m128i*)(TstCr + x));
+    __m128i BestErrorR2TV = _mm_set1_epi32(std::numeric_limits<int32>::max());
+    __m128i BestPlaneR2TV = _mm_set1_epi32(NOT_VALID);
+
+    for(int32 dx = -SR; dx <= SR; dx++)
+    {
+      for(int32 dy = -SR; dy <= SR; dy++)
+      {
+        const int32* RefLm    = RefRows[3 * (dy + SR) + 0] + x + dx;
+        const int32* RefCb    = RefRows[3 * (dy + SR) + 1] + x + dx;
+        const int32* RefCr    = RefRows[3 * (dy + SR) + 2] + x + dx;
+        int32*       ErrorT2R = BestErrorT2R[dy + SR] != nullptr ? BestErrorT2R[dy + SR] + x : nullptr;
+        int32*       PlaneT2R = BestErrorT2R[dy + SR] != nullptr ? BestPlaneT2R[dy + SR] + x : nullptr;
+        if(BestPlaneR2T == nullptr && ErrorT2R == nullptr) { continue; } //halo row of band - only some T2R rows are needed
+
+        const __m128i PlaneIdxV = _mm_set1_epi32((dy + SR) * WindowSize + dx + SR);
+        const __m128i DiffLmV   = _mm_sub_epi32(TstLmV, _mm_loadu_si128((__m128i*)RefLm));
+        const __m128i DiffCbV   = _mm_sub_epi32(TstCbV, _mm_loadu_si128((__m128i*)RefCb));
+        const __m128i DiffCrV   = _mm_sub_epi32(TstCrV, _mm_loadu_si128((__m128i*)RefCr));
+        const __m128i ErrorV    = xCalcWeightedErrorP<tCW>(_mm_mullo_epi32(DiffLmV, DiffLmV), _mm_mullo_epi32(DiffCbV, DiffCbV), _mm_mullo_epi32(DiffCrV, DiffCrV), CmpWeightLmV, CmpWeightCbV, CmpWeightCrV);
+        const __m128i IsBetterR2TV = _mm_or_si128(_mm_cmpgt_epi32(BestErrorR2TV, ErrorV), _mm_and_si128(_mm_cmpeq_epi32(BestErrorR2TV, ErrorV), _mm_cmpgt_epi32(BestPlaneR2TV, PlaneIdxV)));
+        BestErrorR2TV = _mm_min_epi32   (ErrorV, BestErrorR2TV);
+        BestPlaneR2TV = _mm_blendv_epi8 (BestPlaneR2TV, PlaneIdxV, IsBetterR2TV);
+        if(ErrorT2R != nullptr)
+        {
+          const __m128i ErrorT2RV    = _mm_loadu_si128((__m128i*)(ErrorT2R + dx));
+          const __m128i PlaneT2RV    = _mm_loadu_si128((__m128i*)(PlaneT2R + dx));
+          const __m128i PlaneInvV    = _mm_sub_epi32(LastPlaneV, PlaneIdxV);
+          const __m128i IsBetterT2RV = _mm_or_si128(_mm_cmpgt_epi32(ErrorT2RV, ErrorV), _mm_and_si128(_mm_cmpeq_epi32(ErrorT2RV, ErrorV), _mm_cmpgt_epi32(PlaneT2RV, PlaneInvV)));
+          _mm_storeu_si128((__m128i*)(ErrorT2R + dx), _mm_blendv_epi8(ErrorT2RV, ErrorV   , IsBetterT2RV));
+          _mm_storeu_si128((__m128i*)(PlaneT2R + dx), _mm_blendv_epi8(PlaneT2RV, PlaneInvV, IsBetterT2RV));
+        }
+      } //dy
+    } //dx
+
+    if(BestPlaneR2T != nullptr) { _mm_storeu_si128((__m128i*)(BestPlaneR2T + x), BestPlaneR2TV); }
+  } //x
 }
 
 //===============================================================================================================================================================================================================
@@ -15,35 +15,46 @@ namespace PMBB_NAMESPACE {
 //---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // asymetric Q interleaved
 //---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-uint64V4 xCorrespPixelShiftSTD::CalcDistAsymmetricRow(const xPicI* Tst, const xPicI* Ref, const int32 y, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights)
+uint64V4 xCorrespPixelShiftSTD::CalcDistAsymmetricRow(const xPicI* Tst, const xPicI* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp)
+{
+  return xSwitchCmpWeights(CmpWeights, [&](auto CW) { return xSwitchSearchRange(SearchRange, [&](auto SR) { return xCalcDistAsymmetricRow<SR, CW>(Tst, Ref, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights, ShftComp); }); });
+}
+int32 xCorrespPixelShiftSTD::FindBestPixelWithinBlock(const int32V4& TstPel, const xPicI* Ref, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  return xSwitchCmpWeights(CmpWeights, [&](auto CW) { return xSwitchSearchRange(SearchRange, [&](auto SR) { return xFindBestPixelWithinBlock<SR, CW>(TstPel, Ref, CenterX, CenterY, SearchRange, CmpWeights); }); });
+}
+template <int32 tSR, eCmpWgh tCW> uint64V4 xCorrespPixelShiftSTD::xCalcDistAsymmetricRow(const xPicI* Tst, const xPicI* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp)
 {
   assert(Tst->isCompatible(Ref));
 
-  const int32  Width     = Tst->getWidth ();
   const int32  TstStride = Tst->getStride();
   const int32  TstOffset = y * TstStride;
+  const int32  ShftCompY = ShftComp != nullptr ? y % ShftComp->getHeight() : 0;
 
   uint64V4 RowDist = { 0, 0, 0, 0 };
 
   const uint16V4* TstPtr  = Tst->getAddr() + TstOffset;
         
-  for(int32 x = 0; x < Width; x++)
+  for(int32 x = BegX; x < EndX; x++)
   {
     const int32V4 CurrTstValue  = (int32V4)(TstPtr[x]) + GlobalColorShift;
-    const int32   BestRefOffset = FindBestPixelWithinBlock(CurrTstValue, Ref, x, y, SearchRange, CmpWeights);
-    const int32V4 Diff = CurrTstValue - (int32V4)(Ref->getAddr()[BestRefOffset]); //TODO - xc_CLIP_CURR_TST_RANGE
+    const int32   BestRefOffset = xFindBestPixelWithinBlock<tSR, tCW>(CurrTstValue, Ref, x, y, SearchRange, CmpWeights);
+    const int32V4 BestRefValue  = (int32V4)(Ref->getAddr()[BestRefOffset]);
+    const int32V4 Diff = CurrTstValue - BestRefValue; //TODO - xc_CLIP_CURR_TST_RANGE
     const int32V4 Dist = Diff.getVecPow2();
     RowDist += (uint64V4)Dist;
+    if(ShftComp != nullptr) { xStoreShftCompPel(ShftComp, x, ShftCompY, BestRefValue, GlobalColorShift); }
   }//x
 
   return RowDist;
 }
-int32 xCorrespPixelShiftSTD::FindBestPixelWithinBlock(const int32V4& TstPel, const xPicI* Ref, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const int32V4& CmpWeights)
+template <int32 tSR, eCmpWgh tCW> int32 xCorrespPixelShiftSTD::xFindBestPixelWithinBlock(const int32V4& TstPel, const xPicI* Ref, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const int32V4& CmpWeights)
 {
-  const int32 BegY = CenterY - SearchRange;
-  const int32 EndY = CenterY + SearchRange;
-  const int32 BegX = CenterX - SearchRange;
-  const int32 EndX = CenterX + SearchRange;
+  const int32 SR   = tSR > 0 ? tSR : SearchRange;
+  const int32 BegY = CenterY - SR;
+  const int32 EndY = CenterY + SR;
+  const int32 BegX = CenterX - SR;
+  const int32 EndX = CenterX + SR;
 
   const uint16V4* RefPtr = Ref->getAddr  ();
   const int32     Stride = Ref->getStride();
@@ -58,16 +69,8 @@ int32 xCorrespPixelShiftSTD::FindBestPixelWithinBlock(const int32V4& TstPel, con
       const int32   Offset = y * Stride + x;
       const int32V4 RefPel = (int32V4)(RefPtr[Offset]);
       const int32V4 Dist   = (TstPel - RefPel).getVecPow2();
-      if constexpr (c_UseRuntimeCmpWeights)
-      {
-        const int32 Error = (Dist * CmpWeights).getSum();
-        if (Error < BestError) { BestError = Error; BestOffset = Offset; }
-      }
-      else
-      {
-        const int32 Error = (Dist[0] << 2) + Dist[1] + Dist[2];
-        if (Error < BestError) { BestError = Error; BestOffset = Offset; }
-      }
+      const int32   Error  = xCalcWeightedError<tCW>(Dist, CmpWeights);
+      if (Error < BestError) { BestError = Error; BestOffset = Offset; }
     } //x
   } //y
 
@@ -78,10 +81,23 @@ int32 xCorrespPixelShiftSTD::FindBestPixelWithinBlock(const int32V4& TstPel, con
 // asymetric Q interleaved - with mask
 //---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 uint64V4 xCorrespPixelShiftSTD::CalcDistAsymmetricRowM(const xPicI* Tst, const xPicI* Ref, const xPicP* Msk, const int32 y, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  return xSwitchCmpWeights(CmpWeights, [&](auto CW) { return xSwitchSearchRange(SearchRange, [&](auto SR) { return xCalcDistAsymmetricRowM<SR, CW>(Tst, Ref, Msk, y, 0, Tst->getWidth(), GlobalColorShift, SearchRange, CmpWeights); }); });
+}
+uint64V4 xCorrespPixelShiftSTD::CalcDistAsymmetricRowM(const xPicI* Tst, const xPicI* Ref, const xPicMask* Msk, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  //binary mask is read directly from bit plane
+  if(Msk->isBinary()) { const xPicMaskBits MskBits(Msk); return xSwitchCmpWeights(CmpWeights, [&](auto CW) { return xSwitchSearchRange(SearchRange, [&](auto SR) { return xCalcDistAsymmetricRowM<SR, CW>(Tst, Ref, &MskBits, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights); }); }); }
+  return xSwitchCmpWeights(CmpWeights, [&](auto CW) { return xSwitchSearchRange(SearchRange, [&](auto SR) { return xCalcDistAsymmetricRowM<SR, CW>(Tst, Ref, Msk, y, BegX, EndX, GlobalColorShift, SearchRange, CmpWeights); }); });
+}
+int32 xCorrespPixelShiftSTD::FindBestPixelWithinBlockM(const int32V4& TstPel, const xPicI* Ref, const xPicP* Msk, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  return xSwitchCmpWeights(CmpWeights, [&](auto CW) { return xSwitchSearchRange(SearchRange, [&](auto SR) { return xFindBestPixelWithinBlockM<SR, CW>(TstPel, Ref, Msk, CenterX, CenterY, SearchRange, CmpWeights); }); });
+}
+template <int32 tSR, eCmpWgh tCW, class tMsk> uint64V4 xCorrespPixelShiftSTD::xCalcDistAsymmetricRowM(const xPicI* Tst, const xPicI* Ref, const tMsk* Msk, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights)
 {
   assert(Tst->isCompatible(Ref));
 
-  const int32  Width     = Tst->getWidth ();
   const int32  TstStride = Tst->getStride();
   const int32  TstOffset = y * TstStride;
   const int32  MskStride = Msk->getStride();
@@ -90,14 +106,14 @@ uint64V4 xCorrespPixelShiftSTD::CalcDistAsymmetricRowM(const xPicI* Tst, const x
   uint64V4 RowDist = { 0, 0, 0, 0 };
 
   const uint16V4* TstPtr = Tst->getAddr(        ) + TstOffset;
-  const uint16*   MskPtr = Msk->getAddr(eCmp::LM) + MskOffset;
+  const auto      MskPtr = xGetMskAddr(Msk) + MskOffset;
         
-  for(int32 x = 0; x < Width; x++)
+  for(int32 x = BegX; x < EndX; x++)
   {
     const int32   CurrMskValue  = (int32)MskPtr[x];
     if(CurrMskValue == 0) { continue; } //skip masked pixels
     const int32V4 CurrTstValue  = (int32V4)(TstPtr[x]) + GlobalColorShift;
-    const int32   BestRefOffset = FindBestPixelWithinBlockM(CurrTstValue, Ref, Msk, x, y, SearchRange, CmpWeights);
+    const int32   BestRefOffset = xFindBestPixelWithinBlockM<tSR, tCW>(CurrTstValue, Ref, Msk, x, y, SearchRange, CmpWeights);
     const int32V4 Diff = CurrTstValue - (int32V4)(Ref->getAddr()[BestRefOffset]); //TODO - xc_CLIP_CURR_TST_RANGE
     const int32V4 Dist = Diff.getVecPow2();
     RowDist += ((uint64V4)Dist) * CurrMskValue;
@@ -105,16 +121,18 @@ uint64V4 xCorrespPixelShiftSTD::CalcDistAsymmetricRowM(const xPicI* Tst, const x
 
   return RowDist;
 }
-int32 xCorrespPixelShiftSTD::FindBestPixelWithinBlockM(const int32V4& TstPel, const xPicI* Ref, const xPicP* Msk, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const int32V4& CmpWeights)
+template <int32 tSR, eCmpWgh tCW, class tMsk> int32 xCorrespPixelShiftSTD::xFindBestPixelWithinBlockM(const int32V4& TstPel, const xPicI* Ref, const tMsk* Msk, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const int32V4& CmpWeights)
 {
-  const int32 BegY = CenterY - SearchRange;
-  const int32 EndY = CenterY + SearchRange;
-  const int32 BegX = CenterX - SearchRange;
-  const int32 EndX = CenterX + SearchRange;
+  const int32 SR   = tSR > 0 ? tSR : SearchRange;
+  const int32 BegY = CenterY - SR;
+  const int32 EndY = CenterY + SR;
+  const int32 BegX = CenterX - SR;
+  const int32 EndX = CenterX + SR;
 
-  const uint16V4* RefPtr = Ref->getAddr  ();
-  const uint16*   MskPtr = Msk->getAddr  (eCmp::LM);
-  const int32     Stride = Ref->getStride();
+  const uint16V4* RefPtr    = Ref->getAddr  ();
+  const auto      MskPtr    = xGetMskAddr(Msk);
+  const int32     Stride    = Ref->getStride();
+  const int32     MskStride = Msk->getStride();
 
   int32 BestError  = std::numeric_limits<int32>::max();
   int32 BestOffset = NOT_VALID;
@@ -124,25 +142,66 @@ int32 xCorrespPixelShiftSTD::FindBestPixelWithinBlockM(const int32V4& TstPel, co
     for(int32 x = BegX; x <= EndX; x++)
     {
       const int32   Offset = y * Stride + x;
-      if(MskPtr[Offset] == 0) { continue; }
+      if(MskPtr[y * MskStride + x] == 0) { continue; }
       const int32V4 RefPel = (int32V4)(RefPtr[Offset]);
       const int32V4 Dist   = (TstPel - RefPel).getVecPow2();
-      if constexpr (c_UseRuntimeCmpWeights)
-      {
-        const int32 Error = (Dist * CmpWeights).getSum();
-        if (Error < BestError) { BestError = Error; BestOffset = Offset; }
-      }
-      else
-      {
-        const int32 Error = (Dist[0] << 2) + Dist[1] + Dist[2];
-        if (Error < BestError) { BestError = Error; BestOffset = Offset; }
-      }
+      const int32   Error  = xCalcWeightedError<tCW>(Dist, CmpWeights);
+      if (Error < BestError) { BestError = Error; BestOffset = Offset; }
     } //x
   } //y
 
   return BestOffset;
 }
 
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// symmetric Q - planar int32 rows
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void xCorrespPixelShiftSTD::UpdateBestSymmetricRow(const int32* TstLm, const int32* TstCb, const int32* TstCr, const int32* const* RefRows, int32* BestPlaneR2T, int32* const* BestErrorT2R, int32* const* BestPlaneT2R, const int32 BegX, const int32 EndX, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  xSwitchCmpWeights(CmpWeights, [&](auto CW) { xSwitchSearchRange(SearchRange, [&](auto SR) { xUpdateBestSymmetricRow<SR, CW>(TstLm, TstCb, TstCr, RefRows, BestPlaneR2T, BestErrorT2R, BestPlaneT2R, BegX, EndX, SearchRange, CmpWeights); }); });
+}
+uint64V4 xCorrespPixelShiftSTD::CalcDistBestMatchRow(const int32* CurLm, const int32* RingLm, const int32* BestPlane, const int32* PlaneOffsets, const int32 CmpStride, const int32 BegX, const int32 EndX)
+{
+  uint64V4 RowDist = { 0, 0, 0, 0 };
+  for(int32 x = BegX; x < EndX; x++)
+  {
+    const int32 Offset = PlaneOffsets[BestPlane[x]] + x;
+    RowDist[0] += (uint64)xPow2(CurLm[x                ] - RingLm[Offset                ]);
+    RowDist[1] += (uint64)xPow2(CurLm[x +     CmpStride] - RingLm[Offset +     CmpStride]);
+    RowDist[2] += (uint64)xPow2(CurLm[x + 2 * CmpStride] - RingLm[Offset + 2 * CmpStride]);
+  }
+  return RowDist;
+}
+template <int32 tSR, eCmpWgh tCW> void xCorrespPixelShiftSTD::xUpdateBestSymmetricRow(const int32* TstLm, const int32* TstCb, const int32* TstCr, const int32* const* RefRows, int32* BestPlaneR2T, int32* const* BestErrorT2R, int32* const* BestPlaneT2R, const int32 BegX, const int32 EndX, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  const int32 SR         = tSR > 0 ? tSR : SearchRange;
+  const int32 WindowSize = 2 * SR + 1;
+  const int32 NumPlanes  = WindowSize * WindowSize;
+
+  for(int32 x = BegX; x < EndX; x++)
+  {
+    int32 BestError = std::numeric_limits<int32>::max();
+    int32 BestPlane = NOT_VALID;
+    for(int32 dy = -SR; dy <= SR; dy++)
+    {
+      const int32* RefLm    = RefRows[3 * (dy + SR) + 0] + x;
+      const int32* RefCb    = RefRows[3 * (dy + SR) + 1] + x;
+      const int32* RefCr    = RefRows[3 * (dy + SR) + 2] + x;
+      int32*       ErrorT2R = BestErrorT2R[dy + SR] != nullptr ? BestErrorT2R[dy + SR] + x : nullptr;
+      int32*       PlaneT2R = BestErrorT2R[dy + SR] != nullptr ? BestPlaneT2R[dy + SR] + x : nullptr;
+      if(BestPlaneR2T == nullptr && ErrorT2R == nullptr) { continue; } //halo row of band - only some T2R rows are needed
+      for(int32 dx = -SR; dx <= SR; dx++)
+      {
+        const int32 PlaneIdx = (dy + SR) * WindowSize + dx + SR;
+        const int32 Error    = xCalcWeightedError<tCW>(xPow2(TstLm[x] - RefLm[dx]), xPow2(TstCb[x] - RefCb[dx]), xPow2(TstCr[x] - RefCr[dx]), CmpWeights);
+        if(Error < BestError) { BestError = Error; BestPlane = PlaneIdx; } //planes in raster order
+        if(ErrorT2R != nullptr && (Error < ErrorT2R[dx] || (Error == ErrorT2R[dx] && NumPlanes - 1 - PlaneIdx < PlaneT2R[dx]))) { ErrorT2R[dx] = Error; PlaneT2R[dx] = NumPlanes - 1 - PlaneIdx; }
+      } //dx
+    } //dy
+    if(BestPlaneR2T != nullptr) { BestPlaneR2T[x] = BestPlane; }
+  } //x
+}
+
 //===============================================================================================================================================================================================================
 
 } //end of namespace PMBB
\ No newline at end of file
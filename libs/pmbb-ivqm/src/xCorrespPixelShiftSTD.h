@@ -5,7 +5,7 @@
 
 #pragma once
 #include "xCommonDefIVQM.h"
-#include "xPic.h"
+#include "xPicMask.h"
 
 namespace PMBB_NAMESPACE {
 
@@ -14,14 +14,31 @@ namespace PMBB_NAMESPACE {
 class xCorrespPixelShiftSTD
 {
 public:
-  static constexpr bool c_UseRuntimeCmpWeights = xc_USE_RUNTIME_CMPWEIGHTS;
-
-  //asymetric Q interleaved
-  static uint64V4 CalcDistAsymmetricRow    (const xPicI* Tst, const xPicI* Ref, const int32 y, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights);
+  //asymetric Q interleaved - optionally stores shift compensated row: ShftComp(x, y) = Ref(best match) - GlobalColorShift, clipped (ShftComp == nullptr --> not stored, masked test pixels are not stored)
+  static uint64V4 CalcDistAsymmetricRow    (const xPicI* Tst, const xPicI* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp);
   static int32    FindBestPixelWithinBlock (const int32V4& TstPel, const xPicI* Ref, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const int32V4& CmpWeights);
   
   static uint64V4 CalcDistAsymmetricRowM   (const xPicI* Tst, const xPicI* Ref, const xPicP* Msk, const int32 y, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights);
+  static uint64V4 CalcDistAsymmetricRowM   (const xPicI* Tst, const xPicI* Ref, const xPicMask* Msk, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights);
   static int32    FindBestPixelWithinBlockM(const int32V4& TstPel, const xPicI* Ref, const xPicP* Msk, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const int32V4& CmpWeights);
+
+  //symmetric Q - weighted errors of test row [BegX, EndX) against all displacements (RefRows - Lm, Cb and Cr of WindowSize reference rows, int32, column 0), best candidate: lower error, then lower plane index
+  //R2T best plane stored at test positions (BestPlaneR2T == nullptr --> not stored), T2R running minimum updated at reference positions (BestErrorT2R[dy + SearchRange] == nullptr --> row skipped)
+  static void     UpdateBestSymmetricRow  (const int32* TstLm, const int32* TstCb, const int32* TstCr, const int32* const* RefRows, int32* BestPlaneR2T, int32* const* BestErrorT2R, int32* const* BestPlaneT2R, const int32 BegX, const int32 EndX, const int32 SearchRange, const int32V4& CmpWeights);
+  //symmetric Q - distance of best matches, best match of pixel x is RingLm[PlaneOffsets[BestPlane[x]] + x] (Cb and Cr at CmpStride and 2 * CmpStride)
+  static uint64V4 CalcDistBestMatchRow    (const int32* CurLm, const int32* RingLm, const int32* BestPlane, const int32* PlaneOffsets, const int32 CmpStride, const int32 BegX, const int32 EndX);
+
+protected:
+  //tSR > 0 - compile time search range, tSR == 0 - generic (runtime SearchRange), tCW - component weights specialization, tMsk - mask type (xPicP or xPicMask)
+  template <int32 tSR, eCmpWgh tCW> static uint64V4 xCalcDistAsymmetricRow    (const xPicI* Tst, const xPicI* Ref, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp);
+  template <int32 tSR, eCmpWgh tCW> static int32    xFindBestPixelWithinBlock (const int32V4& TstPel, const xPicI* Ref, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const int32V4& CmpWeights);
+
+  template <int32 tSR, eCmpWgh tCW, class tMsk> static uint64V4 xCalcDistAsymmetricRowM   (const xPicI* Tst, const xPicI* Ref, const tMsk* Msk, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights);
+  template <int32 tSR, eCmpWgh tCW, class tMsk> static int32    xFindBestPixelWithinBlockM(const int32V4& TstPel, const xPicI* Ref, const tMsk* Msk, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const int32V4& CmpWeights);
+
+  static inline void xStoreShftCompPel(xPicP* ShftComp, const int32 x, const int32 y, const int32V4& RefPel, const int32V4& GlobalColorShift) { const int32 Offset = ShftComp->getOffset({ x, y }); const int32 MaxValue = xBitDepth2MaxValue(ShftComp->getBitDepth()); ShftComp->getAddr(eCmp::LM)[Offset] = (uint16)xClipU(RefPel[0] - GlobalColorShift[0], MaxValue); ShftComp->getAddr(eCmp::CB)[Offset] = (uint16)xClipU(RefPel[1] - GlobalColorShift[1], MaxValue); ShftComp->getAddr(eCmp::CR)[Offset] = (uint16)xClipU(RefPel[2] - GlobalColorShift[2], MaxValue); }
+
+  template <int32 tSR, eCmpWgh tCW> static void xUpdateBestSymmetricRow(const int32* TstLm, const int32* TstCb, const int32* TstCr, const int32* const* RefRows, int32* BestPlaneR2T, int32* const* BestErrorT2R, int32* const* BestPlaneT2R, const int32 BegX, const int32 EndX, const int32 SearchRange, const int32V4& CmpWeights);
 };
 
 //===============================================================================================================================================================================================================
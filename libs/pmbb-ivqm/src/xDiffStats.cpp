@@ -0,0 +1,88 @@
+/*
+    SPDX-FileCopyrightText: 2019-2023 Jakub Stankowski <jakub.stankowski@put.poznan.pl>
+    SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "xDiffStats.h"
+#include "xDistortion.h"
+#include <cassert>
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+// xDiffStats
+//===============================================================================================================================================================================================================
+void xDiffStats::calcPicDiffStats(const xPicP* Tst, const xPicP* Ref)
+{
+  assert(Ref != nullptr && Tst != nullptr);
+  assert(Ref->isCompatible(Tst));
+
+  m_NumCmps  = Ref->getNumCmps();
+  m_BitDepth = Ref->getBitDepth();
+
+  for(int32 CmpIdx = 0; CmpIdx < m_NumCmps; CmpIdx++)
+  {
+    const int32 Height = Ref->getHeight((eCmp)CmpIdx);
+    m_Area  [CmpIdx] = Ref->getArea((eCmp)CmpIdx);
+    m_Height[CmpIdx] = Height;
+    if((int32)m_RowSSDs[CmpIdx].size() < Height) { m_RowSDs[CmpIdx].resize(Height); m_RowSSDs[CmpIdx].resize(Height); }
+  }
+
+  //rows of all components are distributed over tasks, each row writes into own slot
+  if(m_ThPI.isActive())
+  {
+    int32 NumTasks = 0;
+    for(int32 CmpIdx = 0; CmpIdx < m_NumCmps; CmpIdx++)
+    {
+      for(int32 BegY = 0; BegY < m_Height[CmpIdx]; BegY += c_BandHeight)
+      {
+        const int32 EndY = xMin(BegY + c_BandHeight, m_Height[CmpIdx]);
+        m_ThPI.addWaitingTask([this, Tst, Ref, CmpIdx, BegY, EndY](int32 /*ThreadIdx*/) { xCalcBand(Tst, Ref, (eCmp)CmpIdx, BegY, EndY); });
+        NumTasks++;
+      }
+    }
+    m_ThPI.waitUntilTasksFinished(NumTasks);
+  }
+  else
+  {
+    for(int32 CmpIdx = 0; CmpIdx < m_NumCmps; CmpIdx++) { xCalcBand(Tst, Ref, (eCmp)CmpIdx, 0, m_Height[CmpIdx]); }
+  }
+
+  //reduction in fixed row order - result does not depend on number of threads
+  m_SD  = xMakeVec4<int64 >(0);
+  m_SSD = xMakeVec4<uint64>(0);
+  for(int32 CmpIdx = 0; CmpIdx < m_NumCmps; CmpIdx++)
+  {
+    const int32*  RowSDs  = m_RowSDs [CmpIdx].data();
+    const uint64* RowSSDs = m_RowSSDs[CmpIdx].data();
+    int64  SD  = 0;
+    uint64 SSD = 0;
+    for(int32 y = 0; y < m_Height[CmpIdx]; y++) { SD += RowSDs[y]; SSD += RowSSDs[y]; }
+    m_SD [CmpIdx] = SD;
+    m_SSD[CmpIdx] = SSD;
+  }
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void xDiffStats::xCalcBand(const xPicP* Tst, const xPicP* Ref, eCmp CmpId, int32 BegY, int32 EndY)
+{
+  const int32   Width     = Ref->getWidth (CmpId);
+  const int32   TstStride = Tst->getStride(CmpId);
+  const int32   RefStride = Ref->getStride(CmpId);
+  const uint16* TstPtr    = Tst->getAddr  (CmpId) + BegY * TstStride;
+  const uint16* RefPtr    = Ref->getAddr  (CmpId) + BegY * RefStride;
+
+  int32*  RowSDs  = m_RowSDs [(int32)CmpId].data();
+  uint64* RowSSDs = m_RowSSDs[(int32)CmpId].data();
+  for(int32 y = BegY; y < EndY; y++)
+  {
+    std::tie(RowSDs[y], RowSSDs[y]) = xDistortion::CalcSDSSD(TstPtr, RefPtr, Width);
+    TstPtr += TstStride;
+    RefPtr += RefStride;
+  }
+}
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
@@ -0,0 +1,55 @@
+/*
+    SPDX-FileCopyrightText: 2019-2023 Jakub Stankowski <jakub.stankowski@put.poznan.pl>
+    SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+
+#include "xCommonDefIVQM.h"
+#include "xPic.h"
+#include "xVec.h"
+#include <vector>
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+// Difference statistics - single pass over Tst and Ref producing per-component SD (sum of differences), SSD, per-row SSD and exactness flags
+//===============================================================================================================================================================================================================
+
+class xDiffStats : public xMultiThreaded
+{
+public:
+  static constexpr int32 c_BandHeight = 64; //rows processed by single task
+
+protected:
+  int32    m_NumCmps  = 0;
+  int32    m_BitDepth = 0;
+  int32V4  m_Area     = xMakeVec4<int32 >(0);
+  int32V4  m_Height   = xMakeVec4<int32 >(0);
+  int64V4  m_SD       = xMakeVec4<int64 >(0); //sum of (Tst - Ref)
+  uint64V4 m_SSD      = xMakeVec4<uint64>(0); //sum of (Tst - Ref)^2
+
+  std::vector< int32> m_RowSDs [4];
+  std::vector<uint64> m_RowSSDs[4];
+
+public:
+  void  calcPicDiffStats(const xPicP* Tst, const xPicP* Ref);
+
+  int32         getNumCmps    (         ) const { return m_NumCmps;                      }
+  int32         getBitDepth   (         ) const { return m_BitDepth;                     }
+  int32         getMaxPelValue(         ) const { return xBitDepth2MaxValue(m_BitDepth); }
+  int32         getArea       (eCmp Cmp ) const { return m_Area   [(int32)Cmp];          }
+  int32         getHeight     (eCmp Cmp ) const { return m_Height [(int32)Cmp];          }
+  int64         getSD         (eCmp Cmp ) const { return m_SD     [(int32)Cmp];          }
+  uint64        getSSD        (eCmp Cmp ) const { return m_SSD    [(int32)Cmp];          }
+  bool          isExact       (eCmp Cmp ) const { return m_SSD    [(int32)Cmp] == 0;     }
+  const uint64* getRowSSDs    (eCmp Cmp ) const { return m_RowSSDs[(int32)Cmp].data();   }
+  int64V4       getSDs        (         ) const { return m_SD;                           }
+
+protected:
+  void  xCalcBand(const xPicP* Tst, const xPicP* Ref, eCmp CmpId, int32 BegY, int32 EndY);
+};
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
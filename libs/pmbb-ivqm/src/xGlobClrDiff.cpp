@@ -17,8 +17,6 @@ int32V4 xGlobClrDiff::CalcGlobalColorDiff(const xPicP* Tst, const xPicP* Ref, co
   assert(Ref->isCompatible(Tst));
 
   const int32   NumCmps  = Ref->getNumCmps();
-  const int32   MaxValue = Ref->getMaxPelValue();
-  const int32V4 MaxDiff  = xRoundFltToInt32(CmpUnntcbCoef * (flt32)MaxValue);
   const flt64   Area     = Ref->getArea();
 
   int64V4 SumColorDiff = xMakeVec4<int64>(0);
@@ -40,11 +38,7 @@ int32V4 xGlobClrDiff::CalcGlobalColorDiff(const xPicP* Tst, const xPicP* Ref, co
     }
   }
 
-  flt64V4 AvgColorDiff     = (flt64V4)SumColorDiff / Area;
-  int32V4 GlobalColorShift = xRoundFltToInt32(AvgColorDiff);
-  GlobalColorShift.modClip(-MaxDiff, MaxDiff);
-
-  return GlobalColorShift;
+  return CalcGlobalColorDiff(SumColorDiff, xMakeVec4<flt64>(Area), Ref->getMaxPelValue(), CmpUnntcbCoef);
 }
 
 //---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -52,8 +46,6 @@ int32V4 xGlobClrDiff::CalcGlobalColorDiff(const xPicP* Tst, const xPicP* Ref, co
 int32V4 xGlobClrDiff::CalcGlobalColorDiffM(const xPicP* Tst, const xPicP* Ref, const xPicP* Msk, const flt32V4& CmpUnntcbCoef, const int32 NumNonMasked, tThPI* TPI)
 {
   const int32   NumCmps  = Ref->getNumCmps();
-  const int32   MaxValue = Ref->getMaxPelValue();
-  const int32V4 MaxDiff  = xRoundFltToInt32(CmpUnntcbCoef * (flt32)MaxValue);
 
   int64V4 SumColorDiff = xMakeVec4<int64>(0);
 
@@ -75,12 +67,88 @@ int32V4 xGlobClrDiff::CalcGlobalColorDiffM(const xPicP* Tst, const xPicP* Ref, c
     }
   }
 
-  flt64V4 AvgColorDiff     = (flt64V4)SumColorDiff / (flt64)((int64)NumNonMasked * (int64)(Msk->getMaxPelValue()));
+  const flt64 NumPoints = (flt64)((int64)NumNonMasked * (int64)(Msk->getMaxPelValue()));
+  return CalcGlobalColorDiff(SumColorDiff, xMakeVec4<flt64>(NumPoints), Ref->getMaxPelValue(), CmpUnntcbCoef);
+}
+int32V4 xGlobClrDiff::CalcGlobalColorDiffM(const xPicP* Tst, const xPicP* Ref, const xPicMask* Msk, const flt32V4& CmpUnntcbCoef, tThPI* TPI)
+{
+  const int32   NumCmps  = Ref->getNumCmps();
+
+  int64V4 SumColorDiff = xMakeVec4<int64>(0);
+
+  if(TPI && TPI->isActive())
+  {
+    for(int32 CmpIdx = 0; CmpIdx < NumCmps; CmpIdx++)
+    {
+      TPI->addWaitingTask([&SumColorDiff, &Tst, &Ref, &Msk, CmpIdx](int32 /*ThreadIdx*/) { SumColorDiff[CmpIdx] = xCalcCmpMaskedSD(Tst, Ref, Msk, (eCmp)CmpIdx); });
+    }
+    TPI->waitUntilTasksFinished(NumCmps);
+  }
+  else
+  {
+    for(int32 CmpIdx = 0; CmpIdx < NumCmps; CmpIdx++) { SumColorDiff[CmpIdx] = xCalcCmpMaskedSD(Tst, Ref, Msk, (eCmp)CmpIdx); }
+  }
+
+  const flt64 NumPoints = (flt64)((int64)Msk->getNumNonZero() * (int64)(Msk->getMaxPelValue()));
+  return CalcGlobalColorDiff(SumColorDiff, xMakeVec4<flt64>(NumPoints), Ref->getMaxPelValue(), CmpUnntcbCoef);
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+int32V4 xGlobClrDiff::CalcGlobalColorDiff(const int64V4& SumColorDiff, const flt64V4& NumPoints, int32 MaxValue, const flt32V4& CmpUnntcbCoef)
+{
+  const int32V4 MaxDiff = xRoundFltToInt32(CmpUnntcbCoef * (flt32)MaxValue);
+
+  flt64V4 AvgColorDiff     = (flt64V4)SumColorDiff / NumPoints;
   int32V4 GlobalColorShift = xRoundFltToInt32(AvgColorDiff);
   GlobalColorShift.modClip(-MaxDiff, MaxDiff);
 
   return GlobalColorShift;
 }
+int64 xGlobClrDiff::xCalcCmpMaskedSD(const xPicP* Tst, const xPicP* Ref, const xPicMask* Msk, eCmp CmpId)
+{
+  //weights of binary mask are applied as bits, 8 bit mask otherwise, weight restored by scale (exact in integer arithmetic)
+  //empty tiles are skipped, full tiles are processed without mask (weight of every pel equals max weight)
+  const int32   Width     = Ref->getWidth ();
+  const int32   Height    = Ref->getHeight();
+  const int32   TstStride = Tst->getStride();
+  const int32   RefStride = Ref->getStride();
+  const uint16* TstPtr    = Tst->getAddr  (CmpId);
+  const uint16* RefPtr    = Ref->getAddr  (CmpId);
+
+  int64 SD     = 0;
+  int64 FullSD = 0;
+  for(int32 y = 0; y < Height; y++)
+  {
+    const uint64* BitsPtr = Msk->getBits(y);
+    xPicMask::ForEachTileRun(Msk->getTilesRow(y), Width, [&](int32 BegX, int32 EndX, xPicMask::eTile Tile)
+    {
+      const int32 Len = EndX - BegX;
+      switch(Tile)
+      {
+        case xPicMask::eTile::Empty: break;
+        case xPicMask::eTile::Full : FullSD += xDistortion::CalcSD(TstPtr + BegX, RefPtr + BegX, Len); break;
+        case xPicMask::eTile::Mixed: SD     += Msk->isBinary() ? xDistortion::CalcMaskedSD  (TstPtr + BegX, RefPtr + BegX, BitsPtr + (BegX >> 6), Len)
+                                                               : xDistortion::CalcWeightedSD(TstPtr + BegX, RefPtr + BegX, Msk->getAddr({ BegX, y }), Len); break;
+      }
+    });
+    TstPtr += TstStride;
+    RefPtr += RefStride;
+  }
+  return SD * (int64)Msk->getScale() + FullSD * (int64)Msk->getMaxPelValue();
+}
+
+//===============================================================================================================================================================================================================
+// Global Color Difference - xGlobClrDiffProc
+//===============================================================================================================================================================================================================
+
+int32V4 xGlobClrDiffProc::CalcGlobalColorDiff(const xDiffStats* Stats)
+{
+  //Stats hold sum of (Tst - Ref), while processor calculates difference of Ref against Tst (see CalcGlobalColorDiff for pictures)
+  flt64V4 NumPoints = xMakeVec4<flt64>(1);
+  for(int32 CmpIdx = 0; CmpIdx < Stats->getNumCmps(); CmpIdx++) { NumPoints[CmpIdx] = (flt64)Stats->getArea((eCmp)CmpIdx); }
+  return xGlobClrDiff::CalcGlobalColorDiff(-Stats->getSDs(), NumPoints, Stats->getMaxPelValue(), m_CmpUnntcbCoef);
+}
 
 //===============================================================================================================================================================================================================
 
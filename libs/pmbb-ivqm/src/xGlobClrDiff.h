@@ -6,6 +6,8 @@
 #pragma once
 #include "xCommonDefIVQM.h"
 #include "xPic.h"
+#include "xPicMask.h"
+#include "xDiffStats.h"
 #include "xThreadPool.h"
 
 namespace PMBB_NAMESPACE {
@@ -31,6 +33,13 @@ class xGlobClrDiff
 public:
   static int32V4 CalcGlobalColorDiff (const xPicP* Tst, const xPicP* Ref,                   const flt32V4& CmpUnntcbCoef,                           tThPI* TPI = nullptr);
   static int32V4 CalcGlobalColorDiffM(const xPicP* Tst, const xPicP* Ref, const xPicP* Msk, const flt32V4& CmpUnntcbCoef, const int32 NumNonMasked, tThPI* TPI = nullptr);
+  static int32V4 CalcGlobalColorDiffM(const xPicP* Tst, const xPicP* Ref, const xPicMask* Msk, const flt32V4& CmpUnntcbCoef, tThPI* TPI = nullptr); //compact mask
+
+  //common final stage - average difference rounded and clipped to unnoticeable range
+  static int32V4 CalcGlobalColorDiff (const int64V4& SumColorDiff, const flt64V4& NumPoints, int32 MaxValue, const flt32V4& CmpUnntcbCoef);
+
+protected:
+  static int64   xCalcCmpMaskedSD    (const xPicP* Tst, const xPicP* Ref, const xPicMask* Msk, eCmp CmpId); //weighted sum of differences (Tst - Ref) of single component
 };
 
 //===============================================================================================================================================================================================================
@@ -40,6 +49,8 @@ class xGlobClrDiffProc : public xGlobClrDiffPrms, public xMultiThreaded
 public:
   inline int32V4 CalcGlobalColorDiff (const xPicP* Tst, const xPicP* Ref                                            ) { return xGlobClrDiff::CalcGlobalColorDiff (Ref, Tst,      m_CmpUnntcbCoef,               &m_ThPI); }
   inline int32V4 CalcGlobalColorDiffM(const xPicP* Tst, const xPicP* Ref, const xPicP* Msk, const int32 NumNonMasked) { return xGlobClrDiff::CalcGlobalColorDiffM(Ref, Tst, Msk, m_CmpUnntcbCoef, NumNonMasked, &m_ThPI); }
+  inline int32V4 CalcGlobalColorDiffM(const xPicP* Tst, const xPicP* Ref, const xPicMask* Msk                         ) { return xGlobClrDiff::CalcGlobalColorDiffM(Ref, Tst, Msk, m_CmpUnntcbCoef,               &m_ThPI); }
+         int32V4 CalcGlobalColorDiff (const xDiffStats* Stats); //uses SD precalculated by xDiffStats (Tst - Ref)
 };
 
 //===============================================================================================================================================================================================================
@@ -15,6 +15,11 @@ namespace PMBB_NAMESPACE {
 //===============================================================================================================================================================================================================
 // xIVPSNR
 //===============================================================================================================================================================================================================
+void xIVPSNR::initRowBuffers(int32 Height)
+{
+  xMetricCommon::initRowBuffers(Height);
+  m_RowDistsV4T2R.resize(Height);
+}
 flt64 xIVPSNR::calcPicIVPSNR(const xPicP* Tst, const xPicP* Ref, const xPicI* TstI, const xPicI* RefI)
 {
   assert(Ref != nullptr && Tst != nullptr && Ref->isCompatible(Tst));
@@ -29,27 +34,51 @@ flt64 xIVPSNR::calcPicIVPSNR(const xPicP* Tst, const xPicP* Ref, const xPicI* Ts
   return IVPSNR;
 }
 
-flt64 xIVPSNR::calcPicIVPSNR(const xPicP* Tst, const xPicP* Ref, const int32V4& GlobalColorDiffRef2Tst)
+flt64 xIVPSNR::calcPicIVPSNR(const xPicP* Tst, const xPicP* Ref, const int32V4& GlobalColorDiffRef2Tst, xPicP* ShftCompTst, xPicP* ShftCompRef)
 {
   assert(Ref != nullptr && Tst != nullptr && Ref->isCompatible(Tst));
 
   const int32V4 GlobalColorDiffTst2Ref = -GlobalColorDiffRef2Tst;
+  const uint8*  EqualTiles             = xCalcEqualTiles(Tst, Ref, GlobalColorDiffRef2Tst);
 
-  flt64 R2T = xCalcQualAsymmetricPic(Tst, Ref, GlobalColorDiffRef2Tst);
-  flt64 T2R = xCalcQualAsymmetricPic(Ref, Tst, GlobalColorDiffTst2Ref);  
+  flt64 R2T = std::numeric_limits<flt64>::quiet_NaN();
+  flt64 T2R = std::numeric_limits<flt64>::quiet_NaN();
+  if(m_UseCostVolume)
+  {
+    flt64V2 Qual = xCalcQualSymmetricPic(Tst, Ref, GlobalColorDiffRef2Tst, EqualTiles, ShftCompTst, ShftCompRef);
+    R2T = Qual[0];
+    T2R = Qual[1];
+  }
+  else
+  {
+    R2T = xCalcQualAsymmetricPic(Tst, Ref, GlobalColorDiffRef2Tst, EqualTiles, ShftCompRef);
+    T2R = xCalcQualAsymmetricPic(Ref, Tst, GlobalColorDiffTst2Ref, EqualTiles, ShftCompTst);
+  }
   if(m_DebugCallbackQAP) { m_DebugCallbackQAP(R2T, T2R); }
 
   flt64 IVPSNR = xMin(R2T, T2R);
   return IVPSNR;
 }
-flt64 xIVPSNR::calcPicIVPSNR(const xPicI* Tst, const xPicI* Ref, const int32V4& GlobalColorDiffRef2Tst)
+flt64 xIVPSNR::calcPicIVPSNR(const xPicI* Tst, const xPicI* Ref, const int32V4& GlobalColorDiffRef2Tst, xPicP* ShftCompTst, xPicP* ShftCompRef)
 {
   assert(Ref != nullptr && Tst != nullptr && Ref->isCompatible(Tst));
 
   const int32V4 GlobalColorDiffTst2Ref = -GlobalColorDiffRef2Tst;
+  const uint8*  EqualTiles             = xCalcEqualTiles(Tst, Ref, GlobalColorDiffRef2Tst);
 
-  flt64 R2T = xCalcQualAsymmetricPic(Tst, Ref, GlobalColorDiffRef2Tst);
-  flt64 T2R = xCalcQualAsymmetricPic(Ref, Tst, GlobalColorDiffTst2Ref);  
+  flt64 R2T = std::numeric_limits<flt64>::quiet_NaN();
+  flt64 T2R = std::numeric_limits<flt64>::quiet_NaN();
+  if(m_UseCostVolume)
+  {
+    flt64V2 Qual = xCalcQualSymmetricPic(Tst, Ref, GlobalColorDiffRef2Tst, EqualTiles, ShftCompTst, ShftCompRef);
+    R2T = Qual[0];
+    T2R = Qual[1];
+  }
+  else
+  {
+    R2T = xCalcQualAsymmetricPic(Tst, Ref, GlobalColorDiffRef2Tst, EqualTiles, ShftCompRef);
+    T2R = xCalcQualAsymmetricPic(Ref, Tst, GlobalColorDiffTst2Ref, EqualTiles, ShftCompTst);
+  }
   if(m_DebugCallbackQAP) { m_DebugCallbackQAP(R2T, T2R); }
 
   flt64 IVPSNR = xMin(R2T, T2R);
@@ -57,75 +86,128 @@ flt64 xIVPSNR::calcPicIVPSNR(const xPicI* Tst, const xPicI* Ref, const int32V4&
 }
 
 //---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-// asymetric Q planar
+// equal tiles pre-pass
 //---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-flt64 xIVPSNR::xCalcQualAsymmetricPic(const xPicP* Tst, const xPicP* Ref, const int32V4& GCD)
+template <class tPic> const uint8* xIVPSNR::xCalcEqualTiles(const tPic* Tst, const tPic* Ref, const int32V4& GCD)
 {
-  const int32 Height = Ref->getHeight();
+  if(!tCPS::xCanSkipEqualTiles(GCD, m_CmpWeightsSearch))
+  {
+    if(m_DebugCallbackSKP) { m_DebugCallbackSKP(0); }
+    return nullptr;
+  }
+
+  const int32 NumTilesX = CalcNumEqualTiles(Tst->getWidth ());
+  const int32 NumTilesY = CalcNumEqualTiles(Tst->getHeight());
+  m_EqualTiles.resize(NumTilesX * NumTilesY);
+  m_EqualPels .resize(NumTilesY);
 
   if(m_ThPI.isActive())
   {
-    for(int32 y = 0; y < Height; y++) { m_ThPI.addWaitingTask([this, &Tst, &Ref, &GCD, y](int32) { m_RowDistsV4[y] = tCPS::xCalcDistAsymmetricRow(Tst, Ref, y, GCD, m_SearchRange, m_CmpWeightsSearch); }); }
-    m_ThPI.waitUntilTasksFinished(Height);
+    for(int32 t = 0; t < NumTilesY; t++) { m_ThPI.addWaitingTask([this, &Tst, &Ref, NumTilesX, t](int32) { m_EqualPels[t] = tCPS::xCalcEqualTilesRow(Tst, Ref, t, m_EqualTiles.data() + t * NumTilesX); }); }
+    m_ThPI.waitUntilTasksFinished(NumTilesY);
   }
   else
   {
-    for(int32 y = 0; y < Height; y++) { m_RowDistsV4[y] = tCPS::xCalcDistAsymmetricRow(Tst, Ref, y, GCD, m_SearchRange, m_CmpWeightsSearch); }
+    for(int32 t = 0; t < NumTilesY; t++) { m_EqualPels[t] = tCPS::xCalcEqualTilesRow(Tst, Ref, t, m_EqualTiles.data() + t * NumTilesX); }
   }
 
-  flt64V4 CmpError = xMakeVec4<flt64>(0.0);
-  if(m_UseWS)
+  const int32 NumEqualPels = std::accumulate(m_EqualPels.begin(), m_EqualPels.end(), 0);
+  if(m_DebugCallbackSKP) { m_DebugCallbackSKP(NumEqualPels); }
+  return NumEqualPels > 0 ? m_EqualTiles.data() : nullptr;
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// asymetric Q planar
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+flt64 xIVPSNR::xCalcQualAsymmetricPic(const xPicP* Tst, const xPicP* Ref, const int32V4& GCD, const uint8* EqualTiles, xPicP* ShftComp)
+{
+  const int32 Height    = Ref->getHeight();
+  const int32 NumTilesX = CalcNumEqualTiles(Ref->getWidth());
+  auto getEqualTilesRow = [&](const int32 y) { return EqualTiles != nullptr ? EqualTiles + (y >> c_Log2EqualTileSize) * NumTilesX : nullptr; };
+
+  if(m_ThPI.isActive())
   {
-    xKBNS4 KBNS; for(int32 y = 0; y < Height; y++) { KBNS.acc((flt64V4)m_RowDistsV4[y] * m_EquirectangularWeights[y]); }
-    CmpError = KBNS.result();
+    for(int32 y = 0; y < Height; y++) { m_ThPI.addWaitingTask([this, &Tst, &Ref, &GCD, &getEqualTilesRow, ShftComp, y](int32) { m_RowDistsV4[y] = tCPS::xCalcDistAsymmetricRowSkip(Tst, Ref, y, getEqualTilesRow(y), GCD, m_SearchRange, m_CmpWeightsSearch, ShftComp); }); }
+    m_ThPI.waitUntilTasksFinished(Height);
   }
-  else //!m_UseWS
-  {    
-    CmpError = (flt64V4)std::accumulate(m_RowDistsV4.begin(), m_RowDistsV4.end(), xMakeVec4<uint64>(0));
+  else
+  {
+    for(int32 y = 0; y < Height; y++) { m_RowDistsV4[y] = tCPS::xCalcDistAsymmetricRowSkip(Tst, Ref, y, getEqualTilesRow(y), GCD, m_SearchRange, m_CmpWeightsSearch, ShftComp); }
   }
 
-  flt64V4 CmpQuality  = { 0, 0, 0, 0 };
-  for(int32 c = 0; c < m_NumComponents; c++) { CmpQuality[c] = CalcPSNRfromSSD(CmpError[c] > 0 ? CmpError[c] : 1.0, Tst->getArea(), Tst->getBitDepth()); }
-
-  const int32V4 CmpWeightsAverage = c_UseRuntimeCmpWeights ? m_CmpWeightsAverage : c_DefaultCmpWeights;
-  const int32   SumCmpWeight      = CmpWeightsAverage.getSum();
-  const flt64   CmpWeightInvDenom = 1.0 / (flt64)SumCmpWeight;
-  const flt64   PicQuality        = (CmpQuality * (flt64V4)CmpWeightsAverage).getSum() * CmpWeightInvDenom;
-  return PicQuality;
+  return xCalcQualFromRowDists(m_RowDistsV4, Tst->getArea(), Tst->getBitDepth());
 }
 
 //---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // asymetric Q interleaved
 //---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-flt64 xIVPSNR::xCalcQualAsymmetricPic(const xPicI* Tst, const xPicI* Ref, const int32V4& GCD)
+flt64 xIVPSNR::xCalcQualAsymmetricPic(const xPicI* Tst, const xPicI* Ref, const int32V4& GCD, const uint8* EqualTiles, xPicP* ShftComp)
 {
-  const int32 Height = Ref->getHeight();
+  const int32 Height    = Ref->getHeight();
+  const int32 NumTilesX = CalcNumEqualTiles(Ref->getWidth());
+  auto getEqualTilesRow = [&](const int32 y) { return EqualTiles != nullptr ? EqualTiles + (y >> c_Log2EqualTileSize) * NumTilesX : nullptr; };
 
   if(m_ThPI.isActive())
   {
-    for(int32 y = 0; y < Height; y++) { m_ThPI.addWaitingTask([this, &Tst, &Ref, &GCD, y](int32) { m_RowDistsV4[y] = tCPS::xCalcDistAsymmetricRow(Tst, Ref, y, GCD, m_SearchRange, m_CmpWeightsSearch); }); }
+    for(int32 y = 0; y < Height; y++) { m_ThPI.addWaitingTask([this, &Tst, &Ref, &GCD, &getEqualTilesRow, ShftComp, y](int32) { m_RowDistsV4[y] = tCPS::xCalcDistAsymmetricRowSkip(Tst, Ref, y, getEqualTilesRow(y), GCD, m_SearchRange, m_CmpWeightsSearch, ShftComp); }); }
     m_ThPI.waitUntilTasksFinished(Height);
   }
   else
   {
-    for(int32 y = 0; y < Height; y++) { m_RowDistsV4[y] = tCPS::xCalcDistAsymmetricRow(Tst, Ref, y, GCD, m_SearchRange, m_CmpWeightsSearch); }
+    for(int32 y = 0; y < Height; y++) { m_RowDistsV4[y] = tCPS::xCalcDistAsymmetricRowSkip(Tst, Ref, y, getEqualTilesRow(y), GCD, m_SearchRange, m_CmpWeightsSearch, ShftComp); }
+  }
+
+  return xCalcQualFromRowDists(m_RowDistsV4, Tst->getArea(), Tst->getBitDepth());
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// symmetric Q - shared cost volume
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template <class tPic> flt64V2 xIVPSNR::xCalcQualSymmetricPic(const tPic* Tst, const tPic* Ref, const int32V4& GCD, const uint8* EqualTiles, xPicP* ShftCompTst, xPicP* ShftCompRef)
+{
+  const int32 Height   = Ref->getHeight();
+  const int32 NumBands = (Height + c_CostVolumeBandHeight - 1) / c_CostVolumeBandHeight;
+
+  m_SymmetricBuffers.resize(xMax(m_ThPI.getNumThreads(), 1));
+
+  if(m_ThPI.isActive())
+  {
+    for(int32 b = 0; b < NumBands; b++)
+    {
+      const int32 BegY = b * c_CostVolumeBandHeight;
+      const int32 EndY = xMin(BegY + c_CostVolumeBandHeight, Height);
+      m_ThPI.addWaitingTask([this, &Tst, &Ref, &GCD, EqualTiles, ShftCompTst, ShftCompRef, BegY, EndY](int32 ThreadIdx) { tCPS::xCalcDistSymmetricRows(Tst, Ref, BegY, EndY, EqualTiles, GCD, m_SearchRange, m_CmpWeightsSearch, m_RowDistsV4.data(), m_RowDistsV4T2R.data(), ShftCompTst, ShftCompRef, m_SymmetricBuffers[ThreadIdx]); });
+    }
+    m_ThPI.waitUntilTasksFinished(NumBands);
+  }
+  else
+  {
+    tCPS::xCalcDistSymmetricRows(Tst, Ref, 0, Height, EqualTiles, GCD, m_SearchRange, m_CmpWeightsSearch, m_RowDistsV4.data(), m_RowDistsV4T2R.data(), ShftCompTst, ShftCompRef, m_SymmetricBuffers[0]);
   }
 
+  const flt64 R2T = xCalcQualFromRowDists(m_RowDistsV4   , Tst->getArea(), Tst->getBitDepth());
+  const flt64 T2R = xCalcQualFromRowDists(m_RowDistsV4T2R, Ref->getArea(), Ref->getBitDepth());
+  return { R2T, T2R };
+}
+flt64 xIVPSNR::xCalcQualFromRowDists(const std::vector<uint64V4>& RowDists, const int32 Area, const int32 BitDepth)
+{
+  const int32 Height = (int32)RowDists.size();
+
   flt64V4 CmpError = { 0, 0, 0, 0 };
   if(m_UseWS)
   {
-    xKBNS4 KBNS; for(int32 y = 0; y < Height; y++) { KBNS.acc((flt64V4)m_RowDistsV4[y] * m_EquirectangularWeights[y]); }
+    xKBNS4 KBNS; for(int32 y = 0; y < Height; y++) { KBNS.acc((flt64V4)RowDists[y] * m_EquirectangularWeights[y]); }
     CmpError = KBNS.result();
   }
   else //!m_UseWS
   {    
-    CmpError = (flt64V4)std::accumulate(m_RowDistsV4.begin(), m_RowDistsV4.end(), xMakeVec4<uint64>(0));
+    CmpError = (flt64V4)std::accumulate(RowDists.begin(), RowDists.end(), xMakeVec4<uint64>(0));
   }
 
   flt64V4 CmpQuality  = { 0, 0, 0, 0 };
-  for(int32 c = 0; c < m_NumComponents; c++) { CmpQuality[c] = CalcPSNRfromSSD(CmpError[c] > 0 ? CmpError[c] : 1.0, Tst->getArea(), Tst->getBitDepth()); }
+  for(int32 c = 0; c < m_NumComponents; c++) { CmpQuality[c] = CalcPSNRfromSSD(CmpError[c] > 0 ? CmpError[c] : 1.0, Area, BitDepth); }
 
-  const int32V4 CmpWeightsAverage = c_UseRuntimeCmpWeights ? m_CmpWeightsAverage : c_DefaultCmpWeights;
+  const int32V4 CmpWeightsAverage = m_CmpWeightsAverage;
   const int32   SumCmpWeight      = CmpWeightsAverage.getSum();
   const flt64   CmpWeightInvDenom = 1.0 / (flt64)SumCmpWeight;
   const flt64   PicQuality        = (CmpQuality * (flt64V4)CmpWeightsAverage).getSum() * CmpWeightInvDenom;
@@ -151,26 +233,55 @@ flt64 xIVPSNRM::calcPicIVPSNRM(const xPicP* Tst, const xPicP* Ref, const xPicP*
   flt64 IVPSNR = calcPicIVPSNRM(TstI, RefI, Msk, NumNonMasked, GlobalColorDiffRef2Tst);
   return IVPSNR;
 }
-flt64 xIVPSNRM::calcPicIVPSNRM(const xPicI* Tst, const xPicI* Ref, const xPicP* Msk, int32 NumNonMasked, const int32V4& GlobalColorDiffRef2Tst)
+flt64 xIVPSNRM::calcPicIVPSNRM(const xPicI* Tst, const xPicI* Ref, const xPicP* Msk, int32 NumNonMasked, const int32V4& GlobalColorDiffRef2Tst, xPicP* ShftCompTst, xPicP* ShftCompRef)
+{
+  assert(Ref != nullptr && Tst != nullptr && Msk != nullptr);
+  assert(Ref->isCompatible(Tst));
+  assert(Ref->isSameSizeMargin(Msk));
+
+  const int32V4 GlobalColorDiffTst2Ref = -GlobalColorDiffRef2Tst;
+
+  flt64 R2T = xCalcQualAsymmetricPicM(Ref, Tst, Msk, GlobalColorDiffTst2Ref, NumNonMasked, ShftCompTst);
+  flt64 T2R = xCalcQualAsymmetricPicM(Tst, Ref, Msk, GlobalColorDiffRef2Tst, NumNonMasked, ShftCompRef);
+  if(m_DebugCallbackQAP) { m_DebugCallbackQAP(R2T, T2R); }
+
+  flt64 IVPSNR = xMin(R2T, T2R);
+  return IVPSNR;
+}
+flt64 xIVPSNRM::calcPicIVPSNRM(const xPicI* Tst, const xPicI* Ref, const xPicMask* Msk, const int32V4& GlobalColorDiffRef2Tst, xPicP* ShftCompTst, xPicP* ShftCompRef)
 {
   assert(Ref != nullptr && Tst != nullptr && Msk != nullptr);
   assert(Ref->isCompatible(Tst));
   assert(Ref->isSameSizeMargin(Msk));
 
   const int32V4 GlobalColorDiffTst2Ref = -GlobalColorDiffRef2Tst;
+  const int32   NumNonMasked           = Msk->getNumNonZero();
+  xCalcSearchTiles(Msk);
 
-  flt64 R2T = xCalcQualAsymmetricPicM(Ref, Tst, Msk, GlobalColorDiffTst2Ref, NumNonMasked);
-  flt64 T2R = xCalcQualAsymmetricPicM(Tst, Ref, Msk, GlobalColorDiffRef2Tst, NumNonMasked);
+  flt64 R2T = xCalcQualAsymmetricPicM(Ref, Tst, Msk, GlobalColorDiffTst2Ref, NumNonMasked, ShftCompTst);
+  flt64 T2R = xCalcQualAsymmetricPicM(Tst, Ref, Msk, GlobalColorDiffRef2Tst, NumNonMasked, ShftCompRef);
   if(m_DebugCallbackQAP) { m_DebugCallbackQAP(R2T, T2R); }
 
   flt64 IVPSNR = xMin(R2T, T2R);
   return IVPSNR;
 }
 
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// compact mask search tiles pre-pass
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+const xPicMask::eTile* xIVPSNRM::xCalcSearchTiles(const xPicMask* Msk)
+{
+  const int32 NumTilesX = Msk->getNumTilesX();
+  const int32 NumTilesY = Msk->getNumTilesY();
+  m_SearchTiles.resize(NumTilesX * NumTilesY);
+  for(int32 t = 0; t < NumTilesY; t++) { tCPS::xCalcSearchTilesRow(Msk, t, m_SearchRange, m_SearchTiles.data() + t * NumTilesX); }
+  return m_SearchTiles.data();
+}
+
 //---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // asymetric Q interleaved
 //---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-flt64 xIVPSNRM::xCalcQualAsymmetricPicM(const xPicI* Tst, const xPicI* Ref, const xPicP* Msk, const int32V4& GCD, const int32 NumNonMasked)
+template <class tMsk> flt64 xIVPSNRM::xCalcQualAsymmetricPicM(const xPicI* Tst, const xPicI* Ref, const tMsk* Msk, const int32V4& GCD, const int32 NumNonMasked, xPicP* ShftComp)
 {
   const int32 Height = Ref->getHeight();
 
@@ -178,13 +289,13 @@ flt64 xIVPSNRM::xCalcQualAsymmetricPicM(const xPicI* Tst, const xPicI* Ref, cons
   {
     for(int32 y = 0; y < Height; y++)
     {
-      m_ThPI.addWaitingTask([this, &Tst, &Ref, &Msk, &GCD, y](int32) { m_RowDistsV4[y] = tCPS::xCalcDistAsymmetricRowM(Tst, Ref, Msk, y, GCD, m_SearchRange, m_CmpWeightsSearch); });
+      m_ThPI.addWaitingTask([this, &Tst, &Ref, &Msk, &GCD, ShftComp, y](int32) { m_RowDistsV4[y] = xCalcDistAsymmetricRowM(Tst, Ref, Msk, y, GCD, ShftComp); });
     }
     m_ThPI.waitUntilTasksFinished(Height);
   }
   else
   {
-    for(int32 y = 0; y < Height; y++) { m_RowDistsV4[y] = tCPS::xCalcDistAsymmetricRowM(Tst, Ref, Msk, y, GCD, m_SearchRange, m_CmpWeightsSearch); }
+    for(int32 y = 0; y < Height; y++) { m_RowDistsV4[y] = xCalcDistAsymmetricRowM(Tst, Ref, Msk, y, GCD, ShftComp); }
   }
 
   flt64V4 CmpError = { 0, 0, 0, 0 };
@@ -201,7 +312,7 @@ flt64 xIVPSNRM::xCalcQualAsymmetricPicM(const xPicI* Tst, const xPicI* Ref, cons
   flt64V4 CmpQuality = { 0, 0, 0, 0 };
   for(int32 c = 0; c < m_NumComponents; c++) { CmpQuality[c] = CalcPSNRfromMaskedSSD(CmpError[c] > 0 ? CmpError[c] : 1.0, NumNonMasked, Tst->getBitDepth(), Msk->getBitDepth()); }
 
-  const int32V4 CmpWeightsAverage = c_UseRuntimeCmpWeights ? m_CmpWeightsAverage : c_DefaultCmpWeights;
+  const int32V4 CmpWeightsAverage = m_CmpWeightsAverage;
   const int32   SumCmpWeight      = CmpWeightsAverage.getSum();
   const flt64   CmpWeightInvDenom = 1.0 / (flt64)SumCmpWeight;
   const flt64   PicQuality        = (CmpQuality * (flt64V4)CmpWeightsAverage).getSum() * CmpWeightInvDenom;
@@ -20,23 +20,41 @@ public:
   using tCPS    = xCorrespPixelShift;
   using tDCfGCS = std::function<void(const int32V4&)>; //GCS = GlobalColorDiff
   using tDCfQAP = std::function<void(flt64, flt64)>;   //QAP = QualAsymmetricPic
+  using tDCfSKP = std::function<void(int32)>;          //SKP = number of pixels skipped by search (within equal tiles)
 protected:
   tDCfGCS m_DebugCallbackGCS;
   tDCfQAP m_DebugCallbackQAP;
+  tDCfSKP m_DebugCallbackSKP;
 public:
   void  setDebugCallbackGCS(tDCfGCS DebugCallbackGCS) { m_DebugCallbackGCS = DebugCallbackGCS; }
   void  setDebugCallbackQAP(tDCfQAP DebugCallbackQAP) { m_DebugCallbackQAP = DebugCallbackQAP; }
+  void  setDebugCallbackSKP(tDCfSKP DebugCallbackSKP) { m_DebugCallbackSKP = DebugCallbackSKP; }
+
+protected:
+  std::vector<uint64V4> m_RowDistsV4T2R; //used by symmetric Q
+  std::vector<uint8   > m_EqualTiles;    //equal tiles map (tile rows of CalcNumEqualTiles(Width) entries)
+  std::vector<int32   > m_EqualPels;     //number of pixels within equal tiles - per tile row
+  std::vector<tCPS::xSymmetricBuffers> m_SymmetricBuffers; //symmetric Q scratch buffers - per worker thread
 
 //IVPSNR 
 public:
+  void  initRowBuffers(int32 Height);
+
   flt64 calcPicIVPSNR(const xPicP* Tst, const xPicP* Ref, const xPicI* TstI = nullptr, const xPicI* RefI = nullptr);
 
-  flt64 calcPicIVPSNR(const xPicP* Tst, const xPicP* Ref, const int32V4& GlobalColorDiffRef2Tst);
-  flt64 calcPicIVPSNR(const xPicI* Tst, const xPicI* Ref, const int32V4& GlobalColorDiffRef2Tst);
+  //optionally stores shift compensated pictures found by the same search (as xShftCompPic::GenShftCompPics does)
+  flt64 calcPicIVPSNR(const xPicP* Tst, const xPicP* Ref, const int32V4& GlobalColorDiffRef2Tst, xPicP* ShftCompTst = nullptr, xPicP* ShftCompRef = nullptr);
+  flt64 calcPicIVPSNR(const xPicI* Tst, const xPicI* Ref, const int32V4& GlobalColorDiffRef2Tst, xPicP* ShftCompTst = nullptr, xPicP* ShftCompRef = nullptr);
 
 protected:  
-  flt64 xCalcQualAsymmetricPic(const xPicP* Tst, const xPicP* Ref, const int32V4& GlobalColorDiff); //asymetric Q planar
-  flt64 xCalcQualAsymmetricPic(const xPicI* Tst, const xPicI* Ref, const int32V4& GlobalColorDiff); //asymetric Q interleaved
+  template <class tPic> const uint8* xCalcEqualTiles(const tPic* Tst, const tPic* Ref, const int32V4& GlobalColorDiffRef2Tst); //returns nullptr if skipping is not possible
+
+  flt64 xCalcQualAsymmetricPic(const xPicP* Tst, const xPicP* Ref, const int32V4& GlobalColorDiff, const uint8* EqualTiles, xPicP* ShftComp); //asymetric Q planar
+  flt64 xCalcQualAsymmetricPic(const xPicI* Tst, const xPicI* Ref, const int32V4& GlobalColorDiff, const uint8* EqualTiles, xPicP* ShftComp); //asymetric Q interleaved
+
+  template <class tPic> flt64V2 xCalcQualSymmetricPic(const tPic* Tst, const tPic* Ref, const int32V4& GlobalColorDiffRef2Tst, const uint8* EqualTiles, xPicP* ShftCompTst, xPicP* ShftCompRef); //symmetric Q (R2T, T2R) - shared cost volume
+
+  flt64 xCalcQualFromRowDists(const std::vector<uint64V4>& RowDists, const int32 Area, const int32 BitDepth);
 };
 
 //===============================================================================================================================================================================================================
@@ -46,12 +64,25 @@ class xIVPSNRM : public xIVPSNR
 public:
   flt64 calcPicIVPSNRM(const xPicP* Tst, const xPicP* Ref, const xPicP* Msk, const xPicI* TstI, const xPicI* RefI);
 
-  flt64 calcPicIVPSNRM(const xPicI* Tst, const xPicI* Ref, const xPicP* Msk, int32 NumNonMasked, const int32V4& GlobalColorDiffRef2Tst);
+  //optionally stores shift compensated pictures (as xShftCompPic::GenShftCompPics does) - masked pels are searched for them too
+  flt64 calcPicIVPSNRM(const xPicI* Tst, const xPicI* Ref, const xPicP* Msk, int32 NumNonMasked, const int32V4& GlobalColorDiffRef2Tst, xPicP* ShftCompTst = nullptr, xPicP* ShftCompRef = nullptr);
+  flt64 calcPicIVPSNRM(const xPicI* Tst, const xPicI* Ref, const xPicMask* Msk, const int32V4& GlobalColorDiffRef2Tst, xPicP* ShftCompTst = nullptr, xPicP* ShftCompRef = nullptr); //compact mask, number of non masked pels taken from Msk
 
 protected:
+  std::vector<xPicMask::eTile> m_SearchTiles; //search tiles map of compact mask (tile rows of Msk->getNumTilesX() entries)
+
+  const xPicMask::eTile* xCalcSearchTiles(const xPicMask* Msk);
+
+  //asymetric Q interleaved - row with planar mask or with compact mask (uses search tiles map)
+  inline uint64V4 xCalcDistAsymmetricRowM(const xPicI* Tst, const xPicI* Ref, const xPicP*    Msk, const int32 y, const int32V4& GCD, xPicP* ShftComp) const
+  {
+    if(ShftComp != nullptr) { tCPS::xCalcDistAsymmetricRow(Tst, Ref, y, 0, Ref->getWidth(), GCD, m_SearchRange, m_CmpWeightsSearch, ShftComp); } //shift compensated row covers masked pels too (IV-SSIM is not masked)
+    return tCPS::xCalcDistAsymmetricRowM(Tst, Ref, Msk, y, GCD, m_SearchRange, m_CmpWeightsSearch);
+  }
+  inline uint64V4 xCalcDistAsymmetricRowM(const xPicI* Tst, const xPicI* Ref, const xPicMask* Msk, const int32 y, const int32V4& GCD, xPicP* ShftComp) const { return tCPS::xCalcDistAsymmetricRowSkipM(Tst, Ref, Msk, y, m_SearchTiles.data() + (y >> xPicMask::c_Log2TileSize) * Msk->getNumTilesX(), GCD, m_SearchRange, m_CmpWeightsSearch, ShftComp); }
 
   //asymetric Q interleaved
-  flt64 xCalcQualAsymmetricPicM(const xPicI* Tst, const xPicI* Ref, const xPicP* Msk, const int32V4& GlobalColorDiff, const int32 NumNonMasked);
+  template <class tMsk> flt64 xCalcQualAsymmetricPicM(const xPicI* Tst, const xPicI* Ref, const tMsk* Msk, const int32V4& GlobalColorDiff, const int32 NumNonMasked, xPicP* ShftComp);
 };
 
 //===============================================================================================================================================================================================================
@@ -19,22 +19,13 @@ flt64V4 xPSNR::calcPicPSNR(const xPicP* Tst, const xPicP* Ref)
   assert(Ref != nullptr && Tst != nullptr);
   assert(Ref->isCompatible(Tst));
 
-  flt64V4 PSNR = xMakeVec4(flt64_max );
-  
-  if(m_ThPI.isActive())
-  {
-    for(int32 CmpIdx = 0; CmpIdx < m_NumComponents; CmpIdx++)
-    {
-      m_ThPI.addWaitingTask([this, &PSNR, &Tst, &Ref, CmpIdx](int32 /**/) { PSNR[CmpIdx] = xCalcCmpPSNR(Tst, Ref, (eCmp)CmpIdx); });
-    }
-    m_ThPI.waitUntilTasksFinished(m_NumComponents);
-  }
-  else
+  xCalcPicRowSSDs(Tst, Ref);
+
+  flt64V4 PSNR = xMakeVec4(flt64_max);
+  for(int32 CmpIdx = 0; CmpIdx < m_NumComponents; CmpIdx++)
   {
-    for(int32 CmpIdx = 0; CmpIdx < m_NumComponents; CmpIdx++)
-    {
-      PSNR[CmpIdx] = xCalcCmpPSNR(Tst, Ref, (eCmp)CmpIdx);
-    }
+    const eCmp CmpId = (eCmp)CmpIdx;
+    PSNR[CmpIdx] = xCalcCmpPSNR(xSumRowSSDs(Tst->getHeight(CmpId), CmpId), Tst->getArea(CmpId), Tst->getBitDepth());
   }
 
   return PSNR;
@@ -43,95 +34,193 @@ flt64V4 xPSNR::calcPicPSNRM(const xPicP* Tst, const xPicP* Ref, const xPicP* Msk
 {
   assert(Ref != nullptr && Tst != nullptr && Msk != nullptr);
   assert(Ref->isCompatible    (Tst));
-  assert(Ref->isSameSizeMargin(Msk));
+  assert(Ref->isSameSizeMargin(Msk) && !Ref->isChromaSubsampled());
 
   if(NumNonMasked == NOT_VALID) { NumNonMasked = xPixelOps::CountNonZero(Msk->getAddr(eCmp::LM), Msk->getStride(), Msk->getWidth(), Msk->getHeight()); }
 
-  flt64V4 PSNR = xMakeVec4(flt64_max);
+  xCalcPicRowSSDs(Tst, Ref, Msk);
 
-  if(m_ThPI.isActive())
+  flt64V4 PSNR = xMakeVec4(flt64_max);
+  for(int32 CmpIdx = 0; CmpIdx < m_NumComponents; CmpIdx++)
   {
-    for(int32 CmpIdx = 0; CmpIdx < m_NumComponents; CmpIdx++)
-    {
-      m_ThPI.addWaitingTask([this, &PSNR, Tst, Ref, Msk, NumNonMasked, CmpIdx](int32 /*ThreadIdx*/) { PSNR[CmpIdx] = xCalcCmpPSNRM(Tst, Ref, Msk, NumNonMasked, (eCmp)CmpIdx); });
-    }
-    m_ThPI.waitUntilTasksFinished(m_NumComponents);
+    PSNR[CmpIdx] = xCalcCmpPSNRM(xSumRowSSDs(Tst->getHeight(), (eCmp)CmpIdx), Tst, Msk, NumNonMasked);
   }
-  else
+
+  if(m_DebugCallbackMSK) { m_DebugCallbackMSK(NumNonMasked); }
+
+  return PSNR;
+}
+flt64V4 xPSNR::calcPicPSNRM(const xPicP* Tst, const xPicP* Ref, const xPicMask* Msk)
+{
+  assert(Ref != nullptr && Tst != nullptr && Msk != nullptr);
+  assert(Ref->isCompatible    (Tst));
+  assert(Ref->isSameSizeMargin(Msk) && !Ref->isChromaSubsampled());
+
+  const int32 NumNonMasked = Msk->getNumNonZero();
+
+  xCalcPicRowSSDs(Tst, Ref, Msk);
+
+  flt64V4 PSNR = xMakeVec4(flt64_max);
+  for(int32 CmpIdx = 0; CmpIdx < m_NumComponents; CmpIdx++)
   {
-    for(int32 CmpIdx = 0; CmpIdx < m_NumComponents; CmpIdx++)
-    {
-      PSNR[CmpIdx] = xCalcCmpPSNRM(Tst, Ref, Msk, NumNonMasked, (eCmp)CmpIdx);
-    }
+    PSNR[CmpIdx] = xCalcCmpPSNRM(xSumRowSSDs(Tst->getHeight(), (eCmp)CmpIdx), Tst, Msk, NumNonMasked);
   }
 
   if(m_DebugCallbackMSK) { m_DebugCallbackMSK(NumNonMasked); }
 
   return PSNR;
 }
+flt64V4 xPSNR::calcPicPSNR(const xDiffStats* Stats)
+{
+  assert(Stats != nullptr && Stats->getNumCmps() >= m_NumComponents);
+
+  flt64V4 PSNR = xMakeVec4(flt64_max);
+  for(int32 CmpIdx = 0; CmpIdx < m_NumComponents; CmpIdx++)
+  {
+    PSNR[CmpIdx] = xCalcCmpPSNR(Stats, (eCmp)CmpIdx);
+  }
+
+  return PSNR;
+}
 
 //---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
-flt64 xPSNR::xCalcCmpPSNR(const xPicP* Tst, const xPicP* Ref, eCmp CmpId)
+flt64 xPSNR::xCalcCmpPSNR(uint64 SSD, int32 Area, int32 BitDepth)
 {
-  uint64 SSD  = xCalcCmpSSD(Tst, Ref, CmpId);
-  flt64  PSNR = CalcPSNRfromSSD((flt64)SSD, Tst->getArea(), Tst->getBitDepth());
+  flt64 PSNR = CalcPSNRfromSSD((flt64)SSD, Area, BitDepth);
 
-  if(m_FakeValsForExact && SSD == 0) { PSNR = CalcPSNRfromSSD(1, Tst->getArea(), Tst->getBitDepth()); } //fake PSNR to avoid returning flt64_max
+  if(m_FakeValsForExact && SSD == 0) { PSNR = CalcPSNRfromSSD(1, Area, BitDepth); } //fake PSNR to avoid returning flt64_max
 
   return PSNR;
 }
-flt64 xPSNR::xCalcCmpPSNRM(const xPicP* Tst, const xPicP* Ref, const xPicP* Msk, const int32 NumNonMasked, eCmp CmpId)
+flt64 xPSNR::xCalcCmpPSNRM(uint64 SSD, const xPicP* Tst, const xPicCommon* Msk, const int32 NumNonMasked)
 {
-  uint64 SSD  = xCalcCmpSSDM(Tst, Ref, Msk, CmpId);
-  flt64  PSNR = CalcPSNRfromMaskedSSD((flt64)SSD, NumNonMasked, Tst->getBitDepth(), Msk->getBitDepth());
+  flt64 PSNR = CalcPSNRfromMaskedSSD((flt64)SSD, NumNonMasked, Tst->getBitDepth(), Msk->getBitDepth());
 
   if(m_FakeValsForExact && SSD == 0) { PSNR = CalcPSNRfromSSD(1, Tst->getArea(), Tst->getBitDepth()); } //fake PSNR to avoid returning flt64_max
 
   return PSNR;
 }
-uint64 xPSNR::xCalcCmpSSD(const xPicP* Tst, const xPicP* Ref, eCmp CmpId)
+flt64 xPSNR::xCalcCmpPSNR(const xDiffStats* Stats, eCmp CmpId)
 {
-  const int32   Width     = Ref->getWidth ();
-  const int32   Height    = Ref->getHeight();
-  const uint16* TstPtr    = Tst->getAddr  (CmpId);
-  const uint16* RefPtr    = Ref->getAddr  (CmpId);
-  const int32   TstStride = Tst->getStride();
-  const int32   RefStride = Ref->getStride();
+  return xCalcCmpPSNR(Stats->getSSD(CmpId), Stats->getArea(CmpId), Stats->getBitDepth());
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void xPSNR::xCalcPicRowSSDs(const xPicP* Tst, const xPicP* Ref)
+{
+  xCalcPicRowSSDsT<xPicP>(Tst, Ref, nullptr);
+}
+void xPSNR::xCalcPicRowSSDs(const xPicP* Tst, const xPicP* Ref, const xPicP* Msk)
+{
+  xCalcPicRowSSDsT(Tst, Ref, Msk);
+}
+void xPSNR::xCalcPicRowSSDs(const xPicP* Tst, const xPicP* Ref, const xPicMask* Msk)
+{
+  xCalcPicRowSSDsT(Tst, Ref, Msk);
+}
+template <class tMsk> void xPSNR::xCalcPicRowSSDsT(const xPicP* Tst, const xPicP* Ref, const tMsk* Msk)
+{
+  //rows of all components are distributed over tasks, each row writes into own slot
+  if(m_ThPI.isActive())
+  {
+    int32 NumTasks = 0;
+    for(int32 CmpIdx = 0; CmpIdx < m_NumComponents; CmpIdx++)
+    {
+      const eCmp    CmpId   = (eCmp)CmpIdx;
+      const int32   Height  = Ref->getHeight(CmpId);
+      uint64*       RowSSDs = m_RowDistortions[CmpIdx].data();
+      for(int32 BegY = 0; BegY < Height; BegY += c_BandHeight)
+      {
+        const int32 EndY = xMin(BegY + c_BandHeight, Height);
+        if(Msk == nullptr) { m_ThPI.addWaitingTask([Tst, Ref,      CmpId, BegY, EndY, RowSSDs](int32 /*ThreadIdx*/) { xCalcRowsSSD (Tst, Ref,      CmpId, BegY, EndY, RowSSDs); }); }
+        else               { m_ThPI.addWaitingTask([Tst, Ref, Msk, CmpId, BegY, EndY, RowSSDs](int32 /*ThreadIdx*/) { xCalcRowsSSDM(Tst, Ref, Msk, CmpId, BegY, EndY, RowSSDs); }); }
+        NumTasks++;
+      }
+    }
+    m_ThPI.waitUntilTasksFinished(NumTasks);
+  }
+  else
+  {
+    for(int32 CmpIdx = 0; CmpIdx < m_NumComponents; CmpIdx++)
+    {
+      const eCmp CmpId = (eCmp)CmpIdx;
+      if(Msk == nullptr) { xCalcRowsSSD (Tst, Ref,      CmpId, 0, Ref->getHeight(CmpId), m_RowDistortions[CmpIdx].data()); }
+      else               { xCalcRowsSSDM(Tst, Ref, Msk, CmpId, 0, Ref->getHeight(CmpId), m_RowDistortions[CmpIdx].data()); }
+    }
+  }
+}
+uint64 xPSNR::xSumRowSSDs(int32 Height, eCmp CmpId) const
+{
+  const uint64* RowSSDs = m_RowDistortions[(int32)CmpId].data();
+  return std::accumulate(RowSSDs, RowSSDs + Height, (uint64)0);
+}
+void xPSNR::xCalcRowsSSD(const xPicP* Tst, const xPicP* Ref, eCmp CmpId, int32 BegY, int32 EndY, uint64* restrict RowSSDs)
+{
+  const int32   Width     = Ref->getWidth (CmpId);
+  const int32   TstStride = Tst->getStride(CmpId);
+  const int32   RefStride = Ref->getStride(CmpId);
+  const uint16* TstPtr    = Tst->getAddr  (CmpId) + BegY * TstStride;
+  const uint16* RefPtr    = Ref->getAddr  (CmpId) + BegY * RefStride;
 
-  uint64 CmpSSD = 0;
-  for(int32 y = 0; y < Height; y++)
+  for(int32 y = BegY; y < EndY; y++)
   {
-    uint64 RowSSD = xDistortion::CalcSSD(RefPtr, TstPtr, Width);
-    CmpSSD += RowSSD;
+    RowSSDs[y] = xDistortion::CalcSSD(RefPtr, TstPtr, Width);
     TstPtr += TstStride;
     RefPtr += RefStride;
   }
-
-  return CmpSSD;
 }
-uint64 xPSNR::xCalcCmpSSDM(const xPicP* Tst, const xPicP* Ref, const xPicP* Msk, eCmp CmpId)
+void xPSNR::xCalcRowsSSDM(const xPicP* Tst, const xPicP* Ref, const xPicP* Msk, eCmp CmpId, int32 BegY, int32 EndY, uint64* restrict RowSSDs)
 {
   const int32   Width     = Ref->getWidth ();
-  const int32   Height    = Ref->getHeight();
-  const uint16* TstPtr    = Tst->getAddr  (CmpId   );
-  const uint16* RefPtr    = Ref->getAddr  (CmpId   );
-  const uint16* MskPtr    = Msk->getAddr  (eCmp::LM);
   const int32   TstStride = Tst->getStride();
   const int32   RefStride = Ref->getStride();
   const int32   MskStride = Msk->getStride();
+  const uint16* TstPtr    = Tst->getAddr  (CmpId   ) + BegY * TstStride;
+  const uint16* RefPtr    = Ref->getAddr  (CmpId   ) + BegY * RefStride;
+  const uint16* MskPtr    = Msk->getAddr  (eCmp::LM) + BegY * MskStride;
 
-  uint64 CmpSSD = 0;
-  for(int32 y = 0; y < Height; y++)
+  for(int32 y = BegY; y < EndY; y++)
   {
-    uint64 RowSSD = xDistortion::CalcWeightedSSD(RefPtr, TstPtr, MskPtr, Width);
-    CmpSSD += RowSSD;
+    RowSSDs[y] = xDistortion::CalcWeightedSSD(RefPtr, TstPtr, MskPtr, Width);
     TstPtr += TstStride;
     RefPtr += RefStride;
     MskPtr += MskStride;
-  }  
+  }
+}
+void xPSNR::xCalcRowsSSDM(const xPicP* Tst, const xPicP* Ref, const xPicMask* Msk, eCmp CmpId, int32 BegY, int32 EndY, uint64* restrict RowSSDs)
+{
+  //weights of binary mask are applied as bits, 8 bit mask otherwise, weight restored by scale (exact in integer arithmetic)
+  //empty tiles are skipped, full tiles are processed without mask (weight of every pel equals MaxWeight)
+  const int32   Width     = Ref->getWidth ();
+  const int32   TstStride = Tst->getStride();
+  const int32   RefStride = Ref->getStride();
+  const uint64  Scale     = (uint64)Msk->getScale();
+  const uint64  MaxWeight = (uint64)Msk->getMaxPelValue();
+  const uint16* TstPtr    = Tst->getAddr  (CmpId) + BegY * TstStride;
+  const uint16* RefPtr    = Ref->getAddr  (CmpId) + BegY * RefStride;
 
-  return CmpSSD;
+  for(int32 y = BegY; y < EndY; y++)
+  {
+    const uint64* BitsPtr = Msk->getBits(y);
+    uint64        SSD     = 0;
+    uint64        FullSSD = 0;
+    xPicMask::ForEachTileRun(Msk->getTilesRow(y), Width, [&](int32 BegX, int32 EndX, xPicMask::eTile Tile)
+    {
+      const int32 Len = EndX - BegX;
+      switch(Tile)
+      {
+        case xPicMask::eTile::Empty: break;
+        case xPicMask::eTile::Full : FullSSD += xDistortion::CalcSSD(RefPtr + BegX, TstPtr + BegX, Len); break;
+        case xPicMask::eTile::Mixed: SSD     += Msk->isBinary() ? xDistortion::CalcMaskedSSD  (RefPtr + BegX, TstPtr + BegX, BitsPtr + (BegX >> 6), Len)
+                                                                : xDistortion::CalcWeightedSSD(RefPtr + BegX, TstPtr + BegX, Msk->getAddr({ BegX, y }), Len); break;
+      }
+    });
+    RowSSDs[y] = SSD * Scale + FullSSD * MaxWeight;
+    TstPtr += TstStride;
+    RefPtr += RefStride;
+  }
 }
 
 //---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
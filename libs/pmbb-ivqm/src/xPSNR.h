@@ -7,7 +7,9 @@
 
 #include "xCommonDefIVQM.h"
 #include "xMetricCommon.h"
+#include "xDiffStats.h"
 #include "xPic.h"
+#include "xPicMask.h"
 #include "xVec.h"
 #include <vector>
 #include <tuple>
@@ -32,12 +34,26 @@ public:
 
   flt64V4 calcPicPSNR  (const xPicP* Tst, const xPicP* Ref);
   flt64V4 calcPicPSNRM (const xPicP* Tst, const xPicP* Ref, const xPicP* Msk, int32 NumNonMasked = NOT_VALID);
+  flt64V4 calcPicPSNRM (const xPicP* Tst, const xPicP* Ref, const xPicMask* Msk); //compact mask, number of non masked pels taken from Msk
+  flt64V4 calcPicPSNR  (const xDiffStats* Stats); //uses SSD precalculated by xDiffStats
 
 protected:
-  flt64         xCalcCmpPSNR (const xPicP* Tst, const xPicP* Ref,                                             eCmp CmpId);
-  flt64         xCalcCmpPSNRM(const xPicP* Tst, const xPicP* Ref, const xPicP* Msk, const int32 NumNonMasked, eCmp CmpId);
-  static uint64 xCalcCmpSSD  (const xPicP* Tst, const xPicP* Ref,                                             eCmp CmpId);
-  static uint64 xCalcCmpSSDM (const xPicP* Tst, const xPicP* Ref, const xPicP* Msk,                           eCmp CmpId);
+  static constexpr int32 c_BandHeight = 64; //rows processed by single task
+
+  flt64         xCalcCmpPSNR (uint64 SSD, int32 Area, int32 BitDepth);
+  flt64         xCalcCmpPSNRM(uint64 SSD, const xPicP* Tst, const xPicCommon* Msk, const int32 NumNonMasked);
+  flt64         xCalcCmpPSNR (const xDiffStats* Stats, eCmp CmpId);
+
+  //per-row SSD of all components stored in m_RowDistortions (rows distributed over tasks in bands)
+  void          xCalcPicRowSSDs(const xPicP* Tst, const xPicP* Ref                     );
+  void          xCalcPicRowSSDs(const xPicP* Tst, const xPicP* Ref, const xPicP*    Msk);
+  void          xCalcPicRowSSDs(const xPicP* Tst, const xPicP* Ref, const xPicMask* Msk);
+  uint64        xSumRowSSDs    (int32 Height, eCmp CmpId) const; //reduction in fixed row order
+  static void   xCalcRowsSSD   (const xPicP* Tst, const xPicP* Ref,                      eCmp CmpId, int32 BegY, int32 EndY, uint64* restrict RowSSDs);
+  static void   xCalcRowsSSDM  (const xPicP* Tst, const xPicP* Ref, const xPicP*    Msk, eCmp CmpId, int32 BegY, int32 EndY, uint64* restrict RowSSDs);
+  static void   xCalcRowsSSDM  (const xPicP* Tst, const xPicP* Ref, const xPicMask* Msk, eCmp CmpId, int32 BegY, int32 EndY, uint64* restrict RowSSDs);
+
+  template <class tMsk> void xCalcPicRowSSDsT(const xPicP* Tst, const xPicP* Ref, const tMsk* Msk); //Msk == nullptr for unmasked variant
 
 public:
   static flt64 CalcPSNRfromSSD      (flt64 SSD, int32 Area, int32 BitDepth);
@@ -13,7 +13,7 @@ namespace PMBB_NAMESPACE {
 //===============================================================================================================================================================================================================
 // xSSIM
 //===============================================================================================================================================================================================================
-void xSSIM::create(int32V2 Size, int32 BitDepth, int32 /*Margin*/, bool EnableMS)
+void xSSIM::create(int32V2 Size, int32 BitDepth, int32 /*Margin*/, bool EnableMS, eCrF ChromaFormat)
 {
   m_Size        = Size;
   m_BitDepth    = BitDepth;
@@ -33,8 +33,9 @@ void xSSIM::create(int32V2 Size, int32 BitDepth, int32 /*Margin*/, bool EnableMS
     for(int32 i = 1; i < c_NumMultiScales; i++)
     {
       int32V2 NewSize = LastSize >> 1;
-      m_SubPicTst[i] = new xPicP(NewSize, BitDepth, 0);
-      m_SubPicRef[i] = new xPicP(NewSize, BitDepth, 0);
+      m_SubPicTst[i] = new xPicP(NewSize, BitDepth, 0, ChromaFormat);
+      m_SubPicRef[i] = new xPicP(NewSize, BitDepth, 0, ChromaFormat);
+      for(int32 CmpIdx = 0; CmpIdx < 4; CmpIdx++) { m_SubRowSums[i][CmpIdx].resize(Size.getY(), 0.0); }
       LastSize = NewSize;
     }
   }
@@ -50,100 +51,434 @@ void xSSIM::destroy()
     if(m_SubPicTst[i]) { m_SubPicTst[i]->destroy(); delete m_SubPicTst[i]; m_SubPicTst[i] = nullptr; }
     if(m_SubPicRef[i]) { m_SubPicRef[i]->destroy(); delete m_SubPicRef[i]; m_SubPicRef[i] = nullptr; }
   }
+
+  invalidateMomentCache();
+  for(xMomentPlanes& MP : m_MomentCache)
+  {
+    for(int32 CmpIdx = 0; CmpIdx < 4; CmpIdx++) { MP.m_Planes32[CmpIdx].clear(); MP.m_Planes64[CmpIdx].clear(); }
+  }
+}
+void xSSIM::invalidateMomentCache()
+{
+  for(xMomentPlanes& MP : m_MomentCache) { MP.m_Pic = nullptr; MP.m_Precision = NOT_VALID; }
 }
 flt64V4 xSSIM::calcPicSSIM(const xPicP* Tst, const xPicP* Ref, bool CalcL)
 {
   assert(Ref != nullptr && Tst != nullptr);
   assert(Ref->isCompatible(Tst) && Ref->getHeight() <= m_Size.getY() && Ref->isSameBitDepth(m_BitDepth));
 
-  flt64V4 SSIM = xMakeVec4<flt64>(0.0);
-  for(int32 CmpIdx = 0; CmpIdx < m_NumComponents; CmpIdx++)
-  {
-    SSIM[CmpIdx] = xCalcCmpSSIM(Tst, Ref, (eCmp)CmpIdx, CalcL);
-  }
+  xMomentSrc SrcT, SrcR;
+  if(m_UseMomentCache) { SrcT = xGetMomentSrc(Tst); SrcR = xGetMomentSrc(Ref); }
 
-  return SSIM;
+  //all components are processed as single batch of band tasks
+  const int32 NumTasks = xCalcBandsPicSSIM(Tst, Ref, CalcL, SrcT, SrcR, m_RowSums, c_BandHeight);
+  if(NumTasks > 0) { m_ThPI.waitUntilTasksFinished(NumTasks); }
+
+  return xReducePicSSIM(m_RowSums, Ref, m_SampleStep);
 }
 flt64V4 xSSIM::calcPicMSSSIM(const xPicP* Tst, const xPicP* Ref)
 {
   assert(Ref != nullptr && Tst != nullptr);
-  assert(Ref->isCompatible(Tst) && Ref->isSameSize(m_Size) && Ref->isSameBitDepth(m_BitDepth));
+  assert(Ref->isCompatible(Tst) && Ref->isSameSize(m_Size) && Ref->isSameBitDepth(m_BitDepth) && Ref->isSameChromaFormat(m_SubPicTst[1]));
 
-  std::array<flt64V4, c_NumMultiScales> m_SubScores = { xMakeVec4<flt64>(0) };
+  //stage 1 - scale 0 (all components) together with downsampling of all sub-scales (independent bands of pyramid)
+  xMomentSrc SrcT, SrcR, SrcNone;
+  if(m_UseMomentCache) { SrcT = xGetMomentSrc(Tst); SrcR = xGetMomentSrc(Ref); }
 
-  m_SubScores[0] = calcPicSSIM(Tst, Ref, false);
-  for(int32 i = 1; i < c_NumMultiScales; i++)
+  const int32 SubHeight   = m_SubPicTst[1]->getHeight();
+  const int32 NumPyrBands = (SubHeight + c_PyramidBandHeight - 1) / c_PyramidBandHeight;
+  int32       NumTasks    = 0;
+
+  for(int32 b = 0; b < NumPyrBands; b++)
   {
-    if(i == 1) { xDownsamplePic(m_SubPicTst[i], Tst             ); xDownsamplePic(m_SubPicRef[i], Ref             ); }
-    else       { xDownsamplePic(m_SubPicTst[i], m_SubPicTst[i-1]); xDownsamplePic(m_SubPicRef[i], m_SubPicRef[i-1]); }
+    const int32 BandBegY = b * c_PyramidBandHeight;
+    const int32 BandEndY = xMin(BandBegY + c_PyramidBandHeight, SubHeight);
+    if(m_ThPI.isActive()) { m_ThPI.addWaitingTask([this, Tst, Ref, BandBegY, BandEndY](int32) { xDownsamplePyramid(Tst, Ref, BandBegY, BandEndY); }); NumTasks++; }
+    else                  { xDownsamplePyramid(Tst, Ref, BandBegY, BandEndY); }
+  }
+  NumTasks += xCalcBandsPicSSIM(Tst, Ref, false, SrcT, SrcR, m_RowSums, c_BandHeight);
+  if(NumTasks > 0) { m_ThPI.waitUntilTasksFinished(NumTasks); NumTasks = 0; }
 
-    m_SubScores[i] = calcPicSSIM(m_SubPicTst[i], m_SubPicRef[i], i != c_NumMultiScales -1);
+  //stage 2 - all sub-scales and components at once, band height grows with scale, so coarse scales are split into few large tasks
+  for(int32 i = 1; i < c_NumMultiScales; i++)
+  {
+    NumTasks += xCalcBandsPicSSIM(m_SubPicTst[i], m_SubPicRef[i], i != c_NumMultiScales - 1, SrcNone, SrcNone, m_SubRowSums[i], c_BandHeight << i);
   }
+  if(NumTasks > 0) { m_ThPI.waitUntilTasksFinished(NumTasks); }
+
+  std::array<flt64V4, c_NumMultiScales> SubScores = { xMakeVec4<flt64>(0) };
+  SubScores[0] = xReducePicSSIM(m_RowSums, Tst, m_SampleStep);
+  for(int32 i = 1; i < c_NumMultiScales; i++) { SubScores[i] = xReducePicSSIM(m_SubRowSums[i], m_SubPicTst[i], m_SampleStep); }
 
   flt64V4 CompoundScore = xMakeVec4<flt64>(1);
-  for(int32 i = 0; i < c_NumMultiScales; i++) { CompoundScore = CompoundScore * m_SubScores[i].getVecPow1(c_MultiScaleWghts<flt64>[i]); }
+  for(int32 i = 0; i < c_NumMultiScales; i++) { CompoundScore = CompoundScore * SubScores[i].getVecPow1(c_MultiScaleWghts<flt64>[i]); }
 
   return CompoundScore;
 }
+flt64V4 xSSIM::calcPicFastSSIM(const xPicP* Tst, const xPicP* Ref)
+{
+  assert(Ref != nullptr && Tst != nullptr);
+  assert(Ref->isCompatible(Tst) && Ref->getHeight() <= m_Size.getY() && Ref->isSameBitDepth(m_BitDepth));
+
+  const int32 NumTasks = xCalcBandsPicFastSSIM(Tst, Ref, m_RowSums);
+  if(NumTasks > 0) { m_ThPI.waitUntilTasksFinished(NumTasks); }
+
+  return xReducePicSSIM(m_RowSums, Ref, 1);
+}
 
 //---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
-flt64 xSSIM::xCalcCmpSSIM(const xPicP* Tst, const xPicP* Ref, eCmp CmpId, bool CalcL)
+int32 xSSIM::xCalcBandsPicSSIM(const xPicP* Tst, const xPicP* Ref, bool CalcL, const xMomentSrc& SrcT, const xMomentSrc& SrcR, std::vector<flt64>* RowSums, int32 BandHeight)
 {
-  const int32 Width  = Ref->getWidth();
-  const int32 Height = Ref->getHeight();
+  int32 NumTasks = 0;
+  for(int32 CmpIdx = 0; CmpIdx < m_NumComponents; CmpIdx++)
+  {
+    memset(RowSums[CmpIdx].data(), 0, RowSums[CmpIdx].size() * sizeof(flt64));
+    NumTasks += xCalcBandsSSIM(Tst, Ref, (eCmp)CmpIdx, CalcL, SrcT, SrcR, RowSums[CmpIdx].data(), BandHeight);
+  }
+  return NumTasks;
+}
+int32 xSSIM::xCalcBandsSSIM(const xPicP* Tst, const xPicP* Ref, eCmp CmpId, bool CalcL, const xMomentSrc& SrcT, const xMomentSrc& SrcR, flt64* RowSums, int32 BandHeight)
+{
+  const int32 BegY     = c_FilterRange;
+  const int32 EndY     = Ref->getHeight(CmpId) - c_FilterRange;
+  const int32 NumBands = (EndY - BegY + BandHeight - 1) / BandHeight;
 
-  memset(m_RowSums[(int32)CmpId].data(), 0, m_RowSums[(int32)CmpId].size() * sizeof(flt64));
+  if(EndY <= BegY) { return 0; } //picture smaller than SSIM window - no valid rows
 
-  for(int32 y = c_FilterRange; y < Height - c_FilterRange; y++)
+  if(!m_ThPI.isActive())
   {
-    m_ThPI.addWaitingTask([this, &Tst, &Ref, CmpId, y, CalcL](int32 ) { m_RowSums[(int32)CmpId][y] = xCalcRowSSIM(Tst, Ref, CmpId, y, CalcL); });
+    xCalcRowsSSIM(Tst, Ref, CmpId, BegY, EndY, CalcL, SrcT, SrcR, RowSums);
+    return 0;
   }
-  m_ThPI.waitUntilTasksFinished(Height - 2 * c_FilterRange);
 
+  for(int32 b = 0; b < NumBands; b++)
+  {
+    const int32 BandBegY = BegY + b * BandHeight;
+    const int32 BandEndY = xMin(BandBegY + BandHeight, EndY);
+    m_ThPI.addWaitingTask([this, Tst, Ref, CmpId, BandBegY, BandEndY, CalcL, &SrcT, &SrcR, RowSums](int32) { xCalcRowsSSIM(Tst, Ref, CmpId, BandBegY, BandEndY, CalcL, SrcT, SrcR, RowSums); });
+  }
+  return xMax(NumBands, 0);
+}
+int32 xSSIM::xCalcBandsPicFastSSIM(const xPicP* Tst, const xPicP* Ref, std::vector<flt64>* RowSums)
+{
+  //window of row y covers rows [y - m_BoxSize / 2, y - m_BoxSize / 2 + m_BoxSize)
+  const int32 BegY     = m_BoxSize >> 1;
+
+  int32 NumTasks = 0;
+  for(int32 CmpIdx = 0; CmpIdx < m_NumComponents; CmpIdx++)
+  {
+    const int32 EndY     = Ref->getHeight((eCmp)CmpIdx) - m_BoxSize + BegY + 1;
+    const int32 NumBands = (EndY - BegY + c_BandHeight - 1) / c_BandHeight;
+
+    flt64* CmpRowSums = RowSums[CmpIdx].data();
+    memset(CmpRowSums, 0, RowSums[CmpIdx].size() * sizeof(flt64));
+    if(EndY <= BegY) { continue; } //picture smaller than box window - no valid rows
+    if(!m_ThPI.isActive()) { xCalcRowsFastSSIM(Tst, Ref, (eCmp)CmpIdx, BegY, EndY, CmpRowSums); continue; }
+
+    for(int32 b = 0; b < NumBands; b++)
+    {
+      const int32 BandBegY = BegY + b * c_BandHeight;
+      const int32 BandEndY = xMin(BandBegY + c_BandHeight, EndY);
+      m_ThPI.addWaitingTask([this, Tst, Ref, CmpIdx, BandBegY, BandEndY, CmpRowSums](int32) { xCalcRowsFastSSIM(Tst, Ref, (eCmp)CmpIdx, BandBegY, BandEndY, CmpRowSums); });
+    }
+    NumTasks += xMax(NumBands, 0);
+  }
+  return NumTasks;
+}
+flt64 xSSIM::xReduceRowSums(std::vector<flt64>& RowSums, int32 Width, int32 Height, int32 SampleStep)
+{
   if(m_UseWS)
   {
-    for(int32 y = 0; y < Height; y++) { m_RowSums[(int32)CmpId][y] = m_RowSums[(int32)CmpId][y] * m_EquirectangularWeights[y]; }
+    const flt64* Weights = std::get<0>(getEquirectangularWeights(Height));
+    for(int32 y = 0; y < Height; y++) { RowSums[y] = RowSums[y] * Weights[y]; }
   }
 
   const int64  NumActive = (int64)Width * (int64)Height;
-  flt64 PicSumSSIM = xKBNS::Accumulate(m_RowSums[(int32)CmpId]);
+  flt64 PicSumSSIM = xKBNS::Accumulate(RowSums);
+  if(SampleStep > 1) //sampled positions represent whole valid area
+  {
+    using tSS = xStructSim<fltTP, true>;
+    const int64 NumValid   = (int64)xMax(Width  - 2 * c_FilterRange, 0) * (int64)xMax(Height - 2 * c_FilterRange, 0);
+    const int64 NumSampled = (int64)tSS::getNumSampled(Width, SampleStep) * (int64)tSS::getNumSampled(Height, SampleStep);
+    if(NumSampled > 0) { PicSumSSIM = PicSumSSIM * (flt64)NumValid / (flt64)NumSampled; }
+  }
   flt64 SSIM = PicSumSSIM / (flt64)NumActive;
   return SSIM;
 }
-flt64 xSSIM::xCalcRowSSIM(const xPicP* Tst, const xPicP* Ref, eCmp CmpId, const int32 y, bool CalcL)
+flt64V4 xSSIM::xReducePicSSIM(std::vector<flt64>* RowSums, const xPicP* Pic, int32 SampleStep)
 {
-  const int32   Width     = Ref->getWidth ();
-  const int32   TstStride = Tst->getStride();
-  const int32   RefStride = Ref->getStride();
-  const uint16* TstPtr    = Tst->getAddr(CmpId) + y * TstStride;
-  const uint16* RefPtr    = Ref->getAddr(CmpId) + y * RefStride;
-  
-  flt64 RowSumSSIM = 0.0;
-  if(CalcL)
+  flt64V4 SSIM = xMakeVec4<flt64>(0.0);
+  for(int32 CmpIdx = 0; CmpIdx < m_NumComponents; CmpIdx++) { SSIM[CmpIdx] = xReduceRowSums(RowSums[CmpIdx], Pic->getWidth((eCmp)CmpIdx), Pic->getHeight((eCmp)CmpIdx), SampleStep); }
+  return SSIM;
+}
+void xSSIM::xCalcRowsSSIM(const xPicP* Tst, const xPicP* Ref, eCmp CmpId, const int32 BegY, const int32 EndY, bool CalcL, const xMomentSrc& SrcT, const xMomentSrc& SrcR, flt64* RowSums)
+{
+  if(m_SampleStep > 1 || (SrcT.m_Cache == nullptr && SrcR.m_Cache == nullptr)) //none of pictures is cached - all moments are filtered at once
+  {
+    xCalcRowsSSIM(xPlaneRows(Tst, CmpId), xPlaneRows(Ref, CmpId), Ref->getWidth(CmpId), BegY, EndY, CalcL, RowSums);
+  }
+  else
+  {
+    if(m_Precision == 32) { xCalcRowsSSIMCT<flt32>(Tst, Ref, CmpId, BegY, EndY, CalcL, SrcT, SrcR, RowSums); }
+    else                  { xCalcRowsSSIMCT<flt64>(Tst, Ref, CmpId, BegY, EndY, CalcL, SrcT, SrcR, RowSums); }
+  }
+}
+void xSSIM::xCalcRowsSSIM(const xPlaneRows& Tst, const xPlaneRows& Ref, int32 Width, const int32 BegY, const int32 EndY, bool CalcL, flt64* RowSums)
+{
+  xCalcRowsSSIM(&Tst, &Ref, 1, Width, BegY, EndY, CalcL, &RowSums, [](int32) {});
+}
+template <class tPrepRow> void xSSIM::xCalcRowsSSIM(const xPlaneRows* Tst, const xPlaneRows* Ref, const int32 NumPlanes, int32 Width, const int32 BegY, const int32 EndY, bool CalcL, flt64* const* RowSums, const tPrepRow& PrepRow)
+{
+  if(m_SampleStep > 1)
+  {
+    if(m_Precision == 32) { xCalcRowsSSIMST<flt32>(Tst, Ref, NumPlanes, Width, BegY, EndY, CalcL, RowSums, PrepRow); }
+    else                  { xCalcRowsSSIMST<flt64>(Tst, Ref, NumPlanes, Width, BegY, EndY, CalcL, RowSums, PrepRow); }
+  }
+  else
+  {
+    if(m_Precision == 32) { xCalcRowsSSIMT<flt32>(Tst, Ref, NumPlanes, Width, BegY, EndY, CalcL, RowSums, PrepRow); }
+    else                  { xCalcRowsSSIMT<flt64>(Tst, Ref, NumPlanes, Width, BegY, EndY, CalcL, RowSums, PrepRow); }
+  }
+}
+template <class tFlt, class tPrepRow> void xSSIM::xCalcRowsSSIMT(const xPlaneRows* Tst, const xPlaneRows* Ref, const int32 NumPlanes, int32 Width, const int32 BegY, const int32 EndY, bool CalcL, flt64* const* RowSums, const tPrepRow& PrepRow)
+{
+  //Gaussian filter is applied as separable horizontal and vertical pass. Horizontally filtered moments of rows [y - c_FilterRange, y + c_FilterRange) are kept
+  //in ring buffer of c_WindowSize slots (row r is stored in slot r % c_WindowSize), so every row of band is filtered horizontally once.
+  using tSS = xStructSim<tFlt, true>;
+
+  const int32   SlotSize  = c_NumMoments * Width;
+  const int32   RingSize  = c_WindowSize * SlotSize;
+
+  const tFlt    C1        = (tFlt)m_C1;
+  const tFlt    C2        = (tFlt)m_C2;
+
+  std::vector<tFlt> Moments (SlotSize);
+  std::vector<tFlt> MomentsV(SlotSize);
+  std::vector<tFlt> RowsH   (NumPlanes * RingSize);
+  const tFlt* Window[c_WindowSize];
+
+  auto getSlot     = [&](const int32 p, const int32 y) { return RowsH.data() + p * RingSize + (y % c_WindowSize) * SlotSize; };
+  auto filterRowH  = [&](const int32 y)
+  {
+    PrepRow(y);
+    for(int32 p = 0; p < NumPlanes; p++) { tSS::FilterRowH(getSlot(p, y), Moments.data(), Tst[p].getRow(y), Ref[p].getRow(y), Width, c_FilterS); }
+  };
+
+  for(int32 y = BegY - c_FilterRange; y < BegY + c_FilterRange - 1; y++) { filterRowH(y); }
+
+  for(int32 y = BegY; y < EndY; y++)
+  {
+    filterRowH(y + c_FilterRange - 1);
+    for(int32 p = 0; p < NumPlanes; p++)
+    {
+      for(int32 i = 0; i < c_WindowSize; i++) { Window[i] = getSlot(p, y - c_FilterRange + i); }
+
+      RowSums[p][y] = CalcL ? xStructSim<tFlt, true >::FilterRowV(MomentsV.data(), Window, Width, c_FilterS, C1, C2)
+                            : xStructSim<tFlt, false>::FilterRowV(MomentsV.data(), Window, Width, c_FilterS, C1, C2);
+    }
+  }
+}
+template <class tFlt> void xSSIM::xCalcRowsSSIMCT(const xPicP* Tst, const xPicP* Ref, eCmp CmpId, const int32 BegY, const int32 EndY, bool CalcL, const xMomentSrc& SrcT, const xMomentSrc& SrcR, flt64* RowSums)
+{
+  //vertically filtered moments of single pictures (X, X^2) are taken from moment plane cache (or calculated for current band if picture is not cached),
+  //so only cross moment (RT) has to be filtered here, using the same ring buffer of horizontally filtered rows as xCalcRowsSSIMT
+  using tSS = xStructSim<tFlt, true>;
+
+  const int32   Width     = Ref->getWidth (CmpId);
+  const int32   TstStride = Tst->getStride(CmpId);
+  const int32   RefStride = Ref->getStride(CmpId);
+  const uint16* TstPtr    = Tst->getAddr(CmpId);
+  const uint16* RefPtr    = Ref->getAddr(CmpId);
+  const int32   RowSize   = c_NumPicMoms * Width;
+
+  const tFlt    C1        = (tFlt)m_C1;
+  const tFlt    C2        = (tFlt)m_C2;
+
+  if(EndY <= BegY) { return; } //empty band - nothing to filter (and nothing to store in moment planes)
+
+  std::vector<tFlt> BandMomsT;
+  std::vector<tFlt> BandMomsR;
+  auto getMoments = [&](const xPicP* Pic, const xMomentSrc& Src, std::vector<tFlt>& BandMoms) -> const tFlt*
+  {
+    if(Src.m_Cache == nullptr)
+    {
+      BandMoms.resize((EndY - BegY) * RowSize);
+      xCalcRowsMomsT(BandMoms.data(), Pic, CmpId, BegY, EndY);
+      return BandMoms.data();
+    }
+    tFlt* CacheMoms = Src.m_Cache->getPlanes<tFlt>((int32)CmpId) + BegY * RowSize;
+    if(Src.m_Fill) { xCalcRowsMomsT(CacheMoms, Pic, CmpId, BegY, EndY); }
+    return CacheMoms;
+  };
+  const tFlt* MomsT = getMoments(Tst, SrcT, BandMomsT);
+  const tFlt* MomsR = getMoments(Ref, SrcR, BandMomsR);
+
+  std::vector<tFlt> Moments (Width);
+  std::vector<tFlt> MomentsV(Width);
+  std::vector<tFlt> RowsH   (c_WindowSize * Width);
+  const tFlt* Window[c_WindowSize];
+
+  auto getSlot     = [&](const int32 y) { return RowsH.data() + (y % c_WindowSize) * Width; };
+  auto filterRowH  = [&](const int32 y) { tSS::FilterRowHRT(getSlot(y), Moments.data(), TstPtr + y * TstStride, RefPtr + y * RefStride, Width, c_FilterS); };
+
+  for(int32 y = BegY - c_FilterRange; y < BegY + c_FilterRange - 1; y++) { filterRowH(y); }
+
+  for(int32 y = BegY; y < EndY; y++)
+  {
+    filterRowH(y + c_FilterRange - 1);
+    for(int32 i = 0; i < c_WindowSize; i++) { Window[i] = getSlot(y - c_FilterRange + i); }
+
+    const int32 Offset = (y - BegY) * RowSize;
+    RowSums[y] = CalcL ? xStructSim<tFlt, true >::FilterRowVRT(MomentsV.data(), Window, MomsT + Offset, MomsR + Offset, Width, c_FilterS, C1, C2)
+                       : xStructSim<tFlt, false>::FilterRowVRT(MomentsV.data(), Window, MomsT + Offset, MomsR + Offset, Width, c_FilterS, C1, C2);
+  }
+}
+template <class tFlt, class tPrepRow> void xSSIM::xCalcRowsSSIMST(const xPlaneRows* Tst, const xPlaneRows* Ref, const int32 NumPlanes, int32 Width, const int32 BegY, const int32 EndY, bool CalcL, flt64* const* RowSums, const tPrepRow& PrepRow)
+{
+  //only rows y = c_FilterRange + n * m_SampleStep are evaluated (grid is global, so it does not depend on band split), horizontally filtered rows
+  //are kept in the same ring buffer as in xCalcRowsSSIMT, rows not covered by window of any sampled row are skipped
+  using tSS = xStructSim<tFlt, true>;
+
+  const int32   Step       = m_SampleStep;
+  const int32   PhaseWidth = tSS::getPhaseWidth(Width, Step);
+  const int32   SlotSize   = c_NumMoments * PhaseWidth;
+  const int32   RingSize   = c_WindowSize * SlotSize;
+
+  const tFlt    C1         = (tFlt)m_C1;
+  const tFlt    C2         = (tFlt)m_C2;
+
+  std::vector<uint16> Phases  (2 * Step * PhaseWidth);
+  std::vector<tFlt>   Moments (Step * SlotSize);
+  std::vector<tFlt>   MomentsV(SlotSize);
+  std::vector<tFlt>   RowsH   (NumPlanes * RingSize);
+  const tFlt* Window[c_WindowSize];
+
+  auto getSlot     = [&](const int32 p, const int32 y) { return RowsH.data() + p * RingSize + (y % c_WindowSize) * SlotSize; };
+  auto filterRowH  = [&](const int32 y)
+  {
+    PrepRow(y);
+    for(int32 p = 0; p < NumPlanes; p++) { tSS::FilterRowHStrided(getSlot(p, y), Moments.data(), Phases.data(), Tst[p].getRow(y), Ref[p].getRow(y), Width, Step, c_FilterS); }
+  };
+
+  const int32 FirstY   = BegY + (Step - (BegY - c_FilterRange) % Step) % Step;
+  int32       NextRowH = FirstY - c_FilterRange;
+
+  for(int32 y = FirstY; y < EndY; y += Step)
   {
-    for(int32 x = c_FilterRange; x < Width - c_FilterRange; x++)
+    for(int32 r = xMax(NextRowH, y - c_FilterRange); r < y + c_FilterRange; r++) { filterRowH(r); }
+    NextRowH = y + c_FilterRange;
+    for(int32 p = 0; p < NumPlanes; p++)
     {
-      flt64 PelSSIM = xStructSim<fltTP, true>::CalcPel(TstPtr + x, RefPtr + x, TstStride, RefStride, c_FilterF, m_C1, m_C2);
-      RowSumSSIM += PelSSIM;
+      for(int32 i = 0; i < c_WindowSize; i++) { Window[i] = getSlot(p, y - c_FilterRange + i); }
+
+      RowSums[p][y] = CalcL ? xStructSim<tFlt, true >::FilterRowVStrided(MomentsV.data(), Window, Width, Step, c_FilterS, C1, C2)
+                            : xStructSim<tFlt, false>::FilterRowVStrided(MomentsV.data(), Window, Width, Step, c_FilterS, C1, C2);
     }
   }
-else
+}
+void xSSIM::xCalcRowsFastSSIM(const xPicP* Tst, const xPicP* Ref, eCmp CmpId, const int32 BegY, const int32 EndY, flt64* RowSums)
 {
-  for(int32 x = c_FilterRange; x < Width - c_FilterRange; x++)
+  //summed-area table is local to band (starts at top row of first window), rows [r - m_BoxSize, r] of table are kept in ring buffer of m_BoxSize + 1 slots
+  const int32   BoxSize   = m_BoxSize;
+  const int32   Width     = Ref->getWidth (CmpId);
+  const int32   TstStride = Tst->getStride(CmpId);
+  const int32   RefStride = Ref->getStride(CmpId);
+  const uint16* TstPtr    = Tst->getAddr(CmpId);
+  const uint16* RefPtr    = Ref->getAddr(CmpId);
+  const int32   SatSize   = c_NumMoments * (Width + 1);
+  const int32   NumSlots  = BoxSize + 1;
+
+  std::vector<int64> Sats   (NumSlots * SatSize);
+  std::vector<flt64> PelSSIM(Width);
+
+  auto getSat    = [&](const int32 r) { return Sats.data() + (r % NumSlots) * SatSize; };
+  auto updateSat = [&](const int32 r) { xStructSimBox::UpdateRowSAT(getSat(r + 1), getSat(r), TstPtr + r * TstStride, RefPtr + r * RefStride, Width); }; //row r of pixels --> SAT row r + 1
+
+  const int32 FirstR = BegY - (BoxSize >> 1);
+  memset(getSat(FirstR), 0, SatSize * sizeof(int64));
+  for(int32 r = FirstR; r < FirstR + BoxSize - 1; r++) { updateSat(r); }
+
+  for(int32 y = BegY; y < EndY; y++)
   {
-    flt64 PelSSIM = xStructSim<fltTP, false>::CalcPel(TstPtr + x, RefPtr + x, TstStride, RefStride, c_FilterF, m_C1, m_C2);
-    RowSumSSIM += PelSSIM;
+    const int32 TopR = y - (BoxSize >> 1);
+    updateSat(TopR + BoxSize - 1);
+    RowSums[y] = xStructSimBox::CalcRowBox(PelSSIM.data(), getSat(TopR), getSat(TopR + BoxSize), Width, BoxSize, m_C1, m_C2);
   }
 }
+template <class tFlt> void xSSIM::xCalcRowsMomsT(tFlt* MomentsV, const xPicP* Pic, eCmp CmpId, const int32 BegY, const int32 EndY)
+{
+  //calculates vertically filtered moments (X, X^2) of rows [BegY, EndY), row y is stored at MomentsV + (y - BegY) * c_NumPicMoms * Width
+  using tSS = xStructSim<tFlt, true>;
+
+  const int32   Width    = Pic->getWidth (CmpId);
+  const int32   Stride   = Pic->getStride(CmpId);
+  const uint16* PicPtr   = Pic->getAddr(CmpId);
+  const int32   RowSize  = c_NumPicMoms * Width;
+
+  std::vector<tFlt> Moments(RowSize);
+  std::vector<tFlt> RowsH  (c_WindowSize * RowSize);
+  const tFlt* Window[c_WindowSize];
+
+  auto getSlot     = [&](const int32 y) { return RowsH.data() + (y % c_WindowSize) * RowSize; };
+  auto filterRowH  = [&](const int32 y) { tSS::FilterRowH(getSlot(y), Moments.data(), PicPtr + y * Stride, Width, c_FilterS); };
 
-  return RowSumSSIM;
+  for(int32 y = BegY - c_FilterRange; y < BegY + c_FilterRange - 1; y++) { filterRowH(y); }
+
+  for(int32 y = BegY; y < EndY; y++)
+  {
+    filterRowH(y + c_FilterRange - 1);
+    for(int32 i = 0; i < c_WindowSize; i++) { Window[i] = getSlot(y - c_FilterRange + i); }
+    tSS::FilterRowV(MomentsV + (y - BegY) * RowSize, Window, Width, c_FilterS);
+  }
 }
-void xSSIM::xDownsamplePic(xPicP* Dst, const xPicP* Src)
+xSSIM::xMomentSrc xSSIM::xGetMomentSrc(const xPicP* Pic)
 {
+  if(m_SampleStep > 1) { return { nullptr, false }; } //strided evaluation does not use moment planes
+
+  for(xMomentPlanes& MP : m_MomentCache) { if(MP.m_Pic == Pic && MP.m_Precision == m_Precision) { return { &MP, false }; } }
+
+  for(xMomentPlanes& MP : m_MomentCache) //assign free slot
+  {
+    if(MP.m_Pic != nullptr) { continue; }
+    MP.m_Pic       = Pic;
+    MP.m_Precision = m_Precision;
+    for(int32 CmpIdx = 0; CmpIdx < m_NumComponents; CmpIdx++)
+    {
+      const int32 PlanesSize = c_NumPicMoms * Pic->getArea((eCmp)CmpIdx);
+      if(m_Precision == 32) { MP.m_Planes32[CmpIdx].resize(PlanesSize); }
+      else                  { MP.m_Planes64[CmpIdx].resize(PlanesSize); }
+    }
+    return { &MP, true };
+  }
+
+  return { nullptr, false }; //no free slot, moments are calculated for each band
+}
+void xSSIM::xDownsamplePyramid(const xPicP* Tst, const xPicP* Ref, const int32 BegY, const int32 EndY)
+{
+  //rows [BegY, EndY) of first sub-scale and corresponding rows of coarser sub-scales, 2x2 averaging does not overlap between rows,
+  //so bands are independent as long as BegY is a multiple of 1 << (c_NumMultiScales - 1) (last band covers remaining rows of each sub-scale)
+  const bool LastBand = EndY == m_SubPicTst[1]->getHeight();
+  for(int32 i = 1; i < c_NumMultiScales; i++)
+  {
+    const int32 SubBegY = BegY >> (i - 1);
+    const int32 SubEndY = EndY >> (i - 1);
+    xDownsamplePic(m_SubPicTst[i], i == 1 ? Tst : m_SubPicTst[i-1], SubBegY, SubEndY, LastBand);
+    xDownsamplePic(m_SubPicRef[i], i == 1 ? Ref : m_SubPicRef[i-1], SubBegY, SubEndY, LastBand);
+  }
+}
+void xSSIM::xDownsamplePic(xPicP* Dst, const xPicP* Src, const int32 BegY, const int32 EndY, const bool LastBand)
+{
+  //BegY and EndY are rows of luma plane, rows of vertically subsampled chroma planes are derived from them
   for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++)
   {
-    xPixelOps::DownsampleHV(Dst->getAddr((eCmp)CmpIdx), Src->getAddr((eCmp)CmpIdx), Dst->getStride(), Src->getStride(), Dst->getWidth(), Dst->getHeight());
+    const eCmp  CmpId     = (eCmp)CmpIdx;
+    const int32 ShiftY    = Dst->getCmpShiftY(CmpId);
+    const int32 CmpBegY   = BegY >> ShiftY;
+    const int32 CmpEndY   = LastBand ? Dst->getHeight(CmpId) : EndY >> ShiftY;
+    const int32 DstStride = Dst->getStride(CmpId);
+    const int32 SrcStride = Src->getStride(CmpId);
+    xPixelOps::DownsampleHV(Dst->getAddr(CmpId) + CmpBegY * DstStride, Src->getAddr(CmpId) + 2 * CmpBegY * SrcStride, DstStride, SrcStride, Dst->getWidth(CmpId), CmpEndY - CmpBegY);
   }
 }
 
@@ -151,16 +486,19 @@ void xSSIM::xDownsamplePic(xPicP* Dst, const xPicP* Src)
 // xIVSSIM
 //===============================================================================================================================================================================================================
 
-void xIVSSIM::create(int32V2 Size, int32 BitDepth, int32 Margin, bool EnableMS)
+void xIVSSIM::create(int32V2 Size, int32 BitDepth, int32 Margin, bool EnableMS, eCrF ChromaFormat)
 {
-  xSSIM::create(Size, BitDepth, Margin, EnableMS);
+  xSSIM::create(Size, BitDepth, Margin, EnableMS, ChromaFormat);
   m_TstSCP = new xPicP(Size, BitDepth, Margin);
   m_RefSCP = new xPicP(Size, BitDepth, Margin);
+  for(int32 CmpIdx = 0; CmpIdx < 4; CmpIdx++) { m_RowSumsR2T[CmpIdx].resize(Size.getY(), 0.0); }
 }
 void xIVSSIM::destroy()
 {
   m_TstSCP->destroy(); delete m_TstSCP; m_TstSCP = nullptr;
   m_RefSCP->destroy(); delete m_RefSCP; m_RefSCP = nullptr;
+  for(xPicP* RowSCP : m_StreamRowSCP) { RowSCP->destroy(); delete RowSCP; }
+  m_StreamRowSCP.clear();
   xSSIM::destroy();
 }
 flt64 xIVSSIM::calcPicIVSSIM(const xPicP* Tst, const xPicP* Ref)
@@ -172,10 +510,10 @@ flt64 xIVSSIM::calcPicIVSSIM(const xPicP* Tst, const xPicP* Ref)
 
   xShftCompPic::GenShftCompPics(m_RefSCP, m_TstSCP, Ref, Tst, GlobalColorDiffRef2Tst, m_SearchRange, m_CmpWeightsSearch, &m_ThPI);
 
-  flt64V4 SSIMs_T2R = calcPicSSIM(Tst, m_RefSCP);
-  flt64V4 SSIMs_R2T = calcPicSSIM(Ref, m_TstSCP);
+  flt64V4 SSIMs_T2R, SSIMs_R2T;
+  xCalcPicSSIMsTR(SSIMs_T2R, SSIMs_R2T, Tst, Ref, m_TstSCP, m_RefSCP);
 
-  const int32V4 CmpWeightsAverage             = c_UseRuntimeCmpWeights ? m_CmpWeightsAverage : c_DefaultCmpWeights;
+  const int32V4 CmpWeightsAverage             = m_CmpWeightsAverage;
   const int32   SumCmpWeight                  = CmpWeightsAverage.getSum();
   const flt64   ComponentWeightInvDenominator = 1.0 / (flt64)SumCmpWeight;
 
@@ -194,10 +532,41 @@ flt64 xIVSSIM::calcPicIVSSIM(const xPicP* Tst, const xPicP* Ref, const xPicP* Ts
   assert(Tst != nullptr && Ref != nullptr && Ref->isCompatible(Tst));
   assert(TstSCP != nullptr && TstSCP->isCompatible(Ref) && RefSCP != nullptr && RefSCP->isCompatible(Tst));
 
-  flt64V4 SSIMs_T2R = calcPicSSIM(Tst, RefSCP);
-  flt64V4 SSIMs_R2T = calcPicSSIM(Ref, TstSCP);
+  flt64V4 SSIMs_T2R, SSIMs_R2T;
+  xCalcPicSSIMsTR(SSIMs_T2R, SSIMs_R2T, Tst, Ref, TstSCP, RefSCP);
+
+  const int32V4 CmpWeightsAverage             = m_CmpWeightsAverage;
+  const int32   SumCmpWeight                  = CmpWeightsAverage.getSum();
+  const flt64   ComponentWeightInvDenominator = 1.0 / (flt64)SumCmpWeight;
+
+  flt64 SSIM_T2R = (SSIMs_T2R * (flt64V4)CmpWeightsAverage).getSum() * ComponentWeightInvDenominator;
+  flt64 SSIM_R2T = (SSIMs_R2T * (flt64V4)CmpWeightsAverage).getSum() * ComponentWeightInvDenominator;
+
+  flt64 IVSSIM = xMin(SSIM_T2R, SSIM_R2T);
+
+  if(m_DebugCallbackQAP) { m_DebugCallbackQAP(SSIM_R2T, SSIM_T2R); }
+  
+  return IVSSIM;
+}
+
+flt64 xIVSSIM::calcPicIVSSIMStreamed(const xPicP* Tst, const xPicP* Ref, const int32V4& GlobalColorDiffRef2Tst)
+{
+  assert(Tst != nullptr && Ref != nullptr && Ref->isCompatible(Tst));
+
+  const int32V4 GlobalColorDiffTst2Ref = -GlobalColorDiffRef2Tst;
+
+  xInitStreamRowSCP();
+
+  //both directions (Tst vs RefSCP and Ref vs TstSCP) are processed as single batch of band tasks
+  int32 NumTasks = 0;
+  NumTasks += xCalcBandsStreamedSSIM(Tst, Ref, GlobalColorDiffRef2Tst, m_RowSums   );
+  NumTasks += xCalcBandsStreamedSSIM(Ref, Tst, GlobalColorDiffTst2Ref, m_RowSumsR2T);
+  if(NumTasks > 0) { m_ThPI.waitUntilTasksFinished(NumTasks); }
 
-  const int32V4 CmpWeightsAverage             = c_UseRuntimeCmpWeights ? m_CmpWeightsAverage : c_DefaultCmpWeights;
+  flt64V4 SSIMs_T2R = xReducePicSSIM(m_RowSums   , Tst, m_SampleStep);
+  flt64V4 SSIMs_R2T = xReducePicSSIM(m_RowSumsR2T, Ref, m_SampleStep);
+
+  const int32V4 CmpWeightsAverage             = m_CmpWeightsAverage;
   const int32   SumCmpWeight                  = CmpWeightsAverage.getSum();
   const flt64   ComponentWeightInvDenominator = 1.0 / (flt64)SumCmpWeight;
 
@@ -210,6 +579,102 @@ flt64 xIVSSIM::calcPicIVSSIM(const xPicP* Tst, const xPicP* Ref, const xPicP* Ts
   
   return IVSSIM;
 }
+flt64 xIVSSIM::calcPicIVFastSSIM(const xPicP* Tst, const xPicP* Ref, const xPicP* TstSCP, const xPicP* RefSCP)
+{
+  assert(Tst != nullptr && Ref != nullptr && Ref->isCompatible(Tst));
+  assert(TstSCP != nullptr && TstSCP->isCompatible(Ref) && RefSCP != nullptr && RefSCP->isCompatible(Tst));
+
+  //both directions and all components are processed as single batch of band tasks
+  int32 NumTasks = 0;
+  NumTasks += xCalcBandsPicFastSSIM(Tst, RefSCP, m_RowSums   );
+  NumTasks += xCalcBandsPicFastSSIM(Ref, TstSCP, m_RowSumsR2T);
+  if(NumTasks > 0) { m_ThPI.waitUntilTasksFinished(NumTasks); }
+
+  flt64V4 SSIMs_T2R = xReducePicSSIM(m_RowSums   , Tst, 1);
+  flt64V4 SSIMs_R2T = xReducePicSSIM(m_RowSumsR2T, Ref, 1);
+
+  const int32V4 CmpWeightsAverage             = m_CmpWeightsAverage;
+  const int32   SumCmpWeight                  = CmpWeightsAverage.getSum();
+  const flt64   ComponentWeightInvDenominator = 1.0 / (flt64)SumCmpWeight;
+
+  flt64 SSIM_T2R = (SSIMs_T2R * (flt64V4)CmpWeightsAverage).getSum() * ComponentWeightInvDenominator;
+  flt64 SSIM_R2T = (SSIMs_R2T * (flt64V4)CmpWeightsAverage).getSum() * ComponentWeightInvDenominator;
+
+  flt64 IVFastSSIM = xMin(SSIM_T2R, SSIM_R2T);
+
+  if(m_DebugCallbackQAP) { m_DebugCallbackQAP(SSIM_R2T, SSIM_T2R); }
+  
+  return IVFastSSIM;
+}
+
+void xIVSSIM::xCalcPicSSIMsTR(flt64V4& SSIMs_T2R, flt64V4& SSIMs_R2T, const xPicP* Tst, const xPicP* Ref, const xPicP* TstSCP, const xPicP* RefSCP)
+{
+  //both directions (Tst vs RefSCP and Ref vs TstSCP) and all components are processed as single batch of band tasks
+  xMomentSrc SrcT, SrcRefSCP, SrcR, SrcTstSCP;
+  if(m_UseMomentCache)
+  {
+    SrcT      = xGetMomentSrc(Tst   );
+    SrcRefSCP = xGetMomentSrc(RefSCP);
+    SrcR      = xGetMomentSrc(Ref   );
+    SrcTstSCP = xGetMomentSrc(TstSCP);
+    //moment planes filled by first direction cannot be read by second one, since both are calculated concurrently
+    for(xMomentSrc* Src : { &SrcR, &SrcTstSCP })
+    {
+      if((SrcT.m_Fill && Src->m_Cache == SrcT.m_Cache) || (SrcRefSCP.m_Fill && Src->m_Cache == SrcRefSCP.m_Cache)) { *Src = xMomentSrc(); }
+    }
+  }
+
+  int32 NumTasks = 0;
+  NumTasks += xCalcBandsPicSSIM(Tst, RefSCP, true, SrcT, SrcRefSCP, m_RowSums   , c_BandHeight);
+  NumTasks += xCalcBandsPicSSIM(Ref, TstSCP, true, SrcR, SrcTstSCP, m_RowSumsR2T, c_BandHeight);
+  if(NumTasks > 0) { m_ThPI.waitUntilTasksFinished(NumTasks); }
+
+  SSIMs_T2R = xReducePicSSIM(m_RowSums   , Tst, m_SampleStep);
+  SSIMs_R2T = xReducePicSSIM(m_RowSumsR2T, Ref, m_SampleStep);
+}
+void xIVSSIM::xInitStreamRowSCP()
+{
+  const int32 NumBuffers = xMax(m_ThPI.getNumThreads(), 1);
+  while((int32)m_StreamRowSCP.size() < NumBuffers) { m_StreamRowSCP.push_back(new xPicP({ m_Size.getX(), 1 }, m_BitDepth, 0)); }
+}
+int32 xIVSSIM::xCalcBandsStreamedSSIM(const xPicP* Org, const xPicP* Src, const int32V4& GlobalColorShift, std::vector<flt64>* RowSums)
+{
+  const int32 BegY     = c_FilterRange;
+  const int32 EndY     = Org->getHeight() - c_FilterRange;
+  const int32 NumBands = (EndY - BegY + c_BandHeight - 1) / c_BandHeight;
+
+  for(int32 CmpIdx = 0; CmpIdx < m_NumComponents; CmpIdx++) { memset(RowSums[CmpIdx].data(), 0, RowSums[CmpIdx].size() * sizeof(flt64)); }
+
+  if(EndY <= BegY) { return 0; } //picture smaller than SSIM window - no valid rows
+
+  if(!m_ThPI.isActive())
+  {
+    xCalcBandStreamedSSIM(Org, Src, GlobalColorShift, BegY, EndY, RowSums, m_StreamRowSCP[0]);
+    return 0;
+  }
+
+  for(int32 b = 0; b < NumBands; b++)
+  {
+    const int32 BandBegY = BegY + b * c_BandHeight;
+    const int32 BandEndY = xMin(BandBegY + c_BandHeight, EndY);
+    m_ThPI.addWaitingTask([this, Org, Src, GlobalColorShift, BandBegY, BandEndY, RowSums](int32 ThreadIdx) { xCalcBandStreamedSSIM(Org, Src, GlobalColorShift, BandBegY, BandEndY, RowSums, m_StreamRowSCP[ThreadIdx]); });
+  }
+  return xMax(NumBands, 0);
+}
+void xIVSSIM::xCalcBandStreamedSSIM(const xPicP* Org, const xPicP* Src, const int32V4& GlobalColorShift, const int32 BegY, const int32 EndY, std::vector<flt64>* RowSums, xPicP* RowSCP)
+{
+  //SSIM rows [BegY, EndY) use SCP rows [BegY - c_FilterRange, EndY + c_FilterRange - 1), so neighboring bands generate c_WindowSize - 1 common rows of SCP twice
+  //every SCP row is read once (by horizontal filtering of all components in lockstep), so RowSCP holds single row only (row y is stored in row y % 1)
+  const int32 Width     = Org->getWidth();
+  const int32 NumPlanes = m_NumComponents;
+
+  xPlaneRows OrgRows[3] = { xPlaneRows(Org, eCmp::LM), xPlaneRows(Org, eCmp::CB), xPlaneRows(Org, eCmp::CR) };
+  xPlaneRows SCPRows[3] = { xPlaneRows(RowSCP->getAddr(eCmp::LM), 0, 0), xPlaneRows(RowSCP->getAddr(eCmp::CB), 0, 0), xPlaneRows(RowSCP->getAddr(eCmp::CR), 0, 0) };
+  flt64*     RowSumsP[3] = { RowSums[0].data(), RowSums[1].data(), RowSums[2].data() };
+
+  auto genRowSCP = [&](const int32 y) { xCorrespPixelShift::xCalcDistAsymmetricRow(Org, Src, y, 0, Width, GlobalColorShift, m_SearchRange, m_CmpWeightsSearch, RowSCP); };
+  xCalcRowsSSIM(OrgRows, SCPRows, NumPlanes, Width, BegY, EndY, true, RowSumsP, genRowSCP);
+}
 
 //===============================================================================================================================================================================================================
 
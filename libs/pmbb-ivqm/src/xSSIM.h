@@ -10,6 +10,7 @@
 #include "xPlane.h"
 #include "xMetricCommon.h"
 #include "xStructSim.h"
+#include "xStructSimBox.h"
 #include "xWeightedSpherically.h"
 #include "xGlobClrDiff.h"
 #include "xShftCompPic.h"
@@ -24,30 +25,110 @@ public:
   using fltTP  = flt64;
   using tFltrF = xStructSim<fltTP, true>::tFltrF;
 
+  static constexpr int32 c_BandHeight        = 64;  //rows processed by single task (using rolling window of horizontally filtered rows)
+  static constexpr int32 c_PyramidBandHeight = 128; //rows of first MS-SSIM sub-scale downsampled by single task (has to be multiple of 1 << (c_NumMultiScales - 1) to keep bands of subsampled chroma planes aligned)
+  static constexpr int32 c_DefaultPrecision  = 64;  //floating point precision of moments and SSIM terms (32 = flt32, 64 = flt64)
+  static constexpr int32 c_MomentCacheSize   = 2;   //number of pictures with moment planes kept in cache (Tst and Ref of current frame)
+  static constexpr int32 c_DefaultSampleStep = 1;   //SSIM is evaluated for every c_DefaultSampleStep-th pixel in x and y (1 = all pixels)
+  static_assert(c_PyramidBandHeight % (1 << (c_NumMultiScales - 1)) == 0);
+
 protected:
   int32V2 m_Size        = { NOT_VALID, NOT_VALID };
   int32   m_BitDepth    = NOT_VALID;
   fltTP   m_C1          = std::numeric_limits<fltTP>::quiet_NaN();
   fltTP   m_C2          = std::numeric_limits<fltTP>::quiet_NaN();
+  int32   m_Precision   = c_DefaultPrecision;
+  int32   m_SampleStep  = c_DefaultSampleStep;
+  int32   m_BoxSize     = c_DefaultBoxSize;
 
   std::vector<flt64> m_RowSums[4];
 
+protected: //moment plane cache - vertically filtered moments (X, X^2) of pictures used in more than one pairing (i.e. Tst and Ref shared by SSIM, MS-SSIM and IV-SSIM)
+  class xMomentPlanes
+  {
+  public:
+    const xPicP*       m_Pic       = nullptr; //picture which moments are stored (nullptr = free slot)
+    int32              m_Precision = NOT_VALID;
+    std::vector<flt32> m_Planes32[4]; //rows of c_NumPicMoms * Width elements for each component
+    std::vector<flt64> m_Planes64[4];
+
+  public:
+    template <class tFlt> tFlt* getPlanes(int32 CmpIdx) { if constexpr(std::is_same_v<tFlt, flt32>) { return m_Planes32[CmpIdx].data(); } else { return m_Planes64[CmpIdx].data(); } }
+  };
+  class xMomentSrc
+  {
+  public:
+    xMomentPlanes* m_Cache = nullptr; //nullptr = moments not cached, calculated for each band
+    bool           m_Fill  = false;   //cache slot was assigned to picture in current call and has to be filled
+  };
+
+  bool          m_UseMomentCache = false;
+  xMomentPlanes m_MomentCache[c_MomentCacheSize];
+
+protected: //rows of single component - row y is located at m_Ptr + (y - m_FirstRow) * m_Stride (allows processing of band-local buffers holding only part of picture, m_Stride == 0 --> single row buffer)
+  class xPlaneRows
+  {
+  public:
+    const uint16* m_Ptr      = nullptr;
+    int32         m_Stride   = 0;
+    int32         m_FirstRow = 0;
+
+  public:
+    xPlaneRows(const uint16* Ptr, int32 Stride, int32 FirstRow) : m_Ptr(Ptr), m_Stride(Stride), m_FirstRow(FirstRow) {}
+    xPlaneRows(const xPicP* Pic, eCmp CmpId) : m_Ptr(Pic->getAddr(CmpId)), m_Stride(Pic->getStride(CmpId)), m_FirstRow(0) {}
+    const uint16* getRow(int32 y) const { return m_Ptr + (y - m_FirstRow) * m_Stride; }
+  };
+
 protected: //MSSSIM 
   xPicP* m_SubPicTst[c_NumMultiScales] = { nullptr };
   xPicP* m_SubPicRef[c_NumMultiScales] = { nullptr };
+  std::vector<flt64> m_SubRowSums[c_NumMultiScales][4]; //sub-scales are calculated concurrently, so each one has own row sums ([0] unused - scale 0 uses m_RowSums)
 
 public:
-  virtual void create (int32V2 Size, int32 BitDepth, int32 Margin, bool EnableMS);
+  virtual void create (int32V2 Size, int32 BitDepth, int32 Margin, bool EnableMS, eCrF ChromaFormat = eCrF::CF444); //ChromaFormat - layout of pictures passed to calcPic* (CF420/CF422 = native chroma planes, not supported by IV-SSIM)
   virtual void destroy();
 
+  void    setPrecision (int32 Precision) { assert(Precision == 32 || Precision == 64); m_Precision = Precision; }
+  int32   getPrecision () const { return m_Precision; }
+
+  //strided (subsampled) evaluation - SSIM is evaluated on regular grid of every SampleStep-th pixel in x and y and averaged over sampled positions (fast approximation, moment cache is not used)
+  void    setSampleStep(int32 SampleStep) { assert(SampleStep >= 1); m_SampleStep = SampleStep; }
+  int32   getSampleStep() const { return m_SampleStep; }
+
+  //box window size of FASTSSIM (BoxSize x BoxSize window, moments taken from summed-area tables)
+  void    setBoxSize   (int32 BoxSize) { assert(BoxSize >= 2 && BoxSize <= c_MaxBoxSize); m_BoxSize = BoxSize; }
+  int32   getBoxSize   () const { return m_BoxSize; }
+
+  //moment planes of first c_MomentCacheSize pictures passed to calcPic* are kept until invalidateMomentCache() is called (has to be called every time content of cached picture changes, i.e. for every frame)
+  void    setUseMomentCache    (bool UseMomentCache) { m_UseMomentCache = UseMomentCache; invalidateMomentCache(); }
+  bool    getUseMomentCache    () const { return m_UseMomentCache; }
+  void    invalidateMomentCache();
+
   flt64V4 calcPicSSIM  (const xPicP* Tst, const xPicP* Ref, bool CalcL = true);
   flt64V4 calcPicMSSSIM(const xPicP* Tst, const xPicP* Ref);
+  flt64V4 calcPicFastSSIM(const xPicP* Tst, const xPicP* Ref); //box window, O(1) cost per pixel, not comparable with SSIM
 
 protected:  
-  flt64   xCalcCmpSSIM(const xPicP* Tst, const xPicP* Ref, eCmp CmpId, bool CalcL);
-  flt64   xCalcRowSSIM(const xPicP* Tst, const xPicP* Ref, eCmp CmpId, const int32 y, bool CalcL);
-
-  static void xDownsamplePic(xPicP* Dst, const xPicP* Src);
+  //xCalcBands* - adds band tasks (returns number of tasks to wait for) or calculates in place if thread pool is not active
+  int32   xCalcBandsPicSSIM(const xPicP* Tst, const xPicP* Ref, bool CalcL, const xMomentSrc& SrcT, const xMomentSrc& SrcR, std::vector<flt64>* RowSums, int32 BandHeight); //all components
+  int32   xCalcBandsSSIM   (const xPicP* Tst, const xPicP* Ref, eCmp CmpId, bool CalcL, const xMomentSrc& SrcT, const xMomentSrc& SrcR, flt64* RowSums, int32 BandHeight);
+  int32   xCalcBandsPicFastSSIM(const xPicP* Tst, const xPicP* Ref, std::vector<flt64>* RowSums); //all components
+  flt64V4 xReducePicSSIM   (std::vector<flt64>* RowSums, const xPicP* Pic, int32 SampleStep); //all components
+  flt64   xReduceRowSums   (std::vector<flt64>& RowSums, int32 Width, int32 Height, int32 SampleStep);
+  void    xCalcRowsSSIM (const xPicP* Tst, const xPicP* Ref, eCmp CmpId, const int32 BegY, const int32 EndY, bool CalcL, const xMomentSrc& SrcT, const xMomentSrc& SrcR, flt64* RowSums);
+  void    xCalcRowsSSIM (const xPlaneRows& Tst, const xPlaneRows& Ref, int32 Width, const int32 BegY, const int32 EndY, bool CalcL, flt64* RowSums); //moment cache is not used
+  //NumPlanes planes of equal width are processed in lockstep, PrepRow(y) is called just before row y of all planes is read (allows generating rows on the fly)
+  template <class tPrepRow> void xCalcRowsSSIM (const xPlaneRows* Tst, const xPlaneRows* Ref, const int32 NumPlanes, int32 Width, const int32 BegY, const int32 EndY, bool CalcL, flt64* const* RowSums, const tPrepRow& PrepRow);
+  template <class tFlt, class tPrepRow> void xCalcRowsSSIMT (const xPlaneRows* Tst, const xPlaneRows* Ref, const int32 NumPlanes, int32 Width, const int32 BegY, const int32 EndY, bool CalcL, flt64* const* RowSums, const tPrepRow& PrepRow);
+  template <class tFlt> void xCalcRowsSSIMCT(const xPicP* Tst, const xPicP* Ref, eCmp CmpId, const int32 BegY, const int32 EndY, bool CalcL, const xMomentSrc& SrcT, const xMomentSrc& SrcR, flt64* RowSums); //uses moment planes
+  template <class tFlt, class tPrepRow> void xCalcRowsSSIMST(const xPlaneRows* Tst, const xPlaneRows* Ref, const int32 NumPlanes, int32 Width, const int32 BegY, const int32 EndY, bool CalcL, flt64* const* RowSums, const tPrepRow& PrepRow); //strided
+  void    xCalcRowsFastSSIM (const xPicP* Tst, const xPicP* Ref, eCmp CmpId, const int32 BegY, const int32 EndY, flt64* RowSums);
+  template <class tFlt> void xCalcRowsMomsT (tFlt* MomentsV, const xPicP* Pic, eCmp CmpId, const int32 BegY, const int32 EndY);
+
+  xMomentSrc xGetMomentSrc(const xPicP* Pic);
+
+  void        xDownsamplePyramid(const xPicP* Tst, const xPicP* Ref, const int32 BegY, const int32 EndY);
+  static void xDownsamplePic    (xPicP* Dst, const xPicP* Src, const int32 BegY, const int32 EndY, const bool LastBand);
 };
 
 //===============================================================================================================================================================================================================
@@ -70,12 +151,25 @@ protected:
   xPicP* m_TstSCP = nullptr; 
   xPicP* m_RefSCP = nullptr;
 
+  std::vector<flt64> m_RowSumsR2T[4]; //row sums of Ref vs TstSCP direction (calculated concurrently with Tst vs RefSCP one, which uses m_RowSums)
+  std::vector<xPicP*> m_StreamRowSCP; //streaming SCP - single row SCP buffer (reused by all bands) - per worker thread
+
 public:
-  virtual void create (int32V2 Size, int32 BitDepth, int32 Margin, bool EnableMS);
+  virtual void create (int32V2 Size, int32 BitDepth, int32 Margin, bool EnableMS, eCrF ChromaFormat = eCrF::CF444);
   virtual void destroy();
 
   flt64 calcPicIVSSIM  (const xPicP* Tst, const xPicP* Ref);
   flt64 calcPicIVSSIM  (const xPicP* Tst, const xPicP* Ref, const xPicP* TstSCP, const xPicP* RefSCP);
+  flt64 calcPicIVSSIMStreamed(const xPicP* Tst, const xPicP* Ref, const int32V4& GlobalColorDiffRef2Tst); //SCP rows are generated by band tasks just ahead of SSIM rows consuming them (no SCP pictures)
+  flt64 calcPicIVFastSSIM(const xPicP* Tst, const xPicP* Ref, const xPicP* TstSCP, const xPicP* RefSCP); //box window variant (FASTSSIM) on shift compensated pictures
+
+protected:
+  void  xCalcPicSSIMsTR(flt64V4& SSIMs_T2R, flt64V4& SSIMs_R2T, const xPicP* Tst, const xPicP* Ref, const xPicP* TstSCP, const xPicP* RefSCP);
+
+  //streaming SCP - Org is compared against SCP generated from Src (Tst vs RefSCP: Org = Tst, Src = Ref), SCP row is generated by IV-PSNR search kernels just before horizontal filtering of all components consumes it
+  void  xInitStreamRowSCP();
+  int32 xCalcBandsStreamedSSIM(const xPicP* Org, const xPicP* Src, const int32V4& GlobalColorShift, std::vector<flt64>* RowSums); //all components
+  void  xCalcBandStreamedSSIM (const xPicP* Org, const xPicP* Src, const int32V4& GlobalColorShift, const int32 BegY, const int32 EndY, std::vector<flt64>* RowSums, xPicP* RowSCP);
 };
 
 //===============================================================================================================================================================================================================
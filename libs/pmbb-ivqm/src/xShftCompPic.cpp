@@ -68,32 +68,8 @@ void xShftCompPic::xGenShftCompPic(xPicI* DstRef, const xPicI* Ref, const xPicI*
 }
 void xShftCompPic::xGenShftCompRow(xPicP* DstRef, const xPicP* Ref, const xPicP* Tst, const int32 y, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights)
 {
-  const int32  Width     = Tst->getWidth ();
-  const int32  TstStride = Tst->getStride();
-  const int32  TstOffset = y * TstStride;
-  const int32  MaxValue  = DstRef->getMaxPelValue();
-
-  const uint16*    TstPtrLm = Tst   ->getAddr(eCmp::LM) + TstOffset;
-  const uint16*    TstPtrCb = Tst   ->getAddr(eCmp::CB) + TstOffset;
-  const uint16*    TstPtrCr = Tst   ->getAddr(eCmp::CR) + TstOffset;
-  uint16* restrict DstPtrLm = DstRef->getAddr(eCmp::LM) + TstOffset;
-  uint16* restrict DstPtrCb = DstRef->getAddr(eCmp::CB) + TstOffset;
-  uint16* restrict DstPtrCr = DstRef->getAddr(eCmp::CR) + TstOffset;
-
-  for(int32 x = 0; x < Width; x++)
-  {
-    const int32V4 CurrTstValue  = int32V4((int32)(TstPtrLm[x]), (int32)(TstPtrCb[x]), (int32)(TstPtrCr[x]), 0) + GlobalColorShift;
-    const int32   BestRefOffset = xCorrespPixelShift::xFindBestPixelWithinBlock(CurrTstValue, Ref, x, y, SearchRange, CmpWeights);
-    int32  RefLm = Ref->getAddr(eCmp::LM)[BestRefOffset];
-    int32  RefCb = Ref->getAddr(eCmp::CB)[BestRefOffset];
-    int32  RefCr = Ref->getAddr(eCmp::CR)[BestRefOffset];
-    uint16 DstLm = (uint16)xClipU(RefLm - GlobalColorShift[0], MaxValue);
-    uint16 DstCb = (uint16)xClipU(RefCb - GlobalColorShift[1], MaxValue);
-    uint16 DstCr = (uint16)xClipU(RefCr - GlobalColorShift[2], MaxValue);
-    DstPtrLm[x] = DstLm;
-    DstPtrCb[x] = DstCb;
-    DstPtrCr[x] = DstCr;
-  }//x
+  //planar search kernels store shift compensated row found by asymmetric search (Tst as test, Ref as reference) - distortion is not needed here
+  xCorrespPixelShift::xCalcDistAsymmetricRow(Tst, Ref, y, 0, Tst->getWidth(), GlobalColorShift, SearchRange, CmpWeights, DstRef);
 }
 void xShftCompPic::xGenShftCompRow(xPicI* DstRef, const xPicI* Ref, const xPicI* Tst, const int32 y, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights)
 {
@@ -12,27 +12,8 @@ namespace PMBB_NAMESPACE {
 // xStructSim
 //===============================================================================================================================================================================================================
 
-template <class fltTP, bool CalcL> fltTP xStructSim<fltTP, CalcL>::CalcPel(const uint16* Tst, const uint16* Ref, int32 StrideT, int32 StrideR, const tFltrF& Filter, fltTP C1, fltTP C2)
+template <class fltTP, bool CalcL> inline fltTP xStructSim<fltTP, CalcL>::xCalcSSIM(fltTP AvgR, fltTP AvgT, fltTP SumR2, fltTP SumT2, fltTP SumRT, fltTP C1, fltTP C2)
 {
-  fltTP SumR = 0, SumT = 0, SumR2 = 0, SumT2 = 0, SumRT = 0;
-
-  for(int32 dy = -c_FilterRange; dy < c_FilterRange; dy++)
-  {
-    for(int32 dx = -c_FilterRange; dx < c_FilterRange; dx++)
-    {
-      fltTP R = Ref[dy * StrideR + dx];
-      fltTP T = Tst[dy * StrideT + dx];
-      fltTP C = Filter[dy + c_FilterRange][dx + c_FilterRange];
-      SumR  += R        * C;
-      SumT  += T        * C;
-      SumR2 += xPow2(R) * C;
-      SumT2 += xPow2(T) * C;
-      SumRT += R*T      * C;
-    }
-  }  
-
-  fltTP AvgR  = SumR;
-  fltTP AvgT  = SumT;
   fltTP VarR2 = SumR2 - xPow2(AvgR);
   fltTP VarT2 = SumT2 - xPow2(AvgT);
   fltTP CovRT = SumRT - AvgR*AvgT;
@@ -58,6 +39,228 @@ template <class fltTP, bool CalcL> fltTP xStructSim<fltTP, CalcL>::CalcPel(const
     return CS;
   }
 }
+template <class fltTP, bool CalcL> fltTP xStructSim<fltTP, CalcL>::CalcPel(const uint16* Tst, const uint16* Ref, int32 StrideT, int32 StrideR, const tFltrF& Filter, fltTP C1, fltTP C2)
+{
+  fltTP SumR = 0, SumT = 0, SumR2 = 0, SumT2 = 0, SumRT = 0;
+
+  for(int32 dy = -c_FilterRange; dy < c_FilterRange; dy++)
+  {
+    for(int32 dx = -c_FilterRange; dx < c_FilterRange; dx++)
+    {
+      fltTP R = Ref[dy * StrideR + dx];
+      fltTP T = Tst[dy * StrideT + dx];
+      fltTP C = Filter[dy + c_FilterRange][dx + c_FilterRange];
+      SumR  += R        * C;
+      SumT  += T        * C;
+      SumR2 += xPow2(R) * C;
+      SumT2 += xPow2(T) * C;
+      SumRT += R*T      * C;
+    }
+  }  
+
+  return xCalcSSIM(SumR, SumT, SumR2, SumT2, SumRT, C1, C2);
+}
+template <class fltTP, bool CalcL> void xStructSim<fltTP, CalcL>::FilterRowH(fltTP* restrict MomentsH, fltTP* restrict Moments, const uint16* Tst, const uint16* Ref, int32 Width, const tFltrS& Filter)
+{
+  xCalcMoments(Moments, Tst, Ref, Width);
+  xFilterPlanesH(MomentsH, Moments, Width, c_NumMoments, Filter);
+}
+template <class fltTP, bool CalcL> flt64 xStructSim<fltTP, CalcL>::FilterRowV(fltTP* restrict MomentsV, const fltTP* const* RowsH, int32 Width, const tFltrS& Filter, fltTP C1, fltTP C2)
+{
+  return xFilterRowV(MomentsV, RowsH, Width, c_FilterRange, Width - c_FilterRange, Filter, C1, C2);
+}
+template <class fltTP, bool CalcL> void xStructSim<fltTP, CalcL>::FilterRowH(fltTP* restrict MomentsH, fltTP* restrict Moments, const uint16* Src, int32 Width, const tFltrS& Filter)
+{
+  fltTP* restrict MomX  = Moments;
+  fltTP* restrict MomX2 = Moments + 1 * Width;
+
+  int32 MomTailX = 0;
+  if constexpr(c_NumPelsSIMD > 0)
+  {
+    MomTailX = Width - Width % c_NumPelsSIMD;
+    if(MomTailX > 0) { xCalcMomentsSIMD(Moments, Src, Width, 0, MomTailX); }
+  }
+  for(int32 x = MomTailX; x < Width; x++)
+  {
+    fltTP X = Src[x];
+    MomX [x] = X;
+    MomX2[x] = xPow2(X);
+  }
+
+  xFilterPlanesH(MomentsH, Moments, Width, c_NumPicMoms, Filter);
+}
+template <class fltTP, bool CalcL> void xStructSim<fltTP, CalcL>::FilterRowV(fltTP* restrict MomentsV, const fltTP* const* RowsH, int32 Width, const tFltrS& Filter)
+{
+  const int32 BegX  = c_FilterRange;
+  const int32 EndX  = Width - c_FilterRange;
+  int32       TailX = BegX;
+  if constexpr(c_NumPelsSIMD > 0)
+  {
+    TailX = EndX - (EndX - BegX) % c_NumPelsSIMD;
+    if(TailX > BegX) { xFilterRowVSIMD(MomentsV, RowsH, Width, c_NumPicMoms, BegX, TailX, Filter); }
+  }
+
+  xFilterPlanesV(MomentsV, RowsH, Width, c_NumPicMoms, TailX, EndX, Filter);
+}
+template <class fltTP, bool CalcL> void xStructSim<fltTP, CalcL>::FilterRowHRT(fltTP* restrict MomentsH, fltTP* restrict Moments, const uint16* Tst, const uint16* Ref, int32 Width, const tFltrS& Filter)
+{
+  int32 MomTailX = 0;
+  if constexpr(c_NumPelsSIMD > 0)
+  {
+    MomTailX = Width - Width % c_NumPelsSIMD;
+    if(MomTailX > 0) { xCalcMomRTSIMD(Moments, Tst, Ref, 0, MomTailX); }
+  }
+  for(int32 x = MomTailX; x < Width; x++)
+  {
+    fltTP R = Ref[x];
+    fltTP T = Tst[x];
+    Moments[x] = R*T;
+  }
+
+  xFilterPlanesH(MomentsH, Moments, Width, 1, Filter);
+}
+template <class fltTP, bool CalcL> flt64 xStructSim<fltTP, CalcL>::FilterRowVRT(fltTP* restrict MomentsV, const fltTP* const* RowsH, const fltTP* MomentsT, const fltTP* MomentsR, int32 Width, const tFltrS& Filter, fltTP C1, fltTP C2)
+{
+  const int32 BegX   = c_FilterRange;
+  const int32 EndX   = Width - c_FilterRange;
+  int32       TailX  = BegX;
+  flt64       RowSum = 0;
+  if constexpr(c_NumPelsSIMD > 0)
+  {
+    TailX = EndX - (EndX - BegX) % c_NumPelsSIMD;
+    if(TailX > BegX) { RowSum = xFilterRowVRTSIMD(RowsH, MomentsT, MomentsR, Width, BegX, TailX, Filter, C1, C2); }
+  }
+
+  xFilterPlanesV(MomentsV, RowsH, Width, 1, TailX, EndX, Filter);
+
+  const fltTP* restrict AvgR  = MomentsR;
+  const fltTP* restrict AvgT  = MomentsT;
+  const fltTP* restrict SumR2 = MomentsR + Width;
+  const fltTP* restrict SumT2 = MomentsT + Width;
+  const fltTP* restrict SumRT = MomentsV;
+
+  for(int32 x = TailX; x < EndX; x++) { RowSum += xCalcSSIM(AvgR[x], AvgT[x], SumR2[x], SumT2[x], SumRT[x], C1, C2); }
+  return RowSum;
+}
+template <class fltTP, bool CalcL> void xStructSim<fltTP, CalcL>::FilterRowHStrided(fltTP* restrict MomentsH, fltTP* restrict Moments, uint16* restrict Phases, const uint16* Tst, const uint16* Ref, int32 Width, int32 Step, const tFltrS& Filter)
+{
+  const int32 PhaseWidth = getPhaseWidth(Width, Step);
+  const int32 NumSampled = getNumSampled(Width, Step);
+  const int32 SlotSize   = c_NumMoments * PhaseWidth;
+
+  //split row into phases (last column of some phases is padded with zeros - never used by valid columns)
+  for(int32 p = 0; p < Step; p++)
+  {
+    uint16* restrict PhaseT = Phases + p * PhaseWidth;
+    uint16* restrict PhaseR = Phases + (Step + p) * PhaseWidth;
+    for(int32 k = 0, x = p; k < PhaseWidth; k++, x += Step)
+    {
+      PhaseT[k] = x < Width ? Tst[x] : 0;
+      PhaseR[k] = x < Width ? Ref[x] : 0;
+    }
+    xCalcMoments(Moments + p * SlotSize, Phases + p * PhaseWidth, Phases + (Step + p) * PhaseWidth, PhaseWidth);
+  }
+
+  //sampled column k covers pixels [k * Step, k * Step + c_WindowSize), so filter tap i reads column k + i / Step of phase i % Step
+  const fltTP* Taps[c_WindowSize];
+  for(int32 i = 0; i < c_WindowSize; i++) { Taps[i] = Moments + (i % Step) * SlotSize + i / Step; }
+
+  int32 TailX = 0;
+  if constexpr(c_NumPelsSIMD > 0)
+  {
+    TailX = NumSampled - NumSampled % c_NumPelsSIMD;
+    if(TailX > 0) { xFilterRowVSIMD(MomentsH, Taps, PhaseWidth, c_NumMoments, 0, TailX, Filter); }
+  }
+  xFilterPlanesV(MomentsH, Taps, PhaseWidth, c_NumMoments, TailX, NumSampled, Filter);
+}
+template <class fltTP, bool CalcL> flt64 xStructSim<fltTP, CalcL>::FilterRowVStrided(fltTP* restrict MomentsV, const fltTP* const* RowsH, int32 Width, int32 Step, const tFltrS& Filter, fltTP C1, fltTP C2)
+{
+  return xFilterRowV(MomentsV, RowsH, getPhaseWidth(Width, Step), 0, getNumSampled(Width, Step), Filter, C1, C2);
+}
+template <class fltTP, bool CalcL> void xStructSim<fltTP, CalcL>::xCalcMoments(fltTP* restrict Moments, const uint16* Tst, const uint16* Ref, int32 Width)
+{
+  fltTP* restrict MomR  = Moments;
+  fltTP* restrict MomT  = Moments + 1 * Width;
+  fltTP* restrict MomR2 = Moments + 2 * Width;
+  fltTP* restrict MomT2 = Moments + 3 * Width;
+  fltTP* restrict MomRT = Moments + 4 * Width;
+
+  int32 MomTailX = 0;
+  if constexpr(c_NumPelsSIMD > 0)
+  {
+    MomTailX = Width - Width % c_NumPelsSIMD;
+    if(MomTailX > 0) { xCalcMomentsSIMD(Moments, Tst, Ref, Width, 0, MomTailX); }
+  }
+  for(int32 x = MomTailX; x < Width; x++)
+  {
+    fltTP R = Ref[x];
+    fltTP T = Tst[x];
+    MomR [x] = R;
+    MomT [x] = T;
+    MomR2[x] = xPow2(R);
+    MomT2[x] = xPow2(T);
+    MomRT[x] = R*T;
+  }
+}
+template <class fltTP, bool CalcL> flt64 xStructSim<fltTP, CalcL>::xFilterRowV(fltTP* restrict MomentsV, const fltTP* const* RowsH, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, fltTP C1, fltTP C2)
+{
+  int32       TailX  = BegX;
+  flt64       RowSum = 0;
+  if constexpr(c_NumPelsSIMD > 0)
+  {
+    TailX = EndX - (EndX - BegX) % c_NumPelsSIMD;
+    if(TailX > BegX) { RowSum = xFilterRowVSIMD(RowsH, Width, BegX, TailX, Filter, C1, C2); }
+  }
+
+  xFilterPlanesV(MomentsV, RowsH, Width, c_NumMoments, TailX, EndX, Filter);
+
+  const fltTP* restrict AvgR  = MomentsV;
+  const fltTP* restrict AvgT  = MomentsV + 1 * Width;
+  const fltTP* restrict SumR2 = MomentsV + 2 * Width;
+  const fltTP* restrict SumT2 = MomentsV + 3 * Width;
+  const fltTP* restrict SumRT = MomentsV + 4 * Width;
+
+  for(int32 x = TailX; x < EndX; x++) { RowSum += xCalcSSIM(AvgR[x], AvgT[x], SumR2[x], SumT2[x], SumRT[x], C1, C2); }
+  return RowSum;
+}
+template <class fltTP, bool CalcL> void xStructSim<fltTP, CalcL>::xFilterPlanesH(fltTP* restrict MomentsH, const fltTP* restrict Moments, int32 Width, int32 NumPlanes, const tFltrS& Filter)
+{
+  const int32 BegX  = c_FilterRange;
+  const int32 EndX  = Width - c_FilterRange;
+  int32       TailX = BegX;
+  if constexpr(c_NumPelsSIMD > 0)
+  {
+    TailX = EndX - (EndX - BegX) % c_NumPelsSIMD;
+    if(TailX > BegX) { xFilterRowHSIMD(MomentsH, Moments, Width, NumPlanes, BegX, TailX, Filter); }
+  }
+  for(int32 m = 0; m < NumPlanes; m++)
+  {
+    const fltTP* restrict Src = Moments  + m * Width;
+    fltTP*       restrict Dst = MomentsH + m * Width;
+    for(int32 x = TailX; x < EndX; x++)
+    {
+      fltTP Sum = 0;
+      for(int32 dx = -c_FilterRange; dx < c_FilterRange; dx++) { Sum += Src[x + dx] * (fltTP)Filter[dx + c_FilterRange]; }
+      Dst[x] = Sum;
+    }
+  }
+}
+template <class fltTP, bool CalcL> void xStructSim<fltTP, CalcL>::xFilterPlanesV(fltTP* restrict MomentsV, const fltTP* const* RowsH, int32 Width, int32 NumPlanes, int32 BegX, int32 EndX, const tFltrS& Filter)
+{
+  for(int32 m = 0; m < NumPlanes; m++)
+  {
+    fltTP* restrict Dst = MomentsV + m * Width;
+    const fltTP C0 = (fltTP)Filter[0];
+    const fltTP* restrict Src0 = RowsH[0] + m * Width;
+    for(int32 x = BegX; x < EndX; x++) { Dst[x] = Src0[x] * C0; }
+    for(int32 dy = 1; dy < c_WindowSize; dy++)
+    {
+      const fltTP C = (fltTP)Filter[dy];
+      const fltTP* restrict Src = RowsH[dy] + m * Width;
+      for(int32 x = BegX; x < EndX; x++) { Dst[x] += Src[x] * C; }
+    }
+  }
+}
 
 //---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
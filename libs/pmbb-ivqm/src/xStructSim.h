@@ -9,6 +9,22 @@
 #include "xVec.h"
 #include <array>
 
+//AVX implementation
+#if X_SIMD_CAN_USE_AVX && __has_include("xStructSimAVX.h")
+#define X_STRUCTSIM_CAN_USE_AVX 1
+#include "xStructSimAVX.h"
+#else
+#define X_STRUCTSIM_CAN_USE_AVX 0
+#endif
+
+//AVX512 implementation
+#if X_SIMD_CAN_USE_AVX512 && __has_include("xStructSimAVX512.h")
+#define X_STRUCTSIM_CAN_USE_AVX512 1
+#include "xStructSimAVX512.h"
+#else
+#define X_STRUCTSIM_CAN_USE_AVX512 0
+#endif
+
 namespace PMBB_NAMESPACE {
 
 //===============================================================================================================================================================================================================
@@ -21,6 +37,69 @@ public:
 
 public:
   static fltTP CalcPel(const uint16* Tst, const uint16* Ref, int32 StrideT, int32 StrideR, const tFltrF& Filter, fltTP C1, fltTP C2); //uses gaussian filter
+
+  //separable gaussian filter - moments are stored as c_NumMoments planes of Width elements each, only columns [c_FilterRange, Width - c_FilterRange) of filtered moments are valid
+  //FilterRowH - calculates moments of one row (Moments) and filters them horizontally (MomentsH)
+  //FilterRowV - filters vertically c_WindowSize horizontally filtered rows (RowsH[0] is the top one) and returns sum of SSIM over row (accumulated in flt64)
+  static void  FilterRowH(fltTP* restrict MomentsH, fltTP* restrict Moments, const uint16* Tst, const uint16* Ref, int32 Width, const tFltrS& Filter);
+  static flt64 FilterRowV(fltTP* restrict MomentsV, const fltTP* const* RowsH, int32 Width, const tFltrS& Filter, fltTP C1, fltTP C2);
+
+  //moment plane cache - moments of single picture (X, X^2) are filtered once and shared between pairings, so only cross moment (RT) has to be filtered for each pair of pictures
+  //FilterRowH   - calculates moments of one row of single picture (c_NumPicMoms planes) and filters them horizontally
+  //FilterRowV   - filters vertically moments of single picture and stores them in MomentsV (c_NumPicMoms planes)
+  //FilterRowHRT - calculates cross moment (RT) of one row and filters it horizontally (single plane)
+  //FilterRowVRT - filters vertically cross moment and returns sum of SSIM over row, remaining moments are taken from vertically filtered moments of Tst and Ref (MomentsT, MomentsR)
+  static void  FilterRowH  (fltTP* restrict MomentsH, fltTP* restrict Moments, const uint16* Src, int32 Width, const tFltrS& Filter);
+  static void  FilterRowV  (fltTP* restrict MomentsV, const fltTP* const* RowsH, int32 Width, const tFltrS& Filter);
+  static void  FilterRowHRT(fltTP* restrict MomentsH, fltTP* restrict Moments, const uint16* Tst, const uint16* Ref, int32 Width, const tFltrS& Filter);
+  static flt64 FilterRowVRT(fltTP* restrict MomentsV, const fltTP* const* RowsH, const fltTP* MomentsT, const fltTP* MomentsR, int32 Width, const tFltrS& Filter, fltTP C1, fltTP C2);
+
+  //strided (subsampled) evaluation - SSIM is calculated only for every Step-th column (x = c_FilterRange + k * Step) of row
+  //pixels of row are split into Step phases (phase p holds pixels p, p + Step, p + 2*Step, ...), so horizontal filter of sampled columns is a sum of shifted phase rows,
+  //moments are stored as c_NumMoments planes of getPhaseWidth() elements each, only first getNumSampled() columns of filtered moments are valid
+  //FilterRowHStrided - Phases has to hold 2 * Step * getPhaseWidth() elements, Moments has to hold Step * c_NumMoments * getPhaseWidth() elements
+  //FilterRowVStrided - Width is the width of picture (not the phase width)
+  static void  FilterRowHStrided(fltTP* restrict MomentsH, fltTP* restrict Moments, uint16* restrict Phases, const uint16* Tst, const uint16* Ref, int32 Width, int32 Step, const tFltrS& Filter);
+  static flt64 FilterRowVStrided(fltTP* restrict MomentsV, const fltTP* const* RowsH, int32 Width, int32 Step, const tFltrS& Filter, fltTP C1, fltTP C2);
+  static int32 getPhaseWidth(int32 Width, int32 Step) { return (Width + Step - 1) / Step; }
+  static int32 getNumSampled(int32 Width, int32 Step) { return xMax(Width - 2 * c_FilterRange + Step - 1, 0) / Step; }
+
+protected:
+  static inline fltTP xCalcSSIM(fltTP AvgR, fltTP AvgT, fltTP SumR2, fltTP SumT2, fltTP SumRT, fltTP C1, fltTP C2);
+  static void  xCalcMoments  (fltTP* restrict Moments, const uint16* Tst, const uint16* Ref, int32 Width);
+  static flt64 xFilterRowV   (fltTP* restrict MomentsV, const fltTP* const* RowsH, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, fltTP C1, fltTP C2);
+  static void xFilterPlanesH(fltTP* restrict MomentsH, const fltTP* restrict Moments, int32 Width, int32 NumPlanes, const tFltrS& Filter);
+  static void xFilterPlanesV(fltTP* restrict MomentsV, const fltTP* const* RowsH, int32 Width, int32 NumPlanes, int32 BegX, int32 EndX, const tFltrS& Filter); //scalar only
+
+  //SIMD - processes groups of c_NumPelsSIMD pixels within columns [BegX, EndX), remaining columns are processed by scalar code
+#if   X_STRUCTSIM_CAN_USE_AVX512
+  static constexpr int32 c_NumPelsSIMD = xStructSimAVX512::c_NumPels<fltTP>;
+  static inline void  xCalcMomentsSIMD (fltTP* restrict Moments , const uint16* Tst, const uint16* Ref, int32 Width, int32 BegX, int32 EndX) { xStructSimAVX512::CalcMoments(Moments, Tst, Ref, Width, BegX, EndX); }
+  static inline void  xCalcMomentsSIMD (fltTP* restrict Moments , const uint16* Src, int32 Width, int32 BegX, int32 EndX) { xStructSimAVX512::CalcMoments(Moments, Src, Width, BegX, EndX); }
+  static inline void  xCalcMomRTSIMD   (fltTP* restrict Moments , const uint16* Tst, const uint16* Ref, int32 BegX, int32 EndX) { xStructSimAVX512::CalcMomRT(Moments, Tst, Ref, BegX, EndX); }
+  static inline void  xFilterRowHSIMD  (fltTP* restrict MomentsH, const fltTP* restrict Moments, int32 Width, int32 NumPlanes, int32 BegX, int32 EndX, const tFltrS& Filter) { xStructSimAVX512::FilterRowH(MomentsH, Moments, Width, NumPlanes, BegX, EndX, Filter); }
+  static inline void  xFilterRowVSIMD  (fltTP* restrict MomentsV, const fltTP* const* RowsH, int32 Width, int32 NumPlanes, int32 BegX, int32 EndX, const tFltrS& Filter) { xStructSimAVX512::FilterRowV(MomentsV, RowsH, Width, NumPlanes, BegX, EndX, Filter); }
+  static inline flt64 xFilterRowVSIMD  (const fltTP* const* RowsH, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, fltTP C1, fltTP C2) { return xStructSimAVX512::FilterRowV<CalcL>(RowsH, Width, BegX, EndX, Filter, C1, C2); }
+  static inline flt64 xFilterRowVRTSIMD(const fltTP* const* RowsH, const fltTP* MomentsT, const fltTP* MomentsR, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, fltTP C1, fltTP C2) { return xStructSimAVX512::FilterRowVRT<CalcL>(RowsH, MomentsT, MomentsR, Width, BegX, EndX, Filter, C1, C2); }
+#elif X_STRUCTSIM_CAN_USE_AVX
+  static constexpr int32 c_NumPelsSIMD = xStructSimAVX::c_NumPels<fltTP>;
+  static inline void  xCalcMomentsSIMD (fltTP* restrict Moments , const uint16* Tst, const uint16* Ref, int32 Width, int32 BegX, int32 EndX) { xStructSimAVX::CalcMoments(Moments, Tst, Ref, Width, BegX, EndX); }
+  static inline void  xCalcMomentsSIMD (fltTP* restrict Moments , const uint16* Src, int32 Width, int32 BegX, int32 EndX) { xStructSimAVX::CalcMoments(Moments, Src, Width, BegX, EndX); }
+  static inline void  xCalcMomRTSIMD   (fltTP* restrict Moments , const uint16* Tst, const uint16* Ref, int32 BegX, int32 EndX) { xStructSimAVX::CalcMomRT(Moments, Tst, Ref, BegX, EndX); }
+  static inline void  xFilterRowHSIMD  (fltTP* restrict MomentsH, const fltTP* restrict Moments, int32 Width, int32 NumPlanes, int32 BegX, int32 EndX, const tFltrS& Filter) { xStructSimAVX::FilterRowH(MomentsH, Moments, Width, NumPlanes, BegX, EndX, Filter); }
+  static inline void  xFilterRowVSIMD  (fltTP* restrict MomentsV, const fltTP* const* RowsH, int32 Width, int32 NumPlanes, int32 BegX, int32 EndX, const tFltrS& Filter) { xStructSimAVX::FilterRowV(MomentsV, RowsH, Width, NumPlanes, BegX, EndX, Filter); }
+  static inline flt64 xFilterRowVSIMD  (const fltTP* const* RowsH, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, fltTP C1, fltTP C2) { return xStructSimAVX::FilterRowV<CalcL>(RowsH, Width, BegX, EndX, Filter, C1, C2); }
+  static inline flt64 xFilterRowVRTSIMD(const fltTP* const* RowsH, const fltTP* MomentsT, const fltTP* MomentsR, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, fltTP C1, fltTP C2) { return xStructSimAVX::FilterRowVRT<CalcL>(RowsH, MomentsT, MomentsR, Width, BegX, EndX, Filter, C1, C2); }
+#else //X_STRUCTSIM_CAN_USE_???
+  static constexpr int32 c_NumPelsSIMD = 0; //scalar only
+  static inline void  xCalcMomentsSIMD (fltTP*, const uint16*, const uint16*, int32, int32, int32) {}
+  static inline void  xCalcMomentsSIMD (fltTP*, const uint16*, int32, int32, int32) {}
+  static inline void  xCalcMomRTSIMD   (fltTP*, const uint16*, const uint16*, int32, int32) {}
+  static inline void  xFilterRowHSIMD  (fltTP*, const fltTP*, int32, int32, int32, int32, const tFltrS&) {}
+  static inline void  xFilterRowVSIMD  (fltTP*, const fltTP* const*, int32, int32, int32, int32, const tFltrS&) {}
+  static inline flt64 xFilterRowVSIMD  (const fltTP* const*, int32, int32, int32, const tFltrS&, fltTP, fltTP) { return 0; }
+  static inline flt64 xFilterRowVRTSIMD(const fltTP* const*, const fltTP*, const fltTP*, int32, int32, int32, const tFltrS&, fltTP, fltTP) { return 0; }
+#endif //X_STRUCTSIM_CAN_USE_???
 };
 
 //---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,362 @@
+/*
+    SPDX-FileCopyrightText: 2019-2024 Jakub Stankowski <jakub.stankowski@put.poznan.pl>
+    SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "xStructSimAVX.h"
+
+#if X_SIMD_CAN_USE_AVX
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+// xStructSimAVX
+//===============================================================================================================================================================================================================
+
+template <bool CalcL> inline __m256 xStructSimAVX::xCalcSSIM(const __m256& AvgR, const __m256& AvgT, const __m256& SumR2, const __m256& SumT2, const __m256& SumRT, const __m256& C1, const __m256& C2)
+{
+  const __m256 Two    = _mm256_set1_ps(2.0f);
+  const __m256 AvgRT  = _mm256_mul_ps(AvgR, AvgT);
+  const __m256 AvgR2  = _mm256_mul_ps(AvgR, AvgR);
+  const __m256 AvgT2  = _mm256_mul_ps(AvgT, AvgT);
+  const __m256 VarR2  = _mm256_sub_ps(SumR2, AvgR2);
+  const __m256 VarT2  = _mm256_sub_ps(SumT2, AvgT2);
+  const __m256 CovRT  = _mm256_sub_ps(SumRT, AvgRT);
+  const __m256 CS     = _mm256_div_ps(_mm256_add_ps(_mm256_mul_ps(Two, CovRT), C2), _mm256_add_ps(_mm256_add_ps(VarR2, VarT2), C2)); //"Contrast"*"Similarity"
+  if constexpr (CalcL)
+  {
+    const __m256 L    = _mm256_div_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(Two, AvgR), AvgT), C1), _mm256_add_ps(_mm256_add_ps(AvgR2, AvgT2), C1)); //"Luminance"
+    const __m256 SSIM = _mm256_mul_ps(L, CS);
+    return SSIM;
+  }
+  else { return CS; }
+}
+template <bool CalcL> inline __m256d xStructSimAVX::xCalcSSIM(const __m256d& AvgR, const __m256d& AvgT, const __m256d& SumR2, const __m256d& SumT2, const __m256d& SumRT, const __m256d& C1, const __m256d& C2)
+{
+  const __m256d Two    = _mm256_set1_pd(2.0);
+  const __m256d AvgRT  = _mm256_mul_pd(AvgR, AvgT);
+  const __m256d AvgR2  = _mm256_mul_pd(AvgR, AvgR);
+  const __m256d AvgT2  = _mm256_mul_pd(AvgT, AvgT);
+  const __m256d VarR2  = _mm256_sub_pd(SumR2, AvgR2);
+  const __m256d VarT2  = _mm256_sub_pd(SumT2, AvgT2);
+  const __m256d CovRT  = _mm256_sub_pd(SumRT, AvgRT);
+  const __m256d CS     = _mm256_div_pd(_mm256_add_pd(_mm256_mul_pd(Two, CovRT), C2), _mm256_add_pd(_mm256_add_pd(VarR2, VarT2), C2)); //"Contrast"*"Similarity"
+  if constexpr (CalcL)
+  {
+    const __m256d L    = _mm256_div_pd(_mm256_add_pd(_mm256_mul_pd(_mm256_mul_pd(Two, AvgR), AvgT), C1), _mm256_add_pd(_mm256_add_pd(AvgR2, AvgT2), C1)); //"Luminance"
+    const __m256d SSIM = _mm256_mul_pd(L, CS);
+    return SSIM;
+  }
+  else { return CS; }
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// flt32
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void xStructSimAVX::CalcMoments(flt32* restrict Moments, const uint16* Tst, const uint16* Ref, int32 Width, int32 BegX, int32 EndX)
+{
+  constexpr int32 NumPels = c_NumPels<flt32>;
+  assert(((EndX - BegX) % NumPels) == 0);
+
+  flt32* restrict MomR  = Moments;
+  flt32* restrict MomT  = Moments + 1 * Width;
+  flt32* restrict MomR2 = Moments + 2 * Width;
+  flt32* restrict MomT2 = Moments + 3 * Width;
+  flt32* restrict MomRT = Moments + 4 * Width;
+
+  for(int32 x = BegX; x < EndX; x += NumPels)
+  {
+    __m256 R = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(Ref + x))));
+    __m256 T = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(Tst + x))));
+    _mm256_storeu_ps(MomR  + x, R);
+    _mm256_storeu_ps(MomT  + x, T);
+    _mm256_storeu_ps(MomR2 + x, _mm256_mul_ps(R, R));
+    _mm256_storeu_ps(MomT2 + x, _mm256_mul_ps(T, T));
+    _mm256_storeu_ps(MomRT + x, _mm256_mul_ps(R, T));
+  }
+}
+void xStructSimAVX::CalcMoments(flt32* restrict Moments, const uint16* Src, int32 Width, int32 BegX, int32 EndX)
+{
+  constexpr int32 NumPels = c_NumPels<flt32>;
+  assert(((EndX - BegX) % NumPels) == 0);
+
+  flt32* restrict MomX  = Moments;
+  flt32* restrict MomX2 = Moments + 1 * Width;
+
+  for(int32 x = BegX; x < EndX; x += NumPels)
+  {
+    __m256 X = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(Src + x))));
+    _mm256_storeu_ps(MomX  + x, X);
+    _mm256_storeu_ps(MomX2 + x, _mm256_mul_ps(X, X));
+  }
+}
+void xStructSimAVX::CalcMomRT(flt32* restrict Moments, const uint16* Tst, const uint16* Ref, int32 BegX, int32 EndX)
+{
+  constexpr int32 NumPels = c_NumPels<flt32>;
+  assert(((EndX - BegX) % NumPels) == 0);
+
+  for(int32 x = BegX; x < EndX; x += NumPels)
+  {
+    __m256 R = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(Ref + x))));
+    __m256 T = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(Tst + x))));
+    _mm256_storeu_ps(Moments + x, _mm256_mul_ps(R, T));
+  }
+}
+void xStructSimAVX::FilterRowH(flt32* restrict MomentsH, const flt32* restrict Moments, int32 Width, int32 NumPlanes, int32 BegX, int32 EndX, const tFltrS& Filter)
+{
+  constexpr int32 NumPels = c_NumPels<flt32>;
+  assert(((EndX - BegX) % NumPels) == 0);
+
+  __m256 FilterV[c_WindowSize];
+  for(int32 i = 0; i < c_WindowSize; i++) { FilterV[i] = _mm256_set1_ps((flt32)Filter[i]); }
+
+  for(int32 m = 0; m < NumPlanes; m++)
+  {
+    const flt32* restrict Src = Moments  + m * Width - c_FilterRange;
+    flt32*       restrict Dst = MomentsH + m * Width;
+    for(int32 x = BegX; x < EndX; x += NumPels)
+    {
+      __m256 Sum = _mm256_mul_ps(_mm256_loadu_ps(Src + x), FilterV[0]);
+      for(int32 i = 1; i < c_WindowSize; i++) { Sum = _mm256_add_ps(Sum, _mm256_mul_ps(_mm256_loadu_ps(Src + x + i), FilterV[i])); }
+      _mm256_storeu_ps(Dst + x, Sum);
+    }
+  }
+}
+void xStructSimAVX::FilterRowV(flt32* restrict MomentsV, const flt32* const* RowsH, int32 Width, int32 NumPlanes, int32 BegX, int32 EndX, const tFltrS& Filter)
+{
+  constexpr int32 NumPels = c_NumPels<flt32>;
+  assert(((EndX - BegX) % NumPels) == 0);
+
+  __m256 FilterV[c_WindowSize];
+  for(int32 i = 0; i < c_WindowSize; i++) { FilterV[i] = _mm256_set1_ps((flt32)Filter[i]); }
+
+  for(int32 m = 0; m < NumPlanes; m++)
+  {
+    for(int32 x = BegX; x < EndX; x += NumPels)
+    {
+      const int32 Offset = m * Width + x;
+      __m256 Sum = _mm256_mul_ps(_mm256_loadu_ps(RowsH[0] + Offset), FilterV[0]);
+      for(int32 i = 1; i < c_WindowSize; i++) { Sum = _mm256_add_ps(Sum, _mm256_mul_ps(_mm256_loadu_ps(RowsH[i] + Offset), FilterV[i])); }
+      _mm256_storeu_ps(MomentsV + Offset, Sum);
+    }
+  }
+}
+template <bool CalcL> flt64 xStructSimAVX::FilterRowV(const flt32* const* RowsH, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, flt32 C1, flt32 C2)
+{
+  constexpr int32 NumPels = c_NumPels<flt32>;
+  assert(((EndX - BegX) % NumPels) == 0);
+
+  __m256 FilterV[c_WindowSize];
+  for(int32 i = 0; i < c_WindowSize; i++) { FilterV[i] = _mm256_set1_ps((flt32)Filter[i]); }
+  const __m256 C1V = _mm256_set1_ps(C1);
+  const __m256 C2V = _mm256_set1_ps(C2);
+
+  __m256d RowSumV = _mm256_setzero_pd(); //flt64 accumulator
+  for(int32 x = BegX; x < EndX; x += NumPels)
+  {
+    __m256 Mom[c_NumMoments];
+    for(int32 m = 0; m < c_NumMoments; m++)
+    {
+      const int32 Offset = m * Width + x;
+      __m256 Sum = _mm256_mul_ps(_mm256_loadu_ps(RowsH[0] + Offset), FilterV[0]);
+      for(int32 i = 1; i < c_WindowSize; i++) { Sum = _mm256_add_ps(Sum, _mm256_mul_ps(_mm256_loadu_ps(RowsH[i] + Offset), FilterV[i])); }
+      Mom[m] = Sum;
+    }
+    __m256 SSIM = xCalcSSIM<CalcL>(Mom[0], Mom[1], Mom[2], Mom[3], Mom[4], C1V, C2V);
+    RowSumV = _mm256_add_pd(RowSumV, _mm256_add_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(SSIM)), _mm256_cvtps_pd(_mm256_extractf128_ps(SSIM, 1))));
+  }
+
+  __m128d RowSum = _mm_add_pd(_mm256_castpd256_pd128(RowSumV), _mm256_extractf128_pd(RowSumV, 1));
+  RowSum = _mm_hadd_pd(RowSum, RowSum);
+  return _mm_cvtsd_f64(RowSum);
+}
+template <bool CalcL> flt64 xStructSimAVX::FilterRowVRT(const flt32* const* RowsH, const flt32* MomentsT, const flt32* MomentsR, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, flt32 C1, flt32 C2)
+{
+  constexpr int32 NumPels = c_NumPels<flt32>;
+  assert(((EndX - BegX) % NumPels) == 0);
+
+  __m256 FilterV[c_WindowSize];
+  for(int32 i = 0; i < c_WindowSize; i++) { FilterV[i] = _mm256_set1_ps((flt32)Filter[i]); }
+  const __m256 C1V = _mm256_set1_ps(C1);
+  const __m256 C2V = _mm256_set1_ps(C2);
+
+  __m256d RowSumV = _mm256_setzero_pd(); //flt64 accumulator
+  for(int32 x = BegX; x < EndX; x += NumPels)
+  {
+    __m256 SumRT = _mm256_mul_ps(_mm256_loadu_ps(RowsH[0] + x), FilterV[0]);
+    for(int32 i = 1; i < c_WindowSize; i++) { SumRT = _mm256_add_ps(SumRT, _mm256_mul_ps(_mm256_loadu_ps(RowsH[i] + x), FilterV[i])); }
+    const __m256 AvgR  = _mm256_loadu_ps(MomentsR + x        );
+    const __m256 AvgT  = _mm256_loadu_ps(MomentsT + x        );
+    const __m256 SumR2 = _mm256_loadu_ps(MomentsR + x + Width);
+    const __m256 SumT2 = _mm256_loadu_ps(MomentsT + x + Width);
+    __m256 SSIM = xCalcSSIM<CalcL>(AvgR, AvgT, SumR2, SumT2, SumRT, C1V, C2V);
+    RowSumV = _mm256_add_pd(RowSumV, _mm256_add_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(SSIM)), _mm256_cvtps_pd(_mm256_extractf128_ps(SSIM, 1))));
+  }
+
+  __m128d RowSum = _mm_add_pd(_mm256_castpd256_pd128(RowSumV), _mm256_extractf128_pd(RowSumV, 1));
+  RowSum = _mm_hadd_pd(RowSum, RowSum);
+  return _mm_cvtsd_f64(RowSum);
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// flt64
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void xStructSimAVX::CalcMoments(flt64* restrict Moments, const uint16* Tst, const uint16* Ref, int32 Width, int32 BegX, int32 EndX)
+{
+  constexpr int32 NumPels = c_NumPels<flt64>;
+  assert(((EndX - BegX) % NumPels) == 0);
+
+  flt64* restrict MomR  = Moments;
+  flt64* restrict MomT  = Moments + 1 * Width;
+  flt64* restrict MomR2 = Moments + 2 * Width;
+  flt64* restrict MomT2 = Moments + 3 * Width;
+  flt64* restrict MomRT = Moments + 4 * Width;
+
+  for(int32 x = BegX; x < EndX; x += NumPels)
+  {
+    __m256d R = _mm256_cvtepi32_pd(_mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)(Ref + x))));
+    __m256d T = _mm256_cvtepi32_pd(_mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)(Tst + x))));
+    _mm256_storeu_pd(MomR  + x, R);
+    _mm256_storeu_pd(MomT  + x, T);
+    _mm256_storeu_pd(MomR2 + x, _mm256_mul_pd(R, R));
+    _mm256_storeu_pd(MomT2 + x, _mm256_mul_pd(T, T));
+    _mm256_storeu_pd(MomRT + x, _mm256_mul_pd(R, T));
+  }
+}
+void xStructSimAVX::CalcMoments(flt64* restrict Moments, const uint16* Src, int32 Width, int32 BegX, int32 EndX)
+{
+  constexpr int32 NumPels = c_NumPels<flt64>;
+  assert(((EndX - BegX) % NumPels) == 0);
+
+  flt64* restrict MomX  = Moments;
+  flt64* restrict MomX2 = Moments + 1 * Width;
+
+  for(int32 x = BegX; x < EndX; x += NumPels)
+  {
+    __m256d X = _mm256_cvtepi32_pd(_mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)(Src + x))));
+    _mm256_storeu_pd(MomX  + x, X);
+    _mm256_storeu_pd(MomX2 + x, _mm256_mul_pd(X, X));
+  }
+}
+void xStructSimAVX::CalcMomRT(flt64* restrict Moments, const uint16* Tst, const uint16* Ref, int32 BegX, int32 EndX)
+{
+  constexpr int32 NumPels = c_NumPels<flt64>;
+  assert(((EndX - BegX) % NumPels) == 0);
+
+  for(int32 x = BegX; x < EndX; x += NumPels)
+  {
+    __m256d R = _mm256_cvtepi32_pd(_mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)(Ref + x))));
+    __m256d T = _mm256_cvtepi32_pd(_mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)(Tst + x))));
+    _mm256_storeu_pd(Moments + x, _mm256_mul_pd(R, T));
+  }
+}
+void xStructSimAVX::FilterRowH(flt64* restrict MomentsH, const flt64* restrict Moments, int32 Width, int32 NumPlanes, int32 BegX, int32 EndX, const tFltrS& Filter)
+{
+  constexpr int32 NumPels = c_NumPels<flt64>;
+  assert(((EndX - BegX) % NumPels) == 0);
+
+  __m256d FilterV[c_WindowSize];
+  for(int32 i = 0; i < c_WindowSize; i++) { FilterV[i] = _mm256_set1_pd(Filter[i]); }
+
+  for(int32 m = 0; m < NumPlanes; m++)
+  {
+    const flt64* restrict Src = Moments  + m * Width - c_FilterRange;
+    flt64*       restrict Dst = MomentsH + m * Width;
+    for(int32 x = BegX; x < EndX; x += NumPels)
+    {
+      __m256d Sum = _mm256_mul_pd(_mm256_loadu_pd(Src + x), FilterV[0]);
+      for(int32 i = 1; i < c_WindowSize; i++) { Sum = _mm256_add_pd(Sum, _mm256_mul_pd(_mm256_loadu_pd(Src + x + i), FilterV[i])); }
+      _mm256_storeu_pd(Dst + x, Sum);
+    }
+  }
+}
+void xStructSimAVX::FilterRowV(flt64* restrict MomentsV, const flt64* const* RowsH, int32 Width, int32 NumPlanes, int32 BegX, int32 EndX, const tFltrS& Filter)
+{
+  constexpr int32 NumPels = c_NumPels<flt64>;
+  assert(((EndX - BegX) % NumPels) == 0);
+
+  __m256d FilterV[c_WindowSize];
+  for(int32 i = 0; i < c_WindowSize; i++) { FilterV[i] = _mm256_set1_pd(Filter[i]); }
+
+  for(int32 m = 0; m < NumPlanes; m++)
+  {
+    for(int32 x = BegX; x < EndX; x += NumPels)
+    {
+      const int32 Offset = m * Width + x;
+      __m256d Sum = _mm256_mul_pd(_mm256_loadu_pd(RowsH[0] + Offset), FilterV[0]);
+      for(int32 i = 1; i < c_WindowSize; i++) { Sum = _mm256_add_pd(Sum, _mm256_mul_pd(_mm256_loadu_pd(RowsH[i] + Offset), FilterV[i])); }
+      _mm256_storeu_pd(MomentsV + Offset, Sum);
+    }
+  }
+}
+template <bool CalcL> flt64 xStructSimAVX::FilterRowV(const flt64* const* RowsH, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, flt64 C1, flt64 C2)
+{
+  constexpr int32 NumPels = c_NumPels<flt64>;
+  assert(((EndX - BegX) % NumPels) == 0);
+
+  __m256d FilterV[c_WindowSize];
+  for(int32 i = 0; i < c_WindowSize; i++) { FilterV[i] = _mm256_set1_pd(Filter[i]); }
+  const __m256d C1V = _mm256_set1_pd(C1);
+  const __m256d C2V = _mm256_set1_pd(C2);
+
+  __m256d RowSumV = _mm256_setzero_pd();
+  for(int32 x = BegX; x < EndX; x += NumPels)
+  {
+    __m256d Mom[c_NumMoments];
+    for(int32 m = 0; m < c_NumMoments; m++)
+    {
+      const int32 Offset = m * Width + x;
+      __m256d Sum = _mm256_mul_pd(_mm256_loadu_pd(RowsH[0] + Offset), FilterV[0]);
+      for(int32 i = 1; i < c_WindowSize; i++) { Sum = _mm256_add_pd(Sum, _mm256_mul_pd(_mm256_loadu_pd(RowsH[i] + Offset), FilterV[i])); }
+      Mom[m] = Sum;
+    }
+    RowSumV = _mm256_add_pd(RowSumV, xCalcSSIM<CalcL>(Mom[0], Mom[1], Mom[2], Mom[3], Mom[4], C1V, C2V));
+  }
+
+  __m128d RowSum = _mm_add_pd(_mm256_castpd256_pd128(RowSumV), _mm256_extractf128_pd(RowSumV, 1));
+  RowSum = _mm_hadd_pd(RowSum, RowSum);
+  return _mm_cvtsd_f64(RowSum);
+}
+template <bool CalcL> flt64 xStructSimAVX::FilterRowVRT(const flt64* const* RowsH, const flt64* MomentsT, const flt64* MomentsR, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, flt64 C1, flt64 C2)
+{
+  constexpr int32 NumPels = c_NumPels<flt64>;
+  assert(((EndX - BegX) % NumPels) == 0);
+
+  __m256d FilterV[c_WindowSize];
+  for(int32 i = 0; i < c_WindowSize; i++) { FilterV[i] = _mm256_set1_pd(Filter[i]); }
+  const __m256d C1V = _mm256_set1_pd(C1);
+  const __m256d C2V = _mm256_set1_pd(C2);
+
+  __m256d RowSumV = _mm256_setzero_pd();
+  for(int32 x = BegX; x < EndX; x += NumPels)
+  {
+    __m256d SumRT = _mm256_mul_pd(_mm256_loadu_pd(RowsH[0] + x), FilterV[0]);
+    for(int32 i = 1; i < c_WindowSize; i++) { SumRT = _mm256_add_pd(SumRT, _mm256_mul_pd(_mm256_loadu_pd(RowsH[i] + x), FilterV[i])); }
+    const __m256d AvgR  = _mm256_loadu_pd(MomentsR + x        );
+    const __m256d AvgT  = _mm256_loadu_pd(MomentsT + x        );
+    const __m256d SumR2 = _mm256_loadu_pd(MomentsR + x + Width);
+    const __m256d SumT2 = _mm256_loadu_pd(MomentsT + x + Width);
+    RowSumV = _mm256_add_pd(RowSumV, xCalcSSIM<CalcL>(AvgR, AvgT, SumR2, SumT2, SumRT, C1V, C2V));
+  }
+
+  __m128d RowSum = _mm_add_pd(_mm256_castpd256_pd128(RowSumV), _mm256_extractf128_pd(RowSumV, 1));
+  RowSum = _mm_hadd_pd(RowSum, RowSum);
+  return _mm_cvtsd_f64(RowSum);
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+template flt64 xStructSimAVX::FilterRowV<false>(const flt32* const* RowsH, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, flt32 C1, flt32 C2);
+template flt64 xStructSimAVX::FilterRowV<true >(const flt32* const* RowsH, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, flt32 C1, flt32 C2);
+template flt64 xStructSimAVX::FilterRowV<false>(const flt64* const* RowsH, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, flt64 C1, flt64 C2);
+template flt64 xStructSimAVX::FilterRowV<true >(const flt64* const* RowsH, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, flt64 C1, flt64 C2);
+template flt64 xStructSimAVX::FilterRowVRT<false>(const flt32* const* RowsH, const flt32* MomentsT, const flt32* MomentsR, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, flt32 C1, flt32 C2);
+template flt64 xStructSimAVX::FilterRowVRT<true >(const flt32* const* RowsH, const flt32* MomentsT, const flt32* MomentsR, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, flt32 C1, flt32 C2);
+template flt64 xStructSimAVX::FilterRowVRT<false>(const flt64* const* RowsH, const flt64* MomentsT, const flt64* MomentsR, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, flt64 C1, flt64 C2);
+template flt64 xStructSimAVX::FilterRowVRT<true >(const flt64* const* RowsH, const flt64* MomentsT, const flt64* MomentsR, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, flt64 C1, flt64 C2);
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
+
+#endif //X_SIMD_CAN_USE_AVX
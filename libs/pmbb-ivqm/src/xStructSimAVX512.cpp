@@ -0,0 +1,354 @@
+/*
+    SPDX-FileCopyrightText: 2019-2024 Jakub Stankowski <jakub.stankowski@put.poznan.pl>
+    SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "xStructSimAVX512.h"
+
+#if X_SIMD_CAN_USE_AVX512
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+// xStructSimAVX512
+//===============================================================================================================================================================================================================
+
+template <bool CalcL> inline __m512 xStructSimAVX512::xCalcSSIM(const __m512& AvgR, const __m512& AvgT, const __m512& SumR2, const __m512& SumT2, const __m512& SumRT, const __m512& C1, const __m512& C2)
+{
+  const __m512 Two    = _mm512_set1_ps(2.0f);
+  const __m512 AvgRT  = _mm512_mul_ps(AvgR, AvgT);
+  const __m512 AvgR2  = _mm512_mul_ps(AvgR, AvgR);
+  const __m512 AvgT2  = _mm512_mul_ps(AvgT, AvgT);
+  const __m512 VarR2  = _mm512_sub_ps(SumR2, AvgR2);
+  const __m512 VarT2  = _mm512_sub_ps(SumT2, AvgT2);
+  const __m512 CovRT  = _mm512_sub_ps(SumRT, AvgRT);
+  const __m512 CS     = _mm512_div_ps(_mm512_add_ps(_mm512_mul_ps(Two, CovRT), C2), _mm512_add_ps(_mm512_add_ps(VarR2, VarT2), C2)); //"Contrast"*"Similarity"
+  if constexpr (CalcL)
+  {
+    const __m512 L    = _mm512_div_ps(_mm512_add_ps(_mm512_mul_ps(_mm512_mul_ps(Two, AvgR), AvgT), C1), _mm512_add_ps(_mm512_add_ps(AvgR2, AvgT2), C1)); //"Luminance"
+    const __m512 SSIM = _mm512_mul_ps(L, CS);
+    return SSIM;
+  }
+  else { return CS; }
+}
+template <bool CalcL> inline __m512d xStructSimAVX512::xCalcSSIM(const __m512d& AvgR, const __m512d& AvgT, const __m512d& SumR2, const __m512d& SumT2, const __m512d& SumRT, const __m512d& C1, const __m512d& C2)
+{
+  const __m512d Two    = _mm512_set1_pd(2.0);
+  const __m512d AvgRT  = _mm512_mul_pd(AvgR, AvgT);
+  const __m512d AvgR2  = _mm512_mul_pd(AvgR, AvgR);
+  const __m512d AvgT2  = _mm512_mul_pd(AvgT, AvgT);
+  const __m512d VarR2  = _mm512_sub_pd(SumR2, AvgR2);
+  const __m512d VarT2  = _mm512_sub_pd(SumT2, AvgT2);
+  const __m512d CovRT  = _mm512_sub_pd(SumRT, AvgRT);
+  const __m512d CS     = _mm512_div_pd(_mm512_add_pd(_mm512_mul_pd(Two, CovRT), C2), _mm512_add_pd(_mm512_add_pd(VarR2, VarT2), C2)); //"Contrast"*"Similarity"
+  if constexpr (CalcL)
+  {
+    const __m512d L    = _mm512_div_pd(_mm512_add_pd(_mm512_mul_pd(_mm512_mul_pd(Two, AvgR), AvgT), C1), _mm512_add_pd(_mm512_add_pd(AvgR2, AvgT2), C1)); //"Luminance"
+    const __m512d SSIM = _mm512_mul_pd(L, CS);
+    return SSIM;
+  }
+  else { return CS; }
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// flt32
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void xStructSimAVX512::CalcMoments(flt32* restrict Moments, const uint16* Tst, const uint16* Ref, int32 Width, int32 BegX, int32 EndX)
+{
+  constexpr int32 NumPels = c_NumPels<flt32>;
+  assert(((EndX - BegX) % NumPels) == 0);
+
+  flt32* restrict MomR  = Moments;
+  flt32* restrict MomT  = Moments + 1 * Width;
+  flt32* restrict MomR2 = Moments + 2 * Width;
+  flt32* restrict MomT2 = Moments + 3 * Width;
+  flt32* restrict MomRT = Moments + 4 * Width;
+
+  for(int32 x = BegX; x < EndX; x += NumPels)
+  {
+    __m512 R = _mm512_cvtepi32_ps(_mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i*)(Ref + x))));
+    __m512 T = _mm512_cvtepi32_ps(_mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i*)(Tst + x))));
+    _mm512_storeu_ps(MomR  + x, R);
+    _mm512_storeu_ps(MomT  + x, T);
+    _mm512_storeu_ps(MomR2 + x, _mm512_mul_ps(R, R));
+    _mm512_storeu_ps(MomT2 + x, _mm512_mul_ps(T, T));
+    _mm512_storeu_ps(MomRT + x, _mm512_mul_ps(R, T));
+  }
+}
+void xStructSimAVX512::CalcMoments(flt32* restrict Moments, const uint16* Src, int32 Width, int32 BegX, int32 EndX)
+{
+  constexpr int32 NumPels = c_NumPels<flt32>;
+  assert(((EndX - BegX) % NumPels) == 0);
+
+  flt32* restrict MomX  = Moments;
+  flt32* restrict MomX2 = Moments + 1 * Width;
+
+  for(int32 x = BegX; x < EndX; x += NumPels)
+  {
+    __m512 X = _mm512_cvtepi32_ps(_mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i*)(Src + x))));
+    _mm512_storeu_ps(MomX  + x, X);
+    _mm512_storeu_ps(MomX2 + x, _mm512_mul_ps(X, X));
+  }
+}
+void xStructSimAVX512::CalcMomRT(flt32* restrict Moments, const uint16* Tst, const uint16* Ref, int32 BegX, int32 EndX)
+{
+  constexpr int32 NumPels = c_NumPels<flt32>;
+  assert(((EndX - BegX) % NumPels) == 0);
+
+  for(int32 x = BegX; x < EndX; x += NumPels)
+  {
+    __m512 R = _mm512_cvtepi32_ps(_mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i*)(Ref + x))));
+    __m512 T = _mm512_cvtepi32_ps(_mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i*)(Tst + x))));
+    _mm512_storeu_ps(Moments + x, _mm512_mul_ps(R, T));
+  }
+}
+void xStructSimAVX512::FilterRowH(flt32* restrict MomentsH, const flt32* restrict Moments, int32 Width, int32 NumPlanes, int32 BegX, int32 EndX, const tFltrS& Filter)
+{
+  constexpr int32 NumPels = c_NumPels<flt32>;
+  assert(((EndX - BegX) % NumPels) == 0);
+
+  __m512 FilterV[c_WindowSize];
+  for(int32 i = 0; i < c_WindowSize; i++) { FilterV[i] = _mm512_set1_ps((flt32)Filter[i]); }
+
+  for(int32 m = 0; m < NumPlanes; m++)
+  {
+    const flt32* restrict Src = Moments  + m * Width - c_FilterRange;
+    flt32*       restrict Dst = MomentsH + m * Width;
+    for(int32 x = BegX; x < EndX; x += NumPels)
+    {
+      __m512 Sum = _mm512_mul_ps(_mm512_loadu_ps(Src + x), FilterV[0]);
+      for(int32 i = 1; i < c_WindowSize; i++) { Sum = _mm512_add_ps(Sum, _mm512_mul_ps(_mm512_loadu_ps(Src + x + i), FilterV[i])); }
+      _mm512_storeu_ps(Dst + x, Sum);
+    }
+  }
+}
+void xStructSimAVX512::FilterRowV(flt32* restrict MomentsV, const flt32* const* RowsH, int32 Width, int32 NumPlanes, int32 BegX, int32 EndX, const tFltrS& Filter)
+{
+  constexpr int32 NumPels = c_NumPels<flt32>;
+  assert(((EndX - BegX) % NumPels) == 0);
+
+  __m512 FilterV[c_WindowSize];
+  for(int32 i = 0; i < c_WindowSize; i++) { FilterV[i] = _mm512_set1_ps((flt32)Filter[i]); }
+
+  for(int32 m = 0; m < NumPlanes; m++)
+  {
+    for(int32 x = BegX; x < EndX; x += NumPels)
+    {
+      const int32 Offset = m * Width + x;
+      __m512 Sum = _mm512_mul_ps(_mm512_loadu_ps(RowsH[0] + Offset), FilterV[0]);
+      for(int32 i = 1; i < c_WindowSize; i++) { Sum = _mm512_add_ps(Sum, _mm512_mul_ps(_mm512_loadu_ps(RowsH[i] + Offset), FilterV[i])); }
+      _mm512_storeu_ps(MomentsV + Offset, Sum);
+    }
+  }
+}
+template <bool CalcL> flt64 xStructSimAVX512::FilterRowV(const flt32* const* RowsH, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, flt32 C1, flt32 C2)
+{
+  constexpr int32 NumPels = c_NumPels<flt32>;
+  assert(((EndX - BegX) % NumPels) == 0);
+
+  __m512 FilterV[c_WindowSize];
+  for(int32 i = 0; i < c_WindowSize; i++) { FilterV[i] = _mm512_set1_ps((flt32)Filter[i]); }
+  const __m512 C1V = _mm512_set1_ps(C1);
+  const __m512 C2V = _mm512_set1_ps(C2);
+
+  __m512d RowSumV = _mm512_setzero_pd(); //flt64 accumulator
+  for(int32 x = BegX; x < EndX; x += NumPels)
+  {
+    __m512 Mom[c_NumMoments];
+    for(int32 m = 0; m < c_NumMoments; m++)
+    {
+      const int32 Offset = m * Width + x;
+      __m512 Sum = _mm512_mul_ps(_mm512_loadu_ps(RowsH[0] + Offset), FilterV[0]);
+      for(int32 i = 1; i < c_WindowSize; i++) { Sum = _mm512_add_ps(Sum, _mm512_mul_ps(_mm512_loadu_ps(RowsH[i] + Offset), FilterV[i])); }
+      Mom[m] = Sum;
+    }
+    __m512 SSIM = xCalcSSIM<CalcL>(Mom[0], Mom[1], Mom[2], Mom[3], Mom[4], C1V, C2V);
+    RowSumV = _mm512_add_pd(RowSumV, _mm512_add_pd(_mm512_cvtps_pd(_mm512_castps512_ps256(SSIM)), _mm512_cvtps_pd(_mm512_extractf32x8_ps(SSIM, 1))));
+  }
+
+  return _mm512_reduce_add_pd(RowSumV);
+}
+template <bool CalcL> flt64 xStructSimAVX512::FilterRowVRT(const flt32* const* RowsH, const flt32* MomentsT, const flt32* MomentsR, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, flt32 C1, flt32 C2)
+{
+  constexpr int32 NumPels = c_NumPels<flt32>;
+  assert(((EndX - BegX) % NumPels) == 0);
+
+  __m512 FilterV[c_WindowSize];
+  for(int32 i = 0; i < c_WindowSize; i++) { FilterV[i] = _mm512_set1_ps((flt32)Filter[i]); }
+  const __m512 C1V = _mm512_set1_ps(C1);
+  const __m512 C2V = _mm512_set1_ps(C2);
+
+  __m512d RowSumV = _mm512_setzero_pd(); //flt64 accumulator
+  for(int32 x = BegX; x < EndX; x += NumPels)
+  {
+    __m512 SumRT = _mm512_mul_ps(_mm512_loadu_ps(RowsH[0] + x), FilterV[0]);
+    for(int32 i = 1; i < c_WindowSize; i++) { SumRT = _mm512_add_ps(SumRT, _mm512_mul_ps(_mm512_loadu_ps(RowsH[i] + x), FilterV[i])); }
+    const __m512 AvgR  = _mm512_loadu_ps(MomentsR + x        );
+    const __m512 AvgT  = _mm512_loadu_ps(MomentsT + x        );
+    const __m512 SumR2 = _mm512_loadu_ps(MomentsR + x + Width);
+    const __m512 SumT2 = _mm512_loadu_ps(MomentsT + x + Width);
+    __m512 SSIM = xCalcSSIM<CalcL>(AvgR, AvgT, SumR2, SumT2, SumRT, C1V, C2V);
+    RowSumV = _mm512_add_pd(RowSumV, _mm512_add_pd(_mm512_cvtps_pd(_mm512_castps512_ps256(SSIM)), _mm512_cvtps_pd(_mm512_extractf32x8_ps(SSIM, 1))));
+  }
+
+  return _mm512_reduce_add_pd(RowSumV);
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// flt64
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void xStructSimAVX512::CalcMoments(flt64* restrict Moments, const uint16* Tst, const uint16* Ref, int32 Width, int32 BegX, int32 EndX)
+{
+  constexpr int32 NumPels = c_NumPels<flt64>;
+  assert(((EndX - BegX) % NumPels) == 0);
+
+  flt64* restrict MomR  = Moments;
+  flt64* restrict MomT  = Moments + 1 * Width;
+  flt64* restrict MomR2 = Moments + 2 * Width;
+  flt64* restrict MomT2 = Moments + 3 * Width;
+  flt64* restrict MomRT = Moments + 4 * Width;
+
+  for(int32 x = BegX; x < EndX; x += NumPels)
+  {
+    __m512d R = _mm512_cvtepi32_pd(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(Ref + x))));
+    __m512d T = _mm512_cvtepi32_pd(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(Tst + x))));
+    _mm512_storeu_pd(MomR  + x, R);
+    _mm512_storeu_pd(MomT  + x, T);
+    _mm512_storeu_pd(MomR2 + x, _mm512_mul_pd(R, R));
+    _mm512_storeu_pd(MomT2 + x, _mm512_mul_pd(T, T));
+    _mm512_storeu_pd(MomRT + x, _mm512_mul_pd(R, T));
+  }
+}
+void xStructSimAVX512::CalcMoments(flt64* restrict Moments, const uint16* Src, int32 Width, int32 BegX, int32 EndX)
+{
+  constexpr int32 NumPels = c_NumPels<flt64>;
+  assert(((EndX - BegX) % NumPels) == 0);
+
+  flt64* restrict MomX  = Moments;
+  flt64* restrict MomX2 = Moments + 1 * Width;
+
+  for(int32 x = BegX; x < EndX; x += NumPels)
+  {
+    __m512d X = _mm512_cvtepi32_pd(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(Src + x))));
+    _mm512_storeu_pd(MomX  + x, X);
+    _mm512_storeu_pd(MomX2 + x, _mm512_mul_pd(X, X));
+  }
+}
+void xStructSimAVX512::CalcMomRT(flt64* restrict Moments, const uint16* Tst, const uint16* Ref, int32 BegX, int32 EndX)
+{
+  constexpr int32 NumPels = c_NumPels<flt64>;
+  assert(((EndX - BegX) % NumPels) == 0);
+
+  for(int32 x = BegX; x < EndX; x += NumPels)
+  {
+    __m512d R = _mm512_cvtepi32_pd(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(Ref + x))));
+    __m512d T = _mm512_cvtepi32_pd(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(Tst + x))));
+    _mm512_storeu_pd(Moments + x, _mm512_mul_pd(R, T));
+  }
+}
+void xStructSimAVX512::FilterRowH(flt64* restrict MomentsH, const flt64* restrict Moments, int32 Width, int32 NumPlanes, int32 BegX, int32 EndX, const tFltrS& Filter)
+{
+  constexpr int32 NumPels = c_NumPels<flt64>;
+  assert(((EndX - BegX) % NumPels) == 0);
+
+  __m512d FilterV[c_WindowSize];
+  for(int32 i = 0; i < c_WindowSize; i++) { FilterV[i] = _mm512_set1_pd(Filter[i]); }
+
+  for(int32 m = 0; m < NumPlanes; m++)
+  {
+    const flt64* restrict Src = Moments  + m * Width - c_FilterRange;
+    flt64*       restrict Dst = MomentsH + m * Width;
+    for(int32 x = BegX; x < EndX; x += NumPels)
+    {
+      __m512d Sum = _mm512_mul_pd(_mm512_loadu_pd(Src + x), FilterV[0]);
+      for(int32 i = 1; i < c_WindowSize; i++) { Sum = _mm512_add_pd(Sum, _mm512_mul_pd(_mm512_loadu_pd(Src + x + i), FilterV[i])); }
+      _mm512_storeu_pd(Dst + x, Sum);
+    }
+  }
+}
+void xStructSimAVX512::FilterRowV(flt64* restrict MomentsV, const flt64* const* RowsH, int32 Width, int32 NumPlanes, int32 BegX, int32 EndX, const tFltrS& Filter)
+{
+  constexpr int32 NumPels = c_NumPels<flt64>;
+  assert(((EndX - BegX) % NumPels) == 0);
+
+  __m512d FilterV[c_WindowSize];
+  for(int32 i = 0; i < c_WindowSize; i++) { FilterV[i] = _mm512_set1_pd(Filter[i]); }
+
+  for(int32 m = 0; m < NumPlanes; m++)
+  {
+    for(int32 x = BegX; x < EndX; x += NumPels)
+    {
+      const int32 Offset = m * Width + x;
+      __m512d Sum = _mm512_mul_pd(_mm512_loadu_pd(RowsH[0] + Offset), FilterV[0]);
+      for(int32 i = 1; i < c_WindowSize; i++) { Sum = _mm512_add_pd(Sum, _mm512_mul_pd(_mm512_loadu_pd(RowsH[i] + Offset), FilterV[i])); }
+      _mm512_storeu_pd(MomentsV + Offset, Sum);
+    }
+  }
+}
+template <bool CalcL> flt64 xStructSimAVX512::FilterRowV(const flt64* const* RowsH, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, flt64 C1, flt64 C2)
+{
+  constexpr int32 NumPels = c_NumPels<flt64>;
+  assert(((EndX - BegX) % NumPels) == 0);
+
+  __m512d FilterV[c_WindowSize];
+  for(int32 i = 0; i < c_WindowSize; i++) { FilterV[i] = _mm512_set1_pd(Filter[i]); }
+  const __m512d C1V = _mm512_set1_pd(C1);
+  const __m512d C2V = _mm512_set1_pd(C2);
+
+  __m512d RowSumV = _mm512_setzero_pd();
+  for(int32 x = BegX; x < EndX; x += NumPels)
+  {
+    __m512d Mom[c_NumMoments];
+    for(int32 m = 0; m < c_NumMoments; m++)
+    {
+      const int32 Offset = m * Width + x;
+      __m512d Sum = _mm512_mul_pd(_mm512_loadu_pd(RowsH[0] + Offset), FilterV[0]);
+      for(int32 i = 1; i < c_WindowSize; i++) { Sum = _mm512_add_pd(Sum, _mm512_mul_pd(_mm512_loadu_pd(RowsH[i] + Offset), FilterV[i])); }
+      Mom[m] = Sum;
+    }
+    RowSumV = _mm512_add_pd(RowSumV, xCalcSSIM<CalcL>(Mom[0], Mom[1], Mom[2], Mom[3], Mom[4], C1V, C2V));
+  }
+
+  return _mm512_reduce_add_pd(RowSumV);
+}
+template <bool CalcL> flt64 xStructSimAVX512::FilterRowVRT(const flt64* const* RowsH, const flt64* MomentsT, const flt64* MomentsR, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, flt64 C1, flt64 C2)
+{
+  constexpr int32 NumPels = c_NumPels<flt64>;
+  assert(((EndX - BegX) % NumPels) == 0);
+
+  __m512d FilterV[c_WindowSize];
+  for(int32 i = 0; i < c_WindowSize; i++) { FilterV[i] = _mm512_set1_pd(Filter[i]); }
+  const __m512d C1V = _mm512_set1_pd(C1);
+  const __m512d C2V = _mm512_set1_pd(C2);
+
+  __m512d RowSumV = _mm512_setzero_pd();
+  for(int32 x = BegX; x < EndX; x += NumPels)
+  {
+    __m512d SumRT = _mm512_mul_pd(_mm512_loadu_pd(RowsH[0] + x), FilterV[0]);
+    for(int32 i = 1; i < c_WindowSize; i++) { SumRT = _mm512_add_pd(SumRT, _mm512_mul_pd(_mm512_loadu_pd(RowsH[i] + x), FilterV[i])); }
+    const __m512d AvgR  = _mm512_loadu_pd(MomentsR + x        );
+    const __m512d AvgT  = _mm512_loadu_pd(MomentsT + x        );
+    const __m512d SumR2 = _mm512_loadu_pd(MomentsR + x + Width);
+    const __m512d SumT2 = _mm512_loadu_pd(MomentsT + x + Width);
+    RowSumV = _mm512_add_pd(RowSumV, xCalcSSIM<CalcL>(AvgR, AvgT, SumR2, SumT2, SumRT, C1V, C2V));
+  }
+
+  return _mm512_reduce_add_pd(RowSumV);
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+template flt64 xStructSimAVX512::FilterRowV<false>(const flt32* const* RowsH, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, flt32 C1, flt32 C2);
+template flt64 xStructSimAVX512::FilterRowV<true >(const flt32* const* RowsH, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, flt32 C1, flt32 C2);
+template flt64 xStructSimAVX512::FilterRowV<false>(const flt64* const* RowsH, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, flt64 C1, flt64 C2);
+template flt64 xStructSimAVX512::FilterRowV<true >(const flt64* const* RowsH, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, flt64 C1, flt64 C2);
+template flt64 xStructSimAVX512::FilterRowVRT<false>(const flt32* const* RowsH, const flt32* MomentsT, const flt32* MomentsR, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, flt32 C1, flt32 C2);
+template flt64 xStructSimAVX512::FilterRowVRT<true >(const flt32* const* RowsH, const flt32* MomentsT, const flt32* MomentsR, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, flt32 C1, flt32 C2);
+template flt64 xStructSimAVX512::FilterRowVRT<false>(const flt64* const* RowsH, const flt64* MomentsT, const flt64* MomentsR, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, flt64 C1, flt64 C2);
+template flt64 xStructSimAVX512::FilterRowVRT<true >(const flt64* const* RowsH, const flt64* MomentsT, const flt64* MomentsR, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, flt64 C1, flt64 C2);
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
+
+#endif //X_SIMD_CAN_USE_AVX512
@@ -0,0 +1,50 @@
+/*
+    SPDX-FileCopyrightText: 2019-2024 Jakub Stankowski <jakub.stankowski@put.poznan.pl>
+    SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+#include "xCommonDefIVQM.h"
+#include "xStructSimConsts.h"
+
+#if X_SIMD_CAN_USE_AVX512
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+
+class xStructSimAVX512 : public xStructSimConsts
+{
+public:
+  template<class XXX> static constexpr int32 c_NumPels = 64 / sizeof(XXX); //pixels processed in single iteration (16 for flt32, 8 for flt64)
+
+  //moments are stored as planes of Width elements each (R, T, R^2, T^2, RT or X, X^2 for single picture), columns [BegX, EndX) are processed, (EndX - BegX) has to be multiple of c_NumPels
+  static void CalcMoments(flt32* restrict Moments , const uint16* Tst, const uint16* Ref, int32 Width, int32 BegX, int32 EndX);
+  static void CalcMoments(flt64* restrict Moments , const uint16* Tst, const uint16* Ref, int32 Width, int32 BegX, int32 EndX);
+  static void CalcMoments(flt32* restrict Moments , const uint16* Src, int32 Width, int32 BegX, int32 EndX); //single picture (X, X^2)
+  static void CalcMoments(flt64* restrict Moments , const uint16* Src, int32 Width, int32 BegX, int32 EndX); //single picture (X, X^2)
+  static void CalcMomRT  (flt32* restrict Moments , const uint16* Tst, const uint16* Ref, int32 BegX, int32 EndX); //cross moment only (RT)
+  static void CalcMomRT  (flt64* restrict Moments , const uint16* Tst, const uint16* Ref, int32 BegX, int32 EndX); //cross moment only (RT)
+  static void FilterRowH (flt32* restrict MomentsH, const flt32* restrict Moments, int32 Width, int32 NumPlanes, int32 BegX, int32 EndX, const tFltrS& Filter);
+  static void FilterRowH (flt64* restrict MomentsH, const flt64* restrict Moments, int32 Width, int32 NumPlanes, int32 BegX, int32 EndX, const tFltrS& Filter);
+  static void FilterRowV (flt32* restrict MomentsV, const flt32* const* RowsH, int32 Width, int32 NumPlanes, int32 BegX, int32 EndX, const tFltrS& Filter);
+  static void FilterRowV (flt64* restrict MomentsV, const flt64* const* RowsH, int32 Width, int32 NumPlanes, int32 BegX, int32 EndX, const tFltrS& Filter);
+
+  //vertical filter (RowsH[0] is the top row) fused with calculation of luminance and contrast-structure terms, returns sum of SSIM (CalcL == true) or CS (CalcL == false) accumulated in flt64
+  template <bool CalcL> static flt64 FilterRowV(const flt32* const* RowsH, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, flt32 C1, flt32 C2);
+  template <bool CalcL> static flt64 FilterRowV(const flt64* const* RowsH, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, flt64 C1, flt64 C2);
+
+  //as above, but only cross moment (RT) is filtered, remaining moments are taken from vertically filtered moments of Tst and Ref (X, X^2 planes of Width elements each)
+  template <bool CalcL> static flt64 FilterRowVRT(const flt32* const* RowsH, const flt32* MomentsT, const flt32* MomentsR, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, flt32 C1, flt32 C2);
+  template <bool CalcL> static flt64 FilterRowVRT(const flt64* const* RowsH, const flt64* MomentsT, const flt64* MomentsR, int32 Width, int32 BegX, int32 EndX, const tFltrS& Filter, flt64 C1, flt64 C2);
+
+protected:
+  template <bool CalcL> static inline __m512  xCalcSSIM(const __m512 & AvgR, const __m512 & AvgT, const __m512 & SumR2, const __m512 & SumT2, const __m512 & SumRT, const __m512 & C1, const __m512 & C2);
+  template <bool CalcL> static inline __m512d xCalcSSIM(const __m512d& AvgR, const __m512d& AvgT, const __m512d& SumR2, const __m512d& SumT2, const __m512d& SumRT, const __m512d& C1, const __m512d& C2);
+};
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
+
+#endif //X_SIMD_CAN_USE_AVX512
@@ -0,0 +1,92 @@
+/*
+    SPDX-FileCopyrightText: 2019-2024 Jakub Stankowski <jakub.stankowski@put.poznan.pl>
+    SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "xStructSimBox.h"
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+// xStructSimBox
+//===============================================================================================================================================================================================================
+void xStructSimBox::UpdateRowSAT(int64* restrict SatCur, const int64* restrict SatPrev, const uint16* Tst, const uint16* Ref, int32 Width)
+{
+  const int32 PlaneSize = Width + 1;
+  int64* restrict CurR  = SatCur;
+  int64* restrict CurT  = SatCur + 1 * PlaneSize;
+  int64* restrict CurR2 = SatCur + 2 * PlaneSize;
+  int64* restrict CurT2 = SatCur + 3 * PlaneSize;
+  int64* restrict CurRT = SatCur + 4 * PlaneSize;
+  const int64* restrict PrvR  = SatPrev;
+  const int64* restrict PrvT  = SatPrev + 1 * PlaneSize;
+  const int64* restrict PrvR2 = SatPrev + 2 * PlaneSize;
+  const int64* restrict PrvT2 = SatPrev + 3 * PlaneSize;
+  const int64* restrict PrvRT = SatPrev + 4 * PlaneSize;
+
+  int64 AccR = 0, AccT = 0, AccR2 = 0, AccT2 = 0, AccRT = 0;
+  CurR[0] = 0; CurT[0] = 0; CurR2[0] = 0; CurT2[0] = 0; CurRT[0] = 0;
+  for(int32 x = 0; x < Width; x++)
+  {
+    const int64 R = Ref[x];
+    const int64 T = Tst[x];
+    AccR  += R;
+    AccT  += T;
+    AccR2 += R * R;
+    AccT2 += T * T;
+    AccRT += R * T;
+    CurR [x + 1] = PrvR [x + 1] + AccR ;
+    CurT [x + 1] = PrvT [x + 1] + AccT ;
+    CurR2[x + 1] = PrvR2[x + 1] + AccR2;
+    CurT2[x + 1] = PrvT2[x + 1] + AccT2;
+    CurRT[x + 1] = PrvRT[x + 1] + AccRT;
+  }
+}
+flt64 xStructSimBox::CalcRowBox(flt64* restrict PelSSIM, const int64* SatT, const int64* SatB, int32 Width, int32 BoxSize, flt64 C1, flt64 C2)
+{
+  //with A = BoxSize^2 and box sums S*: Avg = S/A, Var = (A*S2 - S^2)/A^2, Cov = (A*SRT - SR*ST)/A^2, so both SSIM terms can be expressed in box sums scaled by A^2
+  const int32 PlaneSize = Width + 1;
+  const int32 NumPels   = Width - BoxSize + 1;
+  const int64 Area      = (int64)BoxSize * (int64)BoxSize;
+  const flt64 C1A2      = C1 * (flt64)Area * (flt64)Area;
+  const flt64 C2A2      = C2 * (flt64)Area * (flt64)Area;
+
+  const int64* restrict TR  = SatT;
+  const int64* restrict TT  = SatT + 1 * PlaneSize;
+  const int64* restrict TR2 = SatT + 2 * PlaneSize;
+  const int64* restrict TT2 = SatT + 3 * PlaneSize;
+  const int64* restrict TRT = SatT + 4 * PlaneSize;
+  const int64* restrict BR  = SatB;
+  const int64* restrict BT  = SatB + 1 * PlaneSize;
+  const int64* restrict BR2 = SatB + 2 * PlaneSize;
+  const int64* restrict BT2 = SatB + 3 * PlaneSize;
+  const int64* restrict BRT = SatB + 4 * PlaneSize;
+
+  //independent per pixel values first (vectorizable), then sequential sum (keeps summation order fixed)
+  for(int32 x = 0; x < NumPels; x++)
+  {
+    const int32 x1 = x + BoxSize;
+    const int64 SR   = BR [x1] - BR [x] - TR [x1] + TR [x];
+    const int64 ST   = BT [x1] - BT [x] - TT [x1] + TT [x];
+    const int64 SR2  = BR2[x1] - BR2[x] - TR2[x1] + TR2[x];
+    const int64 ST2  = BT2[x1] - BT2[x] - TT2[x1] + TT2[x];
+    const int64 SRT  = BRT[x1] - BRT[x] - TRT[x1] + TRT[x];
+    const int64 VarR = Area * SR2 - SR * SR;
+    const int64 VarT = Area * ST2 - ST * ST;
+    const int64 Cov  = Area * SRT - SR * ST;
+
+    const flt64 NumL  = (flt64)(2 * SR * ST) + C1A2; //"Luminance"
+    const flt64 DenL  = (flt64)(SR * SR + ST * ST) + C1A2;
+    const flt64 NumCS = (flt64)(2 * Cov    ) + C2A2; //"Contrast"*"Similarity"
+    const flt64 DenCS = (flt64)(VarR + VarT) + C2A2;
+    PelSSIM[x] = (NumL * NumCS) / (DenL * DenCS);
+  }
+
+  flt64 RowSum = 0;
+  for(int32 x = 0; x < NumPels; x++) { RowSum += PelSSIM[x]; }
+  return RowSum;
+}
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
@@ -0,0 +1,27 @@
+/*
+    SPDX-FileCopyrightText: 2019-2024 Jakub Stankowski <jakub.stankowski@put.poznan.pl>
+    SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+#include "xCommonDefIVQM.h"
+#include "xStructSimConsts.h"
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+
+class xStructSimBox : public xStructSimConsts //Structural Similarity with box window (moments taken from summed-area tables)
+{
+public:
+  //summed-area table (SAT) rows are stored as c_NumMoments planes (R, T, R^2, T^2, RT) of Width + 1 elements each, element x holds sum of moments of columns [0, x) of all rows above
+  //moments are kept as integers, so box sums and variances are exact (for BoxSize <= c_MaxBoxSize and BitDepth <= 14) and cost per pixel does not depend on BoxSize
+  //UpdateRowSAT - calculates SAT row (SatCur) from previous one (SatPrev) and one row of pixels
+  //CalcRowBox   - calculates sum of SSIM over row using SAT rows at top (SatT) and bottom (SatB) of window, for window origins [0, Width - BoxSize] (PelSSIM is a buffer of Width elements)
+  static void  UpdateRowSAT(int64* restrict SatCur, const int64* restrict SatPrev, const uint16* Tst, const uint16* Ref, int32 Width);
+  static flt64 CalcRowBox  (flt64* restrict PelSSIM, const int64* SatT, const int64* SatB, int32 Width, int32 BoxSize, flt64 C1, flt64 C2);
+};
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
@@ -18,6 +18,9 @@ public:
   static constexpr int32 c_FilterSize  = 11;
   static constexpr int32 c_FilterRange = c_FilterSize >> 1;
   static constexpr int32 c_FilterArea  = c_FilterSize * c_FilterSize;
+  static constexpr int32 c_WindowSize  = 2 * c_FilterRange; //rows and columns [-c_FilterRange, c_FilterRange) are taken into account
+  static constexpr int32 c_NumMoments  = 5; //R, T, R^2, T^2, RT
+  static constexpr int32 c_NumPicMoms  = 2; //X, X^2 (moments of single picture, kept in moment plane cache)
 
   template<class XXX> static constexpr XXX c_Sigma = XXX(1.50);
   template<class XXX> static constexpr XXX c_K1    = XXX(0.01);
@@ -26,7 +29,12 @@ public:
   static constexpr int32                   c_NumMultiScales = 5;
   template<class XXX> static constexpr XXX c_MultiScaleWghts[c_NumMultiScales] = { XXX(0.0448), XXX(0.2856), XXX(0.3001), XXX(0.2363), XXX(0.1333) };
 
+  //box window SSIM (FASTSSIM)
+  static constexpr int32 c_DefaultBoxSize = 8;
+  static constexpr int32 c_MaxBoxSize     = 64; //keeps integer moment arithmetic within int64 for up to 14-bit input
+
   using tFltrF = std::array< std::array <flt32, c_FilterSize>, c_FilterSize>;
+  using tFltrS = std::array<flt64, c_FilterSize>; //separable gaussian filter, c_FilterS[y] * c_FilterS[x] matches c_FilterF[y][x] (derived from c_FilterF central row)
 
   static constexpr tFltrF c_FilterF =
   { {
@@ -42,6 +50,8 @@ public:
     { 0.0000078144f, 0.0000577411f, 0.0002735612f, 0.0008310054f, 0.0016185776f, 0.0020213588f, 0.0016185776f, 0.0008310054f, 0.0002735612f, 0.0000577411f, 0.0000078144f, },
     { 0.0000010576f, 0.0000078144f, 0.0000370225f, 0.0001124644f, 0.0002190507f, 0.0002735612f, 0.0002190507f, 0.0001124644f, 0.0000370225f, 0.0000078144f, 0.0000010576f, },
   } };
+
+  static constexpr tFltrS c_FilterS = { 0.0010283801942562, 0.0075987582570742, 0.0360007700706427, 0.1093606893324984, 0.2130055368393884, 0.2660117279305033, 0.2130055368393884, 0.1093606893324984, 0.0360007700706427, 0.0075987582570742, 0.0010283801942562, };
 };
 
 //===============================================================================================================================================================================================================
@@ -4,7 +4,6 @@
 */
 
 #include "xWSPSNR.h"
-#include "xDistortion.h"
 #include "xPixelOps.h"
 #include "xMathUtils.h"
 #include <cassert>
@@ -27,34 +26,15 @@ flt64V4 xWSPSNR::calcPicWSPSNR(const xPicP* Tst, const xPicP* Ref)
   }
   else
   {
-    if(m_ThPI.isActive())
+    xCalcPicRowSSDs(Tst, Ref);
+    for(int32 CmpIdx = 0; CmpIdx < m_NumComponents; CmpIdx++)
     {
-      for(int32 CmpIdx = 0; CmpIdx < m_NumComponents; CmpIdx++)
-      {
-        m_ThPI.addWaitingTask([this, &WSPSNR, &Tst, &Ref, CmpIdx](int32 /*ThreadIdx*/) { WSPSNR[CmpIdx] = xCalcCmpWSPSNR(Tst, Ref, (eCmp)CmpIdx); });
-      }
-      m_ThPI.waitUntilTasksFinished(m_NumComponents);
-    }
-    else
-    {
-      for(int32 CmpIdx = 0; CmpIdx < m_NumComponents; CmpIdx++)
-      {
-        WSPSNR[CmpIdx] = xCalcCmpWSPSNR(Tst, Ref, (eCmp)CmpIdx);
-      }
+      const eCmp CmpId = (eCmp)CmpIdx;
+      WSPSNR[CmpIdx] = xCalcCmpWSPSNR(m_RowDistortions[CmpIdx].data(), Tst->getHeight(CmpId), Tst->getArea(CmpId), Tst->getBitDepth());
     }
   }
 
-  if(m_LegacyPeakValue8bitEmulation) //emulates behavior of original WS-PSNR software for 10bit content converted from 8 bit source
-  {
-    const int32 RealBitDepth = Tst->getBitDepth();
-    if(RealBitDepth == 10)
-    {
-      const int32 RealMaxValue = xBitDepth2MaxValue(RealBitDepth);
-      const int32 FakeMaxValue = xBitDepth2MaxValue(8) << (RealBitDepth - 8);
-      const flt64 ModifierPSNR = 10 * (log10(xPow2(RealMaxValue)) - log10(xPow2(FakeMaxValue)));
-      for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++) { WSPSNR[CmpIdx] -= ModifierPSNR; }
-    }
-  }
+  xApplyLegacyPeakValue(WSPSNR, Tst->getBitDepth());
 
   return WSPSNR;
 }
@@ -62,7 +42,7 @@ flt64V4 xWSPSNR::calcPicWSPSNRM(const xPicP* Tst, const xPicP* Ref, const xPicP*
 {
   assert(Ref != nullptr && Tst != nullptr && Msk != nullptr);
   assert(Ref->isCompatible    (Tst));
-  assert(Ref->isSameSizeMargin(Msk));
+  assert(Ref->isSameSizeMargin(Msk) && !Ref->isChromaSubsampled());
 
   if(NumNonMasked == NOT_VALID) { NumNonMasked = xPixelOps::CountNonZero(Msk->getAddr(eCmp::LM), Msk->getStride(), Msk->getWidth(), Msk->getHeight()); }
 
@@ -74,20 +54,10 @@ flt64V4 xWSPSNR::calcPicWSPSNRM(const xPicP* Tst, const xPicP* Ref, const xPicP*
   }
   else
   {
-    if(m_ThPI.isActive())
-    {
-      for(int32 CmpIdx = 0; CmpIdx < m_NumComponents; CmpIdx++)
-      {
-        m_ThPI.addWaitingTask([this, &WSPSNR, &Tst, &Ref, &Msk, &NumNonMasked, CmpIdx](int32 /*ThreadIdx*/) { WSPSNR[CmpIdx] = xCalcCmpWSPSNRM(Tst, Ref, Msk, NumNonMasked, (eCmp)CmpIdx); });
-      }
-      m_ThPI.waitUntilTasksFinished(m_NumComponents);
-    }
-    else
+    xCalcPicRowSSDs(Tst, Ref, Msk);
+    for(int32 CmpIdx = 0; CmpIdx < m_NumComponents; CmpIdx++)
     {
-      for(int32 CmpIdx = 0; CmpIdx < m_NumComponents; CmpIdx++)
-      {
-        WSPSNR[CmpIdx] = xCalcCmpWSPSNRM(Tst, Ref, Msk, NumNonMasked, (eCmp)CmpIdx);
-      }
+      WSPSNR[CmpIdx] = xCalcCmpWSPSNRM(m_RowDistortions[CmpIdx].data(), Tst, Msk, NumNonMasked);
     }
   }
 
@@ -95,55 +65,62 @@ flt64V4 xWSPSNR::calcPicWSPSNRM(const xPicP* Tst, const xPicP* Ref, const xPicP*
 
   return WSPSNR;
 }
+flt64V4 xWSPSNR::calcPicWSPSNRM(const xPicP* Tst, const xPicP* Ref, const xPicMask* Msk)
+{
+  assert(Ref != nullptr && Tst != nullptr && Msk != nullptr);
+  assert(Ref->isCompatible    (Tst));
+  assert(Ref->isSameSizeMargin(Msk) && !Ref->isChromaSubsampled());
 
-//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+  const int32 NumNonMasked = Msk->getNumNonZero();
 
-flt64 xWSPSNR::xCalcCmpWSPSNR(const xPicP* Tst, const xPicP* Ref, eCmp CmpId)
-{
-  const int32   Width     = Ref->getWidth ();
-  const int32   Height    = Ref->getHeight();
-  const uint16* TstPtr    = Tst->getAddr  (CmpId);
-  const uint16* RefPtr    = Ref->getAddr  (CmpId);
-  const int32   TstStride = Tst->getStride();
-  const int32   RefStride = Ref->getStride();
-
-  uint64* RowSSDs = m_RowDistortions[(int32)CmpId].data();
-  for(int32 y = 0; y < Height; y++)
+  flt64V4 WSPSNR = xMakeVec4(flt64_max);
+
+  if(!m_UseWS)
   {
-    uint64 RowSSD = xDistortion::CalcSSD(RefPtr, TstPtr, Width);
-    RowSSDs[y] = RowSSD;
-    TstPtr += TstStride;
-    RefPtr += RefStride;
+    WSPSNR = calcPicPSNRM(Tst, Ref, Msk);
+  }
+  else
+  {
+    xCalcPicRowSSDs(Tst, Ref, Msk);
+    for(int32 CmpIdx = 0; CmpIdx < m_NumComponents; CmpIdx++)
+    {
+      WSPSNR[CmpIdx] = xCalcCmpWSPSNRM(m_RowDistortions[CmpIdx].data(), Tst, Msk, NumNonMasked);
+    }
   }
 
-  xKBNS KBNS; for(int32 y = 0; y < Height; y++) { KBNS.acc((flt64)RowSSDs[y] * m_EquirectangularWeights[y]); }
-  flt64 CmpError = KBNS.result() * m_DistortionCorrection;
-  flt64 WSPSNR   = CalcPSNRfromSSD(CmpError, Tst->getArea(), Tst->getBitDepth());
-  
-  if(m_FakeValsForExact && CmpError == 0) { WSPSNR = CalcPSNRfromSSD(1, Tst->getArea(), Tst->getBitDepth()); } //fake WSPSNR to avoid returning flt64_max
-  
+  if(m_DebugCallbackMSK) { m_DebugCallbackMSK(NumNonMasked); }
+
   return WSPSNR;
 }
-flt64 xWSPSNR::xCalcCmpWSPSNRM(const xPicP* Tst, const xPicP* Ref, const xPicP* Msk, const int32 NumNonMasked, eCmp CmpId)
+flt64V4 xWSPSNR::calcPicWSPSNR(const xDiffStats* Stats)
 {
-  const int32   Width     = Ref->getWidth ();
-  const int32   Height    = Ref->getHeight();
-  const uint16* TstPtr    = Tst->getAddr  (CmpId   );
-  const uint16* RefPtr    = Ref->getAddr  (CmpId   );
-  const uint16* MskPtr    = Msk->getAddr  (eCmp::LM);
-  const int32   TstStride = Tst->getStride();
-  const int32   RefStride = Ref->getStride();
-  const int32   MskStride = Msk->getStride();
-
-  uint64* RowSSDs = m_RowDistortions[(int32)CmpId].data();
-  for(int32 y = 0; y < Height; y++)
+  assert(Stats != nullptr && Stats->getNumCmps() >= m_NumComponents);
+
+  flt64V4 WSPSNR = xMakeVec4(flt64_max);
+
+  if(!m_UseWS)
   {
-    uint64 RowSSD = xDistortion::CalcWeightedSSD(RefPtr, TstPtr, MskPtr, Width);
-    RowSSDs[y] = RowSSD;
-    TstPtr += TstStride;
-    RefPtr += RefStride;
-    MskPtr += MskStride;
+    WSPSNR = calcPicPSNR(Stats);
   }
+  else
+  {
+    for(int32 CmpIdx = 0; CmpIdx < m_NumComponents; CmpIdx++)
+    {
+      const eCmp CmpId = (eCmp)CmpIdx;
+      WSPSNR[CmpIdx] = xCalcCmpWSPSNR(Stats->getRowSSDs(CmpId), Stats->getHeight(CmpId), Stats->getArea(CmpId), Stats->getBitDepth());
+    }
+  }
+
+  xApplyLegacyPeakValue(WSPSNR, Stats->getBitDepth());
+
+  return WSPSNR;
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+flt64 xWSPSNR::xCalcCmpWSPSNRM(const uint64* RowSSDs, const xPicP* Tst, const xPicCommon* Msk, const int32 NumNonMasked)
+{
+  const int32 Height = Tst->getHeight();
 
   xKBNS KBNS; for(int32 y = 0; y < Height; y++) { KBNS.acc((flt64)RowSSDs[y] * m_EquirectangularWeights[y]); }
   flt64 CmpError = KBNS.result() * m_DistortionCorrection;
@@ -154,6 +131,31 @@ flt64 xWSPSNR::xCalcCmpWSPSNRM(const xPicP* Tst, const xPicP* Ref, const xPicP*
   return WSPSNR;
 }
 
+flt64 xWSPSNR::xCalcCmpWSPSNR(const uint64* RowSSDs, int32 Height, int32 Area, int32 BitDepth)
+{
+  const auto [Weights, Correction] = getEquirectangularWeights(Height);
+  xKBNS KBNS; for(int32 y = 0; y < Height; y++) { KBNS.acc((flt64)RowSSDs[y] * Weights[y]); }
+  flt64 CmpError = KBNS.result() * Correction;
+  flt64 WSPSNR   = CalcPSNRfromSSD(CmpError, Area, BitDepth);
+
+  if(m_FakeValsForExact && CmpError == 0) { WSPSNR = CalcPSNRfromSSD(1, Area, BitDepth); } //fake WSPSNR to avoid returning flt64_max
+
+  return WSPSNR;
+}
+void xWSPSNR::xApplyLegacyPeakValue(flt64V4& WSPSNR, int32 RealBitDepth) const
+{
+  if(m_LegacyPeakValue8bitEmulation) //emulates behavior of original WS-PSNR software for 10bit content converted from 8 bit source
+  {
+    if(RealBitDepth == 10)
+    {
+      const int32 RealMaxValue = xBitDepth2MaxValue(RealBitDepth);
+      const int32 FakeMaxValue = xBitDepth2MaxValue(8) << (RealBitDepth - 8);
+      const flt64 ModifierPSNR = 10 * (log10(xPow2(RealMaxValue)) - log10(xPow2(FakeMaxValue)));
+      for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++) { WSPSNR[CmpIdx] -= ModifierPSNR; }
+    }
+  }
+}
+
 //===============================================================================================================================================================================================================
 
 } //end of namespace PMBB
@@ -21,10 +21,13 @@ public:
 
   flt64V4 calcPicWSPSNR  (const xPicP* Tst, const xPicP* Ref);
   flt64V4 calcPicWSPSNRM (const xPicP* Tst, const xPicP* Ref, const xPicP* Msk, int32 NumNonMasked = NOT_VALID);
+  flt64V4 calcPicWSPSNRM (const xPicP* Tst, const xPicP* Ref, const xPicMask* Msk); //compact mask, number of non masked pels taken from Msk
+  flt64V4 calcPicWSPSNR  (const xDiffStats* Stats); //uses per-row SSD precalculated by xDiffStats
 
 protected:
-  flt64 xCalcCmpWSPSNR (const xPicP* Tst, const xPicP* Ref,                                             eCmp CmpId);
-  flt64 xCalcCmpWSPSNRM(const xPicP* Tst, const xPicP* Ref, const xPicP* Msk, const int32 NumNonMasked, eCmp CmpId);
+  flt64 xCalcCmpWSPSNR (const uint64* RowSSDs, int32 Height, int32 Area, int32 BitDepth);
+  flt64 xCalcCmpWSPSNRM(const uint64* RowSSDs, const xPicP* Tst, const xPicCommon* Msk, const int32 NumNonMasked);
+  void  xApplyLegacyPeakValue(flt64V4& WSPSNR, int32 RealBitDepth) const;
 };
 
 //===============================================================================================================================================================================================================
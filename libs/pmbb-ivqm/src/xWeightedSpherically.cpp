@@ -16,17 +16,22 @@ void xWeightedSpherically::initWS(bool UseWS, int32 /*Width*/, int32 Height, int
 
   if(m_UseWS)
   {
-    m_EquirectangularWeights.resize(Height);
-    const flt64 EquirectangularHeight = 180.0 * (flt64)Height / (flt64)LatRangeDeg;
-    const flt64 EquirectangularOffset = (EquirectangularHeight - Height) / 2.0;
-    for(int32 h = 0; h < Height; h++)
-    {
-      m_EquirectangularWeights[h] = cos((h + EquirectangularOffset - (EquirectangularHeight / 2 - 0.5)) * xc_Pi<flt64> / EquirectangularHeight);
-    }
-    flt64 SumEquirectangularWeights = xKBNS::Accumulate(m_EquirectangularWeights);
-    m_DistortionCorrection = Height / SumEquirectangularWeights;
+    m_DistortionCorrection    = xCalcEquirectangularWeights(m_EquirectangularWeights   , Height     , LatRangeDeg);
+    m_DistortionCorrectionSub = xCalcEquirectangularWeights(m_EquirectangularWeightsSub, Height >> 1, LatRangeDeg);
   }
 }
+flt64 xWeightedSpherically::xCalcEquirectangularWeights(std::vector<flt64>& Weights, int32 Height, int32 LatRangeDeg)
+{
+  Weights.resize(Height);
+  const flt64 EquirectangularHeight = 180.0 * (flt64)Height / (flt64)LatRangeDeg;
+  const flt64 EquirectangularOffset = (EquirectangularHeight - Height) / 2.0;
+  for(int32 h = 0; h < Height; h++)
+  {
+    Weights[h] = cos((h + EquirectangularOffset - (EquirectangularHeight / 2 - 0.5)) * xc_Pi<flt64> / EquirectangularHeight);
+  }
+  flt64 SumEquirectangularWeights = xKBNS::Accumulate(Weights);
+  return Height / SumEquirectangularWeights;
+}
 
 //===============================================================================================================================================================================================================
 
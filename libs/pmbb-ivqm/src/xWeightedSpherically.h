@@ -5,6 +5,7 @@
 
 #pragma once
 #include "xCommonDefIVQM.h"
+#include <tuple>
 
 namespace PMBB_NAMESPACE {
 
@@ -16,9 +17,21 @@ protected:
   bool               m_UseWS = false;
   std::vector<flt64> m_EquirectangularWeights;
   flt64              m_DistortionCorrection = 1.0;
+  std::vector<flt64> m_EquirectangularWeightsSub; //for vertically subsampled (native 4:2:0) chroma planes
+  flt64              m_DistortionCorrectionSub = 1.0;
 
 public:
   void  initWS(bool UseWS, int32 Width, int32 Height, int32 BitDepth, int32 LonRangeDeg = 360, int32 LatRangeDeg = 180);
+
+  //row weights and distortion correction for plane of given height (full picture height or half of it)
+  std::tuple<const flt64*, flt64> getEquirectangularWeights(int32 PlaneHeight) const
+  {
+    if(PlaneHeight == (int32)m_EquirectangularWeights.size()) { return { m_EquirectangularWeights   .data(), m_DistortionCorrection    }; }
+    else                                                      { return { m_EquirectangularWeightsSub.data(), m_DistortionCorrectionSub }; }
+  }
+
+protected:
+  static flt64 xCalcEquirectangularWeights(std::vector<flt64>& Weights, int32 Height, int32 LatRangeDeg); //returns distortion correction
 };
 
 //===============================================================================================================================================================================================================
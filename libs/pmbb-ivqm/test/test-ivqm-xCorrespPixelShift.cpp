@@ -0,0 +1,592 @@
+/*
+    SPDX-FileCopyrightText: 2019-2024 Jakub Stankowski <jakub.stankowski@put.poznan.pl>
+    SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+#include "../src/xCommonDefIVQM.h"
+#include "../src/xCorrespPixelShift.h"
+#include "xPicMask.h"
+#include "xTestUtils.h"
+
+using namespace PMBB_NAMESPACE;
+
+//===============================================================================================================================================================================================================
+
+static const std::vector<int32V2> c_Sizes        = { { 5, 5 }, { 17, 9 }, { 37, 18 }, { 70, 20 } }; //widths with SIMD remainder, heights with unchanged band (see genTestPics)
+static const std::vector<int32  > c_SearchRanges = { 1, 2, 3, 4, 5, 6, 7, 8 }; //compile time specializations (1..4) and generic kernels
+static const std::vector<int32  > c_BitDepths    = { 8, 10, 12, 14 }; //narrow (16-bit) and wide search arithmetic
+static const std::vector<int32V4> c_CmpWeights   = { { 4, 1, 1, 0 }, { 1, 1, 1, 0 }, { 2, 1, 3, 0 }, { 8, 1, 1, 0 } }; //specialized (4:1:1, 1:1:1) and generic weights, 8:1:1 - narrow arithmetic limit for 12-bit
+static const std::vector<int32V4> c_GlobColDiffs = { { 0, 0, 0, 0 }, { 2, -1, 3, 0 } };
+
+static constexpr int32 c_Margin      = 32;
+static constexpr int32 c_MskBitDepth = 8;
+
+//Ref is random, Tst is Ref with random noise added and about 1/32 of pels set to 0 or max value - every second band of 16 rows is left unchanged (gives equal tiles)
+static void genTestPics(xPicI* TstI, xPicI* RefI, const int32 BitDepth, uint32 Seed)
+{
+  const int32 MaxValue = xBitDepth2MaxValue(BitDepth);
+  xPicP Tst(TstI->getSize(), BitDepth, c_Margin), Ref(RefI->getSize(), BitDepth, c_Margin);
+  for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++)
+  {
+    const eCmp  CmpId  = (eCmp)CmpIdx;
+    const int32 Width  = Ref.getWidth (CmpId);
+    const int32 Height = Ref.getHeight(CmpId);
+    Seed = xTestUtils::fillRandom(Ref.getAddr(CmpId), Ref.getStride(CmpId), Width, Height, BitDepth, Seed);
+    for(int32 y = 0; y < Height; y++)
+    {
+      for(int32 x = 0; x < Width; x++)
+      {
+        Seed = xTestUtils::xXorShift32(Seed);
+        const int32 Noise = ((int32)(Seed & 0xF) - 8) << (BitDepth - 8);
+        const int32 Value = ((y >> 4) & 1) ? Ref.accessPel({ x, y }, CmpId) : ((Seed >> 4) & 31) == 0 ? ((Seed >> 9) & 1) * MaxValue : Ref.accessPel({ x, y }, CmpId) + Noise;
+        Tst.accessPel({ x, y }, CmpId) = (uint16)xClip(Value, 0, MaxValue);
+      }
+    }
+  }
+  Tst.extend();
+  Ref.extend();
+  TstI->rearrangeFromPlanar(&Tst);
+  RefI->rearrangeFromPlanar(&Ref);
+}
+
+//Tst close to max value and Ref close to 0 (about one quarter of pels equal to max value and 0) - differences close to max value (worst case for narrow arithmetic)
+static void genExtremePics(xPicI* TstI, xPicI* RefI, const int32 BitDepth, uint32 Seed)
+{
+  const int32 MaxValue = xBitDepth2MaxValue(BitDepth);
+  const int32 Spread   = MaxValue >> 3;
+  xPicP Tst(TstI->getSize(), BitDepth, c_Margin), Ref(RefI->getSize(), BitDepth, c_Margin);
+  for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++)
+  {
+    const eCmp CmpId = (eCmp)CmpIdx;
+    for(int32 y = 0; y < Tst.getHeight(); y++)
+    {
+      for(int32 x = 0; x < Tst.getWidth(); x++)
+      {
+        Seed = xTestUtils::xXorShift32(Seed);
+        Tst.accessPel({ x, y }, CmpId) = (uint16)(MaxValue - ((Seed & 0x3) == 0 ? 0 : (int32)((Seed >>  2) % Spread)));
+        Ref.accessPel({ x, y }, CmpId) = (uint16)(           ((Seed & 0xC) == 0 ? 0 : (int32)((Seed >> 16) % Spread)));
+      }
+    }
+  }
+  Tst.extend();
+  Ref.extend();
+  TstI->rearrangeFromPlanar(&Tst);
+  RefI->rearrangeFromPlanar(&Ref);
+}
+
+//binary mask (0 or MaxValue) or weighted mask (random weights, about one third of pels equal to 0) - first 4 columns are not masked
+static void genTestMask(xPicP* Msk, const bool Binary, uint32 Seed)
+{
+  const int32 MaxValue = xBitDepth2MaxValue(c_MskBitDepth);
+  for(int32 y = 0; y < Msk->getHeight(); y++)
+  {
+    for(int32 x = 0; x < Msk->getWidth(); x++)
+    {
+      Seed = xTestUtils::xXorShift32(Seed);
+      const int32 Value = x < 4 ? MaxValue : (Seed % 3 == 0) ? 0 : Binary ? MaxValue : (int32)((Seed >> 8) % MaxValue) + 1;
+      Msk->accessPel({ x, y }, eCmp::LM) = (uint16)Value;
+    }
+  }
+  Msk->extend();
+}
+
+//mask with tile structure - Layout 0: 3x3 full tiles at top left (inner full search tile), column of empty tiles, remaining tiles mixed; Layout 1: all tiles full; Layout 2: tiles cycle through empty, full and mixed
+static void genTileMask(xPicP* Msk, const bool Binary, const int32 Layout, uint32 Seed)
+{
+  using eTile = xPicMask::eTile;
+  const int32 MaxValue = xBitDepth2MaxValue(c_MskBitDepth);
+  for(int32 y = 0; y < Msk->getHeight(); y++)
+  {
+    for(int32 x = 0; x < Msk->getWidth(); x++)
+    {
+      Seed = xTestUtils::xXorShift32(Seed);
+      const int32 TX    = x >> xPicMask::c_Log2TileSize;
+      const int32 TY    = y >> xPicMask::c_Log2TileSize;
+      const eTile Tile  = Layout == 0 ? (TX <= 2 && TY <= 2 ? eTile::Full : TX == 3 ? eTile::Empty : eTile::Mixed) : Layout == 1 ? eTile::Full : (eTile)((TX + TY) % 3);
+      const int32 Mixed = (Seed % 3 == 0) ? 0 : Binary ? MaxValue : (int32)((Seed >> 8) % MaxValue) + 1;
+      Msk->accessPel({ x, y }, eCmp::LM) = (uint16)(Tile == eTile::Full ? MaxValue : Tile == eTile::Empty ? 0 : Mixed);
+    }
+  }
+  Msk->extend();
+}
+
+//all kernels (scalar one included) keep weighted errors in int32 - combinations which can overflow it are not tested
+static bool isInt32Error(const int32 BitDepth, const int32V4& GlobalColorShift, const int32V4& CmpWeights)
+{
+  const int64 MaxDiff = (int64)xBitDepth2MaxValue(BitDepth) + GlobalColorShift.getMaxAbs();
+  return MaxDiff * MaxDiff * CmpWeights.getSum() <= (int64)std::numeric_limits<int32>::max();
+}
+
+//brute force search - raster order of candidates, first candidate with the lowest weighted error wins, Msk == nullptr --> no mask
+static uint64V4 refCalcDistAsymmetricRow(const xPicI* Tst, const xPicI* Ref, const xPicP* Msk, const int32 y, const int32 BegX, const int32 EndX, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights, xPicP* ShftComp)
+{
+  const int32V4 MaxValue = xMakeVec4<int32>(Ref->getMaxPelValue());
+  uint64V4      RowDist  = { 0, 0, 0, 0 };
+
+  for(int32 x = BegX; x < EndX; x++)
+  {
+    const int32 MskValue = Msk != nullptr ? (int32)Msk->accessPel({ x, y }, eCmp::LM) : 1;
+    if(MskValue == 0) { continue; }
+    const int32V4 TstPel    = (int32V4)(Tst->getAddr()[Tst->getOffset({ x, y })]) + GlobalColorShift;
+    int64         BestError = std::numeric_limits<int64>::max();
+    int32V4       BestPel   = { 0, 0, 0, 0 };
+    for(int32 dy = -SearchRange; dy <= SearchRange; dy++)
+    {
+      for(int32 dx = -SearchRange; dx <= SearchRange; dx++)
+      {
+        if(Msk != nullptr && Msk->accessPel({ x + dx, y + dy }, eCmp::LM) == 0) { continue; }
+        const int32V4 RefPel = (int32V4)(Ref->getAddr()[Ref->getOffset({ x + dx, y + dy })]);
+        const int32V4 Dist   = (TstPel - RefPel).getVecPow2();
+        const int64   Error  = (int64)Dist[0] * CmpWeights[0] + (int64)Dist[1] * CmpWeights[1] + (int64)Dist[2] * CmpWeights[2];
+        if(Error < BestError) { BestError = Error; BestPel = RefPel; }
+      }
+    }
+    RowDist += ((uint64V4)((TstPel - BestPel).getVecPow2())) * (uint64)MskValue;
+    if(ShftComp != nullptr)
+    {
+      const int32V4 ShftCompPel = (BestPel - GlobalColorShift).getClipU(MaxValue);
+      for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++) { ShftComp->accessPel({ x, y }, (eCmp)CmpIdx) = (uint16)ShftCompPel[CmpIdx]; }
+    }
+  }
+
+  return RowDist;
+}
+
+//===============================================================================================================================================================================================================
+
+using tAsymRowI = uint64V4(*)(const xPicI*, const xPicI*, const int32, const int32, const int32, const int32V4&, const int32, const int32V4&, xPicP*);
+
+struct xKernelI { const char* Name; tAsymRowI Func; };
+
+static const std::vector<xKernelI> c_KernelsI =
+{
+  { "STD"   , xCorrespPixelShiftSTD   ::CalcDistAsymmetricRow },
+#if X_CORRESPPIXELSHIFT_CAN_USE_SSE
+  { "SSE"   , xCorrespPixelShiftSSE   ::CalcDistAsymmetricRow },
+#endif
+#if X_CORRESPPIXELSHIFT_CAN_USE_AVX
+  { "AVX"   , xCorrespPixelShiftAVX   ::CalcDistAsymmetricRow },
+#endif
+#if X_CORRESPPIXELSHIFT_CAN_USE_AVX512
+  { "AVX512", xCorrespPixelShiftAVX512::CalcDistAsymmetricRow },
+#endif
+};
+
+using tAsymRowP = uint64V4(*)(const xPicP*, const xPicP*, const int32, const int32, const int32, const int32V4&, const int32, const int32V4&, xPicP*);
+
+struct xKernelP { const char* Name; tAsymRowP Func; int32 NumPels; }; //NumPels - processed columns have to be multiple of NumPels
+
+static const std::vector<xKernelP> c_KernelsP =
+{
+  { "Planar", xCorrespPixelShift::xCalcDistAsymmetricRow, 1 }, //SIMD kernel for groups of pixels, scalar code for remaining columns
+#if X_CORRESPPIXELSHIFT_CAN_USE_SSE
+  { "SSE"   , xCorrespPixelShiftSSE   ::CalcDistAsymmetricRow, xCorrespPixelShiftSSE   ::c_NumPelsPlanar },
+#endif
+#if X_CORRESPPIXELSHIFT_CAN_USE_AVX
+  { "AVX"   , xCorrespPixelShiftAVX   ::CalcDistAsymmetricRow, xCorrespPixelShiftAVX   ::c_NumPelsPlanar },
+#endif
+#if X_CORRESPPIXELSHIFT_CAN_USE_AVX512
+  { "AVX512", xCorrespPixelShiftAVX512::CalcDistAsymmetricRow, xCorrespPixelShiftAVX512::c_NumPelsPlanar },
+#endif
+};
+
+using tAsymRowPM = uint64V4(*)(const xPicI*, const xPicI*, const xPicP*   , const int32,                           const int32V4&, const int32, const int32V4&);
+using tAsymRowCM = uint64V4(*)(const xPicI*, const xPicI*, const xPicMask*, const int32, const int32, const int32, const int32V4&, const int32, const int32V4&);
+
+struct xKernelM { const char* Name; tAsymRowPM FuncP; tAsymRowCM FuncC; };
+
+static const std::vector<xKernelM> c_KernelsM =
+{
+  { "STD"   , xCorrespPixelShiftSTD   ::CalcDistAsymmetricRowM, xCorrespPixelShiftSTD   ::CalcDistAsymmetricRowM },
+#if X_CORRESPPIXELSHIFT_CAN_USE_SSE
+  { "SSE"   , xCorrespPixelShiftSSE   ::CalcDistAsymmetricRowM, xCorrespPixelShiftSSE   ::CalcDistAsymmetricRowM },
+#endif
+#if X_CORRESPPIXELSHIFT_CAN_USE_AVX
+  { "AVX"   , xCorrespPixelShiftAVX   ::CalcDistAsymmetricRowM, xCorrespPixelShiftAVX   ::CalcDistAsymmetricRowM },
+#endif
+#if X_CORRESPPIXELSHIFT_CAN_USE_AVX512
+  { "AVX512", xCorrespPixelShiftAVX512::CalcDistAsymmetricRowM, xCorrespPixelShiftAVX512::CalcDistAsymmetricRowM },
+#endif
+};
+
+//===============================================================================================================================================================================================================
+
+TEST_CASE("xCorrespPixelShift-Interleaved")
+{
+  //interleaved search kernels (all SIMD levels available in current build) have to give the same distances and shift compensated pels as brute force search
+  //whole rows and rows with unaligned begin and end are processed
+  for(const int32V2& Size : c_Sizes)
+  {
+    const int32 Width  = Size.getX();
+    const int32 Height = Size.getY();
+
+    for(const int32 BitDepth : c_BitDepths)
+    {
+      xPicI Tst(Size, BitDepth, c_Margin), Ref(Size, BitDepth, c_Margin);
+      genTestPics(&Tst, &Ref, BitDepth, xTestUtils::c_XorShiftSeed);
+      xPicP ShftCompR(Size, BitDepth, c_Margin), ShftCompK(Size, BitDepth, c_Margin);
+
+      for(const int32 SearchRange : c_SearchRanges)
+      {
+        for(const int32V4& CmpWeights : c_CmpWeights)
+        {
+          for(const int32V4& GCD : c_GlobColDiffs)
+          {
+            if(!isInt32Error(BitDepth, GCD, CmpWeights)) { continue; }
+            for(const int32V2& Range : { int32V2(0, Width), int32V2(xMin(3, Width - 1), xMax(Width - 2, 1)) })
+            {
+              std::vector<uint64V4> RowDistR(Height);
+              ShftCompR.fill(0);
+              for(int32 y = 0; y < Height; y++) { RowDistR[y] = refCalcDistAsymmetricRow(&Tst, &Ref, nullptr, y, Range[0], Range[1], GCD, SearchRange, CmpWeights, &ShftCompR); }
+
+              for(const xKernelI& Kernel : c_KernelsI)
+              {
+                CAPTURE(Width        );
+                CAPTURE(Height       );
+                CAPTURE(BitDepth     );
+                CAPTURE(SearchRange  );
+                CAPTURE(CmpWeights[0]);
+                CAPTURE(CmpWeights[2]);
+                CAPTURE(GCD[0]       );
+                CAPTURE(Range[0]     );
+                CAPTURE(Kernel.Name  );
+
+                bool SameDist = true;
+                ShftCompK.fill(0);
+                for(int32 y = 0; y < Height; y++) { SameDist &= Kernel.Func(&Tst, &Ref, y, Range[0], Range[1], GCD, SearchRange, CmpWeights, &ShftCompK) == RowDistR[y]; }
+                CHECK(SameDist);
+                CHECK(ShftCompK.equalPic(&ShftCompR));
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("xCorrespPixelShift-Planar")
+{
+  //planar search kernels have to give the same distances and shift compensated pels as brute force search (of interleaved pictures)
+  //SIMD kernels process groups of pixels only, so processed columns are trimmed to multiple of group size
+  for(const int32V2& Size : c_Sizes)
+  {
+    const int32 Width  = Size.getX();
+    const int32 Height = Size.getY();
+
+    for(const int32 BitDepth : c_BitDepths)
+    {
+      xPicI TstI(Size, BitDepth, c_Margin), RefI(Size, BitDepth, c_Margin);
+      genTestPics(&TstI, &RefI, BitDepth, xTestUtils::c_XorShiftSeed);
+      xPicP TstP(Size, BitDepth, c_Margin), RefP(Size, BitDepth, c_Margin);
+      TstI.rearrangeToPlanar(&TstP);
+      RefI.rearrangeToPlanar(&RefP);
+      xPicP ShftCompR(Size, BitDepth, c_Margin), ShftCompK(Size, BitDepth, c_Margin);
+
+      for(const int32 SearchRange : c_SearchRanges)
+      {
+        for(const int32V4& CmpWeights : c_CmpWeights)
+        {
+          for(const int32V4& GCD : c_GlobColDiffs)
+          {
+            if(!isInt32Error(BitDepth, GCD, CmpWeights)) { continue; }
+            for(const int32V2& Range : { int32V2(0, Width), int32V2(xMin(3, Width - 1), xMax(Width - 2, 1)) })
+            {
+              for(const xKernelP& Kernel : c_KernelsP)
+              {
+                const int32 BegX = Range[0];
+                const int32 EndX = BegX + (Range[1] - BegX) / Kernel.NumPels * Kernel.NumPels;
+                if(EndX == BegX) { continue; }
+
+                CAPTURE(Width        );
+                CAPTURE(Height       );
+                CAPTURE(BitDepth     );
+                CAPTURE(SearchRange  );
+                CAPTURE(CmpWeights[0]);
+                CAPTURE(CmpWeights[2]);
+                CAPTURE(GCD[0]       );
+                CAPTURE(BegX         );
+                CAPTURE(EndX         );
+                CAPTURE(Kernel.Name  );
+
+                bool SameDist = true;
+                ShftCompR.fill(0);
+                ShftCompK.fill(0);
+                for(int32 y = 0; y < Height; y++)
+                {
+                  const uint64V4 RowDistR = refCalcDistAsymmetricRow(&TstI, &RefI, nullptr, y, BegX, EndX, GCD, SearchRange, CmpWeights, &ShftCompR);
+                  SameDist &= Kernel.Func(&TstP, &RefP, y, BegX, EndX, GCD, SearchRange, CmpWeights, &ShftCompK) == RowDistR;
+                }
+                CHECK(SameDist);
+                CHECK(ShftCompK.equalPic(&ShftCompR));
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("xCorrespPixelShift-EqualTiles")
+{
+  //search within tiles identical in Tst and Ref can be skipped (zero GlobalColorShift and positive weights only) - skipping search has to give the same distances and shift compensated pels as brute force search
+  const int32V4 GCD = { 0, 0, 0, 0 };
+  CHECK(!xCorrespPixelShift::xCanSkipEqualTiles({ 2, -1, 3, 0 }, { 4, 1, 1, 0 }));
+  CHECK(!xCorrespPixelShift::xCanSkipEqualTiles(GCD, { 1, 0, 1, 0 }));
+
+  for(const int32V2& Size : c_Sizes)
+  {
+    const int32 Width     = Size.getX();
+    const int32 Height    = Size.getY();
+    const int32 NumTilesX = xCorrespPixelShiftPrms::CalcNumEqualTiles(Width );
+    const int32 NumTilesY = xCorrespPixelShiftPrms::CalcNumEqualTiles(Height);
+
+    for(const int32 BitDepth : c_BitDepths)
+    {
+      xPicI TstI(Size, BitDepth, c_Margin), RefI(Size, BitDepth, c_Margin);
+      genTestPics(&TstI, &RefI, BitDepth, xTestUtils::c_XorShiftSeed);
+      xPicP TstP(Size, BitDepth, c_Margin), RefP(Size, BitDepth, c_Margin);
+      TstI.rearrangeToPlanar(&TstP);
+      RefI.rearrangeToPlanar(&RefP);
+      xPicP ShftCompR(Size, BitDepth, c_Margin), ShftCompK(Size, BitDepth, c_Margin);
+
+      //tiles of unchanged bands are equal, tiles of noisy bands are not - only rows [16, 32) are covered by test sizes
+      std::vector<uint8> EqualTilesI(NumTilesX * NumTilesY), EqualTilesP(NumTilesX * NumTilesY);
+      int32 NumEqualPelsI = 0, NumEqualPelsP = 0;
+      for(int32 ty = 0; ty < NumTilesY; ty++)
+      {
+        NumEqualPelsI += xCorrespPixelShift::xCalcEqualTilesRow(&TstI, &RefI, ty, EqualTilesI.data() + ty * NumTilesX);
+        NumEqualPelsP += xCorrespPixelShift::xCalcEqualTilesRow(&TstP, &RefP, ty, EqualTilesP.data() + ty * NumTilesX);
+      }
+      CAPTURE(Width   );
+      CAPTURE(Height  );
+      CAPTURE(BitDepth);
+      CHECK(EqualTilesI   == EqualTilesP  );
+      CHECK(NumEqualPelsI == NumEqualPelsP);
+      CHECK(NumEqualPelsI == (Height > 16 ? Width * (xMin(Height, 32) - 16) : 0));
+
+      for(const int32 SearchRange : c_SearchRanges)
+      {
+        for(const int32V4& CmpWeights : c_CmpWeights)
+        {
+          if(!isInt32Error(BitDepth, GCD, CmpWeights)) { continue; }
+          REQUIRE(xCorrespPixelShift::xCanSkipEqualTiles(GCD, CmpWeights));
+
+          std::vector<uint64V4> RowDistR(Height);
+          ShftCompR.fill(0);
+          for(int32 y = 0; y < Height; y++) { RowDistR[y] = refCalcDistAsymmetricRow(&TstI, &RefI, nullptr, y, 0, Width, GCD, SearchRange, CmpWeights, &ShftCompR); }
+
+          for(const bool Interleaved : { false, true })
+          {
+            CAPTURE(SearchRange  );
+            CAPTURE(CmpWeights[0]);
+            CAPTURE(CmpWeights[2]);
+            CAPTURE(Interleaved  );
+
+            bool SameDist = true;
+            ShftCompK.fill(0);
+            for(int32 y = 0; y < Height; y++)
+            {
+              const uint8*   EqualTilesRow = EqualTilesI.data() + (y >> xCorrespPixelShiftPrms::c_Log2EqualTileSize) * NumTilesX;
+              const uint64V4 RowDist       = Interleaved ? xCorrespPixelShift::xCalcDistAsymmetricRowSkip(&TstI, &RefI, y, EqualTilesRow, GCD, SearchRange, CmpWeights, &ShftCompK) : xCorrespPixelShift::xCalcDistAsymmetricRowSkip(&TstP, &RefP, y, EqualTilesRow, GCD, SearchRange, CmpWeights, &ShftCompK);
+              SameDist &= RowDist == RowDistR[y];
+            }
+            CHECK(SameDist);
+            CHECK(ShftCompK.equalPic(&ShftCompR));
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("xCorrespPixelShift-CmpWeights")
+{
+  //only exact 4:1:1:0 and 1:1:1:0 weights can use shift/add kernels, any other weights (scaled ones and non-zero 4th weight included) need generic kernels
+  CHECK(xClassifyCmpWeights({ 4, 1, 1, 0 }) == eCmpWgh::W4110  );
+  CHECK(xClassifyCmpWeights({ 1, 1, 1, 0 }) == eCmpWgh::W1110  );
+  CHECK(xClassifyCmpWeights({ 8, 2, 2, 0 }) == eCmpWgh::GENERIC);
+  CHECK(xClassifyCmpWeights({ 2, 2, 2, 0 }) == eCmpWgh::GENERIC);
+  CHECK(xClassifyCmpWeights({ 4, 1, 1, 1 }) == eCmpWgh::GENERIC);
+  CHECK(xClassifyCmpWeights({ 1, 4, 1, 0 }) == eCmpWgh::GENERIC);
+}
+
+TEST_CASE("xCorrespPixelShift-NarrowGuard")
+{
+  //narrow (16-bit) arithmetic can be used only if weighted differences fit in int16 - check the limit and kernels on both sides of it with max differences
+  CHECK( xCanUseNarrowSearch( 8, { 0, 0, 0, 0 }, { 4, 1, 1, 0 }));
+  CHECK( xCanUseNarrowSearch(12, { 0, 0, 0, 0 }, { 8, 1, 1, 0 })); //4095 * 8 = 32760
+  CHECK(!xCanUseNarrowSearch(12, { 1, 0, 0, 0 }, { 8, 1, 1, 0 })); //4096 * 8 = 32768
+  CHECK(!xCanUseNarrowSearch(12, { 0, 0, 0, 0 }, { 9, 1, 1, 0 }));
+  CHECK(!xCanUseNarrowSearch(14, { 0, 0, 0, 0 }, { 4, 1, 1, 0 }));
+  CHECK(!xCanUseNarrowSearch( 8, { 0, 0, 0, 0 }, { 4, -1, 1, 0 }));
+
+  const int32V2 Size     = { 37, 9 };
+  const int32   BitDepth = 12;
+  xPicI Tst(Size, BitDepth, c_Margin), Ref(Size, BitDepth, c_Margin);
+  genExtremePics(&Tst, &Ref, BitDepth, xTestUtils::c_XorShiftSeed);
+  xPicP ShftCompR(Size, BitDepth, c_Margin), ShftCompK(Size, BitDepth, c_Margin);
+
+  for(const int32V4& CmpWeights : { int32V4(8, 1, 1, 0), int32V4(9, 1, 1, 0) })
+  {
+    for(const int32V4& GCD : { int32V4(0, 0, 0, 0), int32V4(1, 0, 0, 0), int32V4(-1, 0, 0, 0) })
+    {
+      for(const int32 SearchRange : { 2, 5 })
+      {
+        std::vector<uint64V4> RowDistR(Size.getY());
+        ShftCompR.fill(0);
+        for(int32 y = 0; y < Size.getY(); y++) { RowDistR[y] = refCalcDistAsymmetricRow(&Tst, &Ref, nullptr, y, 0, Size.getX(), GCD, SearchRange, CmpWeights, &ShftCompR); }
+
+        for(const xKernelI& Kernel : c_KernelsI)
+        {
+          CAPTURE(CmpWeights[0]);
+          CAPTURE(GCD[0]       );
+          CAPTURE(SearchRange  );
+          CAPTURE(Kernel.Name  );
+
+          bool SameDist = true;
+          ShftCompK.fill(0);
+          for(int32 y = 0; y < Size.getY(); y++) { SameDist &= Kernel.Func(&Tst, &Ref, y, 0, Size.getX(), GCD, SearchRange, CmpWeights, &ShftCompK) == RowDistR[y]; }
+          CHECK(SameDist);
+          CHECK(ShftCompK.equalPic(&ShftCompR));
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("xCorrespPixelShift-Masked")
+{
+  //masked search kernels have to give the same (mask weighted) distances as brute force search with masked candidates skipped
+  //planar mask (luma plane) is processed as whole rows, compact mask (bit plane for binary mask, 8 bit plane for weighted mask, distance scaled by getScale()) also as rows with unaligned begin and end
+  for(const int32V2& Size : c_Sizes)
+  {
+    const int32 Width  = Size.getX();
+    const int32 Height = Size.getY();
+
+    for(const bool Binary : { true, false })
+    {
+      xPicP    Msk(Size, c_MskBitDepth, c_Margin);
+      xPicMask PicMsk(Size, c_Margin);
+      genTestMask(&Msk, Binary, xTestUtils::c_XorShiftSeed);
+      PicMsk.pack(&Msk);
+      REQUIRE(PicMsk.isBinary() == Binary);
+      const uint64 Scale = (uint64)PicMsk.getScale();
+
+      for(const int32 BitDepth : c_BitDepths)
+      {
+        xPicI Tst(Size, BitDepth, c_Margin), Ref(Size, BitDepth, c_Margin);
+        genTestPics(&Tst, &Ref, BitDepth, xTestUtils::c_XorShiftSeed);
+
+        for(const int32 SearchRange : c_SearchRanges)
+        {
+          for(const int32V4& CmpWeights : c_CmpWeights)
+          {
+            for(const int32V4& GCD : c_GlobColDiffs)
+            {
+              if(!isInt32Error(BitDepth, GCD, CmpWeights)) { continue; }
+              for(const int32V2& Range : { int32V2(0, Width), int32V2(xMin(3, Width - 1), xMax(Width - 2, 1)) })
+              {
+                std::vector<uint64V4> RowDistR(Height);
+                for(int32 y = 0; y < Height; y++) { RowDistR[y] = refCalcDistAsymmetricRow(&Tst, &Ref, &Msk, y, Range[0], Range[1], GCD, SearchRange, CmpWeights, nullptr); }
+
+                for(const xKernelM& Kernel : c_KernelsM)
+                {
+                  CAPTURE(Width        );
+                  CAPTURE(Height       );
+                  CAPTURE(Binary       );
+                  CAPTURE(BitDepth     );
+                  CAPTURE(SearchRange  );
+                  CAPTURE(CmpWeights[0]);
+                  CAPTURE(CmpWeights[2]);
+                  CAPTURE(GCD[0]       );
+                  CAPTURE(Range[0]     );
+                  CAPTURE(Kernel.Name  );
+
+                  bool SameDistP = true, SameDistC = true;
+                  for(int32 y = 0; y < Height; y++)
+                  {
+                    if(Range[0] == 0 && Range[1] == Width) { SameDistP &= Kernel.FuncP(&Tst, &Ref, &Msk, y, GCD, SearchRange, CmpWeights) == RowDistR[y]; }
+                    SameDistC &= Kernel.FuncC(&Tst, &Ref, &PicMsk, y, Range[0], Range[1], GCD, SearchRange, CmpWeights) * Scale == RowDistR[y];
+                  }
+                  CHECK(SameDistP);
+                  CHECK(SameDistC);
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("xCorrespPixelShift-MaskTiles")
+{
+  //search with compact mask tiles (empty tiles skipped, full tiles searched without mask) has to give the same distances as brute force masked search,
+  //shift compensated rows have to cover all pels (the same as unmasked search) - frames smaller than single tile, partial tiles and inner full search tile
+  using eTile = xPicMask::eTile;
+  for(const int32V2& Size : { int32V2(5, 5), int32V2(70, 20), int32V2(200, 136) })
+  {
+    const int32 Width  = Size.getX();
+    const int32 Height = Size.getY();
+
+    for(const bool Binary : { true, false })
+    {
+      for(const int32 Layout : { 0, 1, 2 })
+      {
+        xPicP    Msk(Size, c_MskBitDepth, c_Margin);
+        xPicMask PicMsk(Size, c_Margin);
+        genTileMask(&Msk, Binary, Layout, xTestUtils::c_XorShiftSeed);
+        PicMsk.pack(&Msk);
+
+        for(const int32 BitDepth : { 8, 10 })
+        {
+          xPicI Tst(Size, BitDepth, c_Margin), Ref(Size, BitDepth, c_Margin);
+          genTestPics(&Tst, &Ref, BitDepth, xTestUtils::c_XorShiftSeed);
+
+          for(const int32 SearchRange : { 1, 3, 8 })
+          {
+            for(const int32V4& CmpWeights : { int32V4(4, 1, 1, 0), int32V4(2, 1, 3, 0) })
+            {
+              for(const int32V4& GCD : c_GlobColDiffs)
+              {
+                CAPTURE(Width        );
+                CAPTURE(Height       );
+                CAPTURE(Binary       );
+                CAPTURE(Layout       );
+                CAPTURE(BitDepth     );
+                CAPTURE(SearchRange  );
+                CAPTURE(CmpWeights[2]);
+                CAPTURE(GCD[0]       );
+
+                xPicP ShftComp(Size, BitDepth, c_Margin), ShftCompR(Size, BitDepth, c_Margin);
+                std::vector<eTile> SearchTilesRow(PicMsk.getNumTilesX());
+                bool SameDist = true, SameDistN = true, AnyFull = false;
+                for(int32 y = 0; y < Height; y++)
+                {
+                  if((y & (xPicMask::c_TileSize - 1)) == 0) { xCorrespPixelShift::xCalcSearchTilesRow(&PicMsk, y >> xPicMask::c_Log2TileSize, SearchRange, SearchTilesRow.data()); }
+                  for(const eTile Tile : SearchTilesRow) { AnyFull |= Tile == eTile::Full; }
+
+                  const uint64V4 RowDistR = refCalcDistAsymmetricRow(&Tst, &Ref, &Msk, y, 0, Width, GCD, SearchRange, CmpWeights, nullptr);
+                  refCalcDistAsymmetricRow(&Tst, &Ref, nullptr, y, 0, Width, GCD, SearchRange, CmpWeights, &ShftCompR);
+                  SameDist  &= xCorrespPixelShift::xCalcDistAsymmetricRowSkipM(&Tst, &Ref, &PicMsk, y, SearchTilesRow.data(), GCD, SearchRange, CmpWeights, &ShftComp) == RowDistR;
+                  SameDistN &= xCorrespPixelShift::xCalcDistAsymmetricRowSkipM(&Tst, &Ref, &PicMsk, y, SearchTilesRow.data(), GCD, SearchRange, CmpWeights, nullptr  ) == RowDistR;
+                }
+                CHECK(SameDist );
+                CHECK(SameDistN);
+                CHECK(ShftComp.equalPic(&ShftCompR));
+                if(Layout == 1 || (Layout == 0 && Width > 3 * xPicMask::c_TileSize)) { CHECK(AnyFull); } //full search tiles have to be detected
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+//===============================================================================================================================================================================================================
@@ -0,0 +1,217 @@
+/*
+    SPDX-FileCopyrightText: 2019-2024 Jakub Stankowski <jakub.stankowski@put.poznan.pl>
+    SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+#include "../src/xCommonDefIVQM.h"
+#include "../src/xIVPSNR.h"
+#include "../src/xShftCompPic.h"
+#include "xPicMask.h"
+#include "xPixelOps.h"
+#include "xThreadPool.h"
+#include "xTestUtils.h"
+#include <algorithm>
+
+using namespace PMBB_NAMESPACE;
+
+//===============================================================================================================================================================================================================
+
+static const std::vector<int32V2> c_Sizes       = { { 8, 8 }, { 16, 12 }, { 64, 4 }, { 70, 11 }, { 24, 70 }, { 136, 40 } }; //smaller than single tile, width with SIMD remainder, multiple tiles
+static const std::vector<int32  > c_SearchRanges = { 1, 2, 3, 4, 5, 8 };
+static const std::vector<int32V4> c_CmpWeights   = { { 4, 1, 1, 0 }, { 1, 1, 1, 0 }, { 2, 1, 3, 0 } };
+static const std::vector<int32V4> c_GlobColDiffs = { { 0, 0, 0, 0 }, { 2, -1, 3, 0 } };
+
+static constexpr int32 c_BitDepth = 8;
+static constexpr int32 c_Margin   = 32;
+
+//Ref is random, Tst is Ref with small random noise added - every second band of 16 rows is left unchanged (gives equal tiles)
+static void genTestPics(xPicP* Tst, xPicP* Ref, uint32 Seed)
+{
+  const int32 MaxValue = xBitDepth2MaxValue(c_BitDepth);
+  for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++)
+  {
+    const eCmp  CmpId  = (eCmp)CmpIdx;
+    const int32 Width  = Ref->getWidth (CmpId);
+    const int32 Height = Ref->getHeight(CmpId);
+    Seed = xTestUtils::fillRandom(Ref->getAddr(CmpId), Ref->getStride(CmpId), Width, Height, c_BitDepth, Seed);
+    for(int32 y = 0; y < Height; y++)
+    {
+      for(int32 x = 0; x < Width; x++)
+      {
+        Seed = xTestUtils::xXorShift32(Seed);
+        const int32 Noise = ((y >> 4) & 1) ? 0 : (int32)(Seed & 0xF) - 8;
+        Tst->accessPel({ x, y }, CmpId) = (uint16)xClip(Ref->accessPel({ x, y }, CmpId) + Noise, 0, MaxValue);
+      }
+    }
+  }
+  Tst->extend();
+  Ref->extend();
+}
+
+//binary mask (0 or MaxValue) or weighted mask (random weights, about one third of pels equal to 0) - left part of the picture is not masked
+static void genTestMask(xPicP* Msk, bool Binary, uint32 Seed)
+{
+  const int32 MaxValue = xBitDepth2MaxValue(c_BitDepth);
+  for(int32 y = 0; y < Msk->getHeight(); y++)
+  {
+    for(int32 x = 0; x < Msk->getWidth(); x++)
+    {
+      Seed = xTestUtils::xXorShift32(Seed);
+      const int32 Value = x < 16 ? MaxValue : (Seed % 3 == 0) ? 0 : Binary ? MaxValue : (int32)((Seed >> 8) % MaxValue) + 1;
+      Msk->accessPel({ x, y }, eCmp::LM) = (uint16)Value;
+    }
+  }
+}
+
+//reference shift compensated pictures - interleaved generation uses scalar search (planar one is based on the same SIMD kernels as IV-PSNR)
+static void genRefShftCompPics(xPicP* DstRef, xPicP* DstTst, const xPicI* SrcRef, const xPicI* SrcTst, const int32V4& GCD, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  xPicI ShftCompRefI(DstRef->getSize(), c_BitDepth, c_Margin), ShftCompTstI(DstTst->getSize(), c_BitDepth, c_Margin);
+  xShftCompPic::GenShftCompPics(&ShftCompRefI, &ShftCompTstI, SrcRef, SrcTst, GCD, SearchRange, CmpWeights);
+  ShftCompRefI.rearrangeToPlanar(DstRef);
+  ShftCompTstI.rearrangeToPlanar(DstTst);
+}
+
+//===============================================================================================================================================================================================================
+
+TEST_CASE("xIVPSNR-SharedSCP")
+{
+  //shift compensated pictures generated by IV-PSNR search (asymmetric or shared cost volume) have to be equal to scalar xShftCompPic::GenShftCompPics output, IV-PSNR value has to be unaffected
+  //IV-PSNR has to be the same for asymmetric search and shared cost volume, planar and interleaved pictures, with and without threads (pictures lower than single cost volume band included)
+  for(const int32V2& Size : c_Sizes)
+  {
+    const int32 Height = Size.getY();
+
+    xPicP Tst(Size, c_BitDepth, c_Margin), Ref(Size, c_BitDepth, c_Margin);
+    xPicI TstI(Size, c_BitDepth, c_Margin), RefI(Size, c_BitDepth, c_Margin);
+    genTestPics(&Tst, &Ref, xTestUtils::c_XorShiftSeed);
+    TstI.rearrangeFromPlanar(&Tst);
+    RefI.rearrangeFromPlanar(&Ref);
+
+    xPicP ShftCompTst(Size, c_BitDepth, c_Margin), ShftCompRef(Size, c_BitDepth, c_Margin);
+    xPicP RefShftCompTst(Size, c_BitDepth, c_Margin), RefShftCompRef(Size, c_BitDepth, c_Margin);
+
+    xThreadPool ThreadPool; ThreadPool.create(4, Height + 1);
+
+    for(const int32 SearchRange : c_SearchRanges)
+    {
+      for(const int32V4& CmpWeights : c_CmpWeights)
+      {
+        for(const int32V4& GCD : c_GlobColDiffs)
+        {
+          genRefShftCompPics(&RefShftCompRef, &RefShftCompTst, &RefI, &TstI, GCD, SearchRange, CmpWeights);
+
+          std::vector<flt64> IVPSNRs;
+          for(const bool UseCostVolume : { false, true })
+          {
+            for(const bool Interleaved : { false, true })
+            {
+              for(const bool UseThreads : { false, true })
+              {
+                CAPTURE(Size.getX()  );
+                CAPTURE(Size.getY()  );
+                CAPTURE(SearchRange  );
+                CAPTURE(CmpWeights[0]);
+                CAPTURE(CmpWeights[2]);
+                CAPTURE(GCD[0]       );
+                CAPTURE(UseCostVolume);
+                CAPTURE(Interleaved  );
+                CAPTURE(UseThreads   );
+
+                xIVPSNR Proc;
+                Proc.setSearchRange    (SearchRange  );
+                Proc.setCmpWeightsSearch(CmpWeights  );
+                Proc.setUseCostVolume  (UseCostVolume);
+                if(UseThreads) { Proc.initThreadPool(&ThreadPool, Height + 1); }
+                Proc.initRowBuffers(Height);
+
+                ShftCompTst.fill(0); ShftCompRef.fill(0);
+                const flt64 IVPSNR_S = Interleaved ? Proc.calcPicIVPSNR(&TstI, &RefI, GCD, &ShftCompTst, &ShftCompRef) : Proc.calcPicIVPSNR(&Tst, &Ref, GCD, &ShftCompTst, &ShftCompRef);
+                const flt64 IVPSNR_N = Interleaved ? Proc.calcPicIVPSNR(&TstI, &RefI, GCD                            ) : Proc.calcPicIVPSNR(&Tst, &Ref, GCD                            );
+
+                CHECK(IVPSNR_S == IVPSNR_N);
+                CHECK(ShftCompTst.equalPic(&RefShftCompTst));
+                CHECK(ShftCompRef.equalPic(&RefShftCompRef));
+                IVPSNRs.push_back(IVPSNR_N);
+
+                if(UseThreads) { Proc.uninitThreadPool(); }
+              }
+            }
+          }
+          CHECK(std::all_of(IVPSNRs.begin(), IVPSNRs.end(), [&](flt64 IVPSNR) { return IVPSNR == IVPSNRs[0]; }));
+        }
+      }
+    }
+
+    ThreadPool.destroy();
+  }
+}
+
+TEST_CASE("xIVPSNR-SharedSCP-Mask")
+{
+  //in mask mode shift compensated pictures have to cover masked pels too (IV-SSIM is not masked) - planar mask and compact mask (binary and weighted)
+  //compact binary mask is searched in bit plane (with margin), so IV-PSNR has to be equal to planar mask one
+  for(const int32V2& Size : c_Sizes)
+  {
+    xPicP Tst(Size, c_BitDepth, c_Margin), Ref(Size, c_BitDepth, c_Margin);
+    xPicI TstI(Size, c_BitDepth, c_Margin), RefI(Size, c_BitDepth, c_Margin);
+    genTestPics(&Tst, &Ref, xTestUtils::c_XorShiftSeed);
+    TstI.rearrangeFromPlanar(&Tst);
+    RefI.rearrangeFromPlanar(&Ref);
+
+    xPicP ShftCompTst(Size, c_BitDepth, c_Margin), ShftCompRef(Size, c_BitDepth, c_Margin);
+    xPicP RefShftCompTst(Size, c_BitDepth, c_Margin), RefShftCompRef(Size, c_BitDepth, c_Margin);
+
+    for(const bool Binary : { true, false })
+    {
+      xPicP    Msk(Size, c_BitDepth, c_Margin);
+      xPicMask PicMsk(Size, c_Margin);
+      genTestMask(&Msk, Binary, xTestUtils::c_XorShiftSeed);
+      PicMsk.pack(&Msk);
+      const int32 NumNonMasked = xPixelOps::CountNonZero(Msk.getAddr(eCmp::LM), Msk.getStride(), Msk.getWidth(), Msk.getHeight());
+
+      for(const int32 SearchRange : c_SearchRanges)
+      {
+        for(const int32V4& CmpWeights : c_CmpWeights)
+        {
+          for(const int32V4& GCD : c_GlobColDiffs)
+          {
+            genRefShftCompPics(&RefShftCompRef, &RefShftCompTst, &RefI, &TstI, GCD, SearchRange, CmpWeights);
+
+            flt64 IVPSNRs[2] = { 0, 0 };
+            for(const bool Compact : { false, true })
+            {
+              CAPTURE(Size.getX()  );
+              CAPTURE(Size.getY()  );
+              CAPTURE(Binary       );
+              CAPTURE(SearchRange  );
+              CAPTURE(CmpWeights[0]);
+              CAPTURE(CmpWeights[2]);
+              CAPTURE(GCD[0]       );
+              CAPTURE(Compact      );
+
+              xIVPSNRM Proc;
+              Proc.setSearchRange    (SearchRange);
+              Proc.setCmpWeightsSearch(CmpWeights);
+              Proc.initRowBuffers(Size.getY());
+
+              ShftCompTst.fill(0); ShftCompRef.fill(0);
+              const flt64 IVPSNR_S = Compact ? Proc.calcPicIVPSNRM(&TstI, &RefI, &PicMsk, GCD, &ShftCompTst, &ShftCompRef) : Proc.calcPicIVPSNRM(&TstI, &RefI, &Msk, NumNonMasked, GCD, &ShftCompTst, &ShftCompRef);
+              const flt64 IVPSNR_N = Compact ? Proc.calcPicIVPSNRM(&TstI, &RefI, &PicMsk, GCD                            ) : Proc.calcPicIVPSNRM(&TstI, &RefI, &Msk, NumNonMasked, GCD                            );
+
+              CHECK(IVPSNR_S == IVPSNR_N);
+              CHECK(ShftCompTst.equalPic(&RefShftCompTst));
+              CHECK(ShftCompRef.equalPic(&RefShftCompRef));
+              IVPSNRs[Compact] = IVPSNR_N;
+            }
+            CHECK(IVPSNRs[0] == IVPSNRs[1]);
+          }
+        }
+      }
+    }
+  }
+}
+
+//===============================================================================================================================================================================================================
@@ -0,0 +1,726 @@
+/*
+    SPDX-FileCopyrightText: 2019-2024 Jakub Stankowski <jakub.stankowski@put.poznan.pl>
+    SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+#include "../src/xCommonDefIVQM.h"
+#include "../src/xSSIM.h"
+#include "../src/xStructSim.h"
+#include "../src/xIVPSNR.h"
+#include "../src/xShftCompPic.h"
+#include "xThreadPool.h"
+#include "xTestUtils.h"
+#include <cmath>
+
+using namespace PMBB_NAMESPACE;
+
+//===============================================================================================================================================================================================================
+
+static const std::vector<int32V2> c_SmallSizes = { { 8, 8 }, { 64, 8 }, { 64, 4 }, { 16, 12 }, { 64, 11 }, { 64, 12 }, { 24, 70 } }; //smaller than SSIM window, single valid row, smaller than one band
+static const std::vector<int32V2> c_StreamSizes = { { 8, 8 }, { 16, 12 }, { 70, 11 }, { 24, 70 }, { 136, 150 } }; //smaller than SSIM window, smaller than one band, multiple bands
+static const std::vector<int32V2> c_RefSizes = { { 8, 8 }, { 16, 12 }, { 37, 21 }, { 70, 11 }, { 24, 70 }, { 136, 150 } }; //width with SIMD remainder, smaller than one band, multiple bands
+static const std::vector<int32V2> c_MultiScaleSizes = { { 16, 12 }, { 70, 11 }, { 136, 150 }, { 200, 180 }, { 250, 190 } }; //coarse scales smaller than SSIM window, all scales valid, odd sub-scale sizes
+static const std::vector<int32V2> c_KernelSizes = { { 32, 11 }, { 48, 20 }, { 64, 13 } }; //widths are multiples of widest SIMD vector (moments of whole row calculated by SIMD kernel), valid columns not
+static const std::vector<int32  > c_NumThreads = { 0, 4 };
+
+static constexpr int32 c_BitDepth = 8;
+static constexpr int32 c_Margin   = 32;
+
+//Ref is random, Tst is Ref with small random noise added (keeps SSIM values far from 0)
+static void genTestPics(xPicP* Tst, xPicP* Ref, int32 BitDepth, uint32 Seed)
+{
+  const int32 MaxValue = xBitDepth2MaxValue(BitDepth);
+  for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++)
+  {
+    const eCmp  CmpId  = (eCmp)CmpIdx;
+    const int32 Width  = Ref->getWidth (CmpId);
+    const int32 Height = Ref->getHeight(CmpId);
+    Seed = xTestUtils::fillRandom(Ref->getAddr(CmpId), Ref->getStride(CmpId), Width, Height, BitDepth, Seed);
+    for(int32 y = 0; y < Height; y++)
+    {
+      for(int32 x = 0; x < Width; x++)
+      {
+        Seed = xTestUtils::xXorShift32(Seed);
+        const int32 Noise = (int32)(Seed & 0xF) - 8;
+        Tst->accessPel({ x, y }, CmpId) = (uint16)xClip(Ref->accessPel({ x, y }, CmpId) + Noise, 0, MaxValue);
+      }
+    }
+  }
+  Tst->extend();
+  Ref->extend();
+}
+
+//moment planes are filtered separately from cross moment, so results may differ by rounding only
+//MS-SSIM of pictures with empty sub-scales is NaN (0/0 average), same for both calculation paths
+static bool isSameResult(flt64 A, flt64 B, flt64 Tolerance) { return std::abs(A - B) <= Tolerance || (std::isnan(A) && std::isnan(B)); }
+
+//reference SSIM - direct 2-D gaussian window (outer product of c_FilterS) evaluated independently for every valid pel, window covers [-c_FilterRange, c_FilterRange) in x and y
+static flt64 refCalcPelSSIM(const xPicP* Tst, const xPicP* Ref, eCmp CmpId, int32 PosX, int32 PosY, bool CalcL, flt64 C1, flt64 C2)
+{
+  const xStructSimConsts::tFltrS& Filter = xStructSimConsts::c_FilterS;
+  const int32 FR = xStructSimConsts::c_FilterRange;
+
+  flt64 AvgR = 0, AvgT = 0, SumR2 = 0, SumT2 = 0, SumRT = 0;
+  for(int32 dy = -FR; dy < FR; dy++)
+  {
+    for(int32 dx = -FR; dx < FR; dx++)
+    {
+      const flt64 C = Filter[dy + FR] * Filter[dx + FR];
+      const flt64 R = Ref->accessPel({ PosX + dx, PosY + dy }, CmpId);
+      const flt64 T = Tst->accessPel({ PosX + dx, PosY + dy }, CmpId);
+      AvgR  += R     * C;
+      AvgT  += T     * C;
+      SumR2 += R * R * C;
+      SumT2 += T * T * C;
+      SumRT += R * T * C;
+    }
+  }
+
+  const flt64 VarR2 = SumR2 - AvgR * AvgR;
+  const flt64 VarT2 = SumT2 - AvgT * AvgT;
+  const flt64 CovRT = SumRT - AvgR * AvgT;
+  const flt64 L     = CalcL ? (2 * AvgR * AvgT + C1) / (AvgR * AvgR + AvgT * AvgT + C1) : 1.0;
+  const flt64 CS    = (2 * CovRT + C2) / (VarR2 + VarT2 + C2);
+  return L * CS;
+}
+
+//reference picture SSIM - sum over valid pels divided by number of all pels (same normalization as xSSIM)
+//strided mode - only pels at FR + k * Step (in x and y) are evaluated, their sum is scaled to number of valid pels
+static flt64 refCalcPicSSIM(const xPicP* Tst, const xPicP* Ref, eCmp CmpId, bool CalcL, int32 Step = 1)
+{
+  const int32 FR       = xStructSimConsts::c_FilterRange;
+  const int32 Width    = Ref->getWidth (CmpId);
+  const int32 Height   = Ref->getHeight(CmpId);
+  const flt64 MaxValue = (flt64)xBitDepth2MaxValue(Ref->getBitDepth());
+  const flt64 C1       = xPow2(xStructSimConsts::c_K1<flt64> * MaxValue);
+  const flt64 C2       = xPow2(xStructSimConsts::c_K2<flt64> * MaxValue);
+
+  flt64 Sum        = 0;
+  int64 NumSampled = 0;
+  for(int32 y = FR; y < Height - FR; y += Step)
+  {
+    for(int32 x = FR; x < Width - FR; x += Step) { Sum += refCalcPelSSIM(Tst, Ref, CmpId, x, y, CalcL, C1, C2); NumSampled++; }
+  }
+  const int64 NumValid = (int64)xMax(Width - 2 * FR, 0) * (int64)xMax(Height - 2 * FR, 0);
+  if(NumSampled > 0) { Sum = Sum * (flt64)NumValid / (flt64)NumSampled; }
+  return Sum / ((flt64)Width * (flt64)Height);
+}
+
+//reference FASTSSIM - box window BoxSize x BoxSize at every origin [0, Width - BoxSize] x [0, Height - BoxSize], moments averaged directly, sum divided by number of all pels
+static flt64 refCalcPicFastSSIM(const xPicP* Tst, const xPicP* Ref, eCmp CmpId, int32 BoxSize)
+{
+  const int32 Width    = Ref->getWidth (CmpId);
+  const int32 Height   = Ref->getHeight(CmpId);
+  const flt64 MaxValue = (flt64)xBitDepth2MaxValue(Ref->getBitDepth());
+  const flt64 C1       = xPow2(xStructSimConsts::c_K1<flt64> * MaxValue);
+  const flt64 C2       = xPow2(xStructSimConsts::c_K2<flt64> * MaxValue);
+  const flt64 InvArea  = 1.0 / (flt64)(BoxSize * BoxSize);
+
+  flt64 Sum = 0;
+  for(int32 y0 = 0; y0 <= Height - BoxSize; y0++)
+  {
+    for(int32 x0 = 0; x0 <= Width - BoxSize; x0++)
+    {
+      flt64 AvgR = 0, AvgT = 0, SumR2 = 0, SumT2 = 0, SumRT = 0;
+      for(int32 y = y0; y < y0 + BoxSize; y++)
+      {
+        for(int32 x = x0; x < x0 + BoxSize; x++)
+        {
+          const flt64 R = Ref->accessPel({ x, y }, CmpId);
+          const flt64 T = Tst->accessPel({ x, y }, CmpId);
+          AvgR += R; AvgT += T; SumR2 += R * R; SumT2 += T * T; SumRT += R * T;
+        }
+      }
+      AvgR *= InvArea; AvgT *= InvArea; SumR2 *= InvArea; SumT2 *= InvArea; SumRT *= InvArea;
+
+      const flt64 VarR2 = SumR2 - AvgR * AvgR;
+      const flt64 VarT2 = SumT2 - AvgT * AvgT;
+      const flt64 CovRT = SumRT - AvgR * AvgT;
+      Sum += ((2 * AvgR * AvgT + C1) / (AvgR * AvgR + AvgT * AvgT + C1)) * ((2 * CovRT + C2) / (VarR2 + VarT2 + C2));
+    }
+  }
+  return Sum / ((flt64)Width * (flt64)Height);
+}
+
+//reference IV-SSIM - worse of two directions (Tst vs RefSCP, Ref vs TstSCP), components averaged with CmpWeights (BoxSize > 0 --> box window variant)
+static flt64 refCalcPicIVSSIM(const xPicP* Tst, const xPicP* Ref, const xPicP* TstSCP, const xPicP* RefSCP, const int32V4& CmpWeights, int32 BoxSize = 0)
+{
+  flt64 SSIM_T2R = 0, SSIM_R2T = 0;
+  for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++)
+  {
+    const eCmp CmpId = (eCmp)CmpIdx;
+    SSIM_T2R += (BoxSize > 0 ? refCalcPicFastSSIM(Tst, RefSCP, CmpId, BoxSize) : refCalcPicSSIM(Tst, RefSCP, CmpId, true)) * CmpWeights[CmpIdx];
+    SSIM_R2T += (BoxSize > 0 ? refCalcPicFastSSIM(Ref, TstSCP, CmpId, BoxSize) : refCalcPicSSIM(Ref, TstSCP, CmpId, true)) * CmpWeights[CmpIdx];
+  }
+  return xMin(SSIM_T2R, SSIM_R2T) / (flt64)CmpWeights.getSum();
+}
+
+//reference MS-SSIM - sequential 2x2 averaging pyramid, scale 0 and last scale use contrast-structure only, remaining scales full SSIM (same term selection as xSSIM)
+static void refDownsamplePic(xPicP* Dst, const xPicP* Src)
+{
+  for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++)
+  {
+    const eCmp CmpId = (eCmp)CmpIdx;
+    for(int32 y = 0; y < Dst->getHeight(CmpId); y++)
+    {
+      for(int32 x = 0; x < Dst->getWidth(CmpId); x++)
+      {
+        const int32 Sum = Src->accessPel({ 2 * x, 2 * y }, CmpId) + Src->accessPel({ 2 * x + 1, 2 * y }, CmpId) + Src->accessPel({ 2 * x, 2 * y + 1 }, CmpId) + Src->accessPel({ 2 * x + 1, 2 * y + 1 }, CmpId);
+        Dst->accessPel({ x, y }, CmpId) = (uint16)((Sum + 2) >> 2);
+      }
+    }
+  }
+}
+
+static flt64V4 refCalcPicMSSSIM(const xPicP* Tst, const xPicP* Ref)
+{
+  constexpr int32 NumScales = xStructSimConsts::c_NumMultiScales;
+
+  std::vector<xPicP*> SubTst = { nullptr }, SubRef = { nullptr };
+  for(int32 i = 1; i < NumScales; i++)
+  {
+    const int32V2 SubSize = Ref->getSize() >> i;
+    SubTst.push_back(new xPicP(SubSize, Ref->getBitDepth(), 0));
+    SubRef.push_back(new xPicP(SubSize, Ref->getBitDepth(), 0));
+    refDownsamplePic(SubTst[i], i == 1 ? Tst : SubTst[i - 1]);
+    refDownsamplePic(SubRef[i], i == 1 ? Ref : SubRef[i - 1]);
+  }
+
+  flt64V4 MSSSIM = xMakeVec4<flt64>(1);
+  for(int32 i = 0; i < NumScales; i++)
+  {
+    const xPicP* ScaleTst = i == 0 ? Tst : SubTst[i];
+    const xPicP* ScaleRef = i == 0 ? Ref : SubRef[i];
+    const bool   CalcL    = i != 0 && i != NumScales - 1;
+    for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++) { MSSSIM[CmpIdx] *= std::pow(refCalcPicSSIM(ScaleTst, ScaleRef, (eCmp)CmpIdx, CalcL), xStructSimConsts::c_MultiScaleWghts<flt64>[i]); }
+  }
+
+  for(int32 i = 1; i < NumScales; i++) { SubTst[i]->destroy(); delete SubTst[i]; SubRef[i]->destroy(); delete SubRef[i]; }
+  return MSSSIM;
+}
+
+//SIMD kernel pipeline (moments, horizontal filter, vertical filter fused with SSIM) for every valid row of luma, columns trimmed to multiple of c_NumPels - row sums compared with direct 2-D window
+//moment cache pipeline (moments of Tst and Ref filtered separately, cross moment fused with SSIM) is checked in the same way
+template <class tSIMD, class fltTP, bool CalcL> static void testKernelRowSums(const int32V2& Size, int32 BitDepth, flt64 Tolerance)
+{
+  constexpr int32 NumPels    = tSIMD::template c_NumPels<fltTP>;
+  constexpr int32 FR         = xStructSimConsts::c_FilterRange;
+  constexpr int32 WindowSize = xStructSimConsts::c_WindowSize;
+  constexpr int32 NumMoms    = xStructSimConsts::c_NumMoments;
+  constexpr int32 NumPicMoms = xStructSimConsts::c_NumPicMoms;
+
+  const int32 Width  = Size.getX();
+  const int32 Height = Size.getY();
+  const int32 BegX   = FR;
+  const int32 EndX   = BegX + (Width - 2 * FR) / NumPels * NumPels;
+
+  xPicP Tst(Size, BitDepth, c_Margin), Ref(Size, BitDepth, c_Margin);
+  genTestPics(&Tst, &Ref, BitDepth, xTestUtils::c_XorShiftSeed);
+
+  const flt64 MaxValue = (flt64)xBitDepth2MaxValue(BitDepth);
+  const flt64 C1       = xPow2(xStructSimConsts::c_K1<flt64> * MaxValue);
+  const flt64 C2       = xPow2(xStructSimConsts::c_K2<flt64> * MaxValue);
+
+  std::vector<fltTP> Moments (NumMoms * Width, 0);
+  std::vector<fltTP> MomentsH(WindowSize * NumMoms * Width, 0);
+  const fltTP* Window[WindowSize];
+
+  std::vector<fltTP> MomentsHT (WindowSize * NumPicMoms * Width, 0), MomentsVT(NumPicMoms * Width, 0);
+  std::vector<fltTP> MomentsHR (WindowSize * NumPicMoms * Width, 0), MomentsVR(NumPicMoms * Width, 0);
+  std::vector<fltTP> MomentsHRT(WindowSize              * Width, 0);
+  const fltTP* WindowT[WindowSize]; const fltTP* WindowR[WindowSize]; const fltTP* WindowRT[WindowSize];
+
+  for(int32 y = FR; y < Height - FR; y++)
+  {
+    for(int32 i = 0; i < WindowSize; i++)
+    {
+      const int32 r = y - FR + i;
+      fltTP* RowH = MomentsH.data() + i * NumMoms * Width;
+      tSIMD::CalcMoments(Moments.data(), Tst.getAddr(eCmp::LM) + r * Tst.getStride(eCmp::LM), Ref.getAddr(eCmp::LM) + r * Ref.getStride(eCmp::LM), Width, 0, Width);
+      tSIMD::FilterRowH (RowH, Moments.data(), Width, NumMoms, BegX, EndX, xStructSimConsts::c_FilterS);
+      Window[i] = RowH;
+
+      fltTP* RowHT  = MomentsHT .data() + i * NumPicMoms * Width;
+      fltTP* RowHR  = MomentsHR .data() + i * NumPicMoms * Width;
+      fltTP* RowHRT = MomentsHRT.data() + i              * Width;
+      tSIMD::CalcMoments(Moments.data(), Tst.getAddr(eCmp::LM) + r * Tst.getStride(eCmp::LM), Width, 0, Width);
+      tSIMD::FilterRowH (RowHT, Moments.data(), Width, NumPicMoms, BegX, EndX, xStructSimConsts::c_FilterS);
+      tSIMD::CalcMoments(Moments.data(), Ref.getAddr(eCmp::LM) + r * Ref.getStride(eCmp::LM), Width, 0, Width);
+      tSIMD::FilterRowH (RowHR, Moments.data(), Width, NumPicMoms, BegX, EndX, xStructSimConsts::c_FilterS);
+      tSIMD::CalcMomRT  (Moments.data(), Tst.getAddr(eCmp::LM) + r * Tst.getStride(eCmp::LM), Ref.getAddr(eCmp::LM) + r * Ref.getStride(eCmp::LM), 0, Width);
+      tSIMD::FilterRowH (RowHRT, Moments.data(), Width, 1, BegX, EndX, xStructSimConsts::c_FilterS);
+      WindowT[i] = RowHT; WindowR[i] = RowHR; WindowRT[i] = RowHRT;
+    }
+    const flt64 RowSum = tSIMD::template FilterRowV<CalcL>(Window, Width, BegX, EndX, xStructSimConsts::c_FilterS, (fltTP)C1, (fltTP)C2);
+
+    tSIMD::FilterRowV(MomentsVT.data(), WindowT, Width, NumPicMoms, BegX, EndX, xStructSimConsts::c_FilterS);
+    tSIMD::FilterRowV(MomentsVR.data(), WindowR, Width, NumPicMoms, BegX, EndX, xStructSimConsts::c_FilterS);
+    const flt64 RowSumC = tSIMD::template FilterRowVRT<CalcL>(WindowRT, MomentsVT.data(), MomentsVR.data(), Width, BegX, EndX, xStructSimConsts::c_FilterS, (fltTP)C1, (fltTP)C2);
+
+    flt64 RowSumR = 0;
+    for(int32 x = BegX; x < EndX; x++) { RowSumR += refCalcPelSSIM(&Tst, &Ref, eCmp::LM, x, y, CalcL, C1, C2); }
+
+    CAPTURE(Width   );
+    CAPTURE(Height  );
+    CAPTURE(BitDepth);
+    CAPTURE(NumPels );
+    CAPTURE(CalcL   );
+    CAPTURE(y       );
+    CHECK(isSameResult(RowSum , RowSumR, Tolerance * (EndX - BegX)));
+    CHECK(isSameResult(RowSumC, RowSumR, Tolerance * (EndX - BegX)));
+  }
+}
+
+template <class tSIMD> static void testKernelRowSums()
+{
+  for(const int32V2& Size : c_KernelSizes)
+  {
+    for(const int32 BitDepth : { 8, 10 })
+    {
+      testKernelRowSums<tSIMD, flt32, true >(Size, BitDepth, 1e-5 );
+      testKernelRowSums<tSIMD, flt32, false>(Size, BitDepth, 1e-5 );
+      testKernelRowSums<tSIMD, flt64, true >(Size, BitDepth, 1e-12);
+      testKernelRowSums<tSIMD, flt64, false>(Size, BitDepth, 1e-12);
+    }
+  }
+}
+
+//===============================================================================================================================================================================================================
+
+TEST_CASE("xSSIM-SmallPictures")
+{
+  //pictures smaller than SSIM window or single band - moment cache (shared by SSIM, MS-SSIM and IV-SSIM) has to give the same results as calculation without cache
+  for(const int32V2& Size : c_SmallSizes)
+  {
+    for(const int32 NumThreads : c_NumThreads)
+    {
+      for(const int32 Precision : { 32, 64 })
+      {
+        const int32 Width  = Size.getX();
+        const int32 Height = Size.getY();
+        CAPTURE(Width     );
+        CAPTURE(Height    );
+        CAPTURE(NumThreads);
+        CAPTURE(Precision );
+
+        xPicP Tst(Size, c_BitDepth, c_Margin);
+        xPicP Ref(Size, c_BitDepth, c_Margin);
+        genTestPics(&Tst, &Ref, c_BitDepth, xTestUtils::c_XorShiftSeed);
+
+        xThreadPool* ThreadPool = nullptr;
+        if(NumThreads > 0) { ThreadPool = new xThreadPool; ThreadPool->create(NumThreads, Height + 1); }
+
+        xIVSSIM ProcCached, ProcSingle;
+        for(xIVSSIM* Proc : { &ProcCached, &ProcSingle })
+        {
+          Proc->create(Size, c_BitDepth, c_Margin, true);
+          Proc->setPrecision(Precision);
+          if(ThreadPool) { Proc->initThreadPool(ThreadPool, Height + 1); }
+        }
+        ProcCached.setUseMomentCache(true );
+        ProcSingle.setUseMomentCache(false);
+
+        const flt64   Tolerance = Precision == 32 ? 1e-6 : 1e-12;
+        const flt64V4 SSIM_C   = ProcCached.calcPicSSIM  (&Tst, &Ref);
+        const flt64V4 MSSSIM_C = ProcCached.calcPicMSSSIM(&Tst, &Ref);
+        const flt64   IVSSIM_C = ProcCached.calcPicIVSSIM(&Tst, &Ref);
+        const flt64V4 SSIM_S   = ProcSingle.calcPicSSIM  (&Tst, &Ref);
+        const flt64V4 MSSSIM_S = ProcSingle.calcPicMSSSIM(&Tst, &Ref);
+        const flt64   IVSSIM_S = ProcSingle.calcPicIVSSIM(&Tst, &Ref);
+
+        for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++)
+        {
+          CHECK(isSameResult(SSIM_C  [CmpIdx], SSIM_S  [CmpIdx], Tolerance));
+          CHECK(isSameResult(MSSSIM_C[CmpIdx], MSSSIM_S[CmpIdx], Tolerance));
+          if(Height <= 2 * xSSIM::c_FilterRange) { CHECK(SSIM_C[CmpIdx] == 0.0); } //no valid rows
+        }
+        CHECK(isSameResult(IVSSIM_C, IVSSIM_S, Tolerance));
+
+        for(xIVSSIM* Proc : { &ProcCached, &ProcSingle }) { Proc->uninitThreadPool(); Proc->destroy(); }
+        if(ThreadPool) { ThreadPool->destroy(); delete ThreadPool; }
+      }
+    }
+  }
+}
+
+#if X_STRUCTSIM_CAN_USE_AVX
+TEST_CASE("xStructSimAVX-Kernels")
+{
+  testKernelRowSums<xStructSimAVX>();
+}
+#endif //X_STRUCTSIM_CAN_USE_AVX
+
+#if X_STRUCTSIM_CAN_USE_AVX512
+TEST_CASE("xStructSimAVX512-Kernels")
+{
+  testKernelRowSums<xStructSimAVX512>();
+}
+#endif //X_STRUCTSIM_CAN_USE_AVX512
+
+TEST_CASE("xSSIM-SeparableReference")
+{
+  //separable gaussian filter with rolling row buffers (SIMD kernels included) has to match direct 2-D window - widths with SIMD remainder, pictures lower than single band and multiple bands
+  //single precision mode has to stay within flt32 rounding of reference, moment cache has to match reference for both filling and cached call
+  for(const int32V2& Size : c_RefSizes)
+  {
+    for(const int32 BitDepth : { 8, 10 })
+    {
+      xPicP Tst(Size, BitDepth, c_Margin), Ref(Size, BitDepth, c_Margin);
+      genTestPics(&Tst, &Ref, BitDepth, xTestUtils::c_XorShiftSeed);
+
+      for(const bool CalcL : { true, false })
+      {
+        const flt64V4 SSIM_R = { refCalcPicSSIM(&Tst, &Ref, eCmp::LM, CalcL), refCalcPicSSIM(&Tst, &Ref, eCmp::CB, CalcL), refCalcPicSSIM(&Tst, &Ref, eCmp::CR, CalcL), 0 };
+
+        for(const int32 NumThreads : c_NumThreads)
+        {
+          for(const int32 Precision : { 64, 32 })
+          {
+            CAPTURE(Size.getX());
+            CAPTURE(Size.getY());
+            CAPTURE(BitDepth   );
+            CAPTURE(CalcL      );
+            CAPTURE(NumThreads );
+            CAPTURE(Precision  );
+
+            xThreadPool* ThreadPool = nullptr;
+            if(NumThreads > 0) { ThreadPool = new xThreadPool; ThreadPool->create(NumThreads, Size.getY() + 1); }
+
+            xSSIM Proc;
+            Proc.create(Size, BitDepth, c_Margin, false);
+            Proc.setPrecision(Precision);
+            if(ThreadPool) { Proc.initThreadPool(ThreadPool, Size.getY() + 1); }
+
+            const flt64 Tolerance = Precision == 32 ? 1e-6 : 1e-10;
+            Proc.setUseMomentCache(false);
+            const flt64V4 SSIM_S = Proc.calcPicSSIM(&Tst, &Ref, CalcL);
+            Proc.setUseMomentCache(true );
+            const flt64V4 SSIM_F = Proc.calcPicSSIM(&Tst, &Ref, CalcL); //fills cache
+            const flt64V4 SSIM_C = Proc.calcPicSSIM(&Tst, &Ref, CalcL); //uses cached moment planes
+            for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++)
+            {
+              CHECK(isSameResult(SSIM_S[CmpIdx], SSIM_R[CmpIdx], Tolerance));
+              CHECK(isSameResult(SSIM_F[CmpIdx], SSIM_R[CmpIdx], Tolerance));
+              CHECK(isSameResult(SSIM_C[CmpIdx], SSIM_R[CmpIdx], Tolerance));
+            }
+
+            Proc.uninitThreadPool(); Proc.destroy();
+            if(ThreadPool) { ThreadPool->destroy(); delete ThreadPool; }
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("xSSIM-StridedReference")
+{
+  //strided evaluation (grid global for whole picture, independent of band split) has to match reference evaluated at sampled pels only
+  for(const int32V2& Size : c_RefSizes)
+  {
+    xPicP Tst(Size, c_BitDepth, c_Margin), Ref(Size, c_BitDepth, c_Margin);
+    genTestPics(&Tst, &Ref, c_BitDepth, xTestUtils::c_XorShiftSeed);
+
+    for(const int32 SampleStep : { 2, 3, 4 })
+    {
+      const flt64V4 SSIM_R = { refCalcPicSSIM(&Tst, &Ref, eCmp::LM, true, SampleStep), refCalcPicSSIM(&Tst, &Ref, eCmp::CB, true, SampleStep), refCalcPicSSIM(&Tst, &Ref, eCmp::CR, true, SampleStep), 0 };
+
+      for(const int32 NumThreads : c_NumThreads)
+      {
+        for(const int32 Precision : { 64, 32 })
+        {
+          CAPTURE(Size.getX());
+          CAPTURE(Size.getY());
+          CAPTURE(SampleStep );
+          CAPTURE(NumThreads );
+          CAPTURE(Precision  );
+
+          xThreadPool* ThreadPool = nullptr;
+          if(NumThreads > 0) { ThreadPool = new xThreadPool; ThreadPool->create(NumThreads, Size.getY() + 1); }
+
+          xSSIM Proc;
+          Proc.create(Size, c_BitDepth, c_Margin, false);
+          Proc.setPrecision (Precision );
+          Proc.setSampleStep(SampleStep);
+          if(ThreadPool) { Proc.initThreadPool(ThreadPool, Size.getY() + 1); }
+
+          const flt64   Tolerance = Precision == 32 ? 1e-6 : 1e-10;
+          const flt64V4 SSIM      = Proc.calcPicSSIM(&Tst, &Ref);
+          for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++) { CHECK(isSameResult(SSIM[CmpIdx], SSIM_R[CmpIdx], Tolerance)); }
+
+          Proc.uninitThreadPool(); Proc.destroy();
+          if(ThreadPool) { ThreadPool->destroy(); delete ThreadPool; }
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("xMSSSIM-Reference")
+{
+  //MS-SSIM with pyramid downsampled in bands and all scales processed concurrently has to match sequentially built reference pyramid (coarse bands spanning whole sub-scale included)
+  for(const int32V2& Size : c_MultiScaleSizes)
+  {
+    xPicP Tst(Size, c_BitDepth, c_Margin), Ref(Size, c_BitDepth, c_Margin);
+    genTestPics(&Tst, &Ref, c_BitDepth, xTestUtils::c_XorShiftSeed);
+    const flt64V4 MSSSIM_R = refCalcPicMSSSIM(&Tst, &Ref);
+
+    for(const int32 NumThreads : c_NumThreads)
+    {
+      for(const bool UseMomentCache : { false, true })
+      {
+        CAPTURE(Size.getX()   );
+        CAPTURE(Size.getY()   );
+        CAPTURE(NumThreads    );
+        CAPTURE(UseMomentCache);
+
+        xThreadPool* ThreadPool = nullptr;
+        if(NumThreads > 0) { ThreadPool = new xThreadPool; ThreadPool->create(NumThreads, Size.getY() + 1); }
+
+        xSSIM Proc;
+        Proc.create(Size, c_BitDepth, c_Margin, true);
+        Proc.setUseMomentCache(UseMomentCache);
+        if(ThreadPool) { Proc.initThreadPool(ThreadPool, Size.getY() + 1); }
+
+        const flt64V4 MSSSIM = Proc.calcPicMSSSIM(&Tst, &Ref);
+        for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++) { CHECK(isSameResult(MSSSIM[CmpIdx], MSSSIM_R[CmpIdx], 1e-10)); }
+
+        Proc.uninitThreadPool(); Proc.destroy();
+        if(ThreadPool) { ThreadPool->destroy(); delete ThreadPool; }
+      }
+    }
+  }
+}
+
+TEST_CASE("xIVSSIM-SingleBatch")
+{
+  //all components and both IV-SSIM directions are processed as single batch of band tasks - has to match reference and give exactly the same result as single threaded processing
+  const int32V4 GCD        = { 2, -1, 3, 0 };
+  const int32V4 CmpWeights = xCorrespPixelShiftPrms::c_DefaultCmpWeights;
+  for(const int32V2& Size : c_StreamSizes)
+  {
+    const int32 Height = Size.getY();
+
+    xPicP Tst(Size, c_BitDepth, c_Margin), Ref(Size, c_BitDepth, c_Margin);
+    genTestPics(&Tst, &Ref, c_BitDepth, xTestUtils::c_XorShiftSeed);
+    xPicI TstI(Size, c_BitDepth, c_Margin), RefI(Size, c_BitDepth, c_Margin);
+    TstI.rearrangeFromPlanar(&Tst);
+    RefI.rearrangeFromPlanar(&Ref);
+
+    xPicI TstSCPI(Size, c_BitDepth, c_Margin), RefSCPI(Size, c_BitDepth, c_Margin);
+    xShftCompPic::GenShftCompPics(&RefSCPI, &TstSCPI, &RefI, &TstI, GCD, xCorrespPixelShiftPrms::c_DefaultSearchRange, CmpWeights);
+    xPicP TstSCP(Size, c_BitDepth, c_Margin), RefSCP(Size, c_BitDepth, c_Margin);
+    TstSCPI.rearrangeToPlanar(&TstSCP);
+    RefSCPI.rearrangeToPlanar(&RefSCP);
+
+    const flt64 IVSSIM_R = refCalcPicIVSSIM(&Tst, &Ref, &TstSCP, &RefSCP, CmpWeights);
+
+    for(const bool UseMomentCache : { false, true })
+    {
+      flt64V4 SSIM_0 = xMakeVec4<flt64>(0);
+      flt64   IVSSIM_0 = 0;
+      for(const int32 NumThreads : { 0, 1, 3, 8 })
+      {
+        CAPTURE(Size.getX()   );
+        CAPTURE(Height        );
+        CAPTURE(UseMomentCache);
+        CAPTURE(NumThreads    );
+
+        xThreadPool* ThreadPool = nullptr;
+        if(NumThreads > 0) { ThreadPool = new xThreadPool; ThreadPool->create(NumThreads, Height + 1); }
+
+        xIVSSIM Proc;
+        Proc.create(Size, c_BitDepth, c_Margin, false);
+        Proc.setUseMomentCache    (UseMomentCache);
+        Proc.setCmpWeightsAverage (CmpWeights    );
+        if(ThreadPool) { Proc.initThreadPool(ThreadPool, Height + 1); }
+
+        const flt64V4 SSIM   = Proc.calcPicSSIM  (&Tst, &Ref);
+        const flt64   IVSSIM = Proc.calcPicIVSSIM(&Tst, &Ref, &TstSCP, &RefSCP);
+        CHECK(isSameResult(IVSSIM, IVSSIM_R, 1e-10));
+        if(NumThreads == 0) { SSIM_0 = SSIM; IVSSIM_0 = IVSSIM; }
+        for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++) { CHECK(SSIM[CmpIdx] == SSIM_0[CmpIdx]); }
+        CHECK(IVSSIM == IVSSIM_0);
+
+        Proc.uninitThreadPool(); Proc.destroy();
+        if(ThreadPool) { ThreadPool->destroy(); delete ThreadPool; }
+      }
+    }
+  }
+}
+
+TEST_CASE("xSSIM-FastSSIMReference")
+{
+  //box window SSIM from integer summed-area tables has to match direct box averaging - pictures smaller than box (no valid window) give 0
+  const int32V4 GCD        = { 2, -1, 3, 0 };
+  const int32V4 CmpWeights = xCorrespPixelShiftPrms::c_DefaultCmpWeights;
+  for(const int32V2& Size : c_RefSizes)
+  {
+    const int32 Height = Size.getY();
+
+    for(const int32 BitDepth : { 8, 10 })
+    {
+      xPicP Tst(Size, BitDepth, c_Margin), Ref(Size, BitDepth, c_Margin);
+      genTestPics(&Tst, &Ref, BitDepth, xTestUtils::c_XorShiftSeed);
+      xPicI TstI(Size, BitDepth, c_Margin), RefI(Size, BitDepth, c_Margin);
+      TstI.rearrangeFromPlanar(&Tst);
+      RefI.rearrangeFromPlanar(&Ref);
+
+      xPicI TstSCPI(Size, BitDepth, c_Margin), RefSCPI(Size, BitDepth, c_Margin);
+      xShftCompPic::GenShftCompPics(&RefSCPI, &TstSCPI, &RefI, &TstI, GCD, xCorrespPixelShiftPrms::c_DefaultSearchRange, CmpWeights);
+      xPicP TstSCP(Size, BitDepth, c_Margin), RefSCP(Size, BitDepth, c_Margin);
+      TstSCPI.rearrangeToPlanar(&TstSCP);
+      RefSCPI.rearrangeToPlanar(&RefSCP);
+
+      for(const int32 BoxSize : { 2, 8, 11, 16 })
+      {
+        const flt64V4 SSIM_R   = { refCalcPicFastSSIM(&Tst, &Ref, eCmp::LM, BoxSize), refCalcPicFastSSIM(&Tst, &Ref, eCmp::CB, BoxSize), refCalcPicFastSSIM(&Tst, &Ref, eCmp::CR, BoxSize), 0 };
+        const flt64   IVSSIM_R = refCalcPicIVSSIM(&Tst, &Ref, &TstSCP, &RefSCP, CmpWeights, BoxSize);
+
+        for(const int32 NumThreads : c_NumThreads)
+        {
+          CAPTURE(Size.getX());
+          CAPTURE(Height     );
+          CAPTURE(BitDepth   );
+          CAPTURE(BoxSize    );
+          CAPTURE(NumThreads );
+
+          xThreadPool* ThreadPool = nullptr;
+          if(NumThreads > 0) { ThreadPool = new xThreadPool; ThreadPool->create(NumThreads, Height + 1); }
+
+          xIVSSIM Proc;
+          Proc.create(Size, BitDepth, c_Margin, false);
+          Proc.setBoxSize          (BoxSize   );
+          Proc.setCmpWeightsAverage(CmpWeights);
+          if(ThreadPool) { Proc.initThreadPool(ThreadPool, Height + 1); }
+
+          const flt64V4 SSIM   = Proc.calcPicFastSSIM  (&Tst, &Ref);
+          const flt64   IVSSIM = Proc.calcPicIVFastSSIM(&Tst, &Ref, &TstSCP, &RefSCP);
+          for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++)
+          {
+            CHECK(isSameResult(SSIM[CmpIdx], SSIM_R[CmpIdx], 1e-10));
+            if(Size.getX() < BoxSize || Height < BoxSize) { CHECK(SSIM[CmpIdx] == 0.0); }
+          }
+          CHECK(isSameResult(IVSSIM, IVSSIM_R, 1e-10));
+
+          Proc.uninitThreadPool(); Proc.destroy();
+          if(ThreadPool) { ThreadPool->destroy(); delete ThreadPool; }
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("xIVSSIM-SharedSCP")
+{
+  //IV-SSIM of SCP pictures stored by IV-PSNR search (asymmetric or shared cost volume) has to be equal to IV-SSIM generating own SCP pictures
+  for(const int32V2& Size : c_StreamSizes)
+  {
+    const int32 Height = Size.getY();
+
+    xPicP Tst(Size, c_BitDepth, c_Margin), Ref(Size, c_BitDepth, c_Margin);
+    genTestPics(&Tst, &Ref, c_BitDepth, xTestUtils::c_XorShiftSeed);
+    const int32V4 GCD = xGlobClrDiff::CalcGlobalColorDiff(&Ref, &Tst, xGlobClrDiffPrms::c_DefaultUnntcbCoef);
+    xPicP TstSCP(Size, c_BitDepth, c_Margin), RefSCP(Size, c_BitDepth, c_Margin);
+
+    for(const int32 SearchRange : { 2, 5 })
+    {
+      for(const int32V4& CmpWeights : { int32V4(4, 1, 1, 0), int32V4(2, 1, 3, 0) })
+      {
+        for(const bool UseCostVolume : { false, true })
+        {
+          CAPTURE(Size.getX()  );
+          CAPTURE(Height       );
+          CAPTURE(SearchRange  );
+          CAPTURE(CmpWeights[2]);
+          CAPTURE(UseCostVolume);
+
+          xIVPSNR ProcPSNR;
+          ProcPSNR.setSearchRange     (SearchRange  );
+          ProcPSNR.setCmpWeightsSearch(CmpWeights   );
+          ProcPSNR.setUseCostVolume   (UseCostVolume);
+          ProcPSNR.initRowBuffers(Height);
+          ProcPSNR.calcPicIVPSNR(&Tst, &Ref, GCD, &TstSCP, &RefSCP);
+
+          xIVSSIM ProcSSIM;
+          ProcSSIM.create(Size, c_BitDepth, c_Margin, true);
+          ProcSSIM.setSearchRange     (SearchRange);
+          ProcSSIM.setCmpWeightsSearch(CmpWeights );
+          const flt64 IVSSIM_S = ProcSSIM.calcPicIVSSIM(&Tst, &Ref, &TstSCP, &RefSCP);
+          const flt64 IVSSIM_O = ProcSSIM.calcPicIVSSIM(&Tst, &Ref);
+          CHECK(isSameResult(IVSSIM_S, IVSSIM_O, 0.0));
+          ProcSSIM.destroy();
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("xIVSSIM-Streamed")
+{
+  //IV-SSIM with SCP rows generated by band tasks (single SCP row buffer per worker) has to be equal to IV-SSIM of SCP pictures generated by scalar search
+  const int32V4 GCD = { 2, -1, 3, 0 };
+  for(const int32V2& Size : c_StreamSizes)
+  {
+    const int32 Height = Size.getY();
+
+    xPicP Tst(Size, c_BitDepth, c_Margin), Ref(Size, c_BitDepth, c_Margin);
+    genTestPics(&Tst, &Ref, c_BitDepth, xTestUtils::c_XorShiftSeed);
+    xPicI TstI(Size, c_BitDepth, c_Margin), RefI(Size, c_BitDepth, c_Margin);
+    TstI.rearrangeFromPlanar(&Tst);
+    RefI.rearrangeFromPlanar(&Ref);
+
+    for(const int32 SearchRange : { 2, 5 })
+    {
+      for(const int32V4& CmpWeights : { int32V4(4, 1, 1, 0), int32V4(2, 1, 3, 0) })
+      {
+        xPicI TstSCPI(Size, c_BitDepth, c_Margin), RefSCPI(Size, c_BitDepth, c_Margin);
+        xShftCompPic::GenShftCompPics(&RefSCPI, &TstSCPI, &RefI, &TstI, GCD, SearchRange, CmpWeights);
+        xPicP TstSCP(Size, c_BitDepth, c_Margin), RefSCP(Size, c_BitDepth, c_Margin);
+        TstSCPI.rearrangeToPlanar(&TstSCP);
+        RefSCPI.rearrangeToPlanar(&RefSCP);
+
+        for(const int32 NumThreads : c_NumThreads)
+        {
+          for(const int32 Precision : { 32, 64 })
+          {
+            for(const int32 SampleStep : { 1, 2 })
+            {
+              CAPTURE(Size.getX()  );
+              CAPTURE(Height       );
+              CAPTURE(SearchRange  );
+              CAPTURE(CmpWeights[2]);
+              CAPTURE(NumThreads   );
+              CAPTURE(Precision    );
+              CAPTURE(SampleStep   );
+
+              xThreadPool* ThreadPool = nullptr;
+              if(NumThreads > 0) { ThreadPool = new xThreadPool; ThreadPool->create(NumThreads, Height + 1); }
+
+              xIVSSIM Proc;
+              Proc.create(Size, c_BitDepth, c_Margin, true);
+              Proc.setPrecision      (Precision );
+              Proc.setSampleStep     (SampleStep);
+              Proc.setUseMomentCache (false     );
+              Proc.setSearchRange    (SearchRange);
+              Proc.setCmpWeightsSearch(CmpWeights);
+              if(ThreadPool) { Proc.initThreadPool(ThreadPool, Height + 1); }
+
+              const flt64 Tolerance = Precision == 32 ? 1e-6 : 1e-12;
+              const flt64 IVSSIM_P  = Proc.calcPicIVSSIM        (&Tst, &Ref, &TstSCP, &RefSCP);
+              const flt64 IVSSIM_S  = Proc.calcPicIVSSIMStreamed(&Tst, &Ref, GCD);
+              CHECK(isSameResult(IVSSIM_P, IVSSIM_S, Tolerance));
+
+              Proc.uninitThreadPool(); Proc.destroy();
+              if(ThreadPool) { ThreadPool->destroy(); delete ThreadPool; }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+//===============================================================================================================================================================================================================